@@ -0,0 +1,27 @@
+QT -= gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+include($$PWD/../../../../Common.pri)
+include($$PWD/../../../../Application.pri)
+
+INCLUDEPATH += $$PWD/../../
+INCLUDEPATH += $$PWD/../../Frames/
+INCLUDEPATH += $$PWD/../../Threads/
+INCLUDEPATH += $$PWD/../../Utils/
+INCLUDEPATH += $$PWD/Common/
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+HEADERS += \
+    $$PWD/Common/AllocationCounter.h \
+    $$PWD/Common/BenchmarkUtils.h
+
+CONFIG(debug, debug|release) {
+    win32: LIBS += -lThreaderd1
+    linux-g++: LIBS += -lThreader
+} else {
+    win32: LIBS += -lThreader1
+    linux-g++: LIBS += -lThreader
+}
@@ -0,0 +1,27 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    CrcKernels \
+    FrameCodecs \
+    FrameExtraction \
+    InboxContention \
+    LogCalls \
+    LogWriter \
+    MessageDispatch \
+    OutboxBatching
+
+linux {
+    SUBDIRS += \
+        DataFramesWindow \
+        FrameReading \
+        LogRateLimits \
+        LoopClockProfile \
+        MessageBudget \
+        MessageConstruction \
+        MessageTiming \
+        PingPong \
+        Polling \
+        ReactorEcho \
+        SlabPipeline \
+        TimerWheel
+}
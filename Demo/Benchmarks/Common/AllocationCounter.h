@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+
+// Подсчет выделений памяти подменой malloc, calloc и realloc (только glibc).
+// Заголовок подключается в единственный файл программы замера: через malloc
+// выделяют память и operator new, и контейнеры Qt.
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+namespace Threader {
+
+namespace Benchmarks {
+
+inline std::atomic<qint64> &allocationsCounter()
+{
+    static std::atomic<qint64> counter(0);
+    return counter;
+}
+
+/**
+ * @brief allocationsCount - Количество выделений памяти с начала работы процесса
+ */
+inline qint64 allocationsCount()
+{
+    return allocationsCounter().load(std::memory_order_relaxed);
+}
+
+}}
+
+extern "C" void *malloc(size_t size) noexcept
+{
+    Threader::Benchmarks::allocationsCounter().fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) noexcept
+{
+    Threader::Benchmarks::allocationsCounter().fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size) noexcept
+{
+    Threader::Benchmarks::allocationsCounter().fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
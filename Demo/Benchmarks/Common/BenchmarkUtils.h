@@ -0,0 +1,181 @@
+#pragma once
+
+#include "DateUtils.h"
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Threader {
+
+namespace Benchmarks {
+
+/**
+ * @brief nowNanoseconds - Чтение монотонного счетчика в наносекундах
+ */
+inline qint64 nowNanoseconds()
+{
+    return Utils::DateUtils::getTickCountNanoseconds();
+}
+
+/**
+ * @brief perSecond - Пересчет количества событий за интервал в количество в секунду
+ * @param count - Количество событий
+ * @param nanoseconds - Длительность интервала в наносекундах
+ */
+inline double perSecond(double count, qint64 nanoseconds)
+{
+    return (nanoseconds > 0) ? count * 1e9 / double(nanoseconds) : 0.0;
+}
+
+/**
+ * @brief number - Форматирование числа с фиксированным количеством знаков после запятой
+ */
+inline QString number(double value, int precision = 1)
+{
+    return QString::number(value, 'f', precision);
+}
+
+/**
+ * @brief LatencySamples - Замеры длительностей для вычисления процентилей
+ */
+class LatencySamples
+{
+public:
+    void reserve(int count)
+    {
+        _samples.reserve(count);
+    }
+
+    void append(qint64 nanoseconds)
+    {
+        _samples.append(nanoseconds);
+        _isSorted = false;
+    }
+
+    void append(const LatencySamples &other)
+    {
+        _samples += other._samples;
+        _isSorted = false;
+    }
+
+    void clear()
+    {
+        _samples.clear();
+        _isSorted = true;
+    }
+
+    int count() const
+    {
+        return _samples.count();
+    }
+
+    /**
+     * @brief percentile - Получение значения, не превышаемого заданной долей замеров
+     * @param percent - Процент от 0 до 100
+     */
+    qint64 percentile(double percent)
+    {
+        if (_samples.isEmpty())
+            return 0;
+
+        if (!_isSorted)
+        {
+            std::sort(_samples.begin(), _samples.end());
+            _isSorted = true;
+        }
+
+        int index = int(std::ceil(double(_samples.count()) * percent / 100.0)) - 1;
+        return _samples.at(qBound(0, index, _samples.count() - 1));
+    }
+
+    double mean() const
+    {
+        if (_samples.isEmpty())
+            return 0.0;
+
+        double sum = 0.0;
+        for (qint64 sample : _samples)
+            sum += double(sample);
+        return sum / double(_samples.count());
+    }
+
+private:
+    QVector<qint64> _samples;
+    bool _isSorted = true;
+};
+
+/**
+ * @brief Table - Вывод результатов таблицей с выравниванием колонок по ширине
+ */
+class Table
+{
+public:
+    explicit Table(const QStringList &headers)
+    {
+        _rows.append(headers);
+    }
+
+    void addRow(const QStringList &cells)
+    {
+        _rows.append(cells);
+    }
+
+    void print() const
+    {
+        QVector<int> widths;
+        for (const QStringList &row : _rows)
+            for (int i = 0; i < row.count(); i++)
+            {
+                if (widths.count() <= i)
+                    widths.append(0);
+                widths[i] = qMax(widths.at(i), row.at(i).length());
+            }
+
+        for (int i = 0; i < _rows.count(); i++)
+        {
+            QString line;
+            for (int j = 0; j < _rows.at(i).count(); j++)
+                line += _rows.at(i).at(j).rightJustified(widths.at(j) + 2);
+            std::cout << line.toStdString() << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    QVector<QStringList> _rows;
+};
+
+/**
+ * @brief processStatusValue - Чтение числового поля /proc/self/status (только Linux)
+ * @param name - Имя поля, например VmRSS (в КиБ) или Threads
+ * @return - Значение поля или 0, если поле недоступно
+ */
+inline qint64 processStatusValue(const QByteArray &name)
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    for (const QByteArray &line : file.readAll().split('\n'))
+    {
+        if (line.startsWith(name + ":"))
+            return line.mid(name.length() + 1).simplified().split(' ').value(0).toLongLong();
+    }
+    return 0;
+}
+
+/**
+ * @brief printTitle - Вывод заголовка раздела результатов
+ */
+inline void printTitle(const QString &title)
+{
+    std::cout << title.toStdString() << std::endl;
+}
+
+}}
@@ -0,0 +1,89 @@
+#include "BenchmarkUtils.h"
+#include "CrcUtils.h"
+
+#include <QCoreApplication>
+#include <QPair>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Utils;
+
+/**
+ * @brief MEASURE_NANOSECONDS - Продолжительность замера одного размера данных
+ */
+const qint64 MEASURE_NANOSECONDS = 200000000;
+
+const int MAXIMUM_SIZE = 1024 * 1024;
+
+volatile quint32 checksumSink = 0;
+
+/**
+ * @brief measure - Вычисление контрольной суммы блока заданного размера в течение
+ * MEASURE_NANOSECONDS
+ * @return - Скорость в ГБ/с
+ */
+template<typename Function>
+double measure(const QByteArray &data, int size, Function checksum)
+{
+    auto pointer = reinterpret_cast<uint8_t*>(const_cast<char*>(data.constData()));
+    qint64 bytes = 0;
+    quint32 accumulated = 0;
+
+    qint64 started = nowNanoseconds();
+    qint64 elapsed = 0;
+    while (elapsed < MEASURE_NANOSECONDS)
+    {
+        // часы читаются после серии вызовов, чтобы не искажать замер малых размеров
+        for (int i = 0; i < 64; i++)
+            accumulated += checksum(pointer, size);
+        bytes += qint64(size) * 64;
+        elapsed = nowNanoseconds() - started;
+    }
+
+    checksumSink = checksumSink + accumulated;
+    return perSecond(double(bytes), elapsed) / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QByteArray data(MAXIMUM_SIZE, '\0');
+    for (int i = 0; i < data.size(); i++)
+        data[i] = char((i * 2654435761u) >> 24);
+
+    const QVector<QPair<CrcUtils::CrcKernel, QString>> kernels = {
+        {CrcUtils::CrcKernel::Bytewise, "Bytewise"},
+        {CrcUtils::CrcKernel::SliceBy8, "SliceBy8"},
+        {CrcUtils::CrcKernel::Clmul, "Clmul"}
+    };
+
+    QStringList headers = {"Размер, байт"};
+    for (const auto &kernel : kernels)
+        if (CrcUtils::isKernelSupported(kernel.first))
+            headers << kernel.second + " CRC-16" << kernel.second + " CRC-32";
+
+    printTitle("Скорость вычисления контрольных сумм, ГБ/с");
+    Table table(headers);
+    for (int size = 16; size <= MAXIMUM_SIZE; size *= 4)
+    {
+        QStringList row = {QString::number(size)};
+        for (const auto &kernel : kernels)
+        {
+            if (!CrcUtils::setKernel(kernel.first))
+                continue;
+
+            row << number(measure(data, size, [](uint8_t *pointer, int count)
+            {
+                return quint32(CrcUtils::Crc16(0xFFFF, pointer, count));
+            }), 2);
+            row << number(measure(data, size, [](uint8_t *pointer, int count)
+            {
+                return CrcUtils::Crc32(pointer, uint32_t(count));
+            }), 2);
+        }
+        table.addRow(row);
+    }
+    table.print();
+
+    return 0;
+}
@@ -0,0 +1,364 @@
+#include "BenchmarkUtils.h"
+#include "ThreadDataFrames.h"
+#include "ThreadListenSocket.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QXmlStreamReader>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <deque>
+#include <thread>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const uint16_t SERVER_PORT = 53910;
+const uint16_t FIRST_PROXY_PORT = 53911;
+
+const int PAYLOAD_SIZE = 1024;
+
+/**
+ * @brief PACKETS_PER_WINDOW_SLOT - Количество пакетов замера на один пакет окна,
+ * чтобы каждый замер длился одинаковое количество периодов обхода
+ */
+const int PACKETS_PER_WINDOW_SLOT = 100;
+
+const qint64 RUN_TIMEOUT_NANOSECONDS = 60000000000;
+
+const char DEFINITIONS[] =
+        "<DataFrames Version=\"1\">"
+        "<DataFrame Name=\"Payload\" NeedsTicket=\"true\">"
+        "<DataAtom Name=\"Data\" Type=\"ByteArray\"/>"
+        "</DataFrame>"
+        "</DataFrames>";
+
+/**
+ * @brief DelayProxy - Посредник TCP, задерживающий данные в каждом направлении
+ * на половину заданного времени обхода
+ */
+class DelayProxy
+{
+public:
+    DelayProxy(uint16_t port, uint16_t targetPort, qint64 roundTripNanoseconds)
+        : _targetPort(targetPort)
+        , _delay(roundTripNanoseconds / 2)
+        , _listenSocket(listenSocket(port))
+        , _thread([this]() { run(); })
+    {
+    }
+
+    ~DelayProxy()
+    {
+        _isStopped = true;
+        _thread.join();
+        ::close(_listenSocket);
+    }
+
+private:
+    struct Chunk
+    {
+        qint64 Due;
+        QByteArray Data;
+    };
+
+    static int listenSocket(uint16_t port)
+    {
+        int result = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        setsockopt(result, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(result, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(result, 1);
+        return result;
+    }
+
+    static int connectSocket(uint16_t port)
+    {
+        int result = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (0 != ::connect(result, reinterpret_cast<sockaddr*>(&address), sizeof(address)))
+        {
+            ::close(result);
+            return -1;
+        }
+        return result;
+    }
+
+    void run()
+    {
+        pollfd listenEvent = {_listenSocket, POLLIN, 0};
+        while (!_isStopped && ::poll(&listenEvent, 1, 100) <= 0)
+        {
+        }
+        if (_isStopped)
+            return;
+
+        int sockets[2] = {::accept(_listenSocket, nullptr, nullptr), connectSocket(_targetPort)};
+        int noDelay = 1;
+        for (int socket : sockets)
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        // очередь i содержит данные, прочитанные из сокета i и ожидающие отправки в другой сокет
+        std::deque<Chunk> chunks[2];
+        char buffer[65536];
+        while (!_isStopped && sockets[0] >= 0 && sockets[1] >= 0)
+        {
+            qint64 now = nowNanoseconds();
+            for (int i = 0; i < 2; i++)
+                while (!chunks[i].empty() && chunks[i].front().Due <= now)
+                {
+                    const QByteArray &data = chunks[i].front().Data;
+                    if (::write(sockets[1 - i], data.constData(), size_t(data.size())) != data.size())
+                        _isStopped = true;
+                    chunks[i].pop_front();
+                }
+
+            // ожидание до ближайшего срока отправки, но не дольше 100 мс
+            qint64 wait = 100000000;
+            for (int i = 0; i < 2; i++)
+                if (!chunks[i].empty())
+                    wait = qMin(wait, chunks[i].front().Due - now);
+
+            pollfd events[2] = {{sockets[0], POLLIN, 0}, {sockets[1], POLLIN, 0}};
+            if (::poll(events, 2, int((qMax(wait, qint64(0)) + 999999) / 1000000)) <= 0)
+                continue;
+
+            now = nowNanoseconds();
+            for (int i = 0; i < 2; i++)
+            {
+                if (0 == events[i].revents)
+                    continue;
+                ssize_t size = ::read(sockets[i], buffer, sizeof(buffer));
+                if (size <= 0)
+                {
+                    _isStopped = true;
+                    break;
+                }
+                chunks[i].push_back({now + _delay, QByteArray(buffer, int(size))});
+            }
+        }
+
+        for (int socket : sockets)
+            if (socket >= 0)
+                ::close(socket);
+    }
+
+    uint16_t _targetPort;
+    qint64 _delay;
+    int _listenSocket;
+    std::atomic<bool> _isStopped{false};
+    std::thread _thread;
+};
+
+/**
+ * @brief ThreadReceiver - Принимающая сторона, подтверждающая каждый пакет
+ */
+class ThreadReceiver : public ThreadDataFrames
+{
+public:
+    ThreadReceiver(IMessageSubscriber *parent, Descriptor socket, const QString &host, uint16_t port)
+        : ThreadDataFrames(parent, socket, host, port, false)
+    {
+        setThreadName(QString("Thread.Receiver.%1").arg(handler()->deviceName()));
+        setTimeout(1000);
+    }
+
+    DataFramesFactory *framesFactory() override
+    {
+        return nullptr;
+    }
+
+protected:
+    void onDisconnected() override
+    {
+        terminateThread();
+    }
+
+    void onPacketIdDiscontinuity(const PacketIdType &, const PacketIdType &) override
+    {
+    }
+
+    void onPacketQueued(const PacketBase::Ptr &) override
+    {
+    }
+
+    void onPacketApplied(const PacketIdType &) override
+    {
+    }
+
+    void onFrameReceived(const DataFramesList &, const PacketIdType &) override
+    {
+    }
+};
+
+class ThreadReceiverListen : public ThreadListenSocket
+{
+public:
+    ThreadReceiverListen()
+        : ThreadListenSocket(SERVER_PORT)
+    {
+        setThreadName("Thread.Receiver.Listen");
+    }
+
+protected:
+    void onBeforeListenSocketInitialization() override
+    {
+    }
+
+    void onListenSocketInitialized() override
+    {
+    }
+
+    void onAcceptConnectionRequest(Descriptor socket, const QString &ipAddress, bool &accept) override
+    {
+        accept = true;
+        registerAndStartConnectionThread(new ThreadReceiver(this, socket, ipAddress, port()));
+    }
+
+    void onListenSocketError(PollerListenSocket *, int) override
+    {
+    }
+};
+
+/**
+ * @brief ThreadSender - Отправляющая сторона: после подключения ставит в очередь
+ * все пакеты замера и завершается по получении последней квитанции
+ */
+class ThreadSender : public ThreadDataFrames
+{
+public:
+    ThreadSender(DataFramesFactory *factory, uint16_t port, int sendWindow, int packetsCount)
+        : ThreadDataFrames(nullptr, "127.0.0.1", port, 1000, true)
+        , _factory(factory)
+        , _packetsCount(packetsCount)
+    {
+        setThreadName("Thread.Sender");
+        setSendWindow(sendWindow);
+        setTimeout(1000);
+    }
+
+    DataFramesFactory *framesFactory() override
+    {
+        return _factory;
+    }
+
+    std::atomic<qint64> ElapsedNanoseconds{0};
+    std::atomic<int> AppliedCount{0};
+
+protected:
+    void onConnected() override
+    {
+        ThreadDataFrames::onConnected();
+        if (_startedNanoseconds > 0)
+            return;
+
+        QByteArray payload(PAYLOAD_SIZE, 'x');
+        _startedNanoseconds = nowNanoseconds();
+        for (int i = 0; i < _packetsCount; i++)
+        {
+            DataFrame::Ptr frame = _factory->buildFrame("Payload");
+            frame->setAtomValue<ByteArrayDataAtom>("Data", payload);
+            sendFrame(frame);
+        }
+    }
+
+    void onPacketIdDiscontinuity(const PacketIdType &, const PacketIdType &) override
+    {
+    }
+
+    void onPacketQueued(const PacketBase::Ptr &) override
+    {
+    }
+
+    void onPacketApplied(const PacketIdType &) override
+    {
+        if (++AppliedCount < _packetsCount)
+            return;
+
+        ElapsedNanoseconds = nowNanoseconds() - _startedNanoseconds;
+        terminateThread();
+    }
+
+    void onFrameReceived(const DataFramesList &, const PacketIdType &) override
+    {
+    }
+
+private:
+    DataFramesFactory *_factory;
+    int _packetsCount;
+    qint64 _startedNanoseconds = 0;
+};
+
+void measure(Table &table, DataFramesFactory &factory, uint16_t proxyPort,
+             int roundTripMilliseconds, int sendWindow)
+{
+    DelayProxy proxy(proxyPort, SERVER_PORT, qint64(roundTripMilliseconds) * 1000000);
+
+    int packetsCount = PACKETS_PER_WINDOW_SLOT * sendWindow;
+    ThreadSender sender(&factory, proxyPort, sendWindow, packetsCount);
+    sender.start();
+
+    qint64 deadline = nowNanoseconds() + RUN_TIMEOUT_NANOSECONDS;
+    while (!sender.isFinished())
+    {
+        if (nowNanoseconds() > deadline)
+            sender.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    int appliedCount = sender.AppliedCount;
+    double packetsPerSecond = perSecond(appliedCount, sender.ElapsedNanoseconds);
+    table.addRow({QString::number(roundTripMilliseconds),
+                  QString::number(sendWindow),
+                  QString::number(appliedCount) + "/" + QString::number(packetsCount),
+                  number(packetsPerSecond, 0),
+                  number(packetsPerSecond * PAYLOAD_SIZE / 1e6, 2)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QByteArray text(DEFINITIONS);
+    QXmlStreamReader xml(text);
+    DataFramesDefinitions definitions;
+    definitions.readFromReader(xml);
+    DataFramesFactory factory;
+    factory.init(&definitions);
+
+    ThreadReceiverListen listen;
+    listen.start();
+    QThread::msleep(500);
+
+    printTitle(QString("Окно отправки ThreadDataFrames: пакеты по %1 байт через посредника с задержкой")
+               .arg(PAYLOAD_SIZE));
+    Table table({"Время обхода, мс", "Окно", "Подтверждено", "Пакетов/с", "МБ/с"});
+    uint16_t proxyPort = FIRST_PROXY_PORT;
+    for (int roundTripMilliseconds : {0, 1, 5, 20})
+        for (int sendWindow : {1, 4, 16, 64})
+            measure(table, factory, proxyPort++, roundTripMilliseconds, sendWindow);
+    table.print();
+
+    while (!listen.isFinished())
+    {
+        listen.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+include(../Benchmarks.pri)
+
+SOURCES += \
+        main.cpp
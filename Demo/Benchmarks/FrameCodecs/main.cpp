@@ -0,0 +1,326 @@
+#include "BenchmarkUtils.h"
+#include "DataFramesFactory.h"
+
+#include <QCoreApplication>
+#include <QXmlStreamReader>
+
+#include <cstddef>
+#include <cstring>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Frames;
+
+const int FRAMES_COUNT = 200000;
+const int ROUNDS_COUNT = 5;
+
+const char DEFINITIONS[] =
+        "<DataFrames Version=\"1\">"
+        "<DataFrame Name=\"Telemetry\">"
+        "<DataAtom Name=\"DeviceId\" Type=\"UInt32\"/>"
+        "<DataAtom Name=\"Sequence\" Type=\"UInt64\"/>"
+        "<DataAtom Name=\"Latitude\" Type=\"Double\"/>"
+        "<DataAtom Name=\"Longitude\" Type=\"Double\"/>"
+        "<DataAtom Name=\"Altitude\" Type=\"Single\"/>"
+        "<DataAtom Name=\"Speed\" Type=\"Single\"/>"
+        "<DataAtom Name=\"Course\" Type=\"UInt16\"/>"
+        "<DataAtom Name=\"Status\" Type=\"UInt8\"/>"
+        "</DataFrame>"
+        "<DataFrame Name=\"Event\">"
+        "<DataAtom Name=\"Code\" Type=\"UInt32\"/>"
+        "<DataAtom Name=\"Text\" Type=\"String\"/>"
+        "</DataFrame>"
+        "</DataFrames>";
+
+// Кодеки ниже повторяют текст, который DataFramesContractBuilder создает
+// для описаний DEFINITIONS в <Project>DataFramesCodec.h
+
+// Фрейм Telemetry: фиксированная раскладка
+#pragma pack(push, 1)
+struct TelemetryData
+{
+    uint32_t deviceId;
+    uint64_t sequence;
+    double latitude;
+    double longitude;
+    float altitude;
+    float speed;
+    uint16_t course;
+    uint8_t status;
+};
+#pragma pack(pop)
+
+struct TelemetryCodec
+{
+    static const char *name() { return "Telemetry"; }
+
+    static constexpr int NAME_SIZE = 10;
+    static constexpr int HEADER_SIZE = int(sizeof(FrameSizeType)) + NAME_SIZE;
+    static constexpr int BODY_SIZE = int(sizeof(TelemetryData));
+    static constexpr int WIRE_SIZE = HEADER_SIZE + BODY_SIZE;
+    static constexpr FrameSizeType FRAME_SIZE = FrameSizeType(NAME_SIZE + BODY_SIZE);
+
+    static inline bool encode(const TelemetryData &data, DataStream &stream)
+    {
+        char image[WIRE_SIZE];
+        FrameSizeType frameSize = FRAME_SIZE;
+        memcpy(image, &frameSize, sizeof(frameSize));
+        memcpy(image + sizeof(frameSize), name(), NAME_SIZE);
+        memcpy(image + HEADER_SIZE, &data, BODY_SIZE);
+        return stream.write(image, WIRE_SIZE);
+    }
+
+    static inline bool decode(DataStream &stream, TelemetryData &data)
+    {
+        if (stream.size() - stream.position() < WIRE_SIZE)
+            return false;
+        const char *image = stream.cursor();
+        FrameSizeType frameSize;
+        memcpy(&frameSize, image, sizeof(frameSize));
+        if (FRAME_SIZE != frameSize ||
+                0 != qstrnicmp(image + sizeof(frameSize), name(), uint(NAME_SIZE)))
+            return false;
+        memcpy(&data, image + HEADER_SIZE, BODY_SIZE);
+        stream.setPosition(stream.position() + WIRE_SIZE);
+        return true;
+    }
+};
+
+// Фрейм Event: последовательная раскладка
+struct EventData
+{
+    uint32_t code;
+    QString text;
+};
+
+struct EventCodec
+{
+    static const char *name() { return "Event"; }
+
+    static constexpr int NAME_SIZE = 6;
+
+    static inline FrameSizeType frameSize(const EventData &data)
+    {
+        FrameSizeType result = NAME_SIZE;
+        result += FrameSizeType(DataStream::valueSize(data.code));
+        result += FrameSizeType(data.text.length() + 1);
+        return result;
+    }
+
+    static inline bool encode(const EventData &data, DataStream &stream)
+    {
+        FrameSizeType size = frameSize(data);
+        bool result = stream.write(size) &&
+                stream.write(name(), NAME_SIZE);
+        result = result && stream.write(data.code);
+        result = result && stream.write(data.text);
+        return result;
+    }
+
+    static inline bool decode(DataStream &stream, EventData &data)
+    {
+        int frameStart = stream.position();
+        FrameSizeType size = 0;
+        QString frameName;
+        bool result = stream.read(size) &&
+                stream.read(frameName) &&
+                0 == frameName.compare(QLatin1String(name()), Qt::CaseInsensitive);
+        result = result && stream.read(data.code);
+        result = result && stream.read(data.text);
+        if (result)
+            stream.setPosition(frameStart + int(size) + int(sizeof(size)));
+        else
+            stream.setPosition(frameStart);
+        return result;
+    }
+};
+
+volatile double valuesSink = 0;
+
+TelemetryData buildTelemetry(int index)
+{
+    TelemetryData result;
+    result.deviceId = uint32_t(index % 64);
+    result.sequence = uint64_t(index);
+    result.latitude = 55.75 + index * 1e-6;
+    result.longitude = 37.61 - index * 1e-6;
+    result.altitude = float(150 + index % 10);
+    result.speed = float(index % 120);
+    result.course = uint16_t(index % 360);
+    result.status = uint8_t(index % 4);
+    return result;
+}
+
+EventData buildEvent(int index)
+{
+    return EventData{uint32_t(index), QString("Событие %1").arg(index)};
+}
+
+/**
+ * @brief buildStream - Поток фреймов, записанный через DataFrame::write
+ */
+template<typename Data>
+QByteArray buildStream(const DataFramesFactory &factory,
+                       const QString &frameName,
+                       const QVector<Data> &values,
+                       qint64 &writeNanoseconds);
+
+template<>
+QByteArray buildStream(const DataFramesFactory &factory,
+                       const QString &frameName,
+                       const QVector<TelemetryData> &values,
+                       qint64 &writeNanoseconds)
+{
+    QByteArray result;
+    DataStream stream(&result);
+    qint64 started = nowNanoseconds();
+    for (const TelemetryData &data : values)
+    {
+        DataFrame::Ptr frame = factory.buildFrame(frameName);
+        frame->setAtomValue<UInt32DataAtom>("DeviceId", data.deviceId);
+        frame->setAtomValue<UInt64DataAtom>("Sequence", data.sequence);
+        frame->setAtomValue<DoubleDataAtom>("Latitude", data.latitude);
+        frame->setAtomValue<DoubleDataAtom>("Longitude", data.longitude);
+        frame->setAtomValue<SingleDataAtom>("Altitude", data.altitude);
+        frame->setAtomValue<SingleDataAtom>("Speed", data.speed);
+        frame->setAtomValue<UInt16DataAtom>("Course", data.course);
+        frame->setAtomValue<UInt8DataAtom>("Status", data.status);
+        frame->write(stream);
+    }
+    writeNanoseconds = nowNanoseconds() - started;
+    return result;
+}
+
+template<>
+QByteArray buildStream(const DataFramesFactory &factory,
+                       const QString &frameName,
+                       const QVector<EventData> &values,
+                       qint64 &writeNanoseconds)
+{
+    QByteArray result;
+    DataStream stream(&result);
+    qint64 started = nowNanoseconds();
+    for (const EventData &data : values)
+    {
+        DataFrame::Ptr frame = factory.buildFrame(frameName);
+        frame->setAtomValue<UInt32DataAtom>("Code", data.code);
+        frame->setAtomValue<StringDataAtom>("Text", data.text);
+        frame->write(stream);
+    }
+    writeNanoseconds = nowNanoseconds() - started;
+    return result;
+}
+
+double readDynamic(DataFrame::Ptr &frame, const TelemetryData *)
+{
+    return frame->getAtomValue<uint32_t>("DeviceId") +
+            frame->getAtomValue<double>("Latitude") +
+            frame->getAtomValue<uint16_t>("Course");
+}
+
+double readDynamic(DataFrame::Ptr &frame, const EventData *)
+{
+    return frame->getAtomValue<uint32_t>("Code") +
+            frame->getAtomValue<QString>("Text").length();
+}
+
+double readTyped(const TelemetryData &data)
+{
+    return data.deviceId + data.latitude + data.course;
+}
+
+double readTyped(const EventData &data)
+{
+    return data.code + data.text.length();
+}
+
+/**
+ * @brief measure - Замер записи и разбора одного вида фрейма: через DataFramesFactory
+ * и атомы и через созданный кодек; из каждого фрейма читаются значения трех полей
+ */
+template<typename Data, typename Codec>
+void measure(Table &table, DataFramesFactory &factory, const QString &frameName,
+             const QVector<Data> &values)
+{
+    qint64 dynamicWrite = 0;
+    QByteArray data = buildStream(factory, frameName, values, dynamicWrite);
+
+    qint64 typedWrite = 0;
+    QByteArray typedData;
+    {
+        DataStream stream(&typedData);
+        qint64 started = nowNanoseconds();
+        for (const Data &value : values)
+            Codec::encode(value, stream);
+        typedWrite = nowNanoseconds() - started;
+    }
+    bool sameBytes = typedData == data;
+
+    qint64 dynamicRead = 0;
+    qint64 typedRead = 0;
+    int dynamicFrames = 0;
+    int typedFrames = 0;
+    for (int round = 0; round < ROUNDS_COUNT; round++)
+    {
+        double accumulated = 0;
+        qint64 started = nowNanoseconds();
+        DataStream stream(&data);
+        DataFramesList frames = factory.readFrames(stream);
+        for (DataFrame::Ptr &frame : frames)
+            accumulated += readDynamic(frame, static_cast<const Data*>(nullptr));
+        dynamicRead += nowNanoseconds() - started;
+        dynamicFrames += frames.count();
+        frames.clear();
+
+        started = nowNanoseconds();
+        DataStream typedStream(&data);
+        Data value;
+        while (Codec::decode(typedStream, value))
+        {
+            accumulated += readTyped(value);
+            typedFrames++;
+        }
+        typedRead += nowNanoseconds() - started;
+        valuesSink = valuesSink + accumulated;
+    }
+
+    double frameBytes = double(data.size()) / qMax(values.count(), 1);
+    table.addRow({frameName, number(frameBytes, 0), "DataFramesFactory",
+                  number(double(dynamicWrite) / values.count(), 1),
+                  number(double(dynamicRead) / qMax(dynamicFrames, 1), 1),
+                  "-"});
+    table.addRow({frameName, number(frameBytes, 0), "кодек",
+                  number(double(typedWrite) / values.count(), 1),
+                  number(double(typedRead) / qMax(typedFrames, 1), 1),
+                  sameBytes ? "да" : "НЕТ"});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QByteArray text(DEFINITIONS);
+    QXmlStreamReader xml(text);
+    DataFramesDefinitions definitions;
+    definitions.readFromReader(xml);
+
+    DataFramesFactory factory;
+    factory.init(&definitions);
+
+    QVector<TelemetryData> telemetry(FRAMES_COUNT);
+    QVector<EventData> events(FRAMES_COUNT);
+    for (int i = 0; i < FRAMES_COUNT; i++)
+    {
+        telemetry[i] = buildTelemetry(i);
+        events[i] = buildEvent(i);
+    }
+
+    printTitle(QString("Созданные кодеки и разбор через атомы: %1 фреймов, %2 проходов разбора")
+               .arg(FRAMES_COUNT).arg(ROUNDS_COUNT));
+    Table table({"Фрейм", "Байт", "Способ", "Запись, нс/фрейм", "Разбор, нс/фрейм",
+                 "Совпадает с DataFrame::write"});
+    measure<TelemetryData, TelemetryCodec>(table, factory, "Telemetry", telemetry);
+    measure<EventData, EventCodec>(table, factory, "Event", events);
+    table.print();
+
+    return 0;
+}
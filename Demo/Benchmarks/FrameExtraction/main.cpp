@@ -0,0 +1,122 @@
+#include "BenchmarkUtils.h"
+#include "DataFramesPackets.h"
+
+#include <QCoreApplication>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Frames;
+
+const int STREAM_BYTES = 16 * 1024 * 1024;
+
+/**
+ * @brief READ_BURST_BYTES - Объем данных, поступающих во входящий буфер за одно чтение
+ */
+const int READ_BURST_BYTES = 65536;
+
+QByteArray buildStream(DataFramesPacketFactory &factory, int packetSize, int &packetsCount)
+{
+    QByteArray payload(packetSize, '\0');
+    for (int i = 0; i < payload.size(); i++)
+        payload[i] = char(i * 31 + 7);
+
+    QByteArray result;
+    DataStream stream(&result);
+    packetsCount = qMax(STREAM_BYTES / (packetSize + int(sizeof(DataFramesPacketHeader))), 256);
+    for (int i = 0; i < packetsCount; i++)
+        factory.buildPacket(payload, true)->write(stream);
+    return result;
+}
+
+struct ExtractionResult
+{
+    qint64 Packets = 0;
+    qint64 MovedBytes = 0;
+    qint64 Nanoseconds = 0;
+};
+
+/**
+ * @brief extractRemovingEach - Разбор с удалением данных пакета из буфера после каждого пакета
+ */
+ExtractionResult extractRemovingEach(const QByteArray &stream)
+{
+    DataFramesPacketFactory factory;
+    ExtractionResult result;
+    QByteArray buffer;
+
+    qint64 started = nowNanoseconds();
+    for (int offset = 0; offset < stream.size(); offset += READ_BURST_BYTES)
+    {
+        buffer.append(stream.constData() + offset, qMin(READ_BURST_BYTES, stream.size() - offset));
+        while (factory.tryExtractPacket(buffer))
+        {
+            // удаление начала буфера сдвигает оставшиеся данные
+            result.MovedBytes += buffer.size();
+            result.Packets++;
+        }
+    }
+    result.Nanoseconds = nowNanoseconds() - started;
+    return result;
+}
+
+/**
+ * @brief extractByPosition - Разбор по позиции чтения со сжатием буфера один раз за чтение
+ */
+ExtractionResult extractByPosition(const QByteArray &stream)
+{
+    DataFramesPacketFactory factory;
+    ExtractionResult result;
+    QByteArray buffer;
+
+    qint64 started = nowNanoseconds();
+    for (int offset = 0; offset < stream.size(); offset += READ_BURST_BYTES)
+    {
+        buffer.append(stream.constData() + offset, qMin(READ_BURST_BYTES, stream.size() - offset));
+
+        int position = 0;
+        while (factory.tryExtractPacket(buffer, position))
+            result.Packets++;
+
+        if (position > 0)
+        {
+            result.MovedBytes += buffer.size() - position;
+            buffer.remove(0, position);
+        }
+    }
+    result.Nanoseconds = nowNanoseconds() - started;
+    return result;
+}
+
+void addRow(Table &table, const QString &method, int packetSize, const ExtractionResult &result)
+{
+    double bytes = double(result.Packets) * (packetSize + int(sizeof(DataFramesPacketHeader)));
+    table.addRow({QString::number(packetSize),
+                  method,
+                  number(perSecond(result.Packets, result.Nanoseconds), 0),
+                  number(perSecond(bytes, result.Nanoseconds) / 1e6, 1),
+                  number(double(result.MovedBytes) / qMax(result.Packets, qint64(1)), 1)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Разбор пакетов DataFramesPacketFactory: поток %1 МиБ, чтение по %2 байт")
+               .arg(STREAM_BYTES / 1024 / 1024).arg(READ_BURST_BYTES));
+    printTitle("Сдвиг буфера - байт, перемещенных при удалении прочитанного, на пакет; "
+               "копирование данных пакета в DataFramesPacket одинаково для обоих способов");
+
+    Table table({"Данные пакета, байт", "Способ", "Пакетов/с", "МБ/с", "Сдвиг буфера, байт/пакет"});
+    // Crc16 пакета принимает 16-битную длину, поэтому наибольший пакет - 65535 байт
+    for (int packetSize : {64, 1024, 65535})
+    {
+        DataFramesPacketFactory factory;
+        int packetsCount = 0;
+        QByteArray stream = buildStream(factory, packetSize, packetsCount);
+
+        addRow(table, "удаление после пакета", packetSize, extractRemovingEach(stream));
+        addRow(table, "позиция чтения", packetSize, extractByPosition(stream));
+    }
+    table.print();
+
+    return 0;
+}
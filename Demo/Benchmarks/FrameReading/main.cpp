@@ -0,0 +1,123 @@
+#include "AllocationCounter.h"
+#include "BenchmarkUtils.h"
+#include "DataFramesFactory.h"
+
+#include <QCoreApplication>
+#include <QXmlStreamReader>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Frames;
+
+const int FRAMES_COUNT = 500000;
+
+/**
+ * @brief BURST_FRAMES - Количество фреймов в одном чтении, обрабатываемых
+ * и освобождаемых вместе
+ */
+const int BURST_FRAMES = 32;
+
+const int ATOMS_COUNT = 20;
+
+/**
+ * @brief buildDefinitions - Описание фрейма из ATOMS_COUNT атомов
+ * числовых типов и одной строки
+ */
+QByteArray buildDefinitions()
+{
+    const QStringList types = {"UInt8", "Int16", "UInt32", "Int64", "Double", "Single", "Boolean"};
+
+    QByteArray result = "<DataFrames Version=\"1\"><DataFrame Name=\"Sensors\">";
+    result += "<DataAtom Name=\"Label\" Type=\"String\"/>";
+    for (int i = 1; i < ATOMS_COUNT; i++)
+        result += QString("<DataAtom Name=\"Value%1\" Type=\"%2\"/>")
+                .arg(i).arg(types.at(i % types.count())).toUtf8();
+    result += "</DataFrame></DataFrames>";
+    return result;
+}
+
+/**
+ * @brief recordStream - Запись потока фреймов, разбитого на чтения по BURST_FRAMES фреймов
+ */
+QVector<QByteArray> recordStream(DataFramesFactory &factory)
+{
+    QVector<QByteArray> result;
+    for (int i = 0; i < FRAMES_COUNT; i += BURST_FRAMES)
+    {
+        QByteArray burst;
+        DataStream stream(&burst);
+        for (int j = i; j < qMin(i + BURST_FRAMES, FRAMES_COUNT); j++)
+        {
+            DataFrame::Ptr frame = factory.buildFrame("Sensors");
+            frame->setAtomValue<StringDataAtom>("Label", QString("Датчик %1").arg(j % 100));
+            frame->setAtomValue<UInt32DataAtom>("Value2", uint32_t(j));
+            frame->setAtomValue<DoubleDataAtom>("Value4", j * 0.5);
+            frame->write(stream);
+        }
+        result.append(burst);
+    }
+    return result;
+}
+
+/**
+ * @brief measure - Разбор записанного потока через readFrames с освобождением
+ * фреймов после каждого чтения
+ */
+void measure(Table &table, const QString &mode, DataFramesFactory &factory,
+             QVector<QByteArray> &bursts)
+{
+    // первый проход прогревает кэш раскладок и пул
+    for (int pass = 0; pass < 2; pass++)
+    {
+        qint64 frames = 0;
+        double accumulated = 0;
+        qint64 allocations = allocationsCount();
+        qint64 started = nowNanoseconds();
+        // поток разбирается на месте, без копирования данных чтения
+        for (QByteArray &burst : bursts)
+        {
+            DataFramesList list = factory.readFrames(&burst);
+            for (const DataFrame::Ptr &frame : list)
+                accumulated += frame->getAtomValue<double>("Value4");
+            frames += list.count();
+        }
+        qint64 elapsed = nowNanoseconds() - started;
+        allocations = allocationsCount() - allocations;
+
+        if (0 == pass || accumulated < 0)
+            continue;
+
+        table.addRow({mode,
+                      number(perSecond(frames, elapsed) / 1e6, 2),
+                      number(double(elapsed) / qMax(frames, qint64(1)), 0),
+                      number(double(allocations) / qMax(frames, qint64(1)), 2)});
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QByteArray text = buildDefinitions();
+    QXmlStreamReader xml(text);
+    DataFramesDefinitions definitions;
+    definitions.readFromReader(xml);
+
+    DataFramesFactory factory;
+    factory.init(&definitions);
+    QVector<QByteArray> bursts = recordStream(factory);
+
+    printTitle(QString("DataFramesFactory::readFrames: %1 фреймов по %2 атомов, чтения по %3 фреймов")
+               .arg(FRAMES_COUNT).arg(ATOMS_COUNT).arg(BURST_FRAMES));
+    Table table({"Режим", "Млн фреймов/с", "нс/фрейм", "Выделений/фрейм"});
+    measure(table, "без пула", factory, bursts);
+
+    DataFramesPool::Ptr pool = std::make_shared<DataFramesPool>(BURST_FRAMES * 2);
+    factory.setFramesPool(pool);
+    measure(table, "DataFramesPool", factory, bursts);
+    table.print();
+
+    printTitle(QString("Пул: выдано из пула %1, создано %2").arg(pool->hits()).arg(pool->misses()));
+    factory.setFramesPool(DataFramesPool::Ptr());
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "BenchmarkUtils.h"
+#include "MessageString.h"
+#include "QueueMessages.h"
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int MESSAGES_COUNT = 4000000;
+
+/**
+ * @brief LATENCY_SAMPLE_EVERY - Замеряется каждое N-е размещение, чтобы чтение часов
+ * не определяло пропускную способность
+ */
+const int LATENCY_SAMPLE_EVERY = 16;
+
+/**
+ * @brief QueueLocked - Очередь с блокировкой, использовавшаяся до перехода на MPSC
+ */
+class QueueLocked
+{
+public:
+    void enqueue(const MessageBase::Ptr &message)
+    {
+        QMutexLocker locker(&_mutex);
+        _queue.enqueue(message);
+    }
+
+    int drain()
+    {
+        QQueue<MessageBase::Ptr> taken;
+        {
+            QMutexLocker locker(&_mutex);
+            taken.swap(_queue);
+        }
+        return taken.count();
+    }
+
+private:
+    QMutex _mutex;
+    QQueue<MessageBase::Ptr> _queue;
+};
+
+/**
+ * @brief QueueLockFree - Входящая очередь потока
+ */
+class QueueLockFree
+{
+public:
+    void enqueue(const MessageBase::Ptr &message)
+    {
+        _queue.enqueue(message);
+    }
+
+    int drain()
+    {
+        QueueMessages::Batch batch = _queue.dequeueBatch();
+        int result = batch.count();
+        while (!batch.isEmpty())
+            batch.takeFirst();
+        return result;
+    }
+
+private:
+    QueueMessages _queue;
+};
+
+/**
+ * @brief measure - Размещение MESSAGES_COUNT сообщений producersCount потоками
+ * и их извлечение одним потребителем
+ */
+template<typename Queue>
+void measure(Table &table, const QString &name, int producersCount)
+{
+    Queue queue;
+    std::atomic<bool> started(false);
+    std::vector<LatencySamples> samples(size_t(producersCount));
+    std::vector<std::thread> producers;
+    int messagesPerProducer = MESSAGES_COUNT / producersCount;
+
+    for (int i = 0; i < producersCount; i++)
+        producers.emplace_back([&queue, &started, &samples, i, messagesPerProducer]()
+        {
+            MessageBase::Ptr message = std::make_shared<MessageString>("benchmark");
+            LatencySamples &producerSamples = samples[size_t(i)];
+            producerSamples.reserve(messagesPerProducer / LATENCY_SAMPLE_EVERY + 1);
+
+            while (!started.load(std::memory_order_acquire))
+            {
+            }
+
+            for (int j = 0; j < messagesPerProducer; j++)
+            {
+                if (0 != j % LATENCY_SAMPLE_EVERY)
+                {
+                    queue.enqueue(message);
+                    continue;
+                }
+
+                qint64 enqueueStarted = nowNanoseconds();
+                queue.enqueue(message);
+                producerSamples.append(nowNanoseconds() - enqueueStarted);
+            }
+        });
+
+    qint64 startedNanoseconds = nowNanoseconds();
+    started.store(true, std::memory_order_release);
+
+    int consumed = 0;
+    int total = messagesPerProducer * producersCount;
+    while (consumed < total)
+        consumed += queue.drain();
+    qint64 elapsed = nowNanoseconds() - startedNanoseconds;
+
+    for (std::thread &producer : producers)
+        producer.join();
+
+    LatencySamples latencies;
+    for (const LatencySamples &producerSamples : samples)
+        latencies.append(producerSamples);
+
+    table.addRow({name,
+                  QString::number(producersCount),
+                  number(perSecond(total, elapsed) / 1e6, 2),
+                  number(latencies.percentile(50), 0),
+                  number(latencies.percentile(99), 0),
+                  number(latencies.percentile(99.9), 0)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Входящая очередь: %1 сообщений, N производителей -> 1 потребитель")
+               .arg(MESSAGES_COUNT));
+
+    Table table({"Очередь", "Производителей", "Млн сообщ/с",
+                 "p50 размещения, нс", "p99, нс", "p99.9, нс"});
+    for (int producersCount : {1, 2, 4, 8})
+    {
+        measure<QueueLocked>(table, "QMutex", producersCount);
+        measure<QueueLockFree>(table, "MPSC", producersCount);
+    }
+    table.print();
+
+    return 0;
+}
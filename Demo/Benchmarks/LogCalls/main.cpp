@@ -0,0 +1,89 @@
+#include "BenchmarkUtils.h"
+#include "BinaryLog.h"
+#include "MessageLog.h"
+#include "ThreadLogs.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int CALLS_PER_THREAD = 250000;
+
+MESSAGE_TEMPLATE(90000, 0, Message, "Значение %d потока %d, строка %s, вещественное %.3f");
+
+/**
+ * @brief measure - Вызовы WRITE_LOG из threadsCount потоков одновременно
+ * @param isBinary - Признак записи в двоичный журнал, иначе сообщения
+ * форматируются потоком-источником и отправляются через MessageLog
+ */
+void measure(Table &table, const QString &name, bool isBinary, int threadsCount)
+{
+    ThreadLogs logs(false);
+    logs.start();
+    QThread::msleep(100);
+
+    // поток протоколирования подключает двоичный журнал при запуске
+    if (!isBinary)
+        BinaryLog::setConsumer(nullptr);
+
+    quint64 overflows = BinaryLog::overflows();
+    std::atomic<bool> started(false);
+    std::atomic<qint64> callsNanoseconds(0);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < threadsCount; thread++)
+        threads.emplace_back([&started, &callsNanoseconds, thread]()
+        {
+            while (!started.load(std::memory_order_acquire))
+            {
+            }
+
+            qint64 threadStarted = nowNanoseconds();
+            for (int i = 0; i < CALLS_PER_THREAD; i++)
+                WRITE_LOG(Message90000, i, thread, "benchmark", i * 0.001);
+            callsNanoseconds += nowNanoseconds() - threadStarted;
+        });
+
+    qint64 startedNanoseconds = nowNanoseconds();
+    started.store(true, std::memory_order_release);
+    for (std::thread &thread : threads)
+        thread.join();
+    qint64 elapsed = nowNanoseconds() - startedNanoseconds;
+    overflows = BinaryLog::overflows() - overflows;
+
+    while (!logs.isFinished())
+    {
+        logs.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    qint64 total = qint64(CALLS_PER_THREAD) * threadsCount;
+    table.addRow({name,
+                  QString::number(threadsCount),
+                  number(perSecond(total, elapsed) / 1e6, 2),
+                  number(double(callsNanoseconds.load()) / total, 1),
+                  QString::number(overflows)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Вызовы WRITE_LOG: %1 вызовов на поток, шаблон с %d, %s и %f")
+               .arg(CALLS_PER_THREAD));
+    printTitle("Сообщения записываются в ./Log/; переполнение - потеря записи после 2 мс ожидания места в буфере");
+    Table table({"Путь", "Потоков", "Млн вызовов/с", "нс/вызов в потоке", "Переполнений"});
+    for (int threadsCount : {1, 4})
+    {
+        measure(table, "MessageLog", false, threadsCount);
+        measure(table, "BinaryLog", true, threadsCount);
+    }
+    table.print();
+
+    return 0;
+}
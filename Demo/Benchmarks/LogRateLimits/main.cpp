@@ -0,0 +1,97 @@
+#include "AllocationCounter.h"
+#include "BenchmarkUtils.h"
+#include "LogRateLimiter.h"
+#include "MessageLog.h"
+#include "ThreadLogs.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int CALLS_PER_THREAD = 200000;
+
+MESSAGE_TEMPLATE(90010, 0, Message, "Поток [%s]: принято %d байт");
+
+/**
+ * @brief measure - Вызовы WRITE_LOG из threadsCount потоков при заданных правилах
+ * Аргумент STRLOG вычисляется только для допущенных сообщений
+ */
+void measure(Table &table, const QString &name, const QVector<LogRateLimit> &limits, int threadsCount)
+{
+    LogRateLimiter::setLimits(limits);
+
+    const QString threadName("Thread.Benchmark");
+    std::atomic<bool> started(false);
+    std::atomic<qint64> callsNanoseconds(0);
+    std::vector<std::thread> threads;
+    qint64 allocations = allocationsCount();
+    for (int thread = 0; thread < threadsCount; thread++)
+        threads.emplace_back([&started, &callsNanoseconds, &threadName]()
+        {
+            while (!started.load(std::memory_order_acquire))
+            {
+            }
+
+            qint64 threadStarted = nowNanoseconds();
+            for (int i = 0; i < CALLS_PER_THREAD; i++)
+                WRITE_LOG(Message90010, STRLOG(threadName), i);
+            callsNanoseconds += nowNanoseconds() - threadStarted;
+        });
+
+    started.store(true, std::memory_order_release);
+    for (std::thread &thread : threads)
+        thread.join();
+    // выделения потока протоколирования при форматировании учитываются вместе с вызовами
+    allocations = allocationsCount() - allocations;
+
+    qint64 total = qint64(CALLS_PER_THREAD) * threadsCount;
+    table.addRow({name,
+                  QString::number(threadsCount),
+                  number(double(callsNanoseconds.load()) / total, 1),
+                  number(double(allocations) / total, 2)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    ThreadLogs logs(false);
+    logs.start();
+    QThread::msleep(100);
+
+    LogRateLimit rate;
+    rate.Number = 90010;
+    rate.RatePerSecond = 100;
+    rate.Burst = 10;
+
+    LogRateLimit sample;
+    sample.Number = 90010;
+    sample.SampleEvery = 100;
+
+    printTitle(QString("Ограничение частоты WRITE_LOG: %1 вызовов на поток, шаблон с STRLOG и %d")
+               .arg(CALLS_PER_THREAD));
+    printTitle("Выделения памяти - все выделения процесса за замер на один вызов");
+    Table table({"Правило", "Потоков", "нс/вызов в потоке", "Выделений/вызов"});
+    for (int threadsCount : {1, 4})
+    {
+        measure(table, "без правил", {}, threadsCount);
+        measure(table, "100/с, пачка 10", {rate}, threadsCount);
+        measure(table, "выборка 1 из 100", {sample}, threadsCount);
+    }
+    table.print();
+
+    LogRateLimiter::setLimits({});
+    while (!logs.isFinished())
+    {
+        logs.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "BenchmarkUtils.h"
+#include "LogSettings.h"
+#include "MessageLog.h"
+#include "WriterLogs.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QVector>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int LINES_COUNT = 2000000;
+const int TEXTS_COUNT = 1024;
+
+/**
+ * @brief FLUSH_SIZE - Размер накопленных данных, при котором они передаются на запись,
+ * как у потока протоколирования
+ */
+const int FLUSH_SIZE = 256 * 1024;
+
+const QString LOG_PATH("./LogWriterBenchmark/");
+
+/**
+ * @brief WriterLegacy - Прежняя запись протокола: строки копятся в QString,
+ * перевод в UTF-8 всего буфера и блокирующая запись с flush() в потоке протоколирования
+ */
+class WriterLegacy
+{
+public:
+    explicit WriterLegacy(const QString &fileName)
+        : _file(fileName)
+    {
+        _file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    }
+
+    void logLine(const QDateTime &created, const QString &text)
+    {
+        _logBuffer.append(MessageLog::format(created, Message, 90000, text));
+        _logBuffer.append("\r\n");
+        // размер строки в символах близок к размеру в байтах для латиницы и цифр
+        if (_logBuffer.size() >= FLUSH_SIZE)
+            logFlushBuffer();
+    }
+
+    void logFlushBuffer()
+    {
+        if (_logBuffer.isEmpty())
+            return;
+
+        QByteArray bufferUtf8 = _logBuffer.toUtf8();
+        _writtenBytes += _file.write(bufferUtf8);
+        _file.flush();
+        _logBuffer.clear();
+    }
+
+    qint64 writtenBytes() const
+    {
+        return _writtenBytes;
+    }
+
+private:
+    QFile _file;
+    QString _logBuffer;
+    qint64 _writtenBytes = 0;
+};
+
+/**
+ * @brief WriterCurrent - Запись протокола через WriterLog и поток записи LogFileWriter
+ */
+class WriterCurrent : public WriterLog
+{
+public:
+    explicit WriterCurrent(const LogRotation &rotation)
+        : WriterLog(false, LOG_PATH, 9)
+    {
+        LogSettings settings;
+        settings.setRotation(rotation);
+        applyLogSettings(settings);
+    }
+
+    void logLine(const QDateTime &created, const QString &text)
+    {
+        doLogLine(created, Message, 90000, 0, text);
+        if (_logBuffer.size() >= FLUSH_SIZE)
+            logFlushBuffer();
+    }
+
+    void finish()
+    {
+        logFlushBuffer();
+        logClose();
+    }
+};
+
+QVector<QString> makeTexts()
+{
+    QVector<QString> result;
+    result.reserve(TEXTS_COUNT);
+    for (int i = 0; i < TEXTS_COUNT; i++)
+        result.append(QString("Поток Thread.Benchmark: принят пакет %1 размером %2 байт")
+                      .arg(i).arg(i * 7 % 1500));
+    return result;
+}
+
+/**
+ * @brief linesBytes - Объем строк протокола замера в UTF-8 с переводами строк
+ */
+qint64 linesBytes(const QDateTime &created, const QVector<QString> &texts)
+{
+    QVector<qint64> sizes;
+    for (const QString &text : texts)
+        sizes.append(MessageLog::format(created, Message, 90000, text).toUtf8().size() + 2);
+
+    qint64 result = 0;
+    for (int i = 0; i < LINES_COUNT; i++)
+        result += sizes.at(i % TEXTS_COUNT);
+    return result;
+}
+
+void addRow(Table &table, const QString &name, qint64 bytes, qint64 threadElapsed, qint64 totalElapsed)
+{
+    table.addRow({name,
+                  number(perSecond(LINES_COUNT, threadElapsed) / 1e6, 2),
+                  number(perSecond(bytes, threadElapsed) / 1e6, 1),
+                  number(perSecond(LINES_COUNT, totalElapsed) / 1e6, 2),
+                  number(perSecond(bytes, totalElapsed) / 1e6, 1)});
+}
+
+void measureLegacy(Table &table, const QVector<QString> &texts, const QDateTime &created)
+{
+    QDir(LOG_PATH).removeRecursively();
+    QDir().mkpath(LOG_PATH);
+
+    WriterLegacy writer(LOG_PATH + "legacy.log");
+    qint64 started = nowNanoseconds();
+    for (int i = 0; i < LINES_COUNT; i++)
+        writer.logLine(created, texts.at(i % TEXTS_COUNT));
+    writer.logFlushBuffer();
+    qint64 elapsed = nowNanoseconds() - started;
+
+    addRow(table, "QString + QFile::flush", writer.writtenBytes(), elapsed, elapsed);
+}
+
+void measureCurrent(Table &table, const QString &name, const QVector<QString> &texts,
+                    const QDateTime &created, const LogRotation &rotation)
+{
+    QDir(LOG_PATH).removeRecursively();
+
+    qint64 threadElapsed = 0;
+    qint64 started = nowNanoseconds();
+    {
+        WriterCurrent writer(rotation);
+        for (int i = 0; i < LINES_COUNT; i++)
+            writer.logLine(created, texts.at(i % TEXTS_COUNT));
+        threadElapsed = nowNanoseconds() - started;
+        // ожидание записи оставшихся данных потоком записи
+        writer.finish();
+    }
+    qint64 totalElapsed = nowNanoseconds() - started;
+
+    addRow(table, name, linesBytes(created, texts), threadElapsed, totalElapsed);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QVector<QString> texts = makeTexts();
+    QDateTime created = QDateTime::currentDateTime();
+
+    printTitle(QString("Запись протокола: %1 строк, %2 МБ, передача на запись каждые %3 КиБ")
+               .arg(LINES_COUNT).arg(number(linesBytes(created, texts) / 1e6, 1)).arg(FLUSH_SIZE / 1024));
+    printTitle("Поток протоколирования - время вызовов записи строк, до записи на диск - "
+               "с ожиданием записи всех данных потоком записи");
+    Table table({"Запись", "Млн строк/с потока", "МБ/с потока",
+                 "Млн строк/с до записи", "МБ/с до записи"});
+    measureLegacy(table, texts, created);
+    measureCurrent(table, "WriterLog + LogFileWriter", texts, created, LogRotation());
+
+    LogRotation rotation;
+    rotation.MaxFileSize = 32 * 1024 * 1024;
+    measureCurrent(table, "ротация 32 МиБ", texts, created, rotation);
+#ifdef Q_OS_LINUX
+    rotation.Compress = true;
+    measureCurrent(table, "ротация 32 МиБ + gzip", texts, created, rotation);
+#endif
+    table.print();
+
+    QDir(LOG_PATH).removeRecursively();
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "BenchmarkUtils.h"
+#include "DateUtils.h"
+#include "LoopClock.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Utils;
+
+const int ITERATIONS_COUNT = 1000000;
+
+/**
+ * @brief PerfCounter - Счетчик perf_event текущего потока
+ * Недоступный счетчик (нет прав или поддержки в ядре) возвращает -1
+ */
+class PerfCounter
+{
+public:
+    PerfCounter(quint32 type, quint64 config)
+    {
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = 1;
+        _descriptor = int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    ~PerfCounter()
+    {
+        if (_descriptor >= 0)
+            ::close(_descriptor);
+    }
+
+    void start()
+    {
+        if (_descriptor < 0)
+            return;
+        ioctl(_descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    qint64 stop()
+    {
+        if (_descriptor < 0)
+            return -1;
+        ioctl(_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        qint64 value = 0;
+        if (::read(_descriptor, &value, sizeof(value)) != ssize_t(sizeof(value)))
+            return -1;
+        return value;
+    }
+
+private:
+    int _descriptor;
+};
+
+/**
+ * @brief syscallTracepointId - Получение идентификатора точки трассировки входа в системный вызов
+ * @return - Идентификатор или -1, если tracefs недоступна
+ */
+qint64 syscallTracepointId()
+{
+    for (const char *path : {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+                             "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"})
+    {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly))
+            return file.readAll().trimmed().toLongLong();
+    }
+    return -1;
+}
+
+/**
+ * @brief legacyIteration - Обращения к часам итерации цикла с одним принятым
+ * и одним отправленным пакетом до введения LoopClock
+ */
+qint64 legacyIteration()
+{
+    // Polling::poll - до и после ожидания, waitEvents и accumulateStatistic
+    qint64 result = DateUtils::getTickCount();
+    result += DateUtils::getTickCount();
+    result += DateUtils::getTickCount();
+    // _aliveCheckedUtc каждого прохода и отметка времени пакета
+    result += QDateTime::currentDateTimeUtc().toMSecsSinceEpoch();
+    result += QDateTime::currentDateTimeUtc().toMSecsSinceEpoch();
+    // счетчики трафика чтения и записи в ThreadHandler
+    result += QDateTime::currentDateTime().toMSecsSinceEpoch();
+    result += QDateTime::currentDateTime().toMSecsSinceEpoch();
+    return result;
+}
+
+/**
+ * @brief loopClockIteration - Те же обращения через время итерации
+ */
+qint64 loopClockIteration()
+{
+    // захват в начале итерации и после возврата из ожидания
+    qint64 result = LoopClock::update();
+    result += LoopClock::update();
+    result += LoopClock::now();
+    result += LoopClock::now();
+    // отметка времени пакета хранится в счетчике
+    result += LoopClock::now();
+    result += LoopClock::currentMSecsSinceEpoch();
+    result += LoopClock::currentMSecsSinceEpoch();
+    return result;
+}
+
+template<typename Function>
+void measure(Table &table, const QString &name, qint64 syscallId, Function iteration)
+{
+    PerfCounter instructions(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    PerfCounter syscalls(PERF_TYPE_TRACEPOINT, quint64(qMax(syscallId, qint64(0))));
+
+    qint64 sum = 0;
+    instructions.start();
+    if (syscallId >= 0)
+        syscalls.start();
+    qint64 started = nowNanoseconds();
+    for (int i = 0; i < ITERATIONS_COUNT; i++)
+        sum += iteration();
+    qint64 elapsed = nowNanoseconds() - started;
+    qint64 syscallsCount = (syscallId >= 0) ? syscalls.stop() : -1;
+    qint64 instructionsCount = instructions.stop();
+
+    table.addRow({name,
+                  number(double(elapsed) / ITERATIONS_COUNT, 1),
+                  (instructionsCount >= 0) ? number(double(instructionsCount) / ITERATIONS_COUNT, 0) : "н/д",
+                  (syscallsCount >= 0) ? number(double(syscallsCount) / ITERATIONS_COUNT, 3) : "н/д",
+                  QString::number(sum & 1)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    qint64 syscallId = syscallTracepointId();
+
+    printTitle(QString("Обращения к часам за итерацию цикла с одним принятым и одним отправленным "
+                       "пакетом, %1 итераций").arg(ITERATIONS_COUNT));
+    printTitle("Инструкции - perf PERF_COUNT_HW_INSTRUCTIONS, системные вызовы - "
+               "точка трассировки raw_syscalls:sys_enter; н/д - счетчик недоступен");
+    Table table({"Часы", "нс/итерация", "Инструкций/итерация", "Системных вызовов/итерация", "Контроль"});
+    measure(table, "прежние: getTickCount + QDateTime", syscallId, legacyIteration);
+    LoopClock::setCoarse(false);
+    measure(table, "LoopClock", syscallId, loopClockIteration);
+    LoopClock::setCoarse(true);
+    measure(table, "LoopClock, CLOCK_MONOTONIC_COARSE", syscallId, loopClockIteration);
+    LoopClock::setCoarse(false);
+    table.print();
+
+    return 0;
+}
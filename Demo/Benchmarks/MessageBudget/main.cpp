@@ -0,0 +1,259 @@
+#include "BenchmarkUtils.h"
+#include "HandlerTcpSocket.h"
+#include "MessageString.h"
+#include "PacketFactoryAsciiLines.h"
+#include "ThreadHandler.h"
+#include "ThreadListenSocket.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const uint16_t FIRST_PORT = 53920;
+
+/**
+ * @brief FLOOD_MESSAGES_COUNT - Количество сообщений одного всплеска
+ */
+const int FLOOD_MESSAGES_COUNT = 200000;
+
+/**
+ * @brief MESSAGE_COST_NANOSECONDS - Продолжительность обработки одного сообщения потока
+ */
+const qint64 MESSAGE_COST_NANOSECONDS = 1000;
+
+const qint64 RUN_NANOSECONDS = 5000000000;
+const int PING_INTERVAL_MILLISECONDS = 1;
+
+/**
+ * @brief ThreadFloodedEcho - Поток подключения, возвращающий принятые строки
+ * и обрабатывающий поток сообщений
+ */
+class ThreadFloodedEcho : public ThreadHandler
+{
+public:
+    ThreadFloodedEcho(IMessageSubscriber *parent, Descriptor socket, const QString &host,
+                      const uint16_t port, int budgetMessages, int budgetMicroseconds)
+        : ThreadHandler(parent, new HandlerTcpSocket(host, port, socket), 0, new PacketFactoryAsciiLines())
+    {
+        setThreadName(QString("Thread.Flooded.%1").arg(handler()->deviceName()));
+        setTimeout(1000);
+        setMessagesBudget(budgetMessages, budgetMicroseconds);
+
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            qint64 finish = nowNanoseconds() + MESSAGE_COST_NANOSECONDS;
+            while (nowNanoseconds() < finish)
+            {
+            }
+            ProcessedCount.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::atomic<qint64> ProcessedCount{0};
+
+protected:
+    void onDisconnected() override
+    {
+        terminateThread();
+    }
+
+    bool onPacketReceived(const PacketBase::Ptr &packet) override
+    {
+        auto lines = std::dynamic_pointer_cast<PacketAsciiLines>(packet);
+        if (!lines)
+            return false;
+        return sendPacket(std::make_shared<PacketAsciiLines>(lines->lines()));
+    }
+
+    bool onPacketSent(const PacketBase::Ptr &) override
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief ThreadFloodedListen - Поток ожидания подключений, запоминающий поток подключения
+ */
+class ThreadFloodedListen : public ThreadListenSocket
+{
+public:
+    ThreadFloodedListen(uint16_t port, int budgetMessages, int budgetMicroseconds)
+        : ThreadListenSocket(port)
+        , _budgetMessages(budgetMessages)
+        , _budgetMicroseconds(budgetMicroseconds)
+    {
+        setThreadName(QString("Thread.Flooded:%1").arg(port));
+        setReactorsCount(0);
+    }
+
+    std::atomic<ThreadFloodedEcho*> Connection{nullptr};
+
+protected:
+    void onBeforeListenSocketInitialization() override
+    {
+    }
+
+    void onListenSocketInitialized() override
+    {
+    }
+
+    void onAcceptConnectionRequest(Descriptor socket, const QString &ipAddress, bool &accept) override
+    {
+        accept = true;
+        auto connection = new ThreadFloodedEcho(this, socket, ipAddress, port(),
+                                                _budgetMessages, _budgetMicroseconds);
+        registerAndStartConnectionThread(connection);
+        Connection = connection;
+    }
+
+    void onListenSocketError(PollerListenSocket *, int) override
+    {
+    }
+
+private:
+    int _budgetMessages;
+    int _budgetMicroseconds;
+};
+
+int connectClient(uint16_t port)
+{
+    int result = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (0 != ::connect(result, reinterpret_cast<sockaddr*>(&address), sizeof(address)))
+    {
+        ::close(result);
+        return -1;
+    }
+
+    int noDelay = 1;
+    setsockopt(result, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return result;
+}
+
+/**
+ * @brief ping - Отправка строки и ожидание ответа
+ * @return - Время ответа в наносекундах или -1 при ошибке
+ */
+qint64 ping(int socket)
+{
+    static const char REQUEST[] = "ping\r\n";
+    const int requestSize = int(sizeof(REQUEST)) - 1;
+
+    qint64 started = nowNanoseconds();
+    if (::write(socket, REQUEST, requestSize) != requestSize)
+        return -1;
+
+    int received = 0;
+    char buffer[256];
+    while (received < requestSize)
+    {
+        ssize_t size = ::read(socket, buffer, sizeof(buffer));
+        if (size <= 0)
+            return -1;
+        received += int(size);
+    }
+    return nowNanoseconds() - started;
+}
+
+void measure(Table &table, const QString &mode, uint16_t port, int budgetMessages, int budgetMicroseconds)
+{
+    ThreadFloodedListen listen(port, budgetMessages, budgetMicroseconds);
+    listen.start();
+    QThread::msleep(500);
+
+    int socket = connectClient(port);
+    while (socket >= 0 && !listen.Connection.load())
+        QThread::msleep(10);
+    ThreadFloodedEcho *connection = listen.Connection.load();
+
+    // всплески сообщений следуют друг за другом после обработки предыдущего
+    std::atomic<bool> stopped(false);
+    std::atomic<int> floodsCount(0);
+    std::thread flooder([connection, &stopped, &floodsCount]()
+    {
+        if (!connection)
+            return;
+
+        MessageBase::Ptr message = std::make_shared<MessageString>("flood");
+        MessagesList flood;
+        for (int i = 0; i < FLOOD_MESSAGES_COUNT; i++)
+            flood.append(message);
+
+        qint64 posted = 0;
+        while (!stopped)
+        {
+            connection->postMessages(flood);
+            posted += FLOOD_MESSAGES_COUNT;
+            floodsCount++;
+            while (!stopped && connection->ProcessedCount.load(std::memory_order_acquire) < posted)
+                QThread::msleep(1);
+        }
+    });
+
+    LatencySamples samples;
+    int errorsCount = 0;
+    qint64 finish = nowNanoseconds() + RUN_NANOSECONDS;
+    while (socket >= 0 && nowNanoseconds() < finish)
+    {
+        qint64 latency = ping(socket);
+        if (latency < 0)
+        {
+            errorsCount++;
+            break;
+        }
+        samples.append(latency);
+        QThread::msleep(PING_INTERVAL_MILLISECONDS);
+    }
+
+    stopped = true;
+    flooder.join();
+    if (socket >= 0)
+        ::close(socket);
+
+    while (!listen.isFinished())
+    {
+        listen.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    table.addRow({mode,
+                  QString::number(floodsCount.load()),
+                  QString::number(samples.count()),
+                  number(samples.percentile(50) / 1000.0, 0),
+                  number(samples.percentile(99) / 1000.0, 0),
+                  number(samples.percentile(99.9) / 1000.0, 0),
+                  number(samples.percentile(100) / 1000.0, 0),
+                  QString::number(errorsCount)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Обслуживание сокета под потоком сообщений: всплески по %1 сообщений "
+                       "по %2 нс, эхо-запрос каждые %3 мс в течение %4 с")
+               .arg(FLOOD_MESSAGES_COUNT).arg(MESSAGE_COST_NANOSECONDS)
+               .arg(PING_INTERVAL_MILLISECONDS).arg(RUN_NANOSECONDS / 1000000000));
+    Table table({"Бюджет прохода", "Всплесков", "Ответов", "p50, мкс", "p99, мкс", "p99.9, мкс",
+                 "max, мкс", "Ошибок"});
+    measure(table, "без ограничения", FIRST_PORT, 0, 0);
+    measure(table, "1000 сообщений", FIRST_PORT + 1, 1000, 0);
+    measure(table, "500 мкс", FIRST_PORT + 2, 0, 500);
+    table.print();
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "BenchmarkUtils.h"
+#include "MessageString.h"
+#include "ThreadBase.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int MESSAGES_COUNT = 4000000;
+
+QMutex legacyMutex;
+qint64 legacyReferenceCount = 0;
+
+/**
+ * @brief MessageStringLegacy - Сообщение, воспроизводящее прежние затраты MessageBase:
+ * счетчик экземпляров под общим мьютексом, системный вызов gettid
+ * и получение местного времени в конструкторе
+ */
+class MessageStringLegacy : public MessageString
+{
+public:
+    explicit MessageStringLegacy(const QString &text)
+        : MessageString(text)
+        , _legacyCreated(QDateTime::currentDateTime())
+        , _legacyThreadId(qint64(syscall(SYS_gettid)))
+    {
+        QMutexLocker locker(&legacyMutex);
+        legacyReferenceCount++;
+    }
+
+    ~MessageStringLegacy() override
+    {
+        QMutexLocker locker(&legacyMutex);
+        legacyReferenceCount--;
+    }
+
+private:
+    QDateTime _legacyCreated;
+    qint64 _legacyThreadId;
+};
+
+/**
+ * @brief ThreadConsumer - Поток, подсчитывающий полученные строковые сообщения
+ */
+class ThreadConsumer : public ThreadBase
+{
+public:
+    ThreadConsumer()
+        : ThreadBase(nullptr, "Thread.Consumer")
+    {
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            ConsumedCount.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    std::atomic<qint64> ConsumedCount{0};
+};
+
+/**
+ * @brief runThreads - Запуск функции в threadsCount потоках одновременно
+ * @return - Длительность работы всех потоков в наносекундах
+ */
+template<typename Function>
+qint64 runThreads(int threadsCount, Function function)
+{
+    std::atomic<bool> started(false);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadsCount; i++)
+        threads.emplace_back([&started, &function]()
+        {
+            while (!started.load(std::memory_order_acquire))
+            {
+            }
+            function();
+        });
+
+    qint64 startedNanoseconds = nowNanoseconds();
+    started.store(true, std::memory_order_release);
+    for (std::thread &thread : threads)
+        thread.join();
+    return nowNanoseconds() - startedNanoseconds;
+}
+
+/**
+ * @brief measureConstruction - Создание и освобождение сообщений в threadsCount потоках
+ */
+template<typename Message>
+void measureConstruction(Table &table, const QString &name, int threadsCount)
+{
+    const QString text("benchmark");
+    int messagesPerThread = MESSAGES_COUNT / threadsCount;
+    qint64 elapsed = runThreads(threadsCount, [&text, messagesPerThread]()
+    {
+        for (int i = 0; i < messagesPerThread; i++)
+        {
+            auto message = std::make_shared<Message>(text);
+            Q_UNUSED(message)
+        }
+    });
+
+    qint64 total = qint64(messagesPerThread) * threadsCount;
+    table.addRow({name, QString::number(threadsCount),
+                  number(perSecond(total, elapsed) / 1e6, 2),
+                  number(double(elapsed) * threadsCount / total, 1)});
+}
+
+/**
+ * @brief measurePostConsume - Создание сообщений в threadsCount потоках и их отправка
+ * потоку ThreadConsumer до обработки последнего сообщения
+ */
+template<typename Message>
+void measurePostConsume(Table &table, const QString &name, int threadsCount)
+{
+    ThreadConsumer consumer;
+    consumer.start();
+    QThread::msleep(100);
+
+    const QString text("benchmark");
+    int messagesPerThread = MESSAGES_COUNT / threadsCount;
+    qint64 total = qint64(messagesPerThread) * threadsCount;
+
+    qint64 started = nowNanoseconds();
+    runThreads(threadsCount, [&consumer, &text, messagesPerThread]()
+    {
+        for (int i = 0; i < messagesPerThread; i++)
+            consumer.postMessage(std::make_shared<Message>(text));
+    });
+    while (consumer.ConsumedCount.load() < total)
+        QThread::yieldCurrentThread();
+    qint64 elapsed = nowNanoseconds() - started;
+
+    table.addRow({name, QString::number(threadsCount),
+                  number(perSecond(total, elapsed) / 1e6, 2),
+                  number(double(elapsed) / total, 1)});
+
+    while (!consumer.isFinished())
+    {
+        consumer.postTerminateEvent();
+        QThread::msleep(10);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Создание сообщений: make_shared<MessageString>, %1 сообщений").arg(MESSAGES_COUNT));
+    printTitle("Прежний MessageBase воспроизводится добавлением его затрат: "
+               "общий мьютекс счетчика, gettid, QDateTime::currentDateTime()");
+    Table construction({"Сообщение", "Потоков", "Млн сообщ/с", "нс/сообщение в потоке"});
+    for (int threadsCount : {1, 4})
+    {
+        measureConstruction<MessageStringLegacy>(construction, "прежний MessageBase", threadsCount);
+        measureConstruction<MessageString>(construction, "MessageString", threadsCount);
+    }
+    construction.print();
+
+    printTitle("Отправка и обработка: производители -> ThreadConsumer");
+    Table postConsume({"Сообщение", "Производителей", "Млн сообщ/с", "нс/сообщение"});
+    for (int threadsCount : {1, 4})
+    {
+        measurePostConsume<MessageStringLegacy>(postConsume, "прежний MessageBase", threadsCount);
+        measurePostConsume<MessageString>(postConsume, "MessageString", threadsCount);
+    }
+    postConsume.print();
+
+    return 0;
+}
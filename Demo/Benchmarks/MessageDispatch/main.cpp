@@ -0,0 +1,197 @@
+#include "BenchmarkUtils.h"
+#include "MessageDispatcher.h"
+#include "MessageTypes.h"
+
+#include <QCoreApplication>
+#include <QHash>
+
+#include <random>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int TYPES_COUNT = 50;
+const int MESSAGES_COUNT = 65536;
+const int PASSES_COUNT = 50;
+
+/**
+ * @brief MessageNumbered - Сообщение одного из TYPES_COUNT классов замера
+ */
+template<int N>
+class MessageNumbered : public MessageBase
+{
+public:
+    static const int TYPE_ID;
+
+    static const QString &messageName()
+    {
+        static const QString name = QString("Message.Numbered.%1").arg(N);
+        return name;
+    }
+
+    MessageNumbered()
+        : MessageBase(messageName())
+    {
+        setTypeId(TYPE_ID);
+    }
+
+    const int Value = N;
+};
+
+template<int N>
+const int MessageNumbered<N>::TYPE_ID = MessageTypes::registerType(QByteArray("MessageNumbered" + QByteArray::number(N)).constData());
+
+/**
+ * @brief Types - Перечисление классов MessageNumbered<0>..MessageNumbered<N - 1>
+ */
+template<int N>
+struct Types
+{
+    using Message = MessageNumbered<N - 1>;
+
+    static void append(QVector<MessageBase::Ptr> &prototypes)
+    {
+        Types<N - 1>::append(prototypes);
+        prototypes.append(std::make_shared<Message>());
+    }
+
+    static void registerHandlers(MessageDispatcher &dispatcher, qint64 &sum)
+    {
+        Types<N - 1>::registerHandlers(dispatcher, sum);
+        dispatcher.on<Message>([&sum](const std::shared_ptr<Message> &message)
+        {
+            sum += message->Value;
+        });
+    }
+
+    static void registerHandlers(QHash<QString, MessageDispatcher::Handler> &handlers, qint64 &sum)
+    {
+        Types<N - 1>::registerHandlers(handlers, sum);
+        handlers.insert(Message::messageName(), [&sum](const MessageBase::Ptr &message)
+        {
+            sum += std::static_pointer_cast<Message>(message)->Value;
+        });
+    }
+
+    /**
+     * @brief dispatchByName - Выбор обработчика последовательным сравнением имен
+     */
+    static bool dispatchByName(const QString &name, const MessageBase::Ptr &message, qint64 &sum)
+    {
+        if (Types<N - 1>::dispatchByName(name, message, sum))
+            return true;
+        if (name != Message::messageName())
+            return false;
+        sum += std::static_pointer_cast<Message>(message)->Value;
+        return true;
+    }
+
+    /**
+     * @brief dispatchByCast - Выбор обработчика последовательным dynamic_pointer_cast
+     */
+    static bool dispatchByCast(const MessageBase::Ptr &message, qint64 &sum)
+    {
+        if (Types<N - 1>::dispatchByCast(message, sum))
+            return true;
+        auto typed = std::dynamic_pointer_cast<Message>(message);
+        if (!typed)
+            return false;
+        sum += typed->Value;
+        return true;
+    }
+};
+
+template<>
+struct Types<0>
+{
+    static void append(QVector<MessageBase::Ptr> &)
+    {
+    }
+
+    static void registerHandlers(MessageDispatcher &, qint64 &)
+    {
+    }
+
+    static void registerHandlers(QHash<QString, MessageDispatcher::Handler> &, qint64 &)
+    {
+    }
+
+    static bool dispatchByName(const QString &, const MessageBase::Ptr &, qint64 &)
+    {
+        return false;
+    }
+
+    static bool dispatchByCast(const MessageBase::Ptr &, qint64 &)
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief measure - Обработка MESSAGES_COUNT сообщений случайных типов PASSES_COUNT раз
+ */
+template<typename Function>
+void measure(Table &table, const QString &name, const QVector<MessageBase::Ptr> &messages,
+             qint64 &sum, Function dispatch)
+{
+    sum = 0;
+    qint64 started = nowNanoseconds();
+    for (int pass = 0; pass < PASSES_COUNT; pass++)
+        for (const MessageBase::Ptr &message : messages)
+            dispatch(message);
+    qint64 elapsed = nowNanoseconds() - started;
+
+    qint64 total = qint64(messages.count()) * PASSES_COUNT;
+    table.addRow({name,
+                  number(double(elapsed) / total, 1),
+                  number(perSecond(total, elapsed) / 1e6, 1),
+                  QString::number(sum)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QVector<MessageBase::Ptr> prototypes;
+    Types<TYPES_COUNT>::append(prototypes);
+
+    // сообщения разных типов чередуются случайно, как во входящей очереди потока
+    std::mt19937 random(TYPES_COUNT);
+    std::uniform_int_distribution<int> distribution(0, TYPES_COUNT - 1);
+    QVector<MessageBase::Ptr> messages;
+    messages.reserve(MESSAGES_COUNT);
+    for (int i = 0; i < MESSAGES_COUNT; i++)
+        messages.append(prototypes.at(distribution(random)));
+
+    qint64 sum = 0;
+    MessageDispatcher dispatcher;
+    Types<TYPES_COUNT>::registerHandlers(dispatcher, sum);
+    QHash<QString, MessageDispatcher::Handler> handlers;
+    Types<TYPES_COUNT>::registerHandlers(handlers, sum);
+
+    printTitle(QString("Выбор обработчика: %1 классов сообщений, %2 сообщений x %3 проходов")
+               .arg(TYPES_COUNT).arg(MESSAGES_COUNT).arg(PASSES_COUNT));
+    printTitle("Контрольная сумма одинакова для всех способов");
+    Table table({"Способ", "нс/сообщение", "Млн сообщ/с", "Контрольная сумма"});
+    measure(table, "сравнение имен", messages, sum, [&sum](const MessageBase::Ptr &message)
+    {
+        Types<TYPES_COUNT>::dispatchByName(message->name(), message, sum);
+    });
+    measure(table, "dynamic_pointer_cast", messages, sum, [&sum](const MessageBase::Ptr &message)
+    {
+        Types<TYPES_COUNT>::dispatchByCast(message, sum);
+    });
+    measure(table, "QHash по имени", messages, sum, [&handlers](const MessageBase::Ptr &message)
+    {
+        auto handler = handlers.constFind(message->name());
+        if (handler != handlers.constEnd())
+            (*handler)(message);
+    });
+    measure(table, "MessageDispatcher", messages, sum, [&dispatcher](const MessageBase::Ptr &message)
+    {
+        dispatcher.dispatch(message);
+    });
+    table.print();
+
+    return 0;
+}
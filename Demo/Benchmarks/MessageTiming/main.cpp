@@ -0,0 +1,127 @@
+#include "BenchmarkUtils.h"
+#include "CycleClock.h"
+#include "DateUtils.h"
+#include "MessageString.h"
+#include "ThreadBase.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+using namespace Threader::Utils;
+
+const qint64 MESSAGES_COUNT = 5000000;
+const qint64 MAXIMUM_IN_FLIGHT = 10000;
+const int REPEATS_COUNT = 3;
+const int READS_COUNT = 10000000;
+
+/**
+ * @brief ThreadConsumer - Поток, подсчитывающий полученные строковые сообщения
+ */
+class ThreadConsumer : public ThreadBase
+{
+public:
+    ThreadConsumer()
+        : ThreadBase(nullptr, "Thread.Consumer")
+    {
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            ConsumedCount.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::atomic<qint64> ConsumedCount{0};
+};
+
+/**
+ * @brief measurePipeline - Отправка MESSAGES_COUNT сообщений потоку ThreadConsumer
+ * @return - Время на сообщение в наносекундах
+ */
+double measurePipeline(bool isTimingEnabled)
+{
+    ThreadBase::setMessageTiming(isTimingEnabled, 0);
+
+    ThreadConsumer consumer;
+    consumer.start();
+    QThread::msleep(100);
+
+    MessageBase::Ptr message = std::make_shared<MessageString>("benchmark");
+    qint64 started = nowNanoseconds();
+    for (qint64 i = 0; i < MESSAGES_COUNT; i++)
+    {
+        while (i - consumer.ConsumedCount.load(std::memory_order_acquire) >= MAXIMUM_IN_FLIGHT)
+            std::this_thread::yield();
+        consumer.postMessage(message);
+    }
+    while (consumer.ConsumedCount.load() < MESSAGES_COUNT)
+        QThread::yieldCurrentThread();
+    qint64 elapsed = nowNanoseconds() - started;
+
+    while (!consumer.isFinished())
+    {
+        consumer.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    return double(elapsed) / MESSAGES_COUNT;
+}
+
+template<typename Function>
+void measureRead(Table &table, const QString &name, Function read)
+{
+    qint64 sum = 0;
+    qint64 started = nowNanoseconds();
+    for (int i = 0; i < READS_COUNT; i++)
+        sum += read();
+    qint64 elapsed = nowNanoseconds() - started;
+
+    table.addRow({name, number(double(elapsed) / READS_COUNT, 1), QString::number(sum & 1)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    CycleClock::calibrate();
+
+    printTitle(QString("Чтение часов: %1 чтений, счетчик тактов: %2")
+               .arg(READS_COUNT).arg(CycleClock::isCycleCounter() ? "да" : "нет"));
+    Table reads({"Часы", "нс/чтение", "Контроль"});
+    measureRead(reads, "DateUtils::getTickCountNanoseconds", []()
+    {
+        return DateUtils::getTickCountNanoseconds();
+    });
+    measureRead(reads, "CycleClock::nanoseconds", []()
+    {
+        return CycleClock::nanoseconds();
+    });
+    reads.print();
+
+    // лучший из повторов исключает влияние планировщика на разность замеров
+    double best[2] = {0, 0};
+    for (int repeat = 0; repeat < REPEATS_COUNT; repeat++)
+    {
+        for (int timing = 0; timing < 2; timing++)
+        {
+            double nanoseconds = measurePipeline(1 == timing);
+            if (0 == repeat || nanoseconds < best[timing])
+                best[timing] = nanoseconds;
+        }
+    }
+
+    printTitle(QString("Производитель -> ThreadConsumer: %1 сообщений, не более %2 в пути, "
+                       "лучший из %3 повторов").arg(MESSAGES_COUNT).arg(MAXIMUM_IN_FLIGHT).arg(REPEATS_COUNT));
+    printTitle("Учет времени: отметка при размещении, чтение часов на сообщение "
+               "и две гистограммы типа сообщения");
+    Table pipeline({"Учет времени", "Млн сообщ/с", "нс/сообщение", "Накладные расходы, нс/сообщение"});
+    pipeline.addRow({"выключен", number(1000.0 / best[0], 2), number(best[0], 1), "-"});
+    pipeline.addRow({"включен", number(1000.0 / best[1], 2), number(best[1], 1),
+                     number(best[1] - best[0], 1)});
+    pipeline.print();
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "BenchmarkUtils.h"
+#include "MessageString.h"
+#include "ThreadBase.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <atomic>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int TRIGGERS_COUNT = 200000;
+const int TRIGGERS_BURST = 1000;
+
+/**
+ * @brief FAN_OUT - Количество сообщений получателю на одно входящее сообщение
+ */
+const int FAN_OUT = 16;
+
+/**
+ * @brief ThreadSink - Поток-получатель, подсчитывающий сообщения
+ */
+class ThreadSink : public ThreadBase
+{
+public:
+    ThreadSink()
+        : ThreadBase(nullptr, "Thread.Sink")
+    {
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            ConsumedCount.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::atomic<qint64> ConsumedCount{0};
+};
+
+/**
+ * @brief ThreadRelay - Поток, отправляющий получателю FAN_OUT сообщений
+ * на каждое входящее сообщение
+ */
+class ThreadRelay : public ThreadBase
+{
+public:
+    ThreadRelay(ThreadSink *sink, bool isBatched)
+        : ThreadBase(nullptr, "Thread.Relay")
+        , _sink(sink)
+        , _isBatched(isBatched)
+        , _message(std::make_shared<MessageString>("relay"))
+    {
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            for (int i = 0; i < FAN_OUT; i++)
+            {
+                if (_isBatched)
+                    _sink->postMessage(_message);
+                else
+                    _sink->postMessageNow(_message);
+            }
+        });
+    }
+
+private:
+    ThreadSink *_sink;
+    bool _isBatched;
+    MessageBase::Ptr _message;
+};
+
+void measure(Table &table, const QString &name, bool isBatched)
+{
+    ThreadSink sink;
+    ThreadRelay relay(&sink, isBatched);
+    sink.start();
+    relay.start();
+    QThread::msleep(100);
+
+    // входящие сообщения поступают всплесками, чтобы проход обработки содержал несколько
+    MessagesList burst;
+    for (int i = 0; i < TRIGGERS_BURST; i++)
+        burst.append(std::make_shared<MessageString>("trigger"));
+
+    qint64 total = qint64(TRIGGERS_COUNT) * FAN_OUT;
+    quint64 wakeUpsIssued = sink.wakeUpsIssued();
+    quint64 wakeUpsSuppressed = sink.wakeUpsSuppressed();
+    qint64 started = nowNanoseconds();
+    for (int posted = 0; posted < TRIGGERS_COUNT; posted += TRIGGERS_BURST)
+    {
+        relay.postMessages(burst);
+        // не более двух всплесков в пути
+        while (sink.ConsumedCount.load(std::memory_order_acquire) <
+               qint64(posted - TRIGGERS_BURST) * FAN_OUT)
+            QThread::yieldCurrentThread();
+    }
+    while (sink.ConsumedCount.load(std::memory_order_acquire) < total)
+        QThread::yieldCurrentThread();
+    qint64 elapsed = nowNanoseconds() - started;
+    wakeUpsIssued = sink.wakeUpsIssued() - wakeUpsIssued;
+    wakeUpsSuppressed = sink.wakeUpsSuppressed() - wakeUpsSuppressed;
+
+    quint64 batches = relay.outboxBatchesCount();
+    table.addRow({name,
+                  number(perSecond(total, elapsed) / 1e6, 2),
+                  (batches > 0) ? number(double(relay.outboxMessagesCount()) / batches, 1) : "-",
+                  QString::number(wakeUpsIssued),
+                  QString::number(wakeUpsSuppressed),
+                  number(double(wakeUpsIssued) * 1000 / total, 2)});
+
+    while (!relay.isFinished() || !sink.isFinished())
+    {
+        relay.postTerminateEvent();
+        sink.postTerminateEvent();
+        QThread::msleep(10);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Буфер исходящих сообщений: %1 входящих сообщений всплесками по %2, "
+                       "на каждое %3 сообщений получателю")
+               .arg(TRIGGERS_COUNT).arg(TRIGGERS_BURST).arg(FAN_OUT));
+    printTitle("Пробуждения - системные вызовы пробуждения потока-получателя");
+    Table table({"Отправка", "Млн сообщ/с", "Сообщений в группе", "Пробуждений",
+                 "Подавлено пробуждений", "Пробуждений на 1000 сообщ"});
+    measure(table, "postMessageNow", false);
+    measure(table, "postMessage (буфер)", true);
+    table.print();
+
+    return 0;
+}
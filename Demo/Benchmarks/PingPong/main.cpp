@@ -0,0 +1,152 @@
+#include "BenchmarkUtils.h"
+#include "MessageString.h"
+#include "ThreadBase.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <sys/resource.h>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int WARMUP_ROUND_TRIPS = 1000;
+
+/**
+ * @brief processCpuNanoseconds - Получение процессорного времени процесса
+ */
+qint64 processCpuNanoseconds()
+{
+    rusage usage;
+    if (0 != getrusage(RUSAGE_SELF, &usage))
+        return 0;
+    return (qint64(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000 +
+            (qint64(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000;
+}
+
+/**
+ * @brief ThreadPingPong - Поток, возвращающий каждое сообщение партнеру.
+ * Ведущий поток замеряет время обхода и делает паузу перед следующей отправкой
+ */
+class ThreadPingPong : public ThreadBase
+{
+public:
+    ThreadPingPong(const QString &name, ThreadRunMode runMode)
+        : ThreadBase(nullptr, name, runMode)
+    {
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            onMessage();
+        });
+    }
+
+    void setPeer(ThreadPingPong *peer)
+    {
+        _peer = peer;
+    }
+
+    /**
+     * @brief setLeader - Назначение потока ведущим
+     * @param roundTripsCount - Количество замеряемых обходов
+     * @param pauseMicroseconds - Пауза между получением ответа и следующей отправкой
+     */
+    void setLeader(int roundTripsCount, int pauseMicroseconds)
+    {
+        _isLeader = true;
+        _roundTripsCount = roundTripsCount;
+        _pauseMicroseconds = pauseMicroseconds;
+        Samples.reserve(roundTripsCount);
+    }
+
+    LatencySamples Samples;
+
+protected:
+    void onThreadStarted() override
+    {
+        if (!_isLeader)
+            return;
+
+        // партнер получает первое сообщение, даже если его поток еще запускается
+        _sent = nowNanoseconds();
+        _peer->postMessage(std::make_shared<MessageString>("ping"));
+    }
+
+private:
+    void onMessage()
+    {
+        if (!_isLeader)
+        {
+            _peer->postMessage(std::make_shared<MessageString>("pong"));
+            return;
+        }
+
+        qint64 now = nowNanoseconds();
+        if (++_received > WARMUP_ROUND_TRIPS)
+            Samples.append(now - _sent);
+
+        if (Samples.count() >= _roundTripsCount)
+        {
+            _peer->postTerminateEvent();
+            terminateThread();
+            return;
+        }
+
+        if (_pauseMicroseconds > 0)
+            QThread::usleep(ulong(_pauseMicroseconds));
+        _sent = nowNanoseconds();
+        _peer->postMessage(std::make_shared<MessageString>("ping"));
+    }
+
+    ThreadPingPong *_peer = nullptr;
+    bool _isLeader = false;
+    int _roundTripsCount = 0;
+    int _pauseMicroseconds = 0;
+    int _received = 0;
+    qint64 _sent = 0;
+};
+
+void measure(Table &table, const QString &mode, ThreadBase::ThreadRunMode runMode,
+             int roundTripsCount, int pauseMicroseconds)
+{
+    ThreadPingPong leader("Thread.Ping", runMode);
+    ThreadPingPong follower("Thread.Pong", runMode);
+    leader.setPeer(&follower);
+    follower.setPeer(&leader);
+    leader.setLeader(roundTripsCount, pauseMicroseconds);
+
+    qint64 started = nowNanoseconds();
+    qint64 startedCpu = processCpuNanoseconds();
+    follower.start();
+    leader.start();
+    while (!leader.isFinished() || !follower.isFinished())
+        QThread::msleep(10);
+    qint64 elapsed = nowNanoseconds() - started;
+    qint64 cpu = processCpuNanoseconds() - startedCpu;
+
+    table.addRow({mode,
+                  QString::number(pauseMicroseconds),
+                  QString::number(leader.Samples.count()),
+                  number(leader.Samples.percentile(50) / 1000.0, 1),
+                  number(leader.Samples.percentile(99) / 1000.0, 1),
+                  number(leader.Samples.percentile(99.9) / 1000.0, 1),
+                  number(100.0 * cpu / qMax(elapsed, qint64(1)), 0)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle("Обмен сообщениями между двумя потоками: время обхода ведущего потока");
+    printTitle("CPU - загрузка процесса в процентах одного ядра за время замера");
+    Table table({"Режим", "Пауза, мкс", "Обходов", "p50, мкс", "p99, мкс", "p99.9, мкс", "CPU, %"});
+    for (int pauseMicroseconds : {0, 200})
+    {
+        int roundTripsCount = (0 == pauseMicroseconds) ? 100000 : 20000;
+        measure(table, "Polling", ThreadBase::ThreadRunMode::Polling, roundTripsCount, pauseMicroseconds);
+        measure(table, "EventLoop", ThreadBase::ThreadRunMode::EventLoop, roundTripsCount, pauseMicroseconds);
+        measure(table, "Spinning", ThreadBase::ThreadRunMode::Spinning, roundTripsCount, pauseMicroseconds);
+    }
+    table.print();
+
+    return 0;
+}
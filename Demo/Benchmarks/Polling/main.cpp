@@ -0,0 +1,136 @@
+#include "BenchmarkUtils.h"
+#include "PollingsLinux.h"
+
+#include <QCoreApplication>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <random>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int ITERATIONS_COUNT = 20000;
+const int ACTIVE_DESCRIPTORS_COUNT = 8;
+
+/**
+ * @brief PollerPipe - Голосующий на стороне чтения канала, вычитывающий поступившие данные
+ */
+class PollerPipe : public PollerBase
+{
+public:
+    explicit PollerPipe(int descriptor)
+        : PollerBase(descriptor, POLLIN)
+    {
+    }
+
+    bool process(const pollfd &event) override
+    {
+        char buffer[64];
+        while (::read(event.fd, buffer, sizeof(buffer)) > 0)
+        {
+        }
+        ProcessedCount++;
+        return true;
+    }
+
+    qint64 ProcessedCount = 0;
+};
+
+/**
+ * @brief raiseDescriptorsLimit - Увеличение допустимого количества открытых дескрипторов
+ */
+bool raiseDescriptorsLimit(rlim_t count)
+{
+    rlimit limit;
+    if (0 != getrlimit(RLIMIT_NOFILE, &limit))
+        return false;
+    if (limit.rlim_cur >= count)
+        return true;
+    limit.rlim_cur = qMin(count, limit.rlim_max);
+    return 0 == setrlimit(RLIMIT_NOFILE, &limit) && limit.rlim_cur >= count;
+}
+
+/**
+ * @brief measure - Замер одного шага голосования при заданном количестве дескрипторов.
+ * На каждом шаге данные записываются в ACTIVE_DESCRIPTORS_COUNT случайных каналов
+ */
+void measure(Table &table, PollingMethod method, int descriptorsCount)
+{
+    QVector<int> writeDescriptors;
+    QVector<PollerPipe*> pollers;
+    Polling polling;
+    polling.setPollingMethod(method);
+
+    for (int i = 0; i < descriptorsCount; i++)
+    {
+        int descriptors[2];
+        if (0 != pipe2(descriptors, O_NONBLOCK | O_CLOEXEC))
+            break;
+        writeDescriptors.append(descriptors[1]);
+        pollers.append(new PollerPipe(descriptors[0]));
+        polling.registerPoller(pollers.last());
+    }
+
+    // регистрации epoll выполняются при первом голосовании
+    polling.poll(0);
+
+    std::mt19937 random(descriptorsCount);
+    std::uniform_int_distribution<int> distribution(0, writeDescriptors.count() - 1);
+    LatencySamples samples;
+    samples.reserve(ITERATIONS_COUNT);
+
+    qint64 started = nowNanoseconds();
+    for (int i = 0; i < ITERATIONS_COUNT; i++)
+    {
+        for (int j = 0; j < ACTIVE_DESCRIPTORS_COUNT; j++)
+        {
+            char byte = 0;
+            if (::write(writeDescriptors.at(distribution(random)), &byte, 1) < 0)
+                break;
+        }
+
+        qint64 pollStarted = nowNanoseconds();
+        polling.poll(0);
+        samples.append(nowNanoseconds() - pollStarted);
+    }
+    qint64 elapsed = nowNanoseconds() - started;
+
+    table.addRow({QString::number(writeDescriptors.count()),
+                  (PollingMethod::Epoll == method) ? "epoll" : "poll",
+                  number(perSecond(ITERATIONS_COUNT, elapsed), 0),
+                  number(samples.mean() / 1000.0, 2),
+                  number(samples.percentile(99) / 1000.0, 2)});
+
+    for (PollerPipe *poller : pollers)
+    {
+        ::close(poller->descriptor());
+        delete poller;
+    }
+    for (int descriptor : writeDescriptors)
+        ::close(descriptor);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    const QVector<int> descriptorsCounts = {10, 100, 1000, 10000};
+    if (!raiseDescriptorsLimit(rlim_t(descriptorsCounts.last()) * 2 + 64))
+        printTitle("Предел открытых дескрипторов не увеличен, замеры ограничены доступным количеством");
+
+    printTitle(QString("Голосование: на каждом шаге активно %1 дескрипторов, шагов %2")
+               .arg(ACTIVE_DESCRIPTORS_COUNT).arg(ITERATIONS_COUNT));
+
+    Table table({"Дескрипторов", "Способ", "Шагов/с", "Шаг, мкс", "p99, мкс"});
+    for (int descriptorsCount : descriptorsCounts)
+    {
+        measure(table, PollingMethod::Poll, descriptorsCount);
+        measure(table, PollingMethod::Epoll, descriptorsCount);
+    }
+    table.print();
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include "BenchmarkUtils.h"
+#include "HandlerTcpSocket.h"
+#include "PacketFactoryAsciiLines.h"
+#include "ThreadHandler.h"
+#include "ThreadListenSocket.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int CONNECTIONS_COUNT = 10000;
+const int ROUNDS_COUNT = 20;
+const qint64 ROUND_TIMEOUT_NANOSECONDS = 10000000000;
+const uint16_t FIRST_PORT = 53900;
+
+/**
+ * @brief ThreadEchoConnection - Поток подключения, возвращающий принятые строки
+ */
+class ThreadEchoConnection : public ThreadHandler
+{
+public:
+    ThreadEchoConnection(IMessageSubscriber *parent,
+                         Descriptor socket,
+                         const QString &host,
+                         const uint16_t port)
+        : ThreadHandler(parent,
+                        new HandlerTcpSocket(host, port, socket),
+                        0,
+                        new PacketFactoryAsciiLines())
+    {
+        setThreadName(QString("Thread.Echo.%1").arg(handler()->deviceName()));
+        setTimeout(1000);
+    }
+
+protected:
+    void onDisconnected() override
+    {
+        terminateThread();
+    }
+
+    bool onPacketReceived(const PacketBase::Ptr &packet) override
+    {
+        auto lines = std::dynamic_pointer_cast<PacketAsciiLines>(packet);
+        if (!lines)
+            return false;
+        return sendPacket(std::make_shared<PacketAsciiLines>(lines->lines()));
+    }
+
+    bool onPacketSent(const PacketBase::Ptr &) override
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief ThreadEchoListen - Поток ожидания подключений эхо-сервера
+ */
+class ThreadEchoListen : public ThreadListenSocket
+{
+public:
+    ThreadEchoListen(uint16_t port, int reactorsCount)
+        : ThreadListenSocket(port)
+    {
+        setThreadName(QString("Thread.Echo:%1").arg(port));
+        setReactorsCount(reactorsCount);
+    }
+
+protected:
+    void onBeforeListenSocketInitialization() override
+    {
+    }
+
+    void onListenSocketInitialized() override
+    {
+    }
+
+    void onAcceptConnectionRequest(Descriptor socket,
+                                   const QString &ipAddress,
+                                   bool &accept) override
+    {
+        accept = true;
+        registerAndStartConnectionThread(new ThreadEchoConnection(this, socket, ipAddress, port()));
+    }
+
+    void onListenSocketError(PollerListenSocket *, int) override
+    {
+    }
+};
+
+int connectClient(uint16_t port)
+{
+    int result = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (result < 0)
+        return -1;
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (0 != ::connect(result, reinterpret_cast<sockaddr*>(&address), sizeof(address)))
+    {
+        ::close(result);
+        return -1;
+    }
+
+    int noDelay = 1;
+    setsockopt(result, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    fcntl(result, F_SETFL, fcntl(result, F_GETFL) | O_NONBLOCK);
+    return result;
+}
+
+/**
+ * @brief runRound - Отправка строки в каждое подключение и ожидание всех ответов
+ * @return - Количество полученных ответов
+ */
+int runRound(int epollDescriptor, const QVector<int> &sockets, LatencySamples &samples)
+{
+    static const char REQUEST[] = "ping\r\n";
+    const int requestSize = int(sizeof(REQUEST)) - 1;
+
+    QVector<qint64> sent(sockets.count());
+    QVector<int> received(sockets.count(), 0);
+    for (int i = 0; i < sockets.count(); i++)
+    {
+        sent[i] = nowNanoseconds();
+        if (::write(sockets.at(i), REQUEST, requestSize) != requestSize)
+            received[i] = -1;
+    }
+
+    int answered = 0;
+    qint64 deadline = nowNanoseconds() + ROUND_TIMEOUT_NANOSECONDS;
+    QVector<epoll_event> events(1024);
+    while (answered < sockets.count() && nowNanoseconds() < deadline)
+    {
+        int count = epoll_wait(epollDescriptor, events.data(), events.count(), 100);
+        qint64 now = nowNanoseconds();
+        for (int i = 0; i < count; i++)
+        {
+            int index = int(events.at(i).data.u32);
+            char buffer[256];
+            ssize_t size;
+            while ((size = ::read(sockets.at(index), buffer, sizeof(buffer))) > 0)
+            {
+                if (received.at(index) < 0)
+                    continue;
+                received[index] += int(size);
+                if (received.at(index) >= requestSize)
+                {
+                    samples.append(now - sent.at(index));
+                    received[index] = -1;
+                    answered++;
+                }
+            }
+        }
+    }
+    return answered;
+}
+
+void measure(Table &table, const QString &mode, int reactorsCount, uint16_t port)
+{
+    ThreadEchoListen listen(port, reactorsCount);
+    listen.start();
+    QThread::msleep(500);
+
+    QVector<int> sockets;
+    int epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    qint64 connectStarted = nowNanoseconds();
+    for (int i = 0; i < CONNECTIONS_COUNT; i++)
+    {
+        int socket = connectClient(port);
+        if (socket < 0)
+            break;
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u32 = uint32_t(sockets.count());
+        epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, socket, &event);
+        sockets.append(socket);
+    }
+    qint64 connectElapsed = nowNanoseconds() - connectStarted;
+
+    LatencySamples samples;
+    samples.reserve(sockets.count() * ROUNDS_COUNT);
+    qint64 answered = 0;
+    qint64 roundsStarted = nowNanoseconds();
+    for (int round = 0; round < ROUNDS_COUNT; round++)
+        answered += runRound(epollDescriptor, sockets, samples);
+    qint64 roundsElapsed = nowNanoseconds() - roundsStarted;
+
+    // потоки и память замеряются под нагрузкой, пока подключения открыты
+    qint64 threadsCount = processStatusValue("Threads");
+    qint64 residentKilobytes = processStatusValue("VmRSS");
+
+    for (int socket : sockets)
+        ::close(socket);
+    ::close(epollDescriptor);
+
+    listen.postTerminateEvent();
+    while (!listen.isFinished())
+    {
+        listen.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    table.addRow({mode,
+                  QString::number(sockets.count()),
+                  number(connectElapsed / 1e6, 0),
+                  number(perSecond(answered, roundsElapsed), 0),
+                  number(samples.percentile(50) / 1000.0, 0),
+                  number(samples.percentile(99) / 1000.0, 0),
+                  QString::number(threadsCount),
+                  number(residentKilobytes / 1024.0, 1),
+                  QString::number(qint64(sockets.count()) * ROUNDS_COUNT - answered)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    printTitle(QString("Эхо-сервер: %1 подключений, %2 раундов по строке на подключение")
+               .arg(CONNECTIONS_COUNT).arg(ROUNDS_COUNT));
+
+    Table table({"Режим", "Подключений", "Подключение, мс", "Ответов/с",
+                 "p50, мкс", "p99, мкс", "Потоков", "RSS, МиБ", "Потеряно"});
+    measure(table, "Поток на подключение", 0, FIRST_PORT);
+    measure(table, "Пул реакторов", ThreadListenSocket::REACTORS_COUNT_AUTO, FIRST_PORT + 1);
+    table.print();
+
+    return 0;
+}
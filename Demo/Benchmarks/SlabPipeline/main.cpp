@@ -0,0 +1,121 @@
+#include "AllocationCounter.h"
+#include "BenchmarkUtils.h"
+#include "MessageString.h"
+#include "SlabAllocator.h"
+#include "ThreadBase.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+using namespace Threader::Utils;
+
+const qint64 MESSAGES_COUNT = 10000000;
+
+/**
+ * @brief MAXIMUM_IN_FLIGHT - Наибольшее количество отправленных и не обработанных сообщений,
+ * чтобы рост памяти отражал работу распределителя, а не длину очереди
+ */
+const qint64 MAXIMUM_IN_FLIGHT = 10000;
+
+const qint64 RSS_SAMPLE_EVERY = 1000000;
+
+/**
+ * @brief ThreadConsumer - Поток-потребитель, освобождающий сообщения, созданные другим потоком
+ */
+class ThreadConsumer : public ThreadBase
+{
+public:
+    ThreadConsumer()
+        : ThreadBase(nullptr, "Thread.Consumer")
+    {
+        on<MessageString>([this](const MessageString::Ptr &)
+        {
+            ConsumedCount.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::atomic<qint64> ConsumedCount{0};
+};
+
+/**
+ * @brief measure - Конвейер производитель -> ThreadConsumer на MESSAGES_COUNT сообщений
+ */
+template<typename Function>
+void measure(Table &table, const QString &name, Function createMessage)
+{
+    ThreadConsumer consumer;
+    consumer.start();
+    QThread::msleep(100);
+
+    qint64 firstResident = 0;
+    qint64 peakResident = 0;
+    qint64 allocations = allocationsCount();
+    qint64 started = nowNanoseconds();
+
+    std::thread producer([&]()
+    {
+        const QString text("benchmark");
+        for (qint64 i = 0; i < MESSAGES_COUNT; i++)
+        {
+            while (i - consumer.ConsumedCount.load(std::memory_order_acquire) >= MAXIMUM_IN_FLIGHT)
+                std::this_thread::yield();
+            consumer.postMessage(createMessage(text));
+
+            if (0 != (i + 1) % RSS_SAMPLE_EVERY)
+                continue;
+            qint64 resident = processStatusValue("VmRSS");
+            if (0 == firstResident)
+                firstResident = resident;
+            peakResident = qMax(peakResident, resident);
+        }
+    });
+    producer.join();
+    while (consumer.ConsumedCount.load() < MESSAGES_COUNT)
+        QThread::yieldCurrentThread();
+
+    qint64 elapsed = nowNanoseconds() - started;
+    allocations = allocationsCount() - allocations;
+    qint64 lastResident = processStatusValue("VmRSS");
+
+    while (!consumer.isFinished())
+    {
+        consumer.postTerminateEvent();
+        QThread::msleep(10);
+    }
+
+    table.addRow({name,
+                  number(perSecond(MESSAGES_COUNT, elapsed) / 1e6, 2),
+                  number(perSecond(allocations, elapsed) / 1e6, 2),
+                  number(double(allocations) / MESSAGES_COUNT, 2),
+                  number(firstResident / 1024.0, 1),
+                  number(peakResident / 1024.0, 1),
+                  number((lastResident - firstResident) / 1024.0, 1)});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    printTitle(QString("Конвейер производитель -> потребитель: %1 сообщений, не более %2 в пути")
+               .arg(MESSAGES_COUNT).arg(MAXIMUM_IN_FLIGHT));
+    printTitle(QString("RSS замеряется каждые %1 сообщений; сообщение освобождает поток-потребитель")
+               .arg(RSS_SAMPLE_EVERY));
+    Table table({"Сообщения", "Млн сообщ/с", "Млн выделений/с", "Выделений/сообщение",
+                 "RSS после 1 млн, МиБ", "RSS max, МиБ", "Рост RSS, МиБ"});
+    measure(table, "std::make_shared", [](const QString &text)
+    {
+        return std::make_shared<MessageString>(text);
+    });
+    measure(table, "makeSlabShared", [](const QString &text)
+    {
+        return makeSlabShared<MessageString>(text);
+    });
+    table.print();
+
+    return 0;
+}
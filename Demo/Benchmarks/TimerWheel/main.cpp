@@ -0,0 +1,189 @@
+#include "BenchmarkUtils.h"
+#include "MessageTimer.h"
+#include "ThreadBase.h"
+#include "TimerWheel.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <sys/resource.h>
+
+#include <random>
+#include <vector>
+
+using namespace Threader::Benchmarks;
+using namespace Threader::Threads;
+
+const int TIMERS_COUNT = 100000;
+const int MINIMUM_DELAY_MILLISECONDS = 10;
+const int MAXIMUM_DELAY_MILLISECONDS = 1000;
+const int RUN_MILLISECONDS = 10000;
+
+/**
+ * @brief threadCpuNanoseconds - Получение процессорного времени текущего потока
+ */
+qint64 threadCpuNanoseconds()
+{
+    rusage usage;
+    if (0 != getrusage(RUSAGE_THREAD, &usage))
+        return 0;
+    return (qint64(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000 +
+            (qint64(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000;
+}
+
+QVector<int> randomDelays()
+{
+    std::mt19937 random(TIMERS_COUNT);
+    std::uniform_int_distribution<int> distribution(MINIMUM_DELAY_MILLISECONDS, MAXIMUM_DELAY_MILLISECONDS);
+
+    QVector<int> result(TIMERS_COUNT);
+    for (int &delay : result)
+        delay = distribution(random);
+    return result;
+}
+
+/**
+ * @brief measureWheel - Замер операций колеса без потока: запуск, остановка
+ * и продвижение по миллисекундам с перезапуском сработавших таймеров
+ */
+void measureWheel()
+{
+    QVector<int> delays = randomDelays();
+    std::vector<TimerWheel::Timer> timers(size_t(TIMERS_COUNT));
+    TimerWheel wheel(0);
+
+    qint64 started = nowNanoseconds();
+    for (int i = 0; i < TIMERS_COUNT; i++)
+        wheel.start(&timers[size_t(i)], delays.at(i));
+    qint64 startElapsed = nowNanoseconds() - started;
+
+    started = nowNanoseconds();
+    for (int i = 0; i < TIMERS_COUNT; i++)
+        wheel.stop(&timers[size_t(i)]);
+    qint64 stopElapsed = nowNanoseconds() - started;
+
+    for (int i = 0; i < TIMERS_COUNT; i++)
+        wheel.start(&timers[size_t(i)], delays.at(i));
+
+    // продвижение колеса на RUN_MILLISECONDS без ожидания
+    qint64 fired = 0;
+    TimerWheel::TimersList expired;
+    started = nowNanoseconds();
+    for (qint64 tickCount = 1; tickCount <= RUN_MILLISECONDS; tickCount++)
+    {
+        expired.clear();
+        fired += wheel.expire(tickCount, expired);
+        for (TimerWheel::Timer *timer : expired)
+        {
+            int index = int(timer - timers.data());
+            wheel.start(timer, timer->expires() + delays.at(index));
+        }
+    }
+    qint64 expireElapsed = nowNanoseconds() - started;
+
+    printTitle(QString("Колесо таймеров без потока: %1 таймеров, задержки %2..%3 мс")
+               .arg(TIMERS_COUNT).arg(MINIMUM_DELAY_MILLISECONDS).arg(MAXIMUM_DELAY_MILLISECONDS));
+    Table table({"Операция", "нс/операцию", "Всего, мс"});
+    table.addRow({"start", number(double(startElapsed) / TIMERS_COUNT), number(startElapsed / 1e6, 2)});
+    table.addRow({"stop", number(double(stopElapsed) / TIMERS_COUNT), number(stopElapsed / 1e6, 2)});
+    table.addRow({QString("expire + restart, %1 срабатываний за %2 с").arg(fired).arg(RUN_MILLISECONDS / 1000),
+                  number(double(expireElapsed) / qMax(fired, qint64(1))), number(expireElapsed / 1e6, 2)});
+    table.print();
+
+    for (TimerWheel::Timer &timer : timers)
+        wheel.stop(&timer);
+}
+
+/**
+ * @brief ThreadTimers - Поток с TIMERS_COUNT многократными таймерами,
+ * замеряющий опоздание срабатываний и процессорное время потока
+ */
+class ThreadTimers : public ThreadBase
+{
+public:
+    ThreadTimers()
+        : ThreadBase(nullptr, "Thread.Timers")
+        , _delays(randomDelays())
+        , _started(TIMERS_COUNT)
+    {
+        on<MessageTimer>([this](const MessageTimer::Ptr &message)
+        {
+            onTimer(message);
+        });
+    }
+
+    LatencySamples Lateness;
+    qint64 FiredCount = 0;
+    qint64 CpuNanoseconds = 0;
+    qint64 ElapsedNanoseconds = 0;
+
+protected:
+    void onThreadStarted() override
+    {
+        for (int i = 0; i < TIMERS_COUNT; i++)
+        {
+            _started[i] = nowNanoseconds();
+            startTimer(QString::number(i), _delays.at(i), true);
+        }
+        startTimer(TIMER_NAME_FINISH, RUN_MILLISECONDS, false);
+
+        _startedNanoseconds = nowNanoseconds();
+        _startedCpuNanoseconds = threadCpuNanoseconds();
+    }
+
+private:
+    void onTimer(const MessageTimer::Ptr &message)
+    {
+        qint64 now = nowNanoseconds();
+        if (TIMER_NAME_FINISH == message->name())
+        {
+            ElapsedNanoseconds = now - _startedNanoseconds;
+            CpuNanoseconds = threadCpuNanoseconds() - _startedCpuNanoseconds;
+            stopAllTimers();
+            terminateThread();
+            return;
+        }
+
+        int index = message->name().toInt();
+        qint64 expected = _started.at(index) + qint64(_delays.at(index)) * message->shotCount() * 1000000;
+        Lateness.append(now - expected);
+        FiredCount++;
+    }
+
+    const QString TIMER_NAME_FINISH = "Finish";
+
+    QVector<int> _delays;
+    QVector<qint64> _started;
+    qint64 _startedNanoseconds = 0;
+    qint64 _startedCpuNanoseconds = 0;
+};
+
+void measureThread()
+{
+    ThreadTimers thread;
+    thread.start();
+    while (!thread.isFinished())
+        QThread::msleep(100);
+
+    printTitle(QString("Таймеры потока: %1 многократных таймеров, %2 с")
+               .arg(TIMERS_COUNT).arg(RUN_MILLISECONDS / 1000));
+    Table table({"Срабатываний/с", "Опоздание p50, мкс", "p99, мкс", "p99.9, мкс", "max, мкс",
+                 "CPU потока, %"});
+    table.addRow({number(perSecond(thread.FiredCount, thread.ElapsedNanoseconds), 0),
+                  number(thread.Lateness.percentile(50) / 1000.0, 0),
+                  number(thread.Lateness.percentile(99) / 1000.0, 0),
+                  number(thread.Lateness.percentile(99.9) / 1000.0, 0),
+                  number(thread.Lateness.percentile(100) / 1000.0, 0),
+                  number(100.0 * thread.CpuNanoseconds / qMax(thread.ElapsedNanoseconds, qint64(1)), 1)});
+    table.print();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    measureWheel();
+    measureThread();
+
+    return 0;
+}
@@ -103,6 +103,7 @@ PacketBase::Ptr PacketFactorySimple::tryExtractPacket(QByteArray &data)
     if (receivedCrc != header.checkSumm)
     {
         setLastResult(int(PacketFactorySimpleResults::BadCheckSumm));
+        countChecksumError();
         return nullptr;
     }
 
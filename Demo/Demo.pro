@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     ../Threader.pro \
+    Benchmarks \
     FramesContractBuilder \
     SerialConsole \
     SimpleClient \
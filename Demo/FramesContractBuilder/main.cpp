@@ -25,6 +25,7 @@ const QString ERROR_INVALID_PROJECT_NAME  = "Имя проекта [%1] не м
 const QString MESSAGE_DEFINITIONS_READ                    = "Прочитано определений фреймов %1 шт.\r\n";
 const QString MESSAGE_DEFINITIONS_HEADERS_WRITTEN         = "Заголовки контракта сохранены в файл [%1]\r\n";
 const QString MESSAGE_DEFINITIONS_IMPLAMENTATIONS_WRITTEN = "Реализация контракта сохранены в файл [%1]\r\n";
+const QString MESSAGE_DEFINITIONS_CODECS_WRITTEN          = "Кодеки фреймов сохранены в файл [%1]\r\n";
 
 bool parameterShowHelp = false;
 QString parameterFile = "./Definitions.xml";
@@ -183,6 +184,16 @@ int main(int argc, char *argv[])
         writeDosString(ERROR_PREFIX + "Ошибка записи файла " + fileName);
 
 
+    fileName = builder.codecFileName();
+    text = builder.codecContent();
+    if (writeFile(text, fileName))
+    {
+        QString message = QString(MESSAGE_DEFINITIONS_CODECS_WRITTEN).arg(fileName);
+        writeDosString(message);
+    } else
+        writeDosString(ERROR_PREFIX + "Ошибка записи файла " + fileName);
+
+
 //    QFile helperImplementationFile(builder.helperImplementationName());
 //    if (helperImplementationFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
 //        QByteArray data = builder.helperImplementation().toUtf8();
@@ -8,6 +8,8 @@ ThreadSimpleServerListenSocket::ThreadSimpleServerListenSocket(ThreadBase *paren
     : ThreadListenSocket(53817, parent)
 {
     setThreadName("Thread.Listen:" + QString("%1").arg(port()));
+    // подключения обслуживаются пулом реакторов по количеству ядер
+    setReactorsCount();
 }
 
 
@@ -50,7 +52,7 @@ void ThreadSimpleServerListenSocket::onAcceptConnectionRequest(Descriptor socket
                                                       ipAddress,
                                                       port());
 
-    registerAndStartChildThread(thread);
+    registerAndStartConnectionThread(thread);
 }
 
 
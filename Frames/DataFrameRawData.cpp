@@ -1,5 +1,8 @@
 #include "DataFrameRawData.h"
 
+#include "../Threads/MessageTypes.h"
+#include "../Utils/SlabAllocator.h"
+
 #include <QFile>
 
 
@@ -11,9 +14,7 @@ namespace Threader {
 namespace Frames {
 
 
-int DataFrameRawData::_referenceCount(0);
-
-QMutex DataFrameRawData::_mutexReferenceCount;
+Utils::ShardedCounter DataFrameRawData::_referenceCount;
 
 DataFrameRawData::DataFrameRawData(const char *data,
                                    const FrameSizeType &length)
@@ -45,7 +46,7 @@ DataFrameRawData::DataFrameRawData(const char *data,
 
     // выделение буфера для хранения с увеличением размена на 1
     // для гараньтированного завершения на 0
-    _buffer = new char[length + 1];
+    _buffer = static_cast<char*>(Utils::SlabAllocator::allocate(length + 1));
 
     // подготовка и перенос данных во внутреннюю память
     memset(_buffer, 0, static_cast<size_t>(length + 1));
@@ -84,14 +85,14 @@ DataFrameRawData::DataFrameRawData(const char *data,
 
 DataFrameRawData::~DataFrameRawData()
 {    
-    delete [] _buffer;
+    Utils::SlabAllocator::deallocate(_buffer);
     _buffer = nullptr;
     decrementReferenceCount();
 }
 
 DataFrameRawData::Ptr DataFrameRawData::clone()
 {
-    DataFrameRawData::Ptr result = std::make_shared<DataFrameRawData>(_buffer, _length);
+    DataFrameRawData::Ptr result = Utils::makeSlabShared<DataFrameRawData>(_buffer, _length);
     result->setDefinition(this->definition());
     return result;
 }
@@ -206,7 +207,7 @@ void DataFrameRawData::parse(QByteArray &source, QList<DataFrameRawData::Ptr> &r
         if (position + frameLength <= sourceSize)
         {
             // формирование неразобранных данных фрейма
-            DataFrameRawData::Ptr dataFrameRawData = std::make_shared<DataFrameRawData>(sourcePointer + position, frameLength);
+            DataFrameRawData::Ptr dataFrameRawData = Utils::makeSlabShared<DataFrameRawData>(sourcePointer + position, frameLength);
             // проверка корректности разбора данных фрейма
             if (dataFrameRawData->isValid())
                 result.append(dataFrameRawData);
@@ -254,30 +255,31 @@ bool DataFrameRawData::loadFromFile(const QString &fileName,
 
 int DataFrameRawData::referenceCount()
 {
-    QMutexLocker locker(&_mutexReferenceCount);
-    return _referenceCount;
+    return int(_referenceCount.value());
 }
 
 void DataFrameRawData::incrementReferenceCount()
 {
-    QMutexLocker locker(&_mutexReferenceCount);
-    _referenceCount++;
+    _referenceCount.increment();
 }
 
 void DataFrameRawData::decrementReferenceCount()
 {
-    QMutexLocker locker(&_mutexReferenceCount);
-    _referenceCount--;
+    _referenceCount.decrement();
 }
 
 
 const QString MessageDataFramesRaw::MESSAGE_NAME = "Message.DataFramesRaw";
 
+const int MessageDataFramesRaw::TYPE_ID = MessageTypes::registerType("MessageDataFramesRaw");
+
 MessageDataFramesRaw::MessageDataFramesRaw(const DataFrameRawDataList &frames,
                                            const QString alias)
     : MessageBase(MESSAGE_NAME)
     , _alias(alias)
 {
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Bulk);
     _frames.append(frames);
 }
 
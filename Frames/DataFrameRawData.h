@@ -163,8 +163,7 @@ private:
     /**
      * @brief _referenceCount - Счетчик экземпляров
      */
-    static QMutex _mutexReferenceCount;
-    static int _referenceCount;
+    static Utils::ShardedCounter _referenceCount;
     void incrementReferenceCount();
     void decrementReferenceCount();
 };
@@ -178,6 +177,8 @@ public:
     using Ptr = std::shared_ptr<MessageDataFramesRaw>;
 
 public:
+    static const int TYPE_ID;
+
     static const QString MESSAGE_NAME;
 
     explicit MessageDataFramesRaw(const DataFrameRawDataList &frames,
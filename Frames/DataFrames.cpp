@@ -196,6 +196,16 @@ uint32_t DataFrame::size() const
     return result;
 }
 
+void DataFrame::reset()
+{
+    setCapacity(1);
+    setCurrentIndex(0);
+    _packetId = 0;
+    foreach (AbstractDataAtom *atom, *_atoms)
+        if (atom)
+            atom->clear();
+}
+
 uint32_t DataFrame::currentIndex() const
 {
     return _currentIndex;
@@ -48,6 +48,11 @@ public:
 
     uint32_t size() const;
 
+    /**
+     * @brief reset - Сброс фрейма в исходное состояние для повторного использования
+     */
+    void reset();
+
     uint32_t currentIndex() const;
     void setCurrentIndex(const uint32_t &currentIndex);
 
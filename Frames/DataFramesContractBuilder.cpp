@@ -40,7 +40,9 @@ DataFramesContractBuilder::DataFramesContractBuilder(DataFramesDefinitions *defi
       _implementationFileName(output + projectName + "DataFramesFactory.cpp"),
 //      _helperImplementationName(output + projectName + "DataFramesHelpers.cpp"),
       _headerContent(""),
-      _implementationContent("")
+      _implementationContent(""),
+      _codecFileName(output + projectName + "DataFramesCodec.h"),
+      _codecContent("")
 {
     _cppTypes[TYPE_NAME_BOOLEAN.toLower()] = "bool";
     _cppTypes[TYPE_NAME_UINT8.toLower()] = "uint8_t";
@@ -308,6 +310,110 @@ QString DataFramesContractBuilder::buildImplementation(const QStringList &frames
     return result;
 }
 
+bool DataFramesContractBuilder::isFixedLayout(DataFrameDefinition::Ptr definition) const
+{
+    // фиксированную раскладку имеют фреймы без емкости, состоящие из чисел
+    if (definition->isArray() || definition->atoms().isEmpty())
+        return false;
+
+    for (int i = 0; i < definition->atoms().count(); i++) {
+        QString type = definition->atoms().at(i)->atomType().toLower();
+        if (type == TYPE_NAME_DATETIME.toLower() ||
+                type == TYPE_NAME_STRING.toLower() ||
+                type == TYPE_NAME_BYTEARRAY.toLower() ||
+                type == TYPE_NAME_GUID.toLower() ||
+                !_cppTypes.contains(type))
+            return false;
+    }
+    return true;
+}
+
+QString DataFramesContractBuilder::buildCodecFrame(DataFrameDefinition::Ptr definition, const QString &frameName)
+{
+    bool fixedLayout = isFixedLayout(definition);
+    QString fields, offsets, capacity, sizes, writes, reads;
+
+    if (definition->isArray()) {
+        sizes += TEMPLATE_CODEC_ARRAY_SIZE;
+        writes += TEMPLATE_CODEC_ARRAY_WRITE;
+        reads += TEMPLATE_CODEC_ARRAY_READ;
+    }
+
+    QVariantHash templates;
+    Mustache::Renderer renderer;
+    templates[FRAME_NAME] = frameName;
+
+    for (int i = 0; i < definition->atoms().count(); i++) {
+        DataAtomDefinition::Ptr atomDefinition = definition->atoms().at(i);
+
+        QString atomType = atomDefinition->atomType().toLower();
+        QString type = (_cppTypes.contains(atomType)) ? _cppTypes[atomType] : "UnknownType";
+
+        // массив байт всегда хранит одно значение, независимо от емкости фрейма
+        bool isVector = definition->isArray() && !atomDefinition->isScalar() &&
+                atomType != TYPE_NAME_BYTEARRAY.toLower();
+        templates[TEMPLATE_TYPE] = isVector ? "QVector<" + type + ">" : type;
+
+        QString argument = atomDefinition->name();
+        if (argument.length() > 0)
+            argument[0] = argument[0].toLower();
+        templates[TEMPLATE_ARGUMENT] = argument;
+        templates[TEMPLATE_ATOM_NAME_UPPER] = atomDefinition->name().toUpper();
+
+        Mustache::QtVariantContext context(templates);
+        fields += renderer.render(TEMPLATE_CODEC_FIELD, &context);
+        if (fixedLayout) {
+            offsets += renderer.render(TEMPLATE_CODEC_OFFSET, &context);
+        } else if (isVector) {
+            capacity += renderer.render(TEMPLATE_CODEC_VALUE_CAPACITY, &context);
+            sizes += renderer.render(TEMPLATE_CODEC_VALUES_SIZE, &context);
+            writes += renderer.render(TEMPLATE_CODEC_VALUES_WRITE, &context);
+            reads += renderer.render(TEMPLATE_CODEC_VALUES_READ, &context);
+        } else {
+            sizes += renderer.render(TEMPLATE_CODEC_VALUE_SIZE, &context);
+            writes += renderer.render(TEMPLATE_CODEC_VALUE_WRITE, &context);
+            reads += renderer.render(TEMPLATE_CODEC_VALUE_READ, &context);
+        }
+    }
+
+    templates[TEMPLATE_FRAME_WIRE_NAME] = definition->name();
+    templates[TEMPLATE_NAME_SIZE] = QString::number(definition->name().length() + 1);
+    templates[TEMPLATE_CODEC_FIELDS] = fields;
+    templates[TEMPLATE_CODEC_OFFSETS] = offsets;
+    templates[TEMPLATE_CODEC_CAPACITY] = capacity;
+    templates[TEMPLATE_CODEC_SIZES] = sizes;
+    templates[TEMPLATE_CODEC_WRITES] = writes;
+    templates[TEMPLATE_CODEC_READS] = reads;
+
+    Mustache::QtVariantContext context(templates);
+    return renderer.render(fixedLayout ? TEMPLATE_CODEC_FIXED : TEMPLATE_CODEC_SEQUENTIAL, &context);
+}
+
+QString DataFramesContractBuilder::buildCodec(const QStringList &framesNames)
+{
+    QString codecs = "";
+
+    for (int i = 0; i < framesNames.count(); i++) {
+        QString frameName = framesNames.at(i);
+        if (frameName.contains('*', Qt::CaseInsensitive))
+            continue;
+
+        DataFrameDefinition::Ptr definition = _definitions->definitionByKey(frameName);
+        if (nullptr == definition)
+            continue;
+
+        codecs += buildCodecFrame(definition, toNameCase(frameName));
+    }
+
+    QVariantHash templates;
+    templates[TEMPLATE_PROJECT_NAME] = _projectName;
+    templates[TEMPLATE_CODECS] = codecs;
+
+    Mustache::Renderer renderer;
+    Mustache::QtVariantContext context(templates);
+    return renderer.render(TEMPLATE_CODEC_FILE, &context);
+}
+
 bool DataFramesContractBuilder::build(bool verbose)
 {
     if (nullptr == _definitions)
@@ -342,6 +448,7 @@ bool DataFramesContractBuilder::build(bool verbose)
 
     _headerContent = buildHeader(framesNames, atomsNames).replace("&amp;amp;", "&");
     _implementationContent = buildImplementation(framesNames, atomsNames).replace("&quot;", "\"").replace("&amp;amp;", "&").replace("&amp;lt;", "<").replace("&amp;gt;", ">");
+    _codecContent = buildCodec(framesNames);
 
     if (verbose)
     {
@@ -353,6 +460,10 @@ bool DataFramesContractBuilder::build(bool verbose)
 
         output << "\r\n" + _implementationFileName + ":\r\n\r\n";
         output << _implementationContent;
+
+
+        output << "\r\n" + _codecFileName + ":\r\n\r\n";
+        output << _codecContent;
     }
 
     return true;
@@ -383,4 +494,14 @@ QString DataFramesContractBuilder::implementationContent() const
     return _implementationContent;
 }
 
+QString DataFramesContractBuilder::codecFileName() const
+{
+    return _codecFileName;
+}
+
+QString DataFramesContractBuilder::codecContent() const
+{
+    return _codecContent;
+}
+
 }}
@@ -35,6 +35,10 @@ public:
 
     QString implementationContent() const;
 
+    QString codecFileName() const;
+
+    QString codecContent() const;
+
     void addNamespaces(QVariantHash &templates);
 
 private:
@@ -45,6 +49,8 @@ private:
     QString _implementationFileName;
     QString _headerContent;
     QString _implementationContent;
+    QString _codecFileName;
+    QString _codecContent;
     QHash<QString, QString> _cppTypes;
     QHash<QString, QString> _atomsTypes;
 
@@ -58,5 +64,8 @@ private:
     QString buildImplementationAssignAtoms(DataFrameDefinition::Ptr definition);
     QString buildFunctionsImplementation(const QStringList &framesNames);
     QString buildImplementation(const QStringList &framesNames, const QStringList &atomsNames);
+    bool isFixedLayout(DataFrameDefinition::Ptr definition) const;
+    QString buildCodecFrame(DataFrameDefinition::Ptr definition, const QString &frameName);
+    QString buildCodec(const QStringList &framesNames);
 };
 }}
@@ -151,10 +151,49 @@ DataFrame::Ptr DataFramesFactory::buildFrame(const QString& key) const
 
 DataFrame::Ptr DataFramesFactory::buildFrame(DataFrameDefinition::Ptr definition) const
 {
-    const DataAtomsDefinitions& atomsDefintions(definition->atoms());
-    AbstractDataAtom* atom;
+    DataFramesPool::Ptr pool = _framesPool;
+    if (pool)
+    {
+        DataFrame::Ptr frame = pool->take(definition);
+        if (frame)
+            return frame;
+    }
+
+    FrameLayout layout = frameLayout(definition);
     auto atomsVector = new AbstractDataAtoms();
-    atomsVector->reserve(atomsDefintions.count());
+    atomsVector->reserve(layout.Atoms.count());
+    foreach (const FrameLayout::Atom &atom, layout.Atoms)
+        atomsVector->append(atom.Prototype ? atom.Prototype->clone(atom.Definition) : nullptr);
+
+    if (pool)
+        return pool->wrap(new DataFrame(definition, atomsVector));
+    return std::make_shared<DataFrame>(definition, atomsVector);
+}
+
+void DataFramesFactory::setFramesPool(const DataFramesPool::Ptr &pool)
+{
+    _framesPool = pool;
+}
+
+DataFramesPool::Ptr DataFramesFactory::framesPool() const
+{
+    return _framesPool;
+}
+
+DataFramesFactory::FrameLayout DataFramesFactory::frameLayout(const DataFrameDefinition::Ptr &definition) const
+{
+    {
+        QReadLocker locker(&_layoutsLock);
+        auto iterator = _layouts.constFind(definition.get());
+        if (iterator != _layouts.constEnd())
+            return iterator.value();
+    }
+
+    // состав атомов вычисляется один раз на описание фрейма
+    FrameLayout layout;
+    layout.Definition = definition;
+    const DataAtomsDefinitions& atomsDefintions(definition->atoms());
+    layout.Atoms.reserve(atomsDefintions.count());
     for (int i = 0; i < atomsDefintions.count(); i++)
     {
         const DataAtomDefinition::Ptr& atomDefinition(atomsDefintions.at(i));
@@ -162,10 +201,21 @@ DataFrame::Ptr DataFramesFactory::buildFrame(DataFrameDefinition::Ptr definition
         if (!atomDefinition)
             continue;
 
-        atom = atomByDefinition(atomDefinition);
-        atomsVector->append(atom);
+        FrameLayout::Atom atom;
+        atom.Prototype = _registry.value(atomDefinition->atomType(), nullptr);
+        atom.Definition = atomDefinition.get();
+        layout.Atoms.append(atom);
     }
-    return std::make_shared<DataFrame>(definition, atomsVector);
+
+    QWriteLocker locker(&_layoutsLock);
+    _layouts.insert(definition.get(), layout);
+    return layout;
+}
+
+void DataFramesFactory::clearLayouts()
+{
+    QWriteLocker locker(&_layoutsLock);
+    _layouts.clear();
 }
 
 QString DataFramesFactory::definitionsFileName() const
@@ -232,9 +282,12 @@ void DataFramesFactory::initializeAtomsStorage()
 
 void DataFramesFactory::releaseAtomsStorage()
 {
+    // составы фреймов ссылаются на удаляемые прототипы атомов
+    clearLayouts();
     foreach (AbstractDataAtom *atom, _registry) {
         delete atom;
     }
+    _registry.clear();
 }
 
 DataFramesDefinitions *DataFramesFactory::createDefinitionStorage()
@@ -246,6 +299,7 @@ DataFramesDefinitions *DataFramesFactory::createDefinitionStorage()
 
 void DataFramesFactory::releaseDefinitionsStorage()
 {
+    clearLayouts();
     if (_definitions && _isOwningDefinitions)
     {
         delete _definitions;
@@ -270,6 +324,7 @@ void DataFramesFactory::init(DataFramesDefinitions *definitions)
 void DataFramesFactory::registerAtom(const QString &type,
                                      AbstractDataAtom *instance)
 {
+    clearLayouts();
     _registry.insert(type.toLower(), instance);
 }
 
@@ -6,9 +6,12 @@
 #include "DataFrameRawData.h"
 #include "DataAtoms.h"
 #include "DataFrames.h"
+#include "DataFramesPool.h"
 
 #include "../Utils/DataStream.h"
 
+#include <QReadWriteLock>
+
 namespace Threader {
 
 namespace Frames {
@@ -49,6 +52,13 @@ public:
     DataFrame::Ptr buildFrame(const QString &key) const;
     DataFrame::Ptr buildFrame(DataFrameDefinition::Ptr definition) const;
 
+    /**
+     * @brief setFramesPool - Подключение пула повторного использования фреймов
+     * @param pool - Пул или пустой указатель для отключения
+     */
+    void setFramesPool(const DataFramesPool::Ptr &pool);
+    DataFramesPool::Ptr framesPool() const;
+
     QString definitionsFileName() const;
     DataFramesDefinitions *definitions() const;
 
@@ -81,12 +91,35 @@ protected:
         return false;
     }
 private:
+    /**
+     * @brief FrameLayout - Заранее вычисленный состав атомов фрейма
+     */
+    struct FrameLayout
+    {
+        struct Atom
+        {
+            const AbstractDataAtom *Prototype;
+            const DataAtomDefinition *Definition;
+        };
+
+        // удерживает описание, чтобы его адрес не был переиспользован
+        DataFrameDefinition::Ptr Definition;
+        QVector<Atom> Atoms;
+    };
+
     AbstractDataAtom *buildAtom();
 
+    FrameLayout frameLayout(const DataFrameDefinition::Ptr &definition) const;
+    void clearLayouts();
+
     QString _definitionsFileName;
     DataFramesDefinitions *_definitions;
     bool _isOwningDefinitions;
     AtomsRegistry _registry;
+    DataFramesPool::Ptr _framesPool;
+
+    mutable QReadWriteLock _layoutsLock;
+    mutable QHash<const DataFrameDefinition*, FrameLayout> _layouts;
 };
 
 }}
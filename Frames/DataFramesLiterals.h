@@ -42,6 +42,16 @@ const QString TEMPLATE_SET_ARGUMENTS = QString("setArguments");
 const QString TEMPLATE_ASSIGN_ATOMS = QString("AssignAtoms");
 const QString TEMPLATE_FUNCTIONS = QString("Functions");
 
+const QString TEMPLATE_FRAME_WIRE_NAME = QString("FrameWireName");
+const QString TEMPLATE_NAME_SIZE = QString("NameSize");
+const QString TEMPLATE_CODECS = QString("Codecs");
+const QString TEMPLATE_CODEC_FIELDS = QString("CodecFields");
+const QString TEMPLATE_CODEC_OFFSETS = QString("CodecOffsets");
+const QString TEMPLATE_CODEC_CAPACITY = QString("CodecCapacity");
+const QString TEMPLATE_CODEC_SIZES = QString("CodecSizes");
+const QString TEMPLATE_CODEC_WRITES = QString("CodecWrites");
+const QString TEMPLATE_CODEC_READS = QString("CodecReads");
+
 const QString TEMPLATE_FRAME_CONSTANT = QString("extern const char FRAME_NAME_{{" + FRAME_NAME_UPPER +
                                                 "}}[];\r\n");
 
@@ -129,6 +139,182 @@ const QString TEMPLATE_IMPLEMENTATION_FILE = QString(
             "\r\n{{" + TEMPLATE_FRAME_NAMESPACE_CLOSE + "}}\r\n"
             );
 
+// Шаблоны типизированных кодеков фреймов
+
+const QString TEMPLATE_CODEC_FIELD = QString("\t{{{" + TEMPLATE_TYPE + "}}} {{" + TEMPLATE_ARGUMENT + "}};\r\n");
+
+const QString TEMPLATE_CODEC_OFFSET = QString(
+            "\tstatic constexpr int OFFSET_{{" + TEMPLATE_ATOM_NAME_UPPER + "}} = HEADER_SIZE + int(offsetof({{" +
+            FRAME_NAME + "}}Data, {{" + TEMPLATE_ARGUMENT + "}}));\r\n");
+
+const QString TEMPLATE_CODEC_VALUE_CAPACITY = QString(
+            "\t\tcapacity = qMax(capacity, uint32_t(data.{{" + TEMPLATE_ARGUMENT + "}}.size()));\r\n");
+
+const QString TEMPLATE_CODEC_VALUE_SIZE = QString("\t\tresult += atomSize(data.{{" + TEMPLATE_ARGUMENT + "}});\r\n");
+const QString TEMPLATE_CODEC_VALUES_SIZE = QString("\t\tresult += valuesSize(data.{{" + TEMPLATE_ARGUMENT + "}}, capacity);\r\n");
+
+const QString TEMPLATE_CODEC_VALUE_WRITE = QString("\t\tresult = result && stream.write(data.{{" + TEMPLATE_ARGUMENT + "}});\r\n");
+const QString TEMPLATE_CODEC_VALUES_WRITE = QString("\t\tresult = result && writeValues(stream, data.{{" + TEMPLATE_ARGUMENT + "}}, capacity);\r\n");
+
+const QString TEMPLATE_CODEC_VALUE_READ = QString("\t\tresult = result && stream.read(data.{{" + TEMPLATE_ARGUMENT + "}});\r\n");
+const QString TEMPLATE_CODEC_VALUES_READ = QString("\t\tresult = result && readValues(stream, data.{{" + TEMPLATE_ARGUMENT + "}}, capacity);\r\n");
+
+const QString TEMPLATE_CODEC_ARRAY_SIZE = QString("\t\tresult += FrameSizeType(sizeof(capacity));\r\n");
+const QString TEMPLATE_CODEC_ARRAY_WRITE = QString("\t\tresult = result && stream.write(capacity);\r\n");
+const QString TEMPLATE_CODEC_ARRAY_READ = QString(
+            "\t\tresult = result && stream.read(capacity) &&\r\n"
+            "\t\t\t\tcapacity <= uint32_t(stream.size() - stream.position());\r\n"
+            "\t\tcapacity = qMax(capacity, uint32_t(1));\r\n");
+
+const QString TEMPLATE_CODEC_FIXED = QString(
+            "// Фрейм {{" + TEMPLATE_FRAME_WIRE_NAME + "}}: фиксированная раскладка\r\n"
+            "#pragma pack(push, 1)\r\n"
+            "struct {{" + FRAME_NAME + "}}Data\r\n"
+            "{\r\n"
+            "{{{" + TEMPLATE_CODEC_FIELDS + "}}}"
+            "};\r\n"
+            "#pragma pack(pop)\r\n\r\n"
+            "struct {{" + FRAME_NAME + "}}Codec\r\n"
+            "{\r\n"
+            "\tstatic const char *name() { return \"{{" + TEMPLATE_FRAME_WIRE_NAME + "}}\"; }\r\n\r\n"
+            "\tstatic constexpr int NAME_SIZE = {{" + TEMPLATE_NAME_SIZE + "}};\r\n"
+            "\tstatic constexpr int HEADER_SIZE = int(sizeof(FrameSizeType)) + NAME_SIZE;\r\n"
+            "\tstatic constexpr int BODY_SIZE = int(sizeof({{" + FRAME_NAME + "}}Data));\r\n"
+            "\tstatic constexpr int WIRE_SIZE = HEADER_SIZE + BODY_SIZE;\r\n"
+            "\tstatic constexpr FrameSizeType FRAME_SIZE = FrameSizeType(NAME_SIZE + BODY_SIZE);\r\n\r\n"
+            "\t// Смещения значений от начала фрейма в потоке\r\n"
+            "{{{" + TEMPLATE_CODEC_OFFSETS + "}}}\r\n"
+            "\tstatic inline bool encode(const {{" + FRAME_NAME + "}}Data &data, DataStream &stream)\r\n"
+            "\t{\r\n"
+            "\t\tchar image[WIRE_SIZE];\r\n"
+            "\t\tFrameSizeType frameSize = FRAME_SIZE;\r\n"
+            "\t\tmemcpy(image, &frameSize, sizeof(frameSize));\r\n"
+            "\t\tmemcpy(image + sizeof(frameSize), name(), NAME_SIZE);\r\n"
+            "\t\tmemcpy(image + HEADER_SIZE, &data, BODY_SIZE);\r\n"
+            "\t\treturn stream.write(image, WIRE_SIZE);\r\n"
+            "\t}\r\n\r\n"
+            "\tstatic inline bool decode(DataStream &stream, {{" + FRAME_NAME + "}}Data &data)\r\n"
+            "\t{\r\n"
+            "\t\tif (stream.size() - stream.position() < WIRE_SIZE)\r\n"
+            "\t\t\treturn false;\r\n"
+            "\t\tconst char *image = stream.cursor();\r\n"
+            "\t\tFrameSizeType frameSize;\r\n"
+            "\t\tmemcpy(&frameSize, image, sizeof(frameSize));\r\n"
+            "\t\tif (FRAME_SIZE != frameSize ||\r\n"
+            "\t\t\t\t0 != qstrnicmp(image + sizeof(frameSize), name(), uint(NAME_SIZE)))\r\n"
+            "\t\t\treturn false;\r\n"
+            "\t\tmemcpy(&data, image + HEADER_SIZE, BODY_SIZE);\r\n"
+            "\t\tstream.setPosition(stream.position() + WIRE_SIZE);\r\n"
+            "\t\treturn true;\r\n"
+            "\t}\r\n"
+            "};\r\n\r\n");
+
+const QString TEMPLATE_CODEC_SEQUENTIAL = QString(
+            "// Фрейм {{" + TEMPLATE_FRAME_WIRE_NAME + "}}: последовательная раскладка\r\n"
+            "struct {{" + FRAME_NAME + "}}Data\r\n"
+            "{\r\n"
+            "{{{" + TEMPLATE_CODEC_FIELDS + "}}}"
+            "};\r\n\r\n"
+            "struct {{" + FRAME_NAME + "}}Codec\r\n"
+            "{\r\n"
+            "\tstatic const char *name() { return \"{{" + TEMPLATE_FRAME_WIRE_NAME + "}}\"; }\r\n\r\n"
+            "\tstatic constexpr int NAME_SIZE = {{" + TEMPLATE_NAME_SIZE + "}};\r\n\r\n"
+            "\tstatic inline uint32_t capacity(const {{" + FRAME_NAME + "}}Data &data)\r\n"
+            "\t{\r\n"
+            "\t\tuint32_t capacity = 1;\r\n"
+            "{{{" + TEMPLATE_CODEC_CAPACITY + "}}}"
+            "\t\tQ_UNUSED(data)\r\n"
+            "\t\treturn capacity;\r\n"
+            "\t}\r\n\r\n"
+            "\t// Размер совпадает с вычисляемым DataFrame::size()\r\n"
+            "\tstatic inline FrameSizeType frameSize(const {{" + FRAME_NAME + "}}Data &data)\r\n"
+            "\t{\r\n"
+            "\t\tuint32_t capacity = {{" + FRAME_NAME + "}}Codec::capacity(data);\r\n"
+            "\t\tFrameSizeType result = NAME_SIZE;\r\n"
+            "{{{" + TEMPLATE_CODEC_SIZES + "}}}"
+            "\t\tQ_UNUSED(capacity)\r\n"
+            "\t\treturn result;\r\n"
+            "\t}\r\n\r\n"
+            "\tstatic inline bool encode(const {{" + FRAME_NAME + "}}Data &data, DataStream &stream)\r\n"
+            "\t{\r\n"
+            "\t\tuint32_t capacity = {{" + FRAME_NAME + "}}Codec::capacity(data);\r\n"
+            "\t\tFrameSizeType size = frameSize(data);\r\n"
+            "\t\tbool result = stream.write(size) &&\r\n"
+            "\t\t\t\tstream.write(name(), NAME_SIZE);\r\n"
+            "{{{" + TEMPLATE_CODEC_WRITES + "}}}"
+            "\t\tQ_UNUSED(capacity)\r\n"
+            "\t\treturn result;\r\n"
+            "\t}\r\n\r\n"
+            "\tstatic inline bool decode(DataStream &stream, {{" + FRAME_NAME + "}}Data &data)\r\n"
+            "\t{\r\n"
+            "\t\tint frameStart = stream.position();\r\n"
+            "\t\tFrameSizeType size = 0;\r\n"
+            "\t\tQString frameName;\r\n"
+            "\t\tuint32_t capacity = 1;\r\n"
+            "\t\tbool result = stream.read(size) &&\r\n"
+            "\t\t\t\tstream.read(frameName) &&\r\n"
+            "\t\t\t\t0 == frameName.compare(QLatin1String(name()), Qt::CaseInsensitive);\r\n"
+            "{{{" + TEMPLATE_CODEC_READS + "}}}"
+            "\t\t// как и DataFramesFactory::readFrame, позиция выставляется по размеру фрейма\r\n"
+            "\t\tif (result)\r\n"
+            "\t\t\tstream.setPosition(frameStart + int(size) + int(sizeof(size)));\r\n"
+            "\t\telse\r\n"
+            "\t\t\tstream.setPosition(frameStart);\r\n"
+            "\t\tQ_UNUSED(capacity)\r\n"
+            "\t\treturn result;\r\n"
+            "\t}\r\n"
+            "};\r\n\r\n");
+
+const QString TEMPLATE_CODEC_FILE = QString(
+            "// Этот файл создан автоматически.\r\n\r\n"
+            "#pragma once\r\n"
+            "#include \"../../Threader/Frames/DataFramesCommon.h\"\r\n"
+            "#include \"../../Threader/Utils/DataStream.h\"\r\n\r\n"
+            "#include <QVector>\r\n\r\n"
+            "#include <cstddef>\r\n"
+            "#include <cstring>\r\n\r\n"
+            "namespace {{" + TEMPLATE_PROJECT_NAME + "}}DataFramesCodec\r\n"
+            "{\r\n"
+            "using Threader::Frames::FrameSizeType;\r\n"
+            "using Threader::Utils::DataStream;\r\n\r\n"
+            "// Размер значения, учитываемый в размере фрейма так же, как в атомах\r\n"
+            "template<typename T> inline FrameSizeType atomSize(const T &value)\r\n"
+            "{\r\n"
+            "\treturn FrameSizeType(DataStream::valueSize(value));\r\n"
+            "}\r\n\r\n"
+            "inline FrameSizeType atomSize(const QString &value)\r\n"
+            "{\r\n"
+            "\treturn FrameSizeType(value.length() + 1);\r\n"
+            "}\r\n\r\n"
+            "// Недостающие до емкости фрейма значения массива дополняются значениями по умолчанию\r\n"
+            "template<typename T> inline FrameSizeType valuesSize(const QVector<T> &values, uint32_t capacity)\r\n"
+            "{\r\n"
+            "\tFrameSizeType result = 0;\r\n"
+            "\tT empty = T();\r\n"
+            "\tfor (uint32_t i = 0; i < capacity; i++)\r\n"
+            "\t\tresult += atomSize(i < uint32_t(values.size()) ? values.at(int(i)) : empty);\r\n"
+            "\treturn result;\r\n"
+            "}\r\n\r\n"
+            "template<typename T> inline bool writeValues(DataStream &stream, const QVector<T> &values, uint32_t capacity)\r\n"
+            "{\r\n"
+            "\tT empty = T();\r\n"
+            "\tfor (uint32_t i = 0; i < capacity; i++)\r\n"
+            "\t\tif (!stream.write(i < uint32_t(values.size()) ? values.at(int(i)) : empty))\r\n"
+            "\t\t\treturn false;\r\n"
+            "\treturn true;\r\n"
+            "}\r\n\r\n"
+            "template<typename T> inline bool readValues(DataStream &stream, QVector<T> &values, uint32_t capacity)\r\n"
+            "{\r\n"
+            "\tvalues.resize(int(capacity));\r\n"
+            "\tfor (uint32_t i = 0; i < capacity; i++)\r\n"
+            "\t\tif (!stream.read(values[int(i)]))\r\n"
+            "\t\t\treturn false;\r\n"
+            "\treturn true;\r\n"
+            "}\r\n\r\n"
+            "{{{" + TEMPLATE_CODECS + "}}}"
+            "}\r\n"
+            );
+
 const QString DataFramesUsing = "using namespace Threader::Frames;\r\n";
 const QString NS_Format = "namespace %1 {\r\n\r\n";
 const QString ConstNSUsing = "using namespace ";
@@ -1,6 +1,7 @@
 #include "DataFramesPackets.h"
 
 #include "../Utils/CrcUtils.h"
+#include "../Utils/SlabAllocator.h"
 
 namespace Threader {
 
@@ -86,6 +87,7 @@ int QueueDataFramesPackets::enqueue(const DataFramesPacket::Ptr &packet)
         return -1;
 
     _packets.append(packet);
+    _idsCount[packet->packetId()]++;
     return _packets.count();
 }
 
@@ -99,17 +101,49 @@ DataFramesPacket::Ptr QueueDataFramesPackets::first()
     return nullptr;
 }
 
+DataFramesPacket::Ptr QueueDataFramesPackets::at(int index)
+{
+    if (index >= 0 && index < _packets.count())
+        return _packets.at(index);
+    return nullptr;
+}
+
+void QueueDataFramesPackets::setPacketId(int index, const PacketIdType &packetId)
+{
+    if (index < 0 || index >= _packets.count())
+        return;
+
+    DataFramesPacket::Ptr packet = _packets.at(index);
+    auto idCount = _idsCount.find(packet->packetId());
+    if (idCount != _idsCount.end() && --idCount.value() <= 0)
+        _idsCount.erase(idCount);
+
+    packet->setPacketId(packetId);
+    _idsCount[packetId]++;
+}
+
 int QueueDataFramesPackets::applyTicket(const PacketIdType &packetId)
 {
+    // квитанции на неизвестные и уже подтвержденные номера не требуют просмотра очереди
+    auto idCount = _idsCount.find(packetId);
+    if (idCount == _idsCount.end())
+        return 0;
+
+    // отправленные пакеты находятся в начале очереди, поэтому просмотр
+    // с начала ограничен окном отправки и завершается на последнем пакете с номером
+    int left = idCount.value();
+    _idsCount.erase(idCount);
+
     int count = 0;
-    for (int i = _packets.count() - 1; i >= 0; i--)
+    for (int i = 0; i < _packets.count() && count < left; )
     {
-        DataFramesPacket::Ptr packet = _packets.at(i);
-        if (packet->packetId() == packetId)
+        if (_packets.at(i)->packetId() == packetId)
         {
             _packets.remove(i);
             count++;
         }
+        else
+            i++;
     }
     return count;
 }
@@ -118,11 +152,16 @@ void QueueDataFramesPackets::reset()
 {
     for (auto packet: _packets)
         packet->setPacketId(0);
+
+    _idsCount.clear();
+    if (!_packets.isEmpty())
+        _idsCount.insert(0, _packets.count());
 }
 
 void QueueDataFramesPackets::clear()
 {
     _packets.clear();
+    _idsCount.clear();
 }
 
 int QueueDataFramesPackets::count()
@@ -138,49 +177,61 @@ DataFramesPacketFactory::DataFramesPacketFactory()
 }
 
 PacketBase::Ptr DataFramesPacketFactory::tryExtractPacket(QByteArray &data)
+{
+    int position = 0;
+    PacketBase::Ptr result = tryExtractPacket(data, position);
+
+    // удаление прочитанных данных
+    if (position > 0)
+        data.remove(0, position);
+    return result;
+}
+
+PacketBase::Ptr DataFramesPacketFactory::tryExtractPacket(QByteArray &data, int &position)
 {
     DataFramesPacketHeader header;
-    uint dataCount = 0;
+    const int dataCount = data.count();
+    const int headerSize = int(sizeof(header));
 
     // выделение заголовка пакета
     while (true)
     {
-        // поиск начала пакета
-        int headerPosition = data.indexOf("\0x5A\0x5A");
+        // поиск метки начала пакета от позиции чтения
+        int headerPosition = data.indexOf(DATAFRAMES_PACKET_TAG_ARRAY, position);
         if (headerPosition < 0)
         {
+            // мусор пропускается, кроме последнего байта, который может быть началом метки
+            if (dataCount > position)
+                position = (DATAFRAMES_PACKET_TAG_ARRAY.at(0) == data.at(dataCount - 1))
+                        ? dataCount - 1 : dataCount;
             setLastResult(int(DataFramesFactoryResults::HeaderNotFound));
             return nullptr;
         }
 
-        // удаление мусора в начале данных
-        if (headerPosition > 0)
-            data.remove(0, headerPosition);
-
-        dataCount = uint(data.count());
+        // пропуск мусора в начале данных
+        position = headerPosition;
 
         // проверка возможности чтения заголовка
-        if (dataCount < sizeof(DataFramesPacketHeader))
+        if (dataCount - position < headerSize)
         {
             setLastResult(int(DataFramesFactoryResults::NotEnoughForHeader));
             return nullptr;
         }
 
-        header = *(reinterpret_cast<DataFramesPacketHeader*>(const_cast<char*>(data.constData())));
+        header = *(reinterpret_cast<const DataFramesPacketHeader*>(data.constData() + position));
 
         // проверка допустимых типов пакета
         if (header.packetType >= PacketType::MaximumValue)
         {
             // если тип пакета недопустимый, то повторный поиск заголовка
-            data.remove(0, 1);
+            position++;
         } else
             // иначе разбор пакета продолжается
             break;
     }
 
     // проверка полного приема пакета
-    auto headerSize = sizeof(header);
-    if (dataCount < headerSize + header.length)
+    if (quint64(dataCount - position) < quint64(headerSize) + header.length)
     {
         setLastResult(int(DataFramesFactoryResults::NotEnoughForBody));
         return nullptr;
@@ -188,18 +239,25 @@ PacketBase::Ptr DataFramesPacketFactory::tryExtractPacket(QByteArray &data)
 
     // проверка контрольной суммы
     uchar* dataPointer = reinterpret_cast<uchar*>(const_cast<char*>(data.constData()))
-            + sizeof(header);
+            + position + headerSize;
     const auto receivedCrc = CrcUtils::Crc16(dataPointer,
                                              static_cast<int>(header.length));
     if (receivedCrc != header.checkSumm)
     {
+        // метка могла оказаться в мусоре, поиск продолжается со следующего байта
+        position++;
         setLastResult(int(DataFramesFactoryResults::BadCheckSumm));
+        countChecksumError();
         return nullptr;
     }
 
     // всё прошло успешно, формирование пакета
-    DataFramesPacket::Ptr result = std::make_shared<DataFramesPacket>(header, reinterpret_cast<char*>(dataPointer), header.length);
-    data.remove(0, static_cast<int>(sizeof(header) + header.length));
+    // данные копируются в пакет: ссылка на часть буфера чтения без копирования
+    // заставила бы буфер копироваться целиком при каждом сжатии после разбора
+    // и при каждом чтении в его конец, а пакет передается другим потокам
+    // и живет дольше буфера, поэтому данные копируются один раз при извлечении
+    DataFramesPacket::Ptr result = Utils::makeSlabShared<DataFramesPacket>(header, reinterpret_cast<char*>(dataPointer), header.length);
+    position += headerSize + static_cast<int>(header.length);
     return result;
 }
 
@@ -221,7 +279,7 @@ PacketBase::Ptr DataFramesPacketFactory::buildPacket(const QByteArray &data,
                                   CrcUtils::Crc16(reinterpret_cast<uchar*>(const_cast<char*>(data.constData())), data.length()),
                                   packetId);
 
-    return std::make_shared<DataFramesPacket>(header, data.constData(), data.length());
+    return Utils::makeSlabShared<DataFramesPacket>(header, data.constData(), data.length());
 }
 
 PacketBase::Ptr DataFramesPacketFactory::buildPacketFromFrame(DataFrame::Ptr frame,
@@ -251,7 +309,7 @@ PacketBase::Ptr DataFramesPacketFactory::buildPacketTicket(PacketIdType &packetI
                                   CrcUtils::Crc16(reinterpret_cast<uchar*>(&packetId), sizeof(packetId)),
                                   generateNextPacketId());
 
-    return std::make_shared<DataFramesPacket>(header, reinterpret_cast<char*>(&packetId), (PacketSizeType)sizeof(packetId));
+    return Utils::makeSlabShared<DataFramesPacket>(header, reinterpret_cast<char*>(&packetId), (PacketSizeType)sizeof(packetId));
 }
 
 }}
@@ -6,6 +6,7 @@
 
 #include "../Threads/PacketFactoryBase.h"
 
+#include <QHash>
 #include <QMap>
 #include <QVector>
 
@@ -30,7 +31,8 @@ using PacketIdType = uint32_t;
 using PacketSizeType = uint32_t;
 
 const uint16_t DATAFRAMES_PACKET_TAG = 0x5A5A;
-const QByteArray DATAFRAMES_PACKET_TAG_ARRAY = {0x5A, 0x5A};
+// длина задается явно: {0x5A, 0x5A} создает массив из 90 символов 'Z'
+const QByteArray DATAFRAMES_PACKET_TAG_ARRAY("\x5A\x5A", 2);
 
 const PacketIdType PACKET_ID_EMPTY = 0;
 
@@ -105,6 +107,16 @@ public:
 
     DataFramesPacket::Ptr first();
 
+    DataFramesPacket::Ptr at(int index);
+
+    /**
+     * @brief setPacketId - Установка номера пакету очереди
+     * Номера пакетов в очереди изменяются только через очередь, иначе квитанция не найдет пакет
+     * @param index - Индекс пакета
+     * @param packetId - Номер пакета
+     */
+    void setPacketId(int index, const PacketIdType &packetId);
+
     int applyTicket(const PacketIdType &packetId);
 
     void reset();
@@ -114,6 +126,11 @@ public:
     int count();
 private:
     VectorDataFramesPacket _packets;
+
+    /**
+     * @brief _idsCount - Количество пакетов очереди с каждым номером
+     */
+    QHash<PacketIdType, int> _idsCount;
 };
 
 enum class DataFramesFactoryResults
@@ -130,6 +147,7 @@ public:
     explicit DataFramesPacketFactory();
 
     PacketBase::Ptr tryExtractPacket(QByteArray &data) override;
+    PacketBase::Ptr tryExtractPacket(QByteArray &data, int &position) override;
 
     uint32_t generateNextPacketId();
 
@@ -0,0 +1,99 @@
+#include "DataFramesPool.h"
+
+#include <QMutexLocker>
+
+namespace Threader {
+
+namespace Frames {
+
+
+DataFramesPool::DataFramesPool(int limit)
+    : _limit(qMax(limit, 1))
+    , _count(0)
+    , _hits(0)
+    , _misses(0)
+{
+}
+
+DataFramesPool::~DataFramesPool()
+{
+    clear();
+}
+
+DataFrame::Ptr DataFramesPool::take(const DataFrameDefinition::Ptr &definition)
+{
+    DataFrame *frame = nullptr;
+    {
+        QMutexLocker locker(&_mutex);
+        auto iterator = _frames.find(definition.get());
+        if (iterator != _frames.end() && !iterator->isEmpty())
+        {
+            frame = iterator->takeLast();
+            _count--;
+            _hits++;
+        }
+        else
+            _misses++;
+    }
+
+    if (!frame)
+        return DataFrame::Ptr();
+    return wrap(frame);
+}
+
+DataFrame::Ptr DataFramesPool::wrap(DataFrame *frame)
+{
+    // пул удерживается фреймами до возврата последнего из них
+    Ptr pool = shared_from_this();
+    return DataFrame::Ptr(frame, [pool](DataFrame *released) {
+        pool->recycle(released);
+    });
+}
+
+int DataFramesPool::count() const
+{
+    QMutexLocker locker(&_mutex);
+    return _count;
+}
+
+void DataFramesPool::clear()
+{
+    QMutexLocker locker(&_mutex);
+    foreach (const QVector<DataFrame*> &frames, _frames)
+        qDeleteAll(frames);
+    _frames.clear();
+    _count = 0;
+}
+
+qint64 DataFramesPool::hits() const
+{
+    QMutexLocker locker(&_mutex);
+    return _hits;
+}
+
+qint64 DataFramesPool::misses() const
+{
+    QMutexLocker locker(&_mutex);
+    return _misses;
+}
+
+void DataFramesPool::recycle(DataFrame *frame)
+{
+    // сброс выполняется вне блокировки
+    frame->reset();
+
+    {
+        QMutexLocker locker(&_mutex);
+        QVector<DataFrame*> &frames = _frames[frame->definition().get()];
+        if (frames.count() < _limit)
+        {
+            frames.append(frame);
+            _count++;
+            return;
+        }
+    }
+
+    delete frame;
+}
+
+}}
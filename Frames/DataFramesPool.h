@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include "DataFrames.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include <memory>
+
+namespace Threader {
+
+namespace Frames {
+
+/**
+ * @brief DataFramesPool - Пул повторного использования фреймов
+ * Фреймы, выданные фабрикой с подключенным пулом, при освобождении последней
+ * ссылки не удаляются, а сбрасываются и возвращаются в пул вместе с атомами
+ * и их буферами значений. Повторная выдача фрейма того же описания не требует
+ * выделения памяти под фрейм, вектор атомов и сами атомы.
+ * Фреймы могут освобождаться в любом потоке, поэтому списки пула защищены мьютексом.
+ */
+class THREADERSHARED_EXPORT DataFramesPool : public std::enable_shared_from_this<DataFramesPool>
+{
+public:
+    using Ptr = std::shared_ptr<DataFramesPool>;
+
+public:
+    /**
+     * @brief DataFramesPool - Конструктор
+     * @param limit - Максимальное количество хранимых фреймов одного описания
+     */
+    explicit DataFramesPool(int limit = 64);
+    ~DataFramesPool();
+
+    DataFramesPool(const DataFramesPool &) = delete;
+    DataFramesPool &operator=(const DataFramesPool &) = delete;
+
+    /**
+     * @brief take - Получение свободного фрейма из пула
+     * @param definition - Описание фрейма
+     * @return - Фрейм, обернутый в указатель с возвратом в пул, или пустой указатель
+     */
+    DataFrame::Ptr take(const DataFrameDefinition::Ptr &definition);
+
+    /**
+     * @brief wrap - Передача нового фрейма под управление пула
+     * @param frame - Фрейм
+     * @return - Указатель, возвращающий фрейм в пул при освобождении
+     */
+    DataFrame::Ptr wrap(DataFrame *frame);
+
+    /**
+     * @brief count - Получение количества свободных фреймов в пуле
+     * @return - Количество фреймов
+     */
+    int count() const;
+
+    /**
+     * @brief clear - Удаление всех свободных фреймов пула
+     */
+    void clear();
+
+    qint64 hits() const;
+    qint64 misses() const;
+
+private:
+    /**
+     * @brief recycle - Возврат освобожденного фрейма в пул
+     * @param frame - Фрейм
+     */
+    void recycle(DataFrame *frame);
+
+    mutable QMutex _mutex;
+    QHash<const DataFrameDefinition*, QVector<DataFrame*>> _frames;
+    int _limit;
+    int _count;
+    qint64 _hits;
+    qint64 _misses;
+};
+
+}}
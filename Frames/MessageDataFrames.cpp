@@ -1,5 +1,7 @@
 #include "MessageDataFrames.h"
 
+#include "../Threads/MessageTypes.h"
+
 namespace Threader {
 
 namespace Frames {
@@ -7,10 +9,13 @@ namespace Frames {
 
 const QString MessageDataFrame::MESSAGE_NAME_DATA_FRAME  = "Message.DataFrame";
 
+const int MessageDataFrame::TYPE_ID = MessageTypes::registerType("MessageDataFrame");
+
 MessageDataFrame::MessageDataFrame(const DataFrame::Ptr &frame)
                     : MessageBase(MESSAGE_NAME_DATA_FRAME)
                     , _frame(frame)
 {
+    setTypeId(TYPE_ID);
 }
 
 DataFrame::Ptr MessageDataFrame::frame() const
@@ -21,12 +26,16 @@ DataFrame::Ptr MessageDataFrame::frame() const
 
 const QString MessageDataFrames::MESSAGE_NAME_DATAFRAMES = "Message.DataFrames";
 
+const int MessageDataFrames::TYPE_ID = MessageTypes::registerType("MessageDataFrames");
+
 MessageDataFrames::MessageDataFrames(const QString &alias,
                                      const DataFrameRawDataList &list)
                     : MessageBase(MESSAGE_NAME_DATAFRAMES)
                     , _alias(alias)
                     , _list(list)
 {
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Bulk);
 }
 
 MessageDataFrames::MessageDataFrames(const QString &alias,
@@ -34,6 +43,8 @@ MessageDataFrames::MessageDataFrames(const QString &alias,
                     : MessageBase(MESSAGE_NAME_DATAFRAMES)
                     , _alias(alias)
 {
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Bulk);
     _list.append(frame);
 }
 
@@ -24,6 +24,7 @@ class THREADERSHARED_EXPORT MessageDataFrame : public MessageBase
 public:
     using Ptr = std::shared_ptr<MessageDataFrame>;
     static const QString MESSAGE_NAME_DATA_FRAME;
+    static const int TYPE_ID;
 
 public:
     explicit MessageDataFrame(const DataFrame::Ptr &frame);
@@ -43,6 +44,8 @@ public:
     using Ptr = std::shared_ptr<MessageDataFrames>;
 
 public:
+    static const int TYPE_ID;
+
     static const QString MESSAGE_NAME_DATAFRAMES;
 
     explicit MessageDataFrames(const QString &alias, const DataFrameRawDataList &list);
@@ -1,5 +1,7 @@
 #include "MessageQueue.h"
 
+#include "../Threads/MessageTypes.h"
+
 namespace Threader {
 
 namespace Frames {
@@ -8,11 +10,15 @@ namespace Frames {
 const QString MessageQueue::MESSAGE_NAME = "Message.Queue";
 
 
+const int MessageQueue::TYPE_ID = MessageTypes::registerType("MessageQueue");
+
 MessageQueue::MessageQueue(const QueueDataFrames *queue, const QString &alias)
     : MessageBase(MESSAGE_NAME)
     , _queue(queue)
     , _alias(alias)
 {
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Control);
 }
 
 const QueueDataFrames *MessageQueue::queue() const
@@ -21,6 +21,8 @@ public:
     using Ptr = std::shared_ptr<MessageQueue>;
 
 public:
+    static const int TYPE_ID;
+
 
     static const QString MESSAGE_NAME;
 
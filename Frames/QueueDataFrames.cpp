@@ -2,6 +2,8 @@
 
 #include "MessageQueue.h"
 
+#include "../Utils/SlabAllocator.h"
+
 namespace Threader {
 
 namespace Frames {
@@ -252,7 +254,7 @@ void QueueDataFrames::notifyThreadQueueChanged()
 {
     if (nullptr != _thread)
     {
-        _thread->postMessage(std::make_shared<MessageQueue>(this, _alias));
+        _thread->postMessage(Utils::makeSlabShared<MessageQueue>(this, _alias));
     }
 }
 
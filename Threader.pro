@@ -12,6 +12,9 @@ DEFINES += THREADER_LIBRARY
 
 DEFINES += QT_DEPRECATED_WARNINGS
 
+# учет времени ожидания и обработки сообщений исключается из сборки:
+# DEFINES += THREADER_NO_MESSAGE_TIMING
+
 SOURCES += \
         Frames/DataAtoms.cpp \
         Frames/DataFrameRawData.cpp \
@@ -21,23 +24,34 @@ SOURCES += \
         Frames/DataFramesFactory.cpp \
         Frames/DataFramesMask.cpp \
         Frames/DataFramesPackets.cpp \
+        Frames/DataFramesPool.cpp \
         Frames/MessageDataFrames.cpp \
         Frames/MessageQueue.cpp \
         Frames/QueueDataFrames.cpp \
         ThirdParty/mustache/mustache.cpp \
+        Threads/BinaryLog.cpp \
         Threads/HandlerBase.cpp \
         Threads/HandlerSerialPort.cpp \
         Threads/HandlerTcpSocket.cpp \
         Threads/HandlerUdpSocket.cpp \
+        Threads/InboxLimiter.cpp \
         Threads/ListThreads.cpp \
+        Threads/LogConsoleSink.cpp \
+        Threads/LogFileWriter.cpp \
+        Threads/LogRateLimiter.cpp \
+        Threads/LogSettings.cpp \
         Threads/MessageBase.cpp \
         Threads/MessageBinary.cpp \
+        Threads/MessageDispatcher.cpp \
         Threads/MessageLog.cpp \
         Threads/MessageObject.cpp \
         Threads/MessageString.cpp \
         Threads/MessageThread.cpp \
         Threads/MessageTimer.cpp \
+        Threads/MessageTypes.cpp \
         Threads/MessageWriteToFile.cpp \
+        Threads/MessagesOutbox.cpp \
+        Threads/MetricsSettings.cpp \
         Threads/PacketFactoryAsciiLines.cpp \
         Threads/PacketFactoryBase.cpp \
         Threads/PollerListenSocket.cpp \
@@ -50,13 +64,23 @@ SOURCES += \
         Threads/ThreadListenSocket.cpp \
         Threads/ThreadLogs.cpp \
         Threads/ThreadMainDaemon.cpp \
-        Threads/ThreadTimer.cpp \
+        Threads/ThreadMetricsConnection.cpp \
+        Threads/ThreadMetricsServer.cpp \
+        Threads/ThreadPlacement.cpp \
+        Threads/ThreadReactor.cpp \
+        Threads/TimerWheel.cpp \
         Threads/WriterLogs.cpp \
         Utils/CrcUtils.cpp \
+        Utils/CycleClock.cpp \
         Utils/DataStream.cpp \
         Utils/DateUtils.cpp \
         Utils/IpMask.cpp \
+        Utils/LoopClock.cpp \
+        Utils/Metrics.cpp \
+        Utils/RttEstimator.cpp \
         Utils/SerialUtils.cpp \
+        Utils/ShardedCounter.cpp \
+        Utils/SlabAllocator.cpp \
         Utils/SocketUtils.cpp \
         Utils/TrafficCounter.cpp
 
@@ -70,10 +94,12 @@ HEADERS += \
     Frames/DataFramesLiterals.h \
     Frames/DataFramesMask.h \
     Frames/DataFramesPackets.h \
+    Frames/DataFramesPool.h \
     Frames/MessageDataFrames.h \
     Frames/MessageQueue.h \
     Frames/QueueDataFrames.h \
     ThirdParty/mustache/mustache.h \
+    Threads/BinaryLog.h \
     Threads/DaemonApplication.h \
     Threads/HandlerSerialPort.h \
     Threads/HandlerUdpSocket.h \
@@ -86,15 +112,24 @@ HEADERS += \
     Threads/ThreadsCommon.h \
     Threads/HandlerBase.h \
     Threads/HandlerTcpSocket.h \
+    Threads/InboxLimiter.h \
     Threads/ListThreads.h \
+    Threads/LogConsoleSink.h \
+    Threads/LogFileWriter.h \
     Threads/LogMessagesTemplates.h \
+    Threads/LogRateLimiter.h \
+    Threads/LogSettings.h \
     Threads/MessageBase.h \
     Threads/MessageBinary.h \
+    Threads/MessageDispatcher.h \
     Threads/MessageLog.h \
     Threads/MessageObject.h \
     Threads/MessageString.h \
     Threads/MessageTimer.h \
+    Threads/MessageTypes.h \
     Threads/MessageWriteToFile.h \
+    Threads/MessagesOutbox.h \
+    Threads/MetricsSettings.h \
     Threads/PacketFactoryBase.h \
     Threads/PollerListenSocket.h \
     Threads/PollerThread.h \
@@ -104,12 +139,22 @@ HEADERS += \
     Threads/ThreadListenSocket.h \
     Threads/ThreadLogs.h \
     Threads/ThreadMainDaemon.h \
-    Threads/ThreadTimer.h \
+    Threads/ThreadMetricsConnection.h \
+    Threads/ThreadMetricsServer.h \
+    Threads/ThreadPlacement.h \
+    Threads/ThreadReactor.h \
+    Threads/TimerWheel.h \
     Threads/WriterLogs.h \
     Utils/CrcUtils.h \
+    Utils/CycleClock.h \
     Utils/DataStream.h \
     Utils/DateUtils.h \
+    Utils/LoopClock.h \
+    Utils/Metrics.h \
+    Utils/RttEstimator.h \
     Utils/SerialUtils.h \
+    Utils/ShardedCounter.h \
+    Utils/SlabAllocator.h \
     Utils/SocketUtils.h \
     Utils/TrafficCounter.h
 
@@ -118,4 +163,5 @@ win32:SOURCES += Threads/PollingsWindows.cpp
 unix:HEADERS += Threads/PollingsLinux.h Utils/PosixHandler.h
 win32:HEADERS += Threads/PollingsWindows.h
 
+unix: LIBS += -lz
 win32: LIBS += -lws2_32 -lpsapi
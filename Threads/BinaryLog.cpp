@@ -0,0 +1,831 @@
+#include "BinaryLog.h"
+
+#include "ThreadBase.h"
+
+#include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
+
+#include <QByteArray>
+#include <QMultiHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Threader {
+
+namespace Threads {
+
+
+using namespace Threader::Utils;
+
+
+namespace {
+
+// размер кольцевого буфера потока (степень двойки)
+const quint64 RING_SIZE = 64 * 1024;
+// максимальное время ожидания места в переполненном буфере, после чего запись теряется;
+// ограничение не дает потоку реального времени бесконечно вытеснять поток протоколирования
+const qint64 OVERFLOW_WAIT_NANOSECONDS = 2 * 1000 * 1000;
+// максимальный размер записи, записи большего размера отправляются обычным путем
+const int RECORD_MAXIMUM_SIZE = 4096;
+// размер ячейки значения аргумента
+const int VALUE_SIZE = 8;
+// максимальная длина строкового аргумента в байтах
+const quint32 STRING_MAXIMUM_LENGTH = 1024;
+// длина, обозначающая пустой указатель на строку
+const quint32 STRING_NULL = 0xFFFFFFFF;
+// идентификатор записи-заполнителя до конца кольцевого буфера
+const quint32 TEMPLATE_PADDING = 0xFFFFFFFF;
+// идентификатор записи с текстом, отформатированным потоком-источником
+const quint32 TEMPLATE_TEXT = 0x80000000;
+// максимальное количество шаблонов в каталоге
+const int TEMPLATES_MAXIMUM_COUNT = 4096;
+// максимальный размер кеша шаблонов потока
+const int TEMPLATES_CACHE_MAXIMUM_SIZE = 1024;
+
+/**
+ * @brief ArgumentKind - Способ извлечения аргумента из списка аргументов
+ */
+enum class ArgumentKind : quint8
+{
+    None,
+    Int,
+    Long,
+    LongLong,
+    IntMax,
+    Size,
+    PtrDiff,
+    Double,
+    LongDouble,
+    String,
+    Pointer
+};
+
+/**
+ * @brief FormatSegment - Фрагмент строки формата: текст и не более одного преобразования
+ */
+struct FormatSegment
+{
+    QByteArray Format;
+    int StarsCount = 0;
+    ArgumentKind Kind = ArgumentKind::None;
+};
+
+/**
+ * @brief TemplateEntry - Разобранный шаблон сообщения каталога
+ */
+struct TemplateEntry
+{
+    quint32 Id;
+    int Number;
+    int Level;
+    MessageType Type;
+    // копия удерживает данные текста шаблона, поэтому их адрес служит ключом поиска
+    QString Text;
+    QByteArray Format;
+    QVector<FormatSegment> Segments;
+    bool IsSupported;
+};
+
+/**
+ * @brief RecordHeader - Заголовок записи кольцевого буфера
+ * За заголовком следуют значения аргументов по 8 байт, строки записываются
+ * длиной (4 байта) и байтами с завершающим нулем с выравниванием до 8 байт
+ */
+struct RecordHeader
+{
+    quint32 Size;
+    quint32 TemplateId;
+    qint64 TickCount;
+};
+
+quint32 alignRecord(quint32 size)
+{
+    return (size + VALUE_SIZE - 1) & ~quint32(VALUE_SIZE - 1);
+}
+
+/**
+ * @brief Ring - Кольцевой буфер записей одного потока (один писатель, один читатель)
+ * Положения головы и хвоста растут монотонно, запись всегда располагается
+ * непрерывно: остаток буфера перед переходом в начало занимает заполнитель
+ */
+class Ring
+{
+public:
+    /**
+     * @brief push - Запись в буфер, вызывается только потоком-владельцем
+     * @param record - Запись
+     * @param size - Размер записи, кратный 8
+     * @param wasEmpty - Признак того, что читатель извлек все предыдущие записи
+     * @return - Признак записи, false при нехватке места
+     */
+    bool push(const char *record, quint32 size, bool &wasEmpty)
+    {
+        quint64 head = _head.load(std::memory_order_relaxed);
+        quint64 position = head & (RING_SIZE - 1);
+        quint64 tailRoom = RING_SIZE - position;
+        quint64 required = (size <= tailRoom) ? size : tailRoom + size;
+
+        if (head + required - _cachedTail > RING_SIZE)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head + required - _cachedTail > RING_SIZE)
+                return false;
+        }
+
+        if (size > tailRoom)
+        {
+            quint32 padding[2] = {quint32(tailRoom), TEMPLATE_PADDING};
+            memcpy(_data + position, padding, sizeof(padding));
+            position = 0;
+        }
+        memcpy(_data + position, record, size);
+
+        // публикация записи и проверка хвоста упорядочены с сохранением хвоста
+        // и чтением головы читателем, поэтому пробуждение не теряется
+        _head.store(head + required, std::memory_order_seq_cst);
+        wasEmpty = (_tail.load(std::memory_order_seq_cst) == head);
+        return true;
+    }
+
+    /**
+     * @brief drain - Извлечение опубликованных записей, вызывается только читателем
+     * @param handler - Обработчик записи
+     * @return - Признак появления новых записей во время извлечения
+     */
+    template <typename Handler>
+    bool drain(const Handler &handler)
+    {
+        quint64 tail = _tail.load(std::memory_order_relaxed);
+        quint64 head = _head.load(std::memory_order_acquire);
+        if (head == tail)
+            return false;
+
+        while (tail != head)
+        {
+            const char *record = _data + (tail & (RING_SIZE - 1));
+            quint32 header[2];
+            memcpy(header, record, sizeof(header));
+            if (TEMPLATE_PADDING != header[1])
+                handler(record);
+            tail += header[0];
+        }
+        _tail.store(tail, std::memory_order_seq_cst);
+
+        return _head.load(std::memory_order_seq_cst) != tail;
+    }
+
+    bool isEmpty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> Orphaned{false};
+
+private:
+    alignas(64) std::atomic<quint64> _head{0};
+    quint64 _cachedTail = 0;
+    alignas(64) std::atomic<quint64> _tail{0};
+    alignas(64) char _data[RING_SIZE];
+};
+
+/**
+ * @brief RingsRegistry - Буферы всех потоков, записывавших в журнал
+ */
+struct RingsRegistry
+{
+    QMutex Mutex;
+    std::vector<std::shared_ptr<Ring>> Rings;
+    std::atomic<int> Generation{0};
+};
+
+RingsRegistry &ringsRegistry()
+{
+    static RingsRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief RingHolder - Буфер текущего потока, при завершении потока буфер
+ * помечается брошенным и удаляется читателем после извлечения записей
+ */
+struct RingHolder
+{
+    std::shared_ptr<Ring> Value;
+
+    ~RingHolder()
+    {
+        if (Value)
+            Value->Orphaned.store(true, std::memory_order_release);
+    }
+};
+
+thread_local RingHolder currentRingHolder;
+
+Ring *currentRing()
+{
+    if (!currentRingHolder.Value)
+    {
+        currentRingHolder.Value = std::make_shared<Ring>();
+        RingsRegistry &registry = ringsRegistry();
+        QMutexLocker locker(&registry.Mutex);
+        registry.Rings.push_back(currentRingHolder.Value);
+        registry.Generation++;
+    }
+    return currentRingHolder.Value.get();
+}
+
+/**
+ * @brief TemplatesCatalog - Каталог разобранных шаблонов
+ * Записи каталога не удаляются, идентификатор шаблона - индекс в каталоге
+ */
+struct TemplatesCatalog
+{
+    QMutex Mutex;
+    QMultiHash<const QChar*, TemplateEntry*> Entries;
+    TemplateEntry *Items[TEMPLATES_MAXIMUM_COUNT] = {};
+    int Count = 0;
+};
+
+TemplatesCatalog &templatesCatalog()
+{
+    static TemplatesCatalog catalog;
+    return catalog;
+}
+
+thread_local QHash<const QChar*, const TemplateEntry*> templatesCache;
+
+std::atomic<ThreadBase*> consumerThread(nullptr);
+std::atomic<quint64> overflowsCount(0);
+
+// используется только потоком протоколирования
+std::vector<std::shared_ptr<Ring>> consumerRings;
+int consumerGeneration = -1;
+
+bool isTemplateMatches(const TemplateEntry &entry, const MessageLogTemplate &messageTemplate)
+{
+    return entry.Number == messageTemplate.number &&
+           entry.Level == messageTemplate.level &&
+           entry.Type == messageTemplate.messageType;
+}
+
+ArgumentKind integerKind(char length, bool isDoubled)
+{
+    switch (length) {
+    case 0:
+    case 'h':
+        return ArgumentKind::Int;
+    case 'l':
+        return isDoubled ? ArgumentKind::LongLong : ArgumentKind::Long;
+    case 'q':
+        return ArgumentKind::LongLong;
+    case 'j':
+        return ArgumentKind::IntMax;
+    case 'z':
+        return ArgumentKind::Size;
+    case 't':
+        return ArgumentKind::PtrDiff;
+    default:
+        return ArgumentKind::None;
+    }
+}
+
+/**
+ * @brief parseFormat - Разбор строки формата на фрагменты
+ * @param format - Строка формата в UTF-8
+ * @param segments - Фрагменты
+ * @return - Признак поддержки всех преобразований строки
+ */
+bool parseFormat(const QByteArray &format, QVector<FormatSegment> &segments)
+{
+    const char *data = format.constData();
+    int size = format.size();
+    FormatSegment segment;
+    int i = 0;
+    while (i < size)
+    {
+        if ('%' != data[i])
+        {
+            segment.Format.append(data[i++]);
+            continue;
+        }
+        if (i + 1 < size && '%' == data[i + 1])
+        {
+            segment.Format.append("%%");
+            i += 2;
+            continue;
+        }
+
+        QByteArray specification("%");
+        i++;
+        // флаги
+        while (i < size && data[i] && strchr("-+ #0'", data[i]))
+            specification.append(data[i++]);
+        // ширина
+        if (i < size && '*' == data[i])
+        {
+            specification.append(data[i++]);
+            segment.StarsCount++;
+        }
+        while (i < size && data[i] >= '0' && data[i] <= '9')
+            specification.append(data[i++]);
+        // точность
+        if (i < size && '.' == data[i])
+        {
+            specification.append(data[i++]);
+            if (i < size && '*' == data[i])
+            {
+                specification.append(data[i++]);
+                segment.StarsCount++;
+            }
+            while (i < size && data[i] >= '0' && data[i] <= '9')
+                specification.append(data[i++]);
+        }
+        // модификатор длины
+        char length = 0;
+        bool isDoubled = false;
+        if (i < size && data[i] && strchr("hlqjztL", data[i]))
+        {
+            length = data[i++];
+            if (i < size && ('h' == length || 'l' == length) && length == data[i])
+            {
+                isDoubled = true;
+                i++;
+            }
+        }
+        if (i >= size)
+            return false;
+
+        char conversion = data[i++];
+        switch (conversion) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            segment.Kind = integerKind(length, isDoubled);
+            break;
+        case 'c':
+            segment.Kind = (0 == length) ? ArgumentKind::Int : ArgumentKind::None;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if ('L' == length)
+                segment.Kind = ArgumentKind::LongDouble;
+            else if (0 == length || ('l' == length && !isDoubled))
+                segment.Kind = ArgumentKind::Double;
+            else
+                segment.Kind = ArgumentKind::None;
+            break;
+        case 's':
+            segment.Kind = (0 == length) ? ArgumentKind::String : ArgumentKind::None;
+            break;
+        case 'p':
+            segment.Kind = (0 == length) ? ArgumentKind::Pointer : ArgumentKind::None;
+            break;
+        default:
+            // %n, %ls, %lc и неизвестные преобразования
+            segment.Kind = ArgumentKind::None;
+            break;
+        }
+        if (ArgumentKind::None == segment.Kind)
+            return false;
+
+        // длинное вещественное хранится как double, 'q' переносимо записывается как "ll"
+        if ('q' == length)
+            specification.append("ll");
+        else if (length && 'L' != length)
+            specification.append(isDoubled ? QByteArray(2, length) : QByteArray(1, length));
+        specification.append(conversion);
+
+        segment.Format.append(specification);
+        segments.append(segment);
+        segment = FormatSegment();
+    }
+
+    if (!segment.Format.isEmpty())
+        segments.append(segment);
+
+    return true;
+}
+
+const TemplateEntry *registerTemplate(const MessageLogTemplate &messageTemplate)
+{
+    TemplatesCatalog &catalog = templatesCatalog();
+    QMutexLocker locker(&catalog.Mutex);
+
+    const QChar *key = messageTemplate.text.constData();
+    for (auto it = catalog.Entries.constFind(key); it != catalog.Entries.constEnd() && it.key() == key; ++it)
+    {
+        if (isTemplateMatches(*it.value(), messageTemplate))
+            return it.value();
+    }
+
+    // шаблоны, формируемые динамически, сверх емкости каталога записываются текстом
+    if (catalog.Count >= TEMPLATES_MAXIMUM_COUNT)
+        return nullptr;
+
+    auto *entry = new TemplateEntry();
+    entry->Id = quint32(catalog.Count);
+    entry->Number = messageTemplate.number;
+    entry->Level = messageTemplate.level;
+    entry->Type = messageTemplate.messageType;
+    entry->Text = messageTemplate.text;
+    entry->Format = entry->Text.toUtf8();
+    entry->IsSupported = parseFormat(entry->Format, entry->Segments);
+
+    catalog.Items[catalog.Count++] = entry;
+    catalog.Entries.insert(key, entry);
+    return entry;
+}
+
+const TemplateEntry *findTemplate(const MessageLogTemplate &messageTemplate)
+{
+    const QChar *key = messageTemplate.text.constData();
+    auto it = templatesCache.constFind(key);
+    if (it != templatesCache.constEnd() && isTemplateMatches(*it.value(), messageTemplate))
+        return it.value();
+
+    const TemplateEntry *entry = registerTemplate(messageTemplate);
+    if (entry)
+    {
+        if (templatesCache.size() >= TEMPLATES_CACHE_MAXIMUM_SIZE)
+            templatesCache.clear();
+        templatesCache.insert(key, entry);
+    }
+    return entry;
+}
+
+template <typename T>
+bool putValue(char *record, quint32 &offset, T value)
+{
+    static_assert(sizeof(T) <= VALUE_SIZE, "value size");
+    if (offset + VALUE_SIZE > quint32(RECORD_MAXIMUM_SIZE))
+        return false;
+    memset(record + offset, 0, VALUE_SIZE);
+    memcpy(record + offset, &value, sizeof(T));
+    offset += VALUE_SIZE;
+    return true;
+}
+
+bool putString(char *record, quint32 &offset, const char *value)
+{
+    quint32 length = value ? quint32(strnlen(value, STRING_MAXIMUM_LENGTH)) : STRING_NULL;
+    quint32 size = alignRecord(sizeof(quint32) + ((STRING_NULL == length) ? 0 : length + 1));
+    if (offset + size > quint32(RECORD_MAXIMUM_SIZE))
+        return false;
+    memcpy(record + offset, &length, sizeof(length));
+    if (STRING_NULL != length)
+    {
+        memcpy(record + offset + sizeof(quint32), value, length);
+        record[offset + sizeof(quint32) + length] = 0;
+    }
+    offset += size;
+    return true;
+}
+
+/**
+ * @brief putArguments - Запись значений аргументов шаблона за заголовком записи
+ * @return - Размер записи или 0, если аргументы не помещаются в запись
+ */
+quint32 putArguments(char *record, const TemplateEntry &entry, va_list args)
+{
+    quint32 offset = sizeof(RecordHeader);
+    bool isFits = true;
+    for (const FormatSegment &segment : entry.Segments)
+    {
+        for (int star = 0; star < segment.StarsCount && isFits; star++)
+            isFits = putValue<qint64>(record, offset, va_arg(args, int));
+
+        switch (segment.Kind) {
+        case ArgumentKind::None:
+            break;
+        case ArgumentKind::Int:
+            isFits = isFits && putValue<qint64>(record, offset, va_arg(args, int));
+            break;
+        case ArgumentKind::Long:
+            isFits = isFits && putValue<qint64>(record, offset, va_arg(args, long));
+            break;
+        case ArgumentKind::LongLong:
+            isFits = isFits && putValue<qint64>(record, offset, va_arg(args, long long));
+            break;
+        case ArgumentKind::IntMax:
+            isFits = isFits && putValue<qint64>(record, offset, qint64(va_arg(args, intmax_t)));
+            break;
+        case ArgumentKind::Size:
+            isFits = isFits && putValue<quint64>(record, offset, quint64(va_arg(args, size_t)));
+            break;
+        case ArgumentKind::PtrDiff:
+            isFits = isFits && putValue<qint64>(record, offset, qint64(va_arg(args, ptrdiff_t)));
+            break;
+        case ArgumentKind::Double:
+            isFits = isFits && putValue<double>(record, offset, va_arg(args, double));
+            break;
+        case ArgumentKind::LongDouble:
+            isFits = isFits && putValue<double>(record, offset, double(va_arg(args, long double)));
+            break;
+        case ArgumentKind::String:
+            isFits = isFits && putString(record, offset, va_arg(args, const char*));
+            break;
+        case ArgumentKind::Pointer:
+            isFits = isFits && putValue<quint64>(record, offset, quint64(quintptr(va_arg(args, void*))));
+            break;
+        }
+        if (!isFits)
+            return 0;
+    }
+    return offset;
+}
+
+/**
+ * @brief putText - Запись номера, уровня, типа и отформатированного текста за заголовком записи
+ * @param format - Строка формата шаблона в UTF-8
+ * @return - Размер записи
+ */
+quint32 putText(char *record, const MessageLogTemplate &messageTemplate,
+                const QByteArray &format, va_list args)
+{
+    char text[STRING_MAXIMUM_LENGTH];
+    int count = vsnprintf(text, sizeof(text), format.constData(), args);
+
+    quint32 offset = sizeof(RecordHeader);
+    putValue<qint64>(record, offset, messageTemplate.number);
+    putValue<qint64>(record, offset, messageTemplate.level);
+    putValue<qint64>(record, offset, qint64(messageTemplate.messageType));
+    putString(record, offset, (count > 0) ? text : "Не удалось выполнить форматирование строки");
+    return offset;
+}
+
+template <typename T>
+T takeValue(const char *&payload)
+{
+    T value;
+    memcpy(&value, payload, sizeof(T));
+    payload += VALUE_SIZE;
+    return value;
+}
+
+const char *takeString(const char *&payload)
+{
+    quint32 length;
+    memcpy(&length, payload, sizeof(length));
+    const char *value = (STRING_NULL == length) ? nullptr : payload + sizeof(quint32);
+    payload += alignRecord(sizeof(quint32) + ((STRING_NULL == length) ? 0 : length + 1));
+    // glibc выводит "(null)", на других платформах пустой указатель недопустим
+    return value ? value : "(null)";
+}
+
+template <typename... Values>
+void appendFormatted(QByteArray &result, const FormatSegment &segment, Values... values)
+{
+    char buffer[256];
+    int count = snprintf(buffer, sizeof(buffer), segment.Format.constData(), values...);
+    if (count <= 0)
+        return;
+    if (count < int(sizeof(buffer)))
+    {
+        result.append(buffer, count);
+        return;
+    }
+    QByteArray large(count + 1, Qt::Uninitialized);
+    snprintf(large.data(), size_t(large.size()), segment.Format.constData(), values...);
+    result.append(large.constData(), count);
+}
+
+template <typename T>
+void appendArgument(QByteArray &result, const FormatSegment &segment, const int *stars, T value)
+{
+    switch (segment.StarsCount) {
+    case 0:
+        appendFormatted(result, segment, value);
+        break;
+    case 1:
+        appendFormatted(result, segment, stars[0], value);
+        break;
+    default:
+        appendFormatted(result, segment, stars[0], stars[1], value);
+        break;
+    }
+}
+
+QString renderRecord(const TemplateEntry &entry, const char *payload)
+{
+    QByteArray result;
+    result.reserve(256);
+    for (const FormatSegment &segment : entry.Segments)
+    {
+        int stars[2] = {0, 0};
+        for (int star = 0; star < segment.StarsCount; star++)
+            stars[star] = int(takeValue<qint64>(payload));
+
+        switch (segment.Kind) {
+        case ArgumentKind::None:
+            appendFormatted(result, segment);
+            break;
+        case ArgumentKind::Int:
+            appendArgument(result, segment, stars, int(takeValue<qint64>(payload)));
+            break;
+        case ArgumentKind::Long:
+            appendArgument(result, segment, stars, long(takeValue<qint64>(payload)));
+            break;
+        case ArgumentKind::LongLong:
+            appendArgument(result, segment, stars, static_cast<long long>(takeValue<qint64>(payload)));
+            break;
+        case ArgumentKind::IntMax:
+            appendArgument(result, segment, stars, intmax_t(takeValue<qint64>(payload)));
+            break;
+        case ArgumentKind::Size:
+            appendArgument(result, segment, stars, size_t(takeValue<quint64>(payload)));
+            break;
+        case ArgumentKind::PtrDiff:
+            appendArgument(result, segment, stars, ptrdiff_t(takeValue<qint64>(payload)));
+            break;
+        case ArgumentKind::Double:
+        case ArgumentKind::LongDouble:
+            appendArgument(result, segment, stars, takeValue<double>(payload));
+            break;
+        case ArgumentKind::String:
+            appendArgument(result, segment, stars, takeString(payload));
+            break;
+        case ArgumentKind::Pointer:
+            appendArgument(result, segment, stars,
+                           reinterpret_cast<void*>(quintptr(takeValue<quint64>(payload))));
+            break;
+        }
+    }
+    return QString::fromUtf8(result);
+}
+
+}
+
+
+void BinaryLog::setConsumer(ThreadBase *consumer)
+{
+    consumerThread.store(consumer, std::memory_order_release);
+}
+
+bool BinaryLog::write(const MessageLogTemplate &messageTemplate, va_list args)
+{
+    ThreadBase *consumer = consumerThread.load(std::memory_order_acquire);
+    if (!consumer)
+        return false;
+
+    const TemplateEntry *entry = findTemplate(messageTemplate);
+
+    // запись формируется в стеке и копируется в буфер одной операцией
+    alignas(8) char record[RECORD_MAXIMUM_SIZE];
+    va_list textArgs;
+    va_copy(textArgs, args);
+    quint32 templateId = entry ? entry->Id : TEMPLATE_TEXT;
+    quint32 offset = (entry && entry->IsSupported) ? putArguments(record, *entry, args) : 0;
+    if (0 == offset)
+    {
+        // шаблоны сверх емкости каталога, с неподдерживаемыми преобразованиями
+        // и с не поместившимися аргументами форматируются сразу,
+        // чтобы запись заняла свое место среди записей потока
+        offset = putText(record, messageTemplate,
+                         entry ? entry->Format : messageTemplate.text.toUtf8(), textArgs);
+        templateId = TEMPLATE_TEXT;
+    }
+    va_end(textArgs);
+
+    RecordHeader header;
+    header.Size = alignRecord(offset);
+    header.TemplateId = templateId;
+    header.TickCount = LoopClock::read();
+    memcpy(record, &header, sizeof(header));
+
+    bool wasEmpty = false;
+    Ring *ring = currentRing();
+    if (!ring->push(record, header.Size, wasEmpty))
+    {
+        // поток протоколирования не может дождаться извлечения собственных записей
+        if (QThread::currentThread() == consumer)
+        {
+            overflowsCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // сообщение, отправленное обычным путем, обогнало бы записи буфера,
+        // поэтому поток-источник ограниченное время ожидает их извлечения,
+        // а по истечении времени запись теряется
+        consumer->wakeUp();
+        const qint64 deadline = DateUtils::getTickCountNanoseconds() + OVERFLOW_WAIT_NANOSECONDS;
+        while (!ring->push(record, header.Size, wasEmpty))
+        {
+            if (consumerThread.load(std::memory_order_acquire) != consumer)
+                return false;
+            if (DateUtils::getTickCountNanoseconds() >= deadline)
+            {
+                overflowsCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    // поток протоколирования будится только при появлении первой записи
+    if (wasEmpty)
+        consumer->wakeUp();
+
+    return true;
+}
+
+int BinaryLog::drain(const RecordHandler &handler)
+{
+    RingsRegistry &registry = ringsRegistry();
+    if (consumerGeneration != registry.Generation.load(std::memory_order_acquire))
+    {
+        QMutexLocker locker(&registry.Mutex);
+        consumerRings = registry.Rings;
+        consumerGeneration = registry.Generation.load(std::memory_order_relaxed);
+    }
+
+    TemplatesCatalog &catalog = templatesCatalog();
+    int count = 0;
+    bool hasPending = false;
+    bool hasOrphaned = false;
+    BinaryLogRecord logRecord;
+    for (const auto &ring : consumerRings)
+    {
+        bool isOrphaned = ring->Orphaned.load(std::memory_order_acquire);
+
+        hasPending |= ring->drain([&](const char *record)
+        {
+            RecordHeader header;
+            memcpy(&header, record, sizeof(header));
+            const char *payload = record + sizeof(header);
+            if (TEMPLATE_TEXT == header.TemplateId)
+            {
+                logRecord.Number = int(takeValue<qint64>(payload));
+                logRecord.Level = int(takeValue<qint64>(payload));
+                logRecord.Type = MessageType(takeValue<qint64>(payload));
+                logRecord.Text = QString::fromUtf8(takeString(payload));
+            }
+            else
+            {
+                // запись опубликована после занесения шаблона в каталог
+                const TemplateEntry *entry = catalog.Items[header.TemplateId];
+                logRecord.Number = entry->Number;
+                logRecord.Level = entry->Level;
+                logRecord.Type = entry->Type;
+                logRecord.Text = renderRecord(*entry, payload);
+            }
+            logRecord.Created = QDateTime::fromMSecsSinceEpoch(
+                        LoopClock::toMSecsSinceEpoch(header.TickCount));
+            handler(logRecord);
+            count++;
+        });
+
+        if (isOrphaned && ring->isEmpty())
+            hasOrphaned = true;
+    }
+
+    // удаление буферов завершившихся потоков
+    if (hasOrphaned)
+    {
+        QMutexLocker locker(&registry.Mutex);
+        auto &rings = registry.Rings;
+        for (auto it = rings.begin(); it != rings.end();)
+        {
+            if ((*it)->Orphaned.load(std::memory_order_acquire) && (*it)->isEmpty())
+                it = rings.erase(it);
+            else
+                ++it;
+        }
+        registry.Generation++;
+    }
+
+    // записи, появившиеся во время извлечения, обрабатываются на следующем шаге
+    if (hasPending)
+    {
+        ThreadBase *consumer = consumerThread.load(std::memory_order_acquire);
+        if (consumer)
+            consumer->wakeUp();
+    }
+
+    return count;
+}
+
+quint64 BinaryLog::overflows()
+{
+    return overflowsCount.load(std::memory_order_relaxed);
+}
+
+}}
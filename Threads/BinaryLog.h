@@ -0,0 +1,85 @@
+#pragma once
+
+#include "MessageLog.h"
+
+#include "../threader_global.h"
+
+#include <QDateTime>
+#include <QString>
+
+#include <cstdarg>
+#include <functional>
+
+namespace Threader {
+
+namespace Threads {
+
+class ThreadBase;
+
+/**
+ * @brief BinaryLogRecord - Сообщение протоколирования, извлеченное из двоичного журнала
+ */
+struct BinaryLogRecord
+{
+    int Number;
+    int Level;
+    MessageType Type;
+    QDateTime Created;
+    QString Text;
+};
+
+/**
+ * @brief BinaryLog - Двоичный журнал сообщений протоколирования с отложенным форматированием
+ * Поток-источник записывает в собственный кольцевой буфер (один писатель, один читатель)
+ * только идентификатор шаблона, время и значения аргументов: числа копируются
+ * как есть, строки - байтами. Разбор строки формата выполняется один раз на шаблон.
+ * Шаблон находится по адресу данных текста, каталог хранит копию текста, поэтому
+ * адрес не может перейти к другому тексту; дополнительно сверяются номер, уровень и тип.
+ * Поток протоколирования будится только при переходе буфера из пустого состояния
+ * и форматирует сообщения при извлечении. Шаблоны сверх емкости каталога,
+ * с неподдерживаемыми преобразованиями (%n, %ls) и с не поместившимися в запись
+ * аргументами форматируются потоком-источником и записываются в тот же буфер.
+ * При переполнении буфера поток-источник ожидает извлечения записей не дольше 2 мс,
+ * чтобы сохранить порядок своих сообщений, после чего запись теряется
+ */
+class THREADERSHARED_EXPORT BinaryLog
+{
+public:
+    using RecordHandler = std::function<void(const BinaryLogRecord &record)>;
+
+    BinaryLog() = delete;
+
+    /**
+     * @brief setConsumer - Регистрация потока, извлекающего сообщения из журнала
+     * @param consumer - Поток протоколирования, nullptr - журнал отключен
+     */
+    static void setConsumer(ThreadBase *consumer);
+
+    /**
+     * @brief write - Запись сообщения в буфер текущего потока без форматирования
+     * @param messageTemplate - Шаблон сообщения
+     * @param args - Аргументы шаблона
+     * @return - Признак записи или потери записи при переполнении буфера,
+     * при false сообщение следует отправить обычным путем:
+     * журнал отключен или буфер переполнен у самого потока протоколирования
+     */
+    static bool write(const MessageLogTemplate &messageTemplate, va_list args);
+
+    /**
+     * @brief drain - Извлечение и форматирование сообщений из буферов всех потоков
+     * Вызывается только потоком протоколирования
+     * @param handler - Обработчик извлеченного сообщения
+     * @return - Количество извлеченных сообщений
+     */
+    static int drain(const RecordHandler &handler);
+
+    /**
+     * @brief overflows - Получение количества переполнений буфера потока,
+     * при которых запись не дождалась места в буфере и была потеряна
+     * или была отправлена потоком протоколирования обычным путем
+     * @return - Количество сообщений
+     */
+    static quint64 overflows();
+};
+
+}}
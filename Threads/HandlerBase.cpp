@@ -86,7 +86,12 @@ bool HandlerBase::needsToWrite() const
 
 void HandlerBase::setNeedsToWrite(const bool needsToWrite)
 {
+    if (_needsToWrite == needsToWrite)
+        return;
     _needsToWrite = needsToWrite;
+#ifdef Q_OS_LINUX
+    notifyEventsChanged();
+#endif
 }
 
 #ifdef Q_OS_LINUX
@@ -157,6 +162,9 @@ void HandlerBase::setConnectionState(HandlerBase::ConnectionState value)
     {
         auto oldState = _connectionState;
         _connectionState = value;
+#ifdef Q_OS_LINUX
+        notifyEventsChanged();
+#endif
         emit signalOnConnectionStateChanged(this, oldState,  _connectionState);
     }
 }
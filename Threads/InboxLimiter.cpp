@@ -0,0 +1,217 @@
+#include "InboxLimiter.h"
+
+#include "../Utils/DateUtils.h"
+
+namespace Threader {
+
+namespace Threads {
+
+using namespace Threader::Utils;
+
+
+InboxLimiter::InboxLimiter()
+    : _count(0)
+    , _bytes(0)
+    , _evictions(0)
+    , _waiting(0)
+    , _droppedNewest(0)
+    , _droppedOldest(0)
+    , _conflated(0)
+    , _timedOut(0)
+    , _highWaterCount(0)
+    , _highWaterBytes(0)
+{
+}
+
+InboxLimits InboxLimiter::limits() const
+{
+    return _limits;
+}
+
+void InboxLimiter::setLimits(const InboxLimits &limits)
+{
+    _limits = limits;
+}
+
+bool InboxLimiter::isBounded() const
+{
+    return _limits.MaxCount > 0 || _limits.MaxBytes > 0 ||
+            InboxOverflowPolicy::Conflate == _limits.Policy;
+}
+
+PostMessageResult InboxLimiter::admit(const MessageBase::Ptr &message, bool canBlock)
+{
+    qint64 bytes = message->approximateSize();
+
+    // сообщения с ключом замещения обрабатываются целиком под блокировкой,
+    // чтобы ключ не оказался в очереди дважды
+    if (InboxOverflowPolicy::Conflate == _limits.Policy && !message->conflationKey().isEmpty())
+    {
+        QMutexLocker locker(&_mutex);
+
+        auto it = _pending.find(message->conflationKey());
+        if (it != _pending.end())
+        {
+            _bytes.fetch_add(bytes - it.value()->approximateSize());
+            it.value() = message;
+            _conflated.fetch_add(1, std::memory_order_relaxed);
+            return PostMessageResult::Conflated;
+        }
+
+        if (!tryReserve(bytes))
+        {
+            _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return PostMessageResult::Rejected;
+        }
+
+        _pending.insert(message->conflationKey(), message);
+        return PostMessageResult::Accepted;
+    }
+
+    if (tryReserve(bytes))
+        return PostMessageResult::Accepted;
+
+    switch (_limits.Policy) {
+    case InboxOverflowPolicy::DropOldest:
+    {
+        // сообщение принимается сверх ограничения, получатель удалит самое старое
+        int count = _count.fetch_add(1) + 1;
+        updateHighWater(count, _bytes.fetch_add(bytes) + bytes);
+        _evictions.fetch_add(1);
+        _droppedOldest.fetch_add(1, std::memory_order_relaxed);
+        return PostMessageResult::DroppedOldest;
+    }
+    case InboxOverflowPolicy::Block:
+    {
+        if (!canBlock)
+            break;
+
+        qint64 deadline = DateUtils::getNextTickCount(uint(qMax(0, _limits.BlockTimeoutMsecs)));
+
+        QMutexLocker locker(&_mutex);
+        _waiting.fetch_add(1);
+        bool reserved = tryReserve(bytes);
+        while (!reserved)
+        {
+            qint64 remaining = deadline - DateUtils::getTickCount();
+            if (remaining <= 0 || !_space.wait(&_mutex, ulong(remaining)))
+            {
+                // место могло освободиться одновременно с истечением времени
+                reserved = tryReserve(bytes);
+                break;
+            }
+            reserved = tryReserve(bytes);
+        }
+        _waiting.fetch_sub(1);
+
+        if (reserved)
+            return PostMessageResult::Accepted;
+
+        _timedOut.fetch_add(1, std::memory_order_relaxed);
+        return PostMessageResult::TimedOut;
+    }
+    default:
+        break;
+    }
+
+    _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+    return PostMessageResult::Rejected;
+}
+
+void InboxLimiter::reserve(int count, qint64 bytes)
+{
+    updateHighWater(_count.fetch_add(count) + count, _bytes.fetch_add(bytes) + bytes);
+}
+
+MessageBase::Ptr InboxLimiter::release(const MessageBase::Ptr &message)
+{
+    MessageBase::Ptr result = message;
+
+    if (InboxOverflowPolicy::Conflate == _limits.Policy && !message->conflationKey().isEmpty())
+    {
+        QMutexLocker locker(&_mutex);
+        MessageBase::Ptr latest = _pending.take(message->conflationKey());
+        if (latest)
+            result = latest;
+    }
+
+    _count.fetch_sub(1);
+    _bytes.fetch_sub(result->approximateSize());
+
+    // пробуждение выполняется только при наличии ожидающих отправителей
+    if (_waiting.load() > 0)
+    {
+        QMutexLocker locker(&_mutex);
+        _space.wakeAll();
+    }
+
+    return result;
+}
+
+bool InboxLimiter::takeEviction()
+{
+    int evictions = _evictions.load(std::memory_order_relaxed);
+    while (evictions > 0)
+    {
+        if (_evictions.compare_exchange_weak(evictions, evictions - 1))
+            return true;
+    }
+    return false;
+}
+
+void InboxLimiter::returnEviction()
+{
+    _evictions.fetch_add(1);
+}
+
+InboxStatistic InboxLimiter::statistic() const
+{
+    InboxStatistic result;
+    result.DroppedNewest = _droppedNewest.load(std::memory_order_relaxed);
+    result.DroppedOldest = _droppedOldest.load(std::memory_order_relaxed);
+    result.Conflated = _conflated.load(std::memory_order_relaxed);
+    result.TimedOut = _timedOut.load(std::memory_order_relaxed);
+    result.HighWaterCount = _highWaterCount.load(std::memory_order_relaxed);
+    result.HighWaterBytes = _highWaterBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+bool InboxLimiter::tryReserve(qint64 bytes)
+{
+    int count = _count.fetch_add(1) + 1;
+    qint64 totalBytes = _bytes.fetch_add(bytes) + bytes;
+
+    // первое сообщение принимается всегда, даже если превышает ограничение объема
+    if (count > 1 && isExceeded(count, totalBytes))
+    {
+        _count.fetch_sub(1);
+        _bytes.fetch_sub(bytes);
+        return false;
+    }
+
+    updateHighWater(count, totalBytes);
+    return true;
+}
+
+bool InboxLimiter::isExceeded(int count, qint64 bytes) const
+{
+    return (_limits.MaxCount > 0 && count > _limits.MaxCount) ||
+            (_limits.MaxBytes > 0 && bytes > _limits.MaxBytes);
+}
+
+void InboxLimiter::updateHighWater(int count, qint64 bytes)
+{
+    int highWaterCount = _highWaterCount.load(std::memory_order_relaxed);
+    while (count > highWaterCount &&
+           !_highWaterCount.compare_exchange_weak(highWaterCount, count, std::memory_order_relaxed))
+    {
+    }
+
+    qint64 highWaterBytes = _highWaterBytes.load(std::memory_order_relaxed);
+    while (bytes > highWaterBytes &&
+           !_highWaterBytes.compare_exchange_weak(highWaterBytes, bytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+}}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include "MessageBase.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief InboxOverflowPolicy - Политика обработки переполнения входящей очереди потока
+ */
+enum class InboxOverflowPolicy
+{
+    Block,       // отправитель ожидает освобождения места не дольше заданного времени
+    DropOldest,  // принимается новое сообщение, самое старое удаляется при обработке
+    DropNewest,  // новое сообщение отклоняется
+    Conflate     // сообщение замещает ожидающее обработки сообщение с тем же ключом
+};
+
+/**
+ * @brief InboxLimits - Ограничения входящей очереди потока
+ * Нулевое значение ограничения означает его отсутствие
+ */
+struct InboxLimits
+{
+    int MaxCount = 0;
+    qint64 MaxBytes = 0;
+    InboxOverflowPolicy Policy = InboxOverflowPolicy::DropNewest;
+    int BlockTimeoutMsecs = 100;
+};
+
+/**
+ * @brief InboxStatistic - Статистика входящей очереди потока
+ */
+struct InboxStatistic
+{
+    quint64 DroppedNewest = 0;
+    quint64 DroppedOldest = 0;
+    quint64 Conflated = 0;
+    quint64 TimedOut = 0;
+    int HighWaterCount = 0;
+    qint64 HighWaterBytes = 0;
+};
+
+/**
+ * @brief InboxLimiter - Учет и ограничение входящих сообщений потока
+ * Отправители резервируют место атомарными операциями до размещения сообщения
+ * в очереди, поток-получатель освобождает его при извлечении сообщения.
+ * Удаление самых старых сообщений выполняется получателем при обработке,
+ * так как очередь без блокировок не позволяет отправителю извлекать сообщения.
+ * Управляющие сообщения не ограничиваются и не учитываются
+ */
+class THREADERSHARED_EXPORT InboxLimiter
+{
+public:
+    InboxLimiter();
+
+    InboxLimiter(const InboxLimiter &) = delete;
+    InboxLimiter &operator=(const InboxLimiter &) = delete;
+
+    /**
+     * @brief limits - Получение ограничений очереди
+     * @return - Ограничения очереди
+     */
+    InboxLimits limits() const;
+
+    /**
+     * @brief setLimits - Установка ограничений очереди
+     * Устанавливается до начала обмена сообщениями
+     * @param limits - Ограничения очереди
+     */
+    void setLimits(const InboxLimits &limits);
+
+    /**
+     * @brief isBounded - Получение признака наличия ограничений или замещения сообщений
+     * @return - Признак наличия ограничений
+     */
+    bool isBounded() const;
+
+    /**
+     * @brief admit - Резервирование места для сообщения отправителем
+     * @param message - Сообщение
+     * @param canBlock - Признак допустимости ожидания отправителя
+     * @return - Результат. Сообщение размещается в очереди только при результатах
+     * Accepted и DroppedOldest
+     */
+    PostMessageResult admit(const MessageBase::Ptr &message, bool canBlock);
+
+    /**
+     * @brief reserve - Учет группы сообщений, размещаемой без проверки ограничений
+     * @param count - Количество сообщений
+     * @param bytes - Объем сообщений
+     */
+    void reserve(int count, qint64 bytes);
+
+    /**
+     * @brief release - Освобождение места сообщения получателем при извлечении из очереди
+     * @param message - Извлеченное сообщение
+     * @return - Сообщение для обработки. При замещении это последнее сообщение с тем же ключом
+     */
+    MessageBase::Ptr release(const MessageBase::Ptr &message);
+
+    /**
+     * @brief takeEviction - Получение получателем очередного требования удаления
+     * самого старого сообщения
+     * @return - Признак наличия требования
+     */
+    bool takeEviction();
+
+    /**
+     * @brief returnEviction - Возврат требования удаления, которое не удалось выполнить
+     */
+    void returnEviction();
+
+    /**
+     * @brief statistic - Получение статистики очереди
+     * @return - Статистика очереди
+     */
+    InboxStatistic statistic() const;
+
+private:
+    /**
+     * @brief tryReserve - Резервирование места с отменой при превышении ограничений
+     * @param bytes - Объем сообщения
+     * @return - Признак успешного резервирования
+     */
+    bool tryReserve(qint64 bytes);
+
+    /**
+     * @brief isExceeded - Проверка превышения ограничений
+     */
+    bool isExceeded(int count, qint64 bytes) const;
+
+    /**
+     * @brief updateHighWater - Обновление максимальных значений заполнения
+     */
+    void updateHighWater(int count, qint64 bytes);
+
+    InboxLimits _limits;
+
+    std::atomic<int> _count;
+    std::atomic<qint64> _bytes;
+    std::atomic<int> _evictions;
+    std::atomic<int> _waiting;
+
+    std::atomic<quint64> _droppedNewest;
+    std::atomic<quint64> _droppedOldest;
+    std::atomic<quint64> _conflated;
+    std::atomic<quint64> _timedOut;
+    std::atomic<int> _highWaterCount;
+    std::atomic<qint64> _highWaterBytes;
+
+    /**
+     * @brief _mutex - Защита ожидания отправителей и таблицы замещаемых сообщений
+     */
+    QMutex _mutex;
+
+    /**
+     * @brief _space - Условие освобождения места в очереди
+     */
+    QWaitCondition _space;
+
+    /**
+     * @brief _pending - Последние сообщения по ключам замещения, ожидающие обработки
+     */
+    QHash<QString, MessageBase::Ptr> _pending;
+};
+
+}}
@@ -61,12 +61,7 @@ bool ListThreads::accumulateStatistic(ThreadBase* thread,
                                       const int &queueCount,
                                       const bool terminated)
 {
-    if (!thread)
-        return false;
-
-    QMutexLocker locker(_mutex);
-
-    ThreadStatisticStruct statistic;
+    ThreadStatisticStruct statistic = {};
     statistic.ThreadId = threadId;
     statistic.ThreadName = threadName;
     statistic.StartedMsecsSinceEpoch = startedMsecsSinceEpoch;
@@ -74,10 +69,29 @@ bool ListThreads::accumulateStatistic(ThreadBase* thread,
     statistic.WaitMSecsCount = qint64(waitMSecsCount);
     statistic.QueueCount = queueCount;
     statistic.Terminated = terminated;
+    return accumulateStatistic(thread, statistic);
+}
+
+bool ListThreads::accumulateStatistic(ThreadBase *thread,
+                                      const ThreadStatisticStruct &statistic)
+{
+    if (!thread)
+        return false;
+
+    QMutexLocker locker(_mutex);
+
     _statistic[thread] = statistic;
     return true;
 }
 
+void ListThreads::applyPlacement()
+{
+    QMutexLocker locker(_mutex);
+
+    for (ThreadBase *thread : _threads)
+        thread->applyPlacement();
+}
+
 ListStatistic ListThreads::statistic()
 {
     QMutexLocker locker(_mutex);
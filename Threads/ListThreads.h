@@ -20,7 +20,22 @@ typedef struct ThreadStatistic
     qint64 AliveMsecsSinceEpoch;
     qint64 WaitMSecsCount;
     int QueueCount;
+    int ControlQueueCount;
+    int NormalQueueCount;
+    int BulkQueueCount;
     bool Terminated;
+    quint64 WakeUpsIssued;
+    quint64 WakeUpsSuppressed;
+    quint64 OutboxMessages;
+    quint64 OutboxBatches;
+    quint64 OutboxRejected;
+    quint64 InboxDroppedNewest;
+    quint64 InboxDroppedOldest;
+    quint64 InboxConflated;
+    quint64 InboxTimedOut;
+    int InboxHighWaterCount;
+    qint64 InboxHighWaterBytes;
+    QString Placement;
 } ThreadStatisticStruct;
 
 using ListStatistic = QList<ThreadStatisticStruct>;
@@ -71,12 +86,27 @@ public:
                              const int &queueCount,
                              const bool terminated);
 
+    /**
+     * @brief accumulateStatistic - Хранение статистики в памяти
+     * @param thread - Указатель на поток
+     * @param statistic - Статистика потока
+     * @return - Статистика добавлена
+     */
+    bool accumulateStatistic(ThreadBase *thread,
+                             const ThreadStatisticStruct &statistic);
+
     /**
      * @brief statistic - Получение списка со статистикой потоков
      * @return - Список со статистикой потоков
      */
     ListStatistic statistic();
 
+    /**
+     * @brief applyPlacement - Повторное применение размещения к зарегистрированным потокам
+     * Используется после чтения настроек размещения потоков, запущенных раньше
+     */
+    void applyPlacement();
+
 private:
 
     static ListThreads *_instance;
@@ -0,0 +1,171 @@
+#include "LogConsoleSink.h"
+
+#include <QMutexLocker>
+#include <QTextCodec>
+
+#include <iostream>
+
+namespace Threader {
+
+namespace Threads {
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_YELLOW  "\x1b[33m"
+#define ANSI_COLOR_BLUE    "\x1b[34m"
+#define ANSI_COLOR_MAGENTA "\x1b[35m"
+#define ANSI_COLOR_CYAN    "\x1b[36m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+
+LogConsoleSink::LogConsoleSink(int maximumLines)
+    : QThread(nullptr)
+    , _maximumLines(maximumLines)
+    , _isStopping(false)
+    , _dropped(0)
+    , _droppedReported(0)
+{
+#ifdef Q_OS_WIN
+    _consoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+    _codec = QTextCodec::codecForName("cp866");
+#endif
+}
+
+LogConsoleSink::~LogConsoleSink()
+{
+    stop();
+}
+
+bool LogConsoleSink::print(MessageType messageType, const QString &messageString)
+{
+    {
+        QMutexLocker locker(&_mutex);
+        if (_lines.count() >= _maximumLines)
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _lines.append({messageType, messageString});
+        _condition.wakeOne();
+    }
+
+    if (!isRunning())
+        start();
+    return true;
+}
+
+void LogConsoleSink::setMaximumLines(int maximumLines)
+{
+    QMutexLocker locker(&_mutex);
+    _maximumLines = (maximumLines > 0) ? maximumLines : DEFAULT_MAXIMUM_LINES;
+}
+
+void LogConsoleSink::stop()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _isStopping = true;
+        _condition.wakeOne();
+    }
+    wait();
+
+    QMutexLocker locker(&_mutex);
+    _isStopping = false;
+}
+
+quint64 LogConsoleSink::dropped() const
+{
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+void LogConsoleSink::run()
+{
+    QVector<Line> lines;
+    while (true)
+    {
+        bool isStopping;
+        {
+            QMutexLocker locker(&_mutex);
+            if (_lines.isEmpty() && !_isStopping)
+                _condition.wait(&_mutex);
+            lines.swap(_lines);
+            isStopping = _isStopping;
+        }
+
+        for (const Line &line : lines)
+            printLine(line.Type, line.Text);
+        lines.resize(0);
+
+        // сообщение об отброшенных строках выводится после освобождения очереди
+        quint64 dropped = _dropped.load(std::memory_order_relaxed);
+        if (dropped != _droppedReported)
+        {
+            printLine(Warning, QString("Вывод на консоль: отброшено строк: %1\r\n").
+                      arg(dropped - _droppedReported));
+            _droppedReported = dropped;
+        }
+        std::cout.flush();
+
+        if (isStopping)
+        {
+            QMutexLocker locker(&_mutex);
+            if (_lines.isEmpty())
+                break;
+        }
+    }
+}
+
+void LogConsoleSink::printLine(MessageType messageType, const QString &messageString)
+{
+#ifdef Q_OS_LINUX
+    const char *colorString;
+    switch (messageType) {
+    case Warning:
+        colorString = ANSI_COLOR_YELLOW;
+        break;
+    case Error:
+        colorString = ANSI_COLOR_RED;
+        break;
+    case Debug:
+        colorString = ANSI_COLOR_BLUE;
+        break;
+    default:
+        colorString = ANSI_COLOR_RESET;
+        break;
+    }
+    QByteArray line = messageString.toUtf8();
+    std::cout << colorString;
+    std::cout.write(line.constData(), line.size());
+#endif
+#ifdef Q_OS_WIN
+    uint8_t color;
+    switch (messageType) {
+    case Message:
+        color = 15;
+        break;
+    case Warning:
+        color = 14;
+        break;
+    case Error:
+        color = 12;
+        break;
+    case Debug:
+        color = 6;
+        break;
+    default:
+        color = 15;
+    }
+    if (INVALID_HANDLE_VALUE != _consoleHandle)
+        SetConsoleTextAttribute(_consoleHandle, color);
+
+    if (_codec)
+    {
+        QByteArray dosString = _codec->fromUnicode(messageString.toUtf8());
+        std::cout << dosString.constData();
+        // цвет устанавливается для консоли, поэтому строка выводится до смены цвета
+        std::cout.flush();
+    }
+#endif
+}
+
+}}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MessageLog.h"
+
+#include "../threader_global.h"
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+class QTextCodec;
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief LogConsoleSink - Поток вывода сообщений протоколирования на консоль
+ * Поток протоколирования только ставит строку в очередь и не ожидает консоль.
+ * При заполнении очереди строки отбрасываются с подсчетом, количество отброшенных
+ * строк выводится на консоль после освобождения очереди
+ */
+class THREADERSHARED_EXPORT LogConsoleSink : public QThread
+{
+public:
+    static const int DEFAULT_MAXIMUM_LINES = 4096;
+
+public:
+    explicit LogConsoleSink(int maximumLines = DEFAULT_MAXIMUM_LINES);
+    ~LogConsoleSink() override;
+
+    /**
+     * @brief print - Постановка строки в очередь вывода без ожидания
+     * @param messageType - Тип сообщения, определяет цвет вывода
+     * @param messageString - Строка с завершающим переводом строки
+     * @return - Признак постановки в очередь, false - строка отброшена
+     */
+    bool print(MessageType messageType, const QString &messageString);
+
+    void setMaximumLines(int maximumLines);
+
+    /**
+     * @brief stop - Вывод оставшихся строк и завершение потока
+     */
+    void stop();
+
+    quint64 dropped() const;
+
+protected:
+    void run() override;
+
+private:
+    struct Line
+    {
+        MessageType Type;
+        QString Text;
+    };
+
+    void printLine(MessageType messageType, const QString &messageString);
+
+private:
+    QMutex _mutex;
+    QWaitCondition _condition;
+    QVector<Line> _lines;
+    int _maximumLines;
+    bool _isStopping;
+
+    std::atomic<quint64> _dropped;
+    quint64 _droppedReported;
+#ifdef Q_OS_WIN
+    HANDLE _consoleHandle;
+    QTextCodec *_codec;
+#endif
+};
+
+}}
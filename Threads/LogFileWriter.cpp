@@ -0,0 +1,380 @@
+#include "LogFileWriter.h"
+
+#include "../Utils/DateUtils.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#ifdef Q_OS_LINUX
+#include <zlib.h>
+#endif
+
+namespace Threader {
+
+namespace Threads {
+
+
+using namespace Threader::Utils;
+
+
+// размер блока чтения при сжатии файла
+#define COMPRESS_BLOCK_SIZE (1024 * 256)
+
+
+LogFileWriter::LogFileWriter()
+    : QThread(nullptr)
+    , _isStopping(false)
+    , _writtenBytes(0)
+    , _writeErrors(0)
+    , _rotations(0)
+{
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    stop();
+}
+
+void LogFileWriter::setRotation(const LogRotation &rotation)
+{
+    QMutexLocker locker(&_mutex);
+    _rotation = rotation;
+}
+
+LogRotation LogFileWriter::rotation() const
+{
+    QMutexLocker locker(&_mutex);
+    return _rotation;
+}
+
+void LogFileWriter::submit(const QString &fileName, QByteArray &data, WriteMode writeMode)
+{
+    if (data.isEmpty())
+        return;
+
+    {
+        QMutexLocker locker(&_mutex);
+
+        // поиск ожидающих записи данных того же файла
+        Chunk *chunk = nullptr;
+        if (WriteMode::Truncate == writeMode)
+        {
+            for (Chunk &pending : _pending)
+            {
+                if (WriteMode::Truncate == pending.Mode && pending.FileName == fileName)
+                {
+                    chunk = &pending;
+                    // ожидающее записи содержимое замещается новым
+                    chunk->Data.resize(0);
+                    break;
+                }
+            }
+        }
+        else if (!_pending.isEmpty() && _pending.last().Mode == writeMode &&
+                 _pending.last().FileName == fileName)
+        {
+            chunk = &_pending.last();
+        }
+
+        if (chunk && !chunk->Data.isEmpty())
+        {
+            chunk->Data.append(data);
+            data.resize(0);
+        }
+        else
+        {
+            if (!chunk)
+            {
+                _pending.append({fileName, QByteArray(), writeMode});
+                chunk = &_pending.last();
+            }
+            // буфер передается без копирования, взамен выдается освобожденный буфер
+            chunk->Data.swap(data);
+            data.swap(_spare);
+            data.resize(0);
+        }
+
+        _condition.wakeOne();
+    }
+
+    if (!isRunning())
+        start();
+}
+
+void LogFileWriter::stop()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _isStopping = true;
+        _condition.wakeOne();
+    }
+    wait();
+
+    QMutexLocker locker(&_mutex);
+    _isStopping = false;
+}
+
+quint64 LogFileWriter::writtenBytes() const
+{
+    return _writtenBytes.load(std::memory_order_relaxed);
+}
+
+quint64 LogFileWriter::writeErrors() const
+{
+    return _writeErrors.load(std::memory_order_relaxed);
+}
+
+quint64 LogFileWriter::rotations() const
+{
+    return _rotations.load(std::memory_order_relaxed);
+}
+
+bool LogFileWriter::compressFile(const QString &fileName)
+{
+#ifdef Q_OS_LINUX
+    QFile source(fileName);
+    if (!source.open(QIODevice::ReadOnly))
+        return false;
+
+    QString targetName = fileName + ".gz";
+    gzFile target = gzopen(QFile::encodeName(targetName).constData(), "wb6");
+    if (!target)
+        return false;
+
+    bool isCompressed = true;
+    while (!source.atEnd())
+    {
+        QByteArray block = source.read(COMPRESS_BLOCK_SIZE);
+        if (block.isEmpty() ||
+                gzwrite(target, block.constData(), unsigned(block.size())) != block.size())
+        {
+            isCompressed = false;
+            break;
+        }
+    }
+    if (Z_OK != gzclose(target))
+        isCompressed = false;
+
+    // исходный файл удаляется только после успешного сжатия
+    if (isCompressed)
+        source.remove();
+    else
+        QFile::remove(targetName);
+    return isCompressed;
+#endif
+
+#ifdef Q_OS_WIN
+    Q_UNUSED(fileName)
+    return false;
+#endif
+}
+
+void LogFileWriter::run()
+{
+    QVector<Chunk> writing;
+    while (true)
+    {
+        bool isStopping;
+        {
+            QMutexLocker locker(&_mutex);
+            if (_pending.isEmpty() && !_isStopping && _compressQueue.isEmpty())
+                _condition.wait(&_mutex);
+            writing.swap(_pending);
+            isStopping = _isStopping;
+        }
+
+        for (Chunk &chunk : writing)
+            writeChunk(chunk);
+
+        if (!writing.isEmpty())
+        {
+            // освобожденный буфер наибольшей емкости возвращается для повторного использования
+            QByteArray *largest = &writing.first().Data;
+            for (Chunk &chunk : writing)
+            {
+                if (chunk.Data.capacity() > largest->capacity())
+                    largest = &chunk.Data;
+            }
+            largest->resize(0);
+
+            QMutexLocker locker(&_mutex);
+            if (_spare.capacity() < largest->capacity())
+                _spare.swap(*largest);
+        }
+        writing.clear();
+
+        // сжатие выполняется только при отсутствии данных для записи
+        bool hasPending;
+        {
+            QMutexLocker locker(&_mutex);
+            hasPending = !_pending.isEmpty();
+        }
+        if (!hasPending)
+            compressRotatedFiles();
+
+        if (isStopping && !hasPending)
+            break;
+    }
+
+    closeFiles();
+}
+
+void LogFileWriter::writeChunk(Chunk &chunk)
+{
+    LogRotation rotation = this->rotation();
+
+    if (WriteMode::Log == chunk.Mode && chunk.FileName != _logFileName)
+    {
+        // смена даты: предыдущий файл протокола завершен
+        if (!_logFileName.isEmpty())
+        {
+            closeFile(_logFileName);
+            if (rotation.Compress)
+                _compressQueue.append(_logFileName);
+        }
+        _logFileName = chunk.FileName;
+    }
+
+    OpenFile *file = openFile(chunk.FileName, chunk.Mode);
+    if (!file)
+    {
+        _writeErrors++;
+        return;
+    }
+
+    if (WriteMode::Log == chunk.Mode && file->Size > 0)
+    {
+        bool isSizeExceeded = rotation.MaxFileSize > 0 &&
+                file->Size + chunk.Data.size() > rotation.MaxFileSize;
+        bool isIntervalExpired = rotation.IntervalMinutes > 0 &&
+                DateUtils::getTickCount() - file->OpenedTickCount >= qint64(rotation.IntervalMinutes) * 60000;
+        if (isSizeExceeded || isIntervalExpired)
+        {
+            rotateLogFile(rotation);
+            file = openFile(chunk.FileName, chunk.Mode);
+            if (!file)
+            {
+                _writeErrors++;
+                return;
+            }
+        }
+    }
+
+    if (WriteMode::Truncate == chunk.Mode)
+    {
+        file->File->resize(0);
+        file->File->seek(0);
+        file->Size = 0;
+    }
+
+    qint64 writtenCount = file->File->write(chunk.Data);
+    if (writtenCount < chunk.Data.size())
+    {
+        // повторное открытие файла и запись оставшихся данных,
+        // замещаемое содержимое записывается заново
+        _writeErrors++;
+        closeFile(chunk.FileName);
+        qint64 offset = (WriteMode::Truncate == chunk.Mode) ? 0 : qMax(writtenCount, qint64(0));
+        _writtenBytes += quint64(offset);
+        file = openFile(chunk.FileName, chunk.Mode);
+        if (!file)
+            return;
+        writtenCount = file->File->write(chunk.Data.constData() + offset, chunk.Data.size() - offset);
+        if (writtenCount < 0)
+            return;
+    }
+
+    file->Size += writtenCount;
+    _writtenBytes += quint64(writtenCount);
+}
+
+LogFileWriter::OpenFile *LogFileWriter::openFile(const QString &fileName, WriteMode writeMode)
+{
+    auto it = _files.find(fileName);
+    if (it != _files.end())
+        return it.value().get();
+
+    // ограничение количества удерживаемых открытыми файлов данных
+    if (_files.count() >= FILES_MAXIMUM_COUNT)
+    {
+        closeFiles();
+    }
+
+    QFileInfo fileInfo(fileName);
+    QDir().mkpath(fileInfo.absolutePath());
+
+    // без буферизации данные записываются одним системным вызовом на блок,
+    // в режиме добавления файл открывается с O_APPEND
+    QIODevice::OpenMode openMode = QIODevice::WriteOnly | QIODevice::Text | QIODevice::Unbuffered;
+    if (WriteMode::Truncate != writeMode)
+        openMode |= QIODevice::Append;
+
+    auto file = std::make_shared<OpenFile>();
+    file->File.reset(new QFile(fileName));
+    if (!file->File->open(openMode))
+        return nullptr;
+    file->Size = file->File->size();
+    file->OpenedTickCount = DateUtils::getTickCount();
+
+    _files.insert(fileName, file);
+    return file.get();
+}
+
+void LogFileWriter::closeFile(const QString &fileName)
+{
+    auto file = _files.take(fileName);
+    if (file)
+        file->File->close();
+}
+
+void LogFileWriter::closeFiles()
+{
+    for (auto &file : _files)
+        file->File->close();
+    _files.clear();
+}
+
+void LogFileWriter::rotateLogFile(const LogRotation &rotation)
+{
+    closeFile(_logFileName);
+
+    // выбор свободного номера части: Name-yy.MM.dd.N.log
+    QFileInfo fileInfo(_logFileName);
+    QString baseName = fileInfo.absolutePath() + QDir::separator() + fileInfo.completeBaseName();
+    QString suffix = fileInfo.suffix().isEmpty() ? QString() : "." + fileInfo.suffix();
+    QString rotatedName;
+    for (int part = 1; ; part++)
+    {
+        rotatedName = QString("%1.%2%3").arg(baseName).arg(part).arg(suffix);
+        if (!QFile::exists(rotatedName) && !QFile::exists(rotatedName + ".gz"))
+            break;
+    }
+
+    if (!QFile::rename(_logFileName, rotatedName))
+    {
+        _writeErrors++;
+        return;
+    }
+    _rotations++;
+
+    if (rotation.Compress)
+        _compressQueue.append(rotatedName);
+}
+
+void LogFileWriter::compressRotatedFiles()
+{
+    while (!_compressQueue.isEmpty())
+    {
+        QString fileName = _compressQueue.takeFirst();
+        if (QFile::exists(fileName))
+            compressFile(fileName);
+
+        // новые данные для записи имеют приоритет перед сжатием
+        QMutexLocker locker(&_mutex);
+        if (!_pending.isEmpty())
+            break;
+    }
+}
+
+}}
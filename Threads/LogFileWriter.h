@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief LogRotation - Правила ротации файла протокола
+ * Файл протокола всегда сменяется при смене даты. Нулевое значение ограничения
+ * означает его отсутствие
+ */
+struct LogRotation
+{
+    qint64 MaxFileSize = 0;        // размер файла в байтах, при превышении файл ротируется
+    int IntervalMinutes = 0;       // время жизни файла в минутах
+    bool Compress = false;         // сжатие ротированных файлов в gzip
+};
+
+/**
+ * @brief LogFileWriter - Поток записи файлов протокола и файлов данных
+ * Поток протоколирования передает накопленный буфер одной операцией и получает
+ * взамен освобожденный буфер записи (двойная буферизация), поэтому запись на диск
+ * его не задерживает. Файлы открываются в режиме добавления без буферизации (O_APPEND)
+ * и удерживаются открытыми между записями, данные записываются большими блоками.
+ * Ротированные файлы сжимаются этим же потоком при отсутствии данных для записи
+ */
+class THREADERSHARED_EXPORT LogFileWriter : public QThread
+{
+public:
+    enum class WriteMode
+    {
+        Log,      // файл протокола с ротацией
+        Append,   // добавление в файл
+        Truncate  // замена содержимого файла, ожидающее записи содержимое замещается
+    };
+
+public:
+    explicit LogFileWriter();
+    ~LogFileWriter() override;
+
+    void setRotation(const LogRotation &rotation);
+    LogRotation rotation() const;
+
+    /**
+     * @brief submit - Передача данных на запись
+     * Буфер заменяется пустым буфером, освобожденным потоком записи
+     * @param fileName - Полное имя файла
+     * @param data - Данные, после вызова пустой буфер
+     * @param writeMode - Режим записи
+     */
+    void submit(const QString &fileName, QByteArray &data, WriteMode writeMode);
+
+    /**
+     * @brief stop - Запись оставшихся данных, закрытие файлов и завершение потока
+     */
+    void stop();
+
+    quint64 writtenBytes() const;
+    quint64 writeErrors() const;
+    quint64 rotations() const;
+
+    /**
+     * @brief compressFile - Сжатие файла в gzip с удалением исходного файла
+     * @param fileName - Имя файла
+     * @return - Признак успешного сжатия, на Windows сжатие не поддерживается
+     */
+    static bool compressFile(const QString &fileName);
+
+protected:
+    void run() override;
+
+private:
+    struct Chunk
+    {
+        QString FileName;
+        QByteArray Data;
+        WriteMode Mode;
+    };
+
+    struct OpenFile
+    {
+        std::unique_ptr<QFile> File;
+        qint64 Size;
+        qint64 OpenedTickCount;
+    };
+
+    void writeChunk(Chunk &chunk);
+    OpenFile *openFile(const QString &fileName, WriteMode writeMode);
+    void closeFile(const QString &fileName);
+    void closeFiles();
+    void rotateLogFile(const LogRotation &rotation);
+    void compressRotatedFiles();
+
+private:
+    static const int FILES_MAXIMUM_COUNT = 16;
+
+    mutable QMutex _mutex;
+    QWaitCondition _condition;
+    QVector<Chunk> _pending;
+    QByteArray _spare;
+    LogRotation _rotation;
+    bool _isStopping;
+
+    // используются только потоком записи
+    QHash<QString, std::shared_ptr<OpenFile>> _files;
+    QString _logFileName;
+    QStringList _compressQueue;
+
+    std::atomic<quint64> _writtenBytes;
+    std::atomic<quint64> _writeErrors;
+    std::atomic<quint64> _rotations;
+};
+
+}}
@@ -68,4 +68,15 @@ MESSAGE_TEMPLATE(113, 0, Message,
 MESSAGE_TEMPLATE(120, 0, Message,
                  "Статистика выполнения - потоков: %d шт., используемая память: %d Kb, сообщений: %d шт.");
 
+// Сообщения сервера метрик
+
+MESSAGE_TEMPLATE(130, 0, Message,
+                 "Запуск сервера метрик на порту %d...");
+
+MESSAGE_TEMPLATE(131, 0, Message,
+                 "Сервер метрик ожидает подключений на порту %d");
+
+MESSAGE_TEMPLATE(132, 0, Error,
+                 "Ошибка сервера метрик на порту %d: %d (%s)");
+
 }}
@@ -0,0 +1,191 @@
+#include "LogRateLimiter.h"
+
+#include "../Utils/DateUtils.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <atomic>
+
+namespace Threader {
+
+namespace Threads {
+
+
+using namespace Threader::Utils;
+
+
+namespace {
+
+/**
+ * @brief LimitState - Состояние ограничения шаблона
+ * Параметры ограничения пересчитываются при смене правил и читаются без блокировки
+ */
+struct LimitState
+{
+    int Number;
+    int Level;
+    MessageType Type;
+
+    std::atomic<qint64> IntervalMicroseconds{0};
+    std::atomic<qint64> ToleranceMicroseconds{0};
+    std::atomic<int> SampleEvery{1};
+
+    // теоретическое время следующего сообщения (GCRA)
+    std::atomic<qint64> ArrivalMicroseconds{0};
+    std::atomic<quint64> Seen{0};
+    std::atomic<quint64> Suppressed{0};
+};
+
+struct LimitsRegistry
+{
+    QMutex Mutex;
+    QVector<LogRateLimit> Limits;
+    QHash<qint64, LimitState*> States;
+};
+
+LimitsRegistry &limitsRegistry()
+{
+    static LimitsRegistry registry;
+    return registry;
+}
+
+std::atomic<bool> isLimitsEnabled(false);
+
+thread_local QHash<qint64, LimitState*> statesCache;
+
+qint64 stateKey(int number, int level)
+{
+    return (qint64(number) << 32) | quint32(level);
+}
+
+void resolveLimit(LimitState &state, const QVector<LogRateLimit> &limits)
+{
+    const LogRateLimit *limit = nullptr;
+    for (const LogRateLimit &rule : limits)
+    {
+        if (rule.Number >= 0 && rule.Number == state.Number)
+        {
+            limit = &rule;
+            break;
+        }
+    }
+    if (!limit)
+    {
+        for (const LogRateLimit &rule : limits)
+        {
+            if (rule.Number < 0 && rule.Level >= 0 && state.Level >= rule.Level &&
+                    (!limit || rule.Level > limit->Level))
+                limit = &rule;
+        }
+    }
+
+    qint64 interval = (limit && limit->RatePerSecond > 0) ? qint64(1000000.0 / limit->RatePerSecond) : 0;
+    int burst = limit ? qMax(limit->Burst, 1) : 1;
+    state.IntervalMicroseconds.store(interval, std::memory_order_relaxed);
+    state.ToleranceMicroseconds.store(interval * (burst - 1), std::memory_order_relaxed);
+    state.SampleEvery.store(limit ? qMax(limit->SampleEvery, 1) : 1, std::memory_order_relaxed);
+}
+
+LimitState *findState(const MessageLogTemplate &messageTemplate)
+{
+    qint64 key = stateKey(messageTemplate.number, messageTemplate.level);
+    LimitState *state = statesCache.value(key, nullptr);
+    if (state)
+        return state;
+
+    LimitsRegistry &registry = limitsRegistry();
+    {
+        QMutexLocker locker(&registry.Mutex);
+        state = registry.States.value(key, nullptr);
+        if (!state)
+        {
+            // состояния не удаляются, количество ограничено количеством шаблонов
+            state = new LimitState();
+            state->Number = messageTemplate.number;
+            state->Level = messageTemplate.level;
+            state->Type = messageTemplate.messageType;
+            resolveLimit(*state, registry.Limits);
+            registry.States.insert(key, state);
+        }
+    }
+    statesCache.insert(key, state);
+    return state;
+}
+
+}
+
+
+void LogRateLimiter::setLimits(const QVector<LogRateLimit> &limits)
+{
+    LimitsRegistry &registry = limitsRegistry();
+    QMutexLocker locker(&registry.Mutex);
+    registry.Limits = limits;
+    for (LimitState *state : registry.States)
+        resolveLimit(*state, registry.Limits);
+    isLimitsEnabled.store(!limits.isEmpty(), std::memory_order_relaxed);
+}
+
+QVector<LogRateLimit> LogRateLimiter::limits()
+{
+    LimitsRegistry &registry = limitsRegistry();
+    QMutexLocker locker(&registry.Mutex);
+    return registry.Limits;
+}
+
+bool LogRateLimiter::allow(const MessageLogTemplate &messageTemplate)
+{
+    if (!isLimitsEnabled.load(std::memory_order_relaxed))
+        return true;
+
+    LimitState *state = findState(messageTemplate);
+
+    // выборка 1 из N
+    int sampleEvery = state->SampleEvery.load(std::memory_order_relaxed);
+    if (sampleEvery > 1 && 0 != state->Seen.fetch_add(1, std::memory_order_relaxed) % quint64(sampleEvery))
+    {
+        state->Suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // корзина маркеров: сообщение допускается, если теоретическое время его прихода
+    // опережает текущее не более чем на допуск пачки
+    qint64 interval = state->IntervalMicroseconds.load(std::memory_order_relaxed);
+    if (interval <= 0)
+        return true;
+
+    // время шага цикла потока (LoopClock) имеет разрешение 1 мс и не меняется в течение шага:
+    // интервалы меньше миллисекунды не соблюдались бы, долгий шаг подавлял бы лишние сообщения
+    qint64 now = DateUtils::getTickCountNanoseconds() / 1000;
+    qint64 tolerance = state->ToleranceMicroseconds.load(std::memory_order_relaxed);
+    qint64 arrival = state->ArrivalMicroseconds.load(std::memory_order_relaxed);
+    while (true)
+    {
+        qint64 base = qMax(arrival, now);
+        if (base - now > tolerance)
+        {
+            state->Suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (state->ArrivalMicroseconds.compare_exchange_weak(arrival, base + interval,
+                                                             std::memory_order_relaxed))
+            return true;
+    }
+}
+
+QVector<LogSuppressedCount> LogRateLimiter::takeSuppressed()
+{
+    QVector<LogSuppressedCount> result;
+    LimitsRegistry &registry = limitsRegistry();
+    QMutexLocker locker(&registry.Mutex);
+    for (LimitState *state : registry.States)
+    {
+        quint64 count = state->Suppressed.exchange(0, std::memory_order_relaxed);
+        if (count > 0)
+            result.append({state->Number, state->Level, state->Type, count});
+    }
+    return result;
+}
+
+}}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "MessageLog.h"
+
+#include "../threader_global.h"
+
+#include <QVector>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief LogRateLimit - Ограничение частоты сообщений протоколирования
+ * Правило по номеру шаблона имеет приоритет над правилом по уровню, из правил
+ * по уровню выбирается правило с наибольшим уровнем, не превышающим уровень шаблона
+ */
+struct LogRateLimit
+{
+    int Number = -1;            // номер шаблона, -1 - правило по уровню
+    int Level = -1;             // уровень шаблона и выше (менее важные сообщения)
+    double RatePerSecond = 0;   // средняя частота сообщений, 0 - без ограничения
+    int Burst = 1;              // количество сообщений, пропускаемых подряд
+    int SampleEvery = 1;        // пропускается каждое N-е сообщение, 1 - все
+};
+
+/**
+ * @brief LogSuppressedCount - Количество подавленных сообщений шаблона
+ */
+struct LogSuppressedCount
+{
+    int Number;
+    int Level;
+    MessageType Type;
+    quint64 Count;
+};
+
+/**
+ * @brief LogRateLimiter - Ограничение частоты и выборка сообщений протоколирования
+ * Решение принимается в потоке-источнике до форматирования и выделения памяти:
+ * сначала выборка 1 из N, затем корзина маркеров (алгоритм GCRA на одной атомарной
+ * переменной). Состояние ведется по паре номер-уровень шаблона и общее для всех
+ * потоков. Без заданных правил проверка сводится к чтению одного признака
+ */
+class THREADERSHARED_EXPORT LogRateLimiter
+{
+public:
+    LogRateLimiter() = delete;
+
+    /**
+     * @brief setLimits - Замена правил ограничения, применяется к уже известным шаблонам
+     * @param limits - Правила ограничения
+     */
+    static void setLimits(const QVector<LogRateLimit> &limits);
+    static QVector<LogRateLimit> limits();
+
+    /**
+     * @brief allow - Проверка допустимости сообщения
+     * @param messageTemplate - Шаблон сообщения
+     * @return - Признак записи сообщения, false - сообщение подавлено
+     */
+    static bool allow(const MessageLogTemplate &messageTemplate);
+
+    /**
+     * @brief takeSuppressed - Получение и сброс счетчиков подавленных сообщений
+     * @return - Шаблоны, сообщения которых подавлялись после предыдущего вызова
+     */
+    static QVector<LogSuppressedCount> takeSuppressed();
+};
+
+}}
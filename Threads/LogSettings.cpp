@@ -0,0 +1,130 @@
+#include "LogSettings.h"
+
+#include <QMutexLocker>
+
+namespace Threader {
+
+namespace Threads {
+
+#define LOG_SETTINGS_GROUP_NAME "Log"
+#define RATE_LIMITS_ARRAY_NAME "LogRateLimit"
+
+
+bool LogSettings::read(QSettings &settings)
+{
+    LogRotation rotation;
+    settings.beginGroup(LOG_SETTINGS_GROUP_NAME);
+    rotation.MaxFileSize = settings.value("MaxFileSize", 0).toLongLong();
+    rotation.IntervalMinutes = settings.value("RotationIntervalMinutes", 0).toInt();
+    rotation.Compress = settings.value("CompressRotated", false).toBool();
+    int consoleMaximumLines = settings.value("ConsoleMaximumLines", 0).toInt();
+    int rateLimitSummarySeconds = settings.value("RateLimitSummarySeconds",
+                                                 DEFAULT_RATE_LIMIT_SUMMARY_SECONDS).toInt();
+    settings.endGroup();
+
+    QVector<LogRateLimit> rateLimits;
+    int count = settings.beginReadArray(RATE_LIMITS_ARRAY_NAME);
+    for (int i = 0; i < count; i++)
+    {
+        settings.setArrayIndex(i);
+
+        LogRateLimit limit;
+        limit.Number = settings.value("Number", -1).toInt();
+        limit.Level = settings.value("Level", -1).toInt();
+        if (limit.Number < 0 && limit.Level < 0)
+            continue;
+
+        limit.RatePerSecond = settings.value("RatePerSecond", 0).toDouble();
+        limit.Burst = settings.value("Burst", 1).toInt();
+        limit.SampleEvery = settings.value("SampleEvery", 1).toInt();
+        rateLimits.append(limit);
+    }
+    settings.endArray();
+
+    QMutexLocker locker(&_mutex);
+    _rotation = rotation;
+    _consoleMaximumLines = consoleMaximumLines;
+    _rateLimits = rateLimits;
+    _rateLimitSummarySeconds = rateLimitSummarySeconds;
+    return true;
+}
+
+bool LogSettings::write(QSettings &settings)
+{
+    QMutexLocker locker(&_mutex);
+    settings.beginGroup(LOG_SETTINGS_GROUP_NAME);
+    settings.setValue("MaxFileSize", _rotation.MaxFileSize);
+    settings.setValue("RotationIntervalMinutes", _rotation.IntervalMinutes);
+    settings.setValue("CompressRotated", _rotation.Compress);
+    settings.setValue("ConsoleMaximumLines", _consoleMaximumLines);
+    settings.setValue("RateLimitSummarySeconds", _rateLimitSummarySeconds);
+    settings.endGroup();
+
+    // без правил массив в файл настроек не добавляется
+    if (_rateLimits.isEmpty())
+        return true;
+
+    settings.beginWriteArray(RATE_LIMITS_ARRAY_NAME, _rateLimits.count());
+    for (int i = 0; i < _rateLimits.count(); i++)
+    {
+        const LogRateLimit &limit = _rateLimits.at(i);
+        settings.setArrayIndex(i);
+        settings.setValue("Number", limit.Number);
+        settings.setValue("Level", limit.Level);
+        settings.setValue("RatePerSecond", limit.RatePerSecond);
+        settings.setValue("Burst", limit.Burst);
+        settings.setValue("SampleEvery", limit.SampleEvery);
+    }
+    settings.endArray();
+    return true;
+}
+
+LogRotation LogSettings::rotation() const
+{
+    QMutexLocker locker(&_mutex);
+    return _rotation;
+}
+
+void LogSettings::setRotation(const LogRotation &rotation)
+{
+    QMutexLocker locker(&_mutex);
+    _rotation = rotation;
+}
+
+int LogSettings::consoleMaximumLines() const
+{
+    QMutexLocker locker(&_mutex);
+    return _consoleMaximumLines;
+}
+
+void LogSettings::setConsoleMaximumLines(int consoleMaximumLines)
+{
+    QMutexLocker locker(&_mutex);
+    _consoleMaximumLines = consoleMaximumLines;
+}
+
+QVector<LogRateLimit> LogSettings::rateLimits() const
+{
+    QMutexLocker locker(&_mutex);
+    return _rateLimits;
+}
+
+void LogSettings::setRateLimits(const QVector<LogRateLimit> &rateLimits)
+{
+    QMutexLocker locker(&_mutex);
+    _rateLimits = rateLimits;
+}
+
+int LogSettings::rateLimitSummarySeconds() const
+{
+    QMutexLocker locker(&_mutex);
+    return _rateLimitSummarySeconds;
+}
+
+void LogSettings::setRateLimitSummarySeconds(int rateLimitSummarySeconds)
+{
+    QMutexLocker locker(&_mutex);
+    _rateLimitSummarySeconds = rateLimitSummarySeconds;
+}
+
+}}
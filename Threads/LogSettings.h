@@ -0,0 +1,70 @@
+#pragma once
+
+#include "LogFileWriter.h"
+#include "LogRateLimiter.h"
+#include "SettingsBase.h"
+
+#include "../threader_global.h"
+
+#include <QMutex>
+#include <QSettings>
+#include <QVector>
+
+#include <memory>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief LogSettings - Настройки подсистемы протоколирования
+ * Настройки хранятся в разделе Log:
+ *   Log\MaxFileSize=67108864
+ *   Log\RotationIntervalMinutes=0
+ *   Log\CompressRotated=true
+ *   Log\ConsoleMaximumLines=4096
+ *   Log\RateLimitSummarySeconds=10
+ * Ограничения частоты сообщений хранятся в массиве LogRateLimit:
+ *   LogRateLimit\size=2
+ *   LogRateLimit\1\Number=1107
+ *   LogRateLimit\1\RatePerSecond=10
+ *   LogRateLimit\1\Burst=20
+ *   LogRateLimit\2\Level=8
+ *   LogRateLimit\2\SampleEvery=100
+ */
+class THREADERSHARED_EXPORT LogSettings : public SettingsBase
+{
+public:
+    using Ptr = std::shared_ptr<LogSettings>;
+
+public:
+    bool read(QSettings &settings) override;
+    bool write(QSettings &settings) override;
+
+    LogRotation rotation() const;
+    void setRotation(const LogRotation &rotation);
+
+    int consoleMaximumLines() const;
+    void setConsoleMaximumLines(int consoleMaximumLines);
+
+    QVector<LogRateLimit> rateLimits() const;
+    void setRateLimits(const QVector<LogRateLimit> &rateLimits);
+
+    /**
+     * @brief rateLimitSummarySeconds - Период вывода количества подавленных сообщений
+     * @return - Период в секундах
+     */
+    int rateLimitSummarySeconds() const;
+    void setRateLimitSummarySeconds(int rateLimitSummarySeconds);
+
+private:
+    static const int DEFAULT_RATE_LIMIT_SUMMARY_SECONDS = 10;
+
+    mutable QMutex _mutex;
+    LogRotation _rotation;
+    int _consoleMaximumLines = 0;
+    QVector<LogRateLimit> _rateLimits;
+    int _rateLimitSummarySeconds = DEFAULT_RATE_LIMIT_SUMMARY_SECONDS;
+};
+
+}}
@@ -1,4 +1,7 @@
 #include "MessageBase.h"
+#include "MessageTypes.h"
+
+#include "../Utils/DateUtils.h"
 
 #ifdef Q_OS_LINUX
 #include "ThreadBase.h"
@@ -12,13 +15,18 @@ namespace Threader {
 
 namespace Threads {
 
-int MessageBase::_referenceCount(0);
+using namespace Threader::Utils;
+
+ShardedCounter MessageBase::_referenceCount;
 
-QMutex MessageBase::_mutexReferenceCount;
+const int MessageBase::TYPE_ID = MessageTypes::registerType("MessageBase");
 
 MessageBase::MessageBase(const QString &name)
-    : _created(QDateTime::currentDateTime())
+    : _createdNanoseconds(DateUtils::getTickCountNanoseconds())
+    , _enqueuedNanoseconds(0)
     , _name(name)
+    , _typeId(TYPE_ID)
+    , _priority(MessagePriority::Normal)
     #ifdef Q_OS_LINUX
     , _threadId(ThreadBase::threadId())
     #endif
@@ -26,17 +34,27 @@ MessageBase::MessageBase(const QString &name)
     , _threadId(GetCurrentThreadId())
     #endif
 {
-    incrementReferenceCount();
+    _referenceCount.increment();
 }
 
 MessageBase::~MessageBase()
 {
-    decrementReferenceCount();
+    _referenceCount.decrement();
 }
 
 QDateTime MessageBase::created()
 {
-    return _created;
+    if (_created.isValid())
+        return _created;
+
+    // календарное время получается вычитанием возраста сообщения из текущего
+    qint64 ageMsecs = (DateUtils::getTickCountNanoseconds() - _createdNanoseconds) / 1000000;
+    return QDateTime::fromMSecsSinceEpoch(QDateTime::currentMSecsSinceEpoch() - ageMsecs);
+}
+
+qint64 MessageBase::createdNanoseconds() const
+{
+    return _createdNanoseconds;
 }
 
 QString MessageBase::name() const
@@ -44,27 +62,44 @@ QString MessageBase::name() const
     return _name;
 }
 
-long MessageBase::threadId() const
+int MessageBase::typeId() const
 {
-    return _threadId;
+    return _typeId;
 }
 
-int MessageBase::referenceCount()
+MessagePriority MessageBase::priority() const
 {
-    QMutexLocker locker(&_mutexReferenceCount);
-    return _referenceCount;
+    return _priority;
 }
 
-void MessageBase::incrementReferenceCount()
+void MessageBase::setPriority(MessagePriority priority)
 {
-    QMutexLocker locker(&_mutexReferenceCount);
-    MessageBase::_referenceCount++;
+    _priority = priority;
 }
 
-void MessageBase::decrementReferenceCount()
+QString MessageBase::conflationKey() const
 {
-    QMutexLocker locker(&_mutexReferenceCount);
-    _referenceCount--;
+    return _conflationKey;
+}
+
+void MessageBase::setConflationKey(const QString &conflationKey)
+{
+    _conflationKey = conflationKey;
+}
+
+qint64 MessageBase::approximateSize() const
+{
+    return qint64(sizeof(MessageBase)) + _name.size() * qint64(sizeof(QChar));
+}
+
+long MessageBase::threadId() const
+{
+    return _threadId;
+}
+
+int MessageBase::referenceCount()
+{
+    return int(_referenceCount.value());
 }
 
 void MessageBase::setCreated(const QDateTime &created)
@@ -72,4 +107,9 @@ void MessageBase::setCreated(const QDateTime &created)
     _created = created;
 }
 
+void MessageBase::setTypeId(int typeId)
+{
+    _typeId = typeId;
+}
+
 }}
@@ -2,19 +2,36 @@
 
 #include "../threader_global.h"
 
+#include "../Utils/ShardedCounter.h"
+
 #include <QDateTime>
 #include <QList>
 #include <QMetaType>
-#include <QMutex>
 #include <QThread>
 #include <QVector>
 
+#include <atomic>
 #include <memory>
 
 namespace Threader {
 
 namespace Threads {
 
+/**
+ * @brief MessagePriority - Приоритет сообщения, определяющий очередь потока-получателя
+ */
+enum class MessagePriority
+{
+    Control,  // управляющие сообщения обрабатываются раньше всех остальных
+    Normal,   // сообщения по умолчанию
+    Bulk      // массовые данные, обрабатываются после обычных с защитой от голодания
+};
+
+/**
+ * @brief MESSAGE_PRIORITIES_COUNT - Количество приоритетов сообщений
+ */
+const int MESSAGE_PRIORITIES_COUNT = 3;
+
 /**
  * @brief MessageBase - Базовый класс сообщения, передаваемого между потоками
  */
@@ -24,6 +41,8 @@ public:
     using Ptr = std::shared_ptr<MessageBase>;
 
 public:
+    static const int TYPE_ID;
+
     /**
      * @brief BaseMessage - Конструктор класса с задаваемым именем сообщения
      * @param name - Имя сообщения
@@ -37,16 +56,78 @@ public:
 
     /**
      * @brief created - Получение даты и времени создания сообщения
+     * Вычисляется при обращении по монотонной отметке времени создания
      * @return - Дата и время создания сообщения
      */
     QDateTime created();
 
+    /**
+     * @brief createdNanoseconds - Получение монотонной отметки времени создания сообщения
+     * @return - Значение монотонного счетчика в наносекундах
+     */
+    qint64 createdNanoseconds() const;
+
+    /**
+     * @brief enqueuedNanoseconds - Получение монотонной отметки времени размещения
+     * сообщения во входящей очереди потока-получателя
+     * @return - Значение CycleClock::nanoseconds(), 0 - время не отмечалось
+     */
+    qint64 enqueuedNanoseconds() const;
+
+    /**
+     * @brief setEnqueuedNanoseconds - Установка отметки времени размещения в очереди
+     * Устанавливается потоком-получателем при размещении сообщения в очереди
+     * @param enqueuedNanoseconds - Значение CycleClock::nanoseconds()
+     */
+    void setEnqueuedNanoseconds(qint64 enqueuedNanoseconds);
+
     /**
      * @brief name - Получение имени сообщения
      * @return - Имя сообщения
      */
     QString name() const;
 
+    /**
+     * @brief typeId - Получение идентификатора типа сообщения
+     * Используется для маршрутизации вместо сравнения имен
+     * @return - Идентификатор типа из реестра MessageTypes
+     */
+    int typeId() const;
+
+    /**
+     * @brief priority - Получение приоритета сообщения
+     * @return - Приоритет сообщения
+     */
+    MessagePriority priority() const;
+
+    /**
+     * @brief setPriority - Установка приоритета сообщения
+     * Устанавливается отправителем до отправки сообщения
+     * @param priority - Приоритет сообщения
+     */
+    void setPriority(MessagePriority priority);
+
+    /**
+     * @brief conflationKey - Получение ключа замещения сообщения
+     * При политике замещения очереди получателя сообщение с тем же ключом,
+     * ожидающее обработки, замещается новым
+     * @return - Ключ замещения или пустая строка
+     */
+    QString conflationKey() const;
+
+    /**
+     * @brief setConflationKey - Установка ключа замещения сообщения
+     * @param conflationKey - Ключ замещения
+     */
+    void setConflationKey(const QString &conflationKey);
+
+    /**
+     * @brief approximateSize - Получение приблизительного объема памяти сообщения
+     * Используется для ограничения объема входящей очереди потока
+     * @return - Объем в байтах
+     */
+    virtual qint64 approximateSize() const;
+
     /**
      * @brief threadId - Получение идентификатора потока, создавшего сообщение
      * @return - Идентификатор потока
@@ -63,9 +144,27 @@ protected:
      */
     void setCreated(const QDateTime &created);
 
+    /**
+     * @brief setTypeId - Установка идентификатора типа сообщения
+     * Вызывается конструкторами производных классов
+     * @param typeId - Идентификатор типа из реестра MessageTypes
+     */
+    void setTypeId(int typeId);
+
 private:
     /**
-     * @brief _created - Дата и время создания сообщения
+     * @brief _createdNanoseconds - Монотонная отметка времени создания сообщения
+     */
+    qint64 _createdNanoseconds;
+
+    /**
+     * @brief _enqueuedNanoseconds - Монотонная отметка времени размещения в очереди
+     * Сообщение, отправленное нескольким получателям, хранит отметку последнего размещения
+     */
+    std::atomic<qint64> _enqueuedNanoseconds;
+
+    /**
+     * @brief _created - Явно установленные дата и время создания сообщения
      */
     QDateTime _created;
 
@@ -74,6 +173,21 @@ private:
      */
     QString _name;
 
+    /**
+     * @brief _typeId - Идентификатор типа сообщения
+     */
+    int _typeId;
+
+    /**
+     * @brief _priority - Приоритет сообщения
+     */
+    MessagePriority _priority;
+
+    /**
+     * @brief _conflationKey - Ключ замещения сообщения
+     */
+    QString _conflationKey;
+
     /**
      * @brief _threadId - Идентификатор потока
      */
@@ -82,17 +196,35 @@ private:
     /**
      * @brief _referenceCount - Счетчик экземпляров
      */
-    static int _referenceCount;
-
-    static QMutex _mutexReferenceCount;
-    void incrementReferenceCount();
-    void decrementReferenceCount();
+    static Utils::ShardedCounter _referenceCount;
 };
 
+inline qint64 MessageBase::enqueuedNanoseconds() const
+{
+    return _enqueuedNanoseconds.load(std::memory_order_relaxed);
+}
+
+inline void MessageBase::setEnqueuedNanoseconds(qint64 enqueuedNanoseconds)
+{
+    _enqueuedNanoseconds.store(enqueuedNanoseconds, std::memory_order_relaxed);
+}
+
 using MessagesList = QList<MessageBase::Ptr>;
 
 using MessagesVector = QVector<MessageBase::Ptr>;
 
+/**
+ * @brief PostMessageResult - Результат отправки сообщения
+ */
+enum class PostMessageResult
+{
+    Accepted,       // сообщение принято
+    DroppedOldest,  // сообщение принято, самое старое сообщение очереди будет удалено
+    Conflated,      // сообщение заместило ожидающее обработки сообщение с тем же ключом
+    Rejected,       // сообщение отклонено из-за переполнения очереди
+    TimedOut        // сообщение отклонено по истечении времени ожидания места в очереди
+};
+
 /**
  * @brief ISubscriber - Интерфейс потребителя сообщений
  */
@@ -105,8 +237,9 @@ public:
     /**
      * @brief postMessage - Оправка сообщения потоку
      * @param message - Сообщения для потока
+     * @return - Результат отправки
      */
-    virtual void postMessage(const MessageBase::Ptr &message) = 0;
+    virtual PostMessageResult postMessage(const MessageBase::Ptr &message) = 0;
 
     /**
      * @brief postMessages - Отправка потоку группы сообщений
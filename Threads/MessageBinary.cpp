@@ -1,14 +1,19 @@
 #include "MessageBinary.h"
 
+#include "MessageTypes.h"
+
 namespace Threader {
 
 namespace Threads {
 
 const QString MessageBinary::BINARY_MESSAGE_NAME = "Message.Binary";
 
+const int MessageBinary::TYPE_ID = MessageTypes::registerType("MessageBinary");
+
 MessageBinary::MessageBinary(const char *data, int size)
     : MessageBase (QString(BINARY_MESSAGE_NAME))
 {
+    setTypeId(TYPE_ID);
     _data.append(data, size);
 }
 
@@ -16,6 +21,7 @@ MessageBinary::MessageBinary(const QString &name,
                              const char *data, int size)
     : MessageBase(name)
 {
+    setTypeId(TYPE_ID);
     _data.append(data, size);
 }
 
@@ -23,14 +29,23 @@ MessageBinary::MessageBinary(const QString &name,
                              const QByteArray *data)
     : MessageBase(name)
     , _data(*data)
-{}
+{
+    setTypeId(TYPE_ID);
+}
 
 MessageBinary::MessageBinary(const QString& name,
                              const QByteArray &data)
     : MessageBase(name)
     , _data(data)
-{}
+{
+    setTypeId(TYPE_ID);
+}
+
 
+qint64 MessageBinary::approximateSize() const
+{
+    return MessageBase::approximateSize() + _data.size();
+}
 
 const QByteArray *MessageBinary::data() const
 {
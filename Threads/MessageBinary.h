@@ -16,6 +16,7 @@ public:
     using Ptr = std::shared_ptr<MessageBinary>;
 
 public:
+    static const int TYPE_ID;
 
     static const QString BINARY_MESSAGE_NAME;
 
@@ -26,6 +27,8 @@ public:
 
     const QByteArray *data() const;
 
+    qint64 approximateSize() const override;
+
 protected:
     void setData(QByteArray *data);
 
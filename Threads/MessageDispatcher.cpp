@@ -0,0 +1,19 @@
+#include "MessageDispatcher.h"
+
+namespace Threader {
+
+namespace Threads {
+
+
+void MessageDispatcher::setHandler(int typeId, const Handler &handler)
+{
+    if (typeId < 0)
+        return;
+
+    if (typeId >= _handlers.count())
+        _handlers.resize(typeId + 1);
+
+    _handlers[typeId] = handler;
+}
+
+}}
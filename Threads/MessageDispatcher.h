@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include "MessageBase.h"
+
+#include <QVector>
+
+#include <functional>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief MessageDispatcher - Таблица обработчиков сообщений по идентификатору типа
+ * Обработчик выбирается индексом в массиве по MessageBase::typeId(),
+ * сообщение приводится к типу обработчика через static_pointer_cast.
+ * Тип сопоставляется точно: обработчик базового класса не вызывается
+ * для сообщений производных классов
+ */
+class THREADERSHARED_EXPORT MessageDispatcher
+{
+public:
+    using Handler = std::function<void(const MessageBase::Ptr &)>;
+
+public:
+    /**
+     * @brief on - Установка обработчика сообщений заданного класса
+     * @param handler - Функция, принимающая const std::shared_ptr<T> &
+     */
+    template<typename T, typename Function>
+    void on(Function handler)
+    {
+        setHandler(T::TYPE_ID, [handler](const MessageBase::Ptr &message)
+        {
+            handler(std::static_pointer_cast<T>(message));
+        });
+    }
+
+    /**
+     * @brief off - Удаление обработчика сообщений заданного класса
+     */
+    template<typename T>
+    void off()
+    {
+        setHandler(T::TYPE_ID, Handler());
+    }
+
+    /**
+     * @brief setHandler - Установка обработчика для идентификатора типа
+     * @param typeId - Идентификатор типа сообщения
+     * @param handler - Обработчик, пустой обработчик удаляет установленный
+     */
+    void setHandler(int typeId, const Handler &handler);
+
+    /**
+     * @brief dispatch - Вызов обработчика, соответствующего типу сообщения
+     * @param message - Сообщение
+     * @return - Признак наличия обработчика
+     */
+    bool dispatch(const MessageBase::Ptr &message) const
+    {
+        int typeId = message->typeId();
+        if (typeId >= _handlers.count())
+            return false;
+
+        const Handler &handler = _handlers.at(typeId);
+        if (!handler)
+            return false;
+
+        handler(message);
+        return true;
+    }
+
+private:
+    /**
+     * @brief _handlers - Обработчики, индексированные идентификатором типа
+     */
+    QVector<Handler> _handlers;
+};
+
+}}
@@ -1,5 +1,7 @@
 #include "MessageLog.h"
 
+#include "MessageTypes.h"
+
 namespace Threader {
 
 namespace Threads {
@@ -8,12 +10,15 @@ namespace Threads {
 
 const QString MessageLog::MESSAGE_NAME = MESSAGE_NAME_LOG_DEFINITION;
 
+const int MessageLog::TYPE_ID = MessageTypes::registerType("MessageLog");
+
 MessageLog::MessageLog(const QString& text, int number, int level, MessageType messageType)
     : MessageString(text, MessageLog::MESSAGE_NAME)
     , _number(number)
     , _level(level)
     , _messageType(messageType)
 {
+    setTypeId(TYPE_ID);
 }
 
 MessageLog::MessageLog(const MessageLogTemplate *messageTemplate, ...)
@@ -22,6 +27,7 @@ MessageLog::MessageLog(const MessageLogTemplate *messageTemplate, ...)
     , _level(messageTemplate->level)
     , _messageType(messageTemplate->messageType)
 {
+    setTypeId(TYPE_ID);
     char resultPtr[1024];
     memset(resultPtr, 0, sizeof(resultPtr));
 
@@ -44,6 +50,7 @@ MessageLog::MessageLog(const MessageLogTemplate messageTemplate)
     , _level(messageTemplate.level)
     , _messageType(messageTemplate.messageType)
 {
+    setTypeId(TYPE_ID);
     setText(messageTemplate.text);
 }
 
@@ -68,19 +75,25 @@ int MessageLog::level() const
 }
 
 QString MessageLog::toString(int messageFlags)
+{
+    return format(created(), _messageType, _number, text(), messageFlags);
+}
+
+QString MessageLog::format(const QDateTime &created, MessageType messageType, int number,
+                           const QString &text, int messageFlags)
 {
     QString format;
     QString result = "";
     if (MessageToStringFlags::Date & messageFlags) {
         format = "dd.MM.yyyy";
-        result += created().toString(format);
+        result += created.toString(format);
     }
 
     if (MessageToStringFlags::Time & messageFlags) {
         format = "hh:mm:ss.zzz";
         if (!result.isEmpty())
             result += " ";
-        result += created().toString(format);
+        result += created.toString(format);
     }
 
     if (!result.isEmpty())
@@ -89,20 +102,20 @@ QString MessageLog::toString(int messageFlags)
     if (MessageToStringFlags::Type & messageFlags) {
         if (!result.isEmpty())
             result += " ";
-        result += messageTypeString() + ':';
+        result += MessagesTypesNames[messageType] + ':';
     }
 
     if (MessageToStringFlags::Number & messageFlags) {
         if (!result.isEmpty())
             result += " ";
 
-        result += QString(" %1 ").arg(number(), 5, 10, QLatin1Char('0'));
+        result += QString(" %1 ").arg(number, 5, 10, QLatin1Char('0'));
     }
 
     if (MessageToStringFlags::Text & messageFlags) {
         if (!result.isEmpty())
             result += " ";
-        result += text();
+        result += text;
     }
 
     return result;
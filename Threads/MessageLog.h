@@ -48,14 +48,15 @@ struct MessageLogTemplate {
 #pragma pack(pop)
 
 /**
- * Макрос для задания шаблона сообщения.
+ * Макрос для задания шаблона сообщения. Шаблон статический: объявленный в функции
+ * создается один раз, а адрес его текста служит ключом каталога двоичного журнала
  * @param NUMBER - номер сообщения
  * @param LEVEL  - уровень сообщения
  * @param TYPE   - тип сообщения
  * @param TEXT   - текст сообщения
  */
 #define MESSAGE_TEMPLATE(NUMBER, LEVEL, TYPE, TEXT)                                                \
-    const MessageLogTemplate Message##NUMBER = {NUMBER, LEVEL, TYPE, TEXT}
+    static const MessageLogTemplate Message##NUMBER = {NUMBER, LEVEL, TYPE, TEXT}
 
 /**
  * Макрос для протоколирования идентификаторов
@@ -100,6 +101,7 @@ public:
     using Ptr = std::shared_ptr<MessageLog>;
 
 public:
+    static const int TYPE_ID;
     static const QString MESSAGE_NAME;
 
     explicit MessageLog(const QString &text,
@@ -119,6 +121,20 @@ public:
     QString toString(int messageFlags = MessageToStringFlags::Time | MessageToStringFlags::Type |
             MessageToStringFlags::Number | MessageToStringFlags::Text);
 
+    /**
+     * @brief format - Форматирование сообщения протоколирования в строку
+     * @param created - Дата и время сообщения
+     * @param messageType - Тип сообщения
+     * @param number - Номер сообщения
+     * @param text - Текст сообщения
+     * @param messageFlags - Флаги отображения данных
+     * @return - Строка сообщения
+     */
+    static QString format(const QDateTime &created, MessageType messageType, int number,
+                          const QString &text,
+                          int messageFlags = MessageToStringFlags::Time | MessageToStringFlags::Type |
+            MessageToStringFlags::Number | MessageToStringFlags::Text);
+
 protected:
     int         _number;
     int         _level;
@@ -1,10 +1,14 @@
 #include "MessageObject.h"
 
+#include "MessageTypes.h"
+
 namespace Threader {
 
 namespace Threads {
 
 
+const int MessageObject::TYPE_ID = MessageTypes::registerType("MessageObject");
+
 MessageObject::MessageObject(const QString &name,
                              QObject *object,
                              bool ownsObject)
@@ -12,6 +16,7 @@ MessageObject::MessageObject(const QString &name,
     , _object(object)
     , _ownsObject(ownsObject)
 {
+    setTypeId(TYPE_ID);
 }
 
 MessageObject::~MessageObject()
@@ -13,6 +13,8 @@ public:
     using Ptr = std::shared_ptr<MessageObject>;
 
 public:
+    static const int TYPE_ID;
+
     explicit MessageObject(const QString &name,
                            QObject *object,
                            bool ownsObject = false);
@@ -1,15 +1,20 @@
 #include "MessageString.h"
 
+#include "MessageTypes.h"
+
 namespace Threader {
 
 namespace Threads {
 
 const QString MessageString::MESSAGE_NAME_STRING = "Message.String";
 
+const int MessageString::TYPE_ID = MessageTypes::registerType("MessageString");
+
 MessageString::MessageString(const QString& text, const QString &name)
     : MessageBase(name)
     , _text(text)
 {
+    setTypeId(TYPE_ID);
 }
 
 QString MessageString::text()
@@ -17,6 +22,11 @@ QString MessageString::text()
     return _text;
 }
 
+qint64 MessageString::approximateSize() const
+{
+    return MessageBase::approximateSize() + _text.size() * qint64(sizeof(QChar));
+}
+
 void MessageString::setText(const QString &text)
 {
     _text = text;
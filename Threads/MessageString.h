@@ -16,6 +16,7 @@ public:
     using Ptr = std::shared_ptr<MessageString>;
 
 public:
+    static const int TYPE_ID;
 
     /**
      * @brief MESSAGE_NAME_STRING - Имя строкового сообщения по умолчанию
@@ -35,6 +36,9 @@ public:
      * @return - Текст сообщения
      */
     QString text();
+
+    qint64 approximateSize() const override;
+
 protected:
     /**
      * @brief setText - Установка текста сообщения
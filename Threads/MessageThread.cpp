@@ -1,5 +1,7 @@
 #include "MessageThread.h"
 
+#include "MessageTypes.h"
+
 namespace Threader{
 
 namespace Threads {
@@ -8,10 +10,22 @@ namespace Threads {
 const QString MessageThread::MESSAGE_NAME = "Message.Thread";
 
 
+const int MessageThread::TYPE_ID = MessageTypes::registerType("MessageThread");
+
 MessageThread::MessageThread(ThreadBase *thread)
     : MessageBase(MESSAGE_NAME)
     , _thread(thread)
 {
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Control);
+}
+
+MessageThread::MessageThread(const QString &name, ThreadBase *thread)
+    : MessageBase(name)
+    , _thread(thread)
+{
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Control);
 }
 
 ThreadBase *MessageThread::thread() const
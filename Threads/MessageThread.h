@@ -16,10 +16,14 @@ public:
     using Ptr = std::shared_ptr<MessageThread>;
 
 public:
+    static const int TYPE_ID;
+
     static const QString MESSAGE_NAME;
 
     explicit MessageThread(ThreadBase *thread);
 
+    explicit MessageThread(const QString &name, ThreadBase *thread);
+
     ThreadBase *thread() const;
 
 private:
@@ -1,15 +1,21 @@
 #include "MessageTimer.h"
 
+#include "MessageTypes.h"
+
 namespace Threader {
 
 namespace Threads {
 
 
+const int MessageTimer::TYPE_ID = MessageTypes::registerType("MessageTimer");
+
 MessageTimer::MessageTimer(const QString &name,
                            const qint64 &shotCount)
     : MessageBase(name)
     , _shotCount(shotCount)
 {
+    setTypeId(TYPE_ID);
+    setPriority(MessagePriority::Control);
 }
 
 qint64 MessageTimer::shotCount() const
@@ -16,6 +16,8 @@ public:
     using Ptr = std::shared_ptr<MessageTimer>;
 
 public:
+    static const int TYPE_ID;
+
     /**
      * @brief MessageTimer - Конструктор
      * @param name - Имя сообщения таймера
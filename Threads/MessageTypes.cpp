@@ -0,0 +1,57 @@
+#include "MessageTypes.h"
+
+#include <QMutex>
+#include <QStringList>
+
+namespace Threader {
+
+namespace Threads {
+
+
+namespace {
+
+/**
+ * @brief MessageTypesRegistry - Хранилище имен зарегистрированных типов
+ * Создается при первом обращении, поэтому не зависит от порядка
+ * статической инициализации единиц трансляции
+ */
+struct MessageTypesRegistry
+{
+    QMutex Mutex;
+    QStringList Names;
+};
+
+MessageTypesRegistry &registry()
+{
+    static MessageTypesRegistry instance;
+    return instance;
+}
+
+}
+
+
+int MessageTypes::registerType(const char *typeName)
+{
+    MessageTypesRegistry &types = registry();
+    QMutexLocker locker(&types.Mutex);
+    types.Names.append(QString(typeName));
+    return types.Names.count() - 1;
+}
+
+int MessageTypes::count()
+{
+    MessageTypesRegistry &types = registry();
+    QMutexLocker locker(&types.Mutex);
+    return types.Names.count();
+}
+
+QString MessageTypes::typeName(int typeId)
+{
+    MessageTypesRegistry &types = registry();
+    QMutexLocker locker(&types.Mutex);
+    if (typeId < 0 || typeId >= types.Names.count())
+        return QString();
+    return types.Names.at(typeId);
+}
+
+}}
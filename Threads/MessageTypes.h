@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QString>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief MessageTypes - Реестр типов сообщений
+ * Каждый класс сообщения получает при статической инициализации
+ * небольшой целочисленный идентификатор, по которому выполняется
+ * маршрутизация сообщений без сравнения имен
+ */
+class THREADERSHARED_EXPORT MessageTypes
+{
+public:
+    /**
+     * @brief registerType - Регистрация типа сообщения
+     * @param typeName - Имя класса сообщения
+     * @return - Идентификатор типа
+     */
+    static int registerType(const char *typeName);
+
+    /**
+     * @brief count - Получение количества зарегистрированных типов
+     * @return - Количество типов
+     */
+    static int count();
+
+    /**
+     * @brief typeName - Получение имени класса сообщения по идентификатору типа
+     * @param typeId - Идентификатор типа
+     * @return - Имя класса сообщения или пустая строка для неизвестного типа
+     */
+    static QString typeName(int typeId);
+};
+
+}}
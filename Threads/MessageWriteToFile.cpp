@@ -1,11 +1,15 @@
 #include "MessageWriteToFile.h"
 
+#include "MessageTypes.h"
+
 namespace Threader {
 
 namespace Threads {
 
 const QString MessageWriteToFile::MESSAGE_NAME_WRITE_TO_FILE = "Message.Write.To.File";
 
+const int MessageWriteToFile::TYPE_ID = MessageTypes::registerType("MessageWriteToFile");
+
 MessageWriteToFile::MessageWriteToFile(const QString &fileName,
                                        const QString &data,
                                        const WriteMode writeMode)
@@ -13,6 +17,7 @@ MessageWriteToFile::MessageWriteToFile(const QString &fileName,
     , _fileName(fileName)
     , _writeMode(writeMode)
 {
+    setTypeId(TYPE_ID);
 }
 
 QString MessageWriteToFile::fileName() const
@@ -15,6 +15,8 @@ public:
     using Ptr = std::shared_ptr<MessageWriteToFile>;
 
 public:
+    static const int TYPE_ID;
+
     static const QString MESSAGE_NAME_WRITE_TO_FILE;
 
     explicit MessageWriteToFile(const QString &fileName,
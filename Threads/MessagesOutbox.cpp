@@ -0,0 +1,109 @@
+#include "MessagesOutbox.h"
+
+namespace Threader {
+
+namespace Threads {
+
+
+void MessagesOutbox::append(IMessageSubscriber *target, const MessageBase::Ptr &message)
+{
+    auto it = _indexes.constFind(target);
+    if (it == _indexes.constEnd())
+    {
+        _indexes.insert(target, _targets.count());
+        _targets.append({target, MessagesList()});
+        _targets.last().Messages.append(message);
+        return;
+    }
+
+    _targets[it.value()].Messages.append(message);
+}
+
+int MessagesOutbox::flush()
+{
+    if (_targets.isEmpty())
+        return 0;
+
+    // буфер освобождается до отправки, так как получатель может оказаться в этом же потоке
+    QVector<TargetMessages> targets;
+    targets.swap(_targets);
+    _indexes.clear();
+
+    int result = 0;
+    for (const TargetMessages &target : targets)
+        result += deliver(target.Target, target.Messages);
+    return result;
+}
+
+int MessagesOutbox::flush(IMessageSubscriber *target)
+{
+    auto it = _indexes.constFind(target);
+    if (it == _indexes.constEnd())
+        return 0;
+
+    // запись получателя остается в буфере пустой, чтобы не смещать индексы остальных
+    MessagesList messages;
+    messages.swap(_targets[it.value()].Messages);
+    return deliver(target, messages);
+}
+
+int MessagesOutbox::remove(IMessageSubscriber *target)
+{
+    auto it = _indexes.find(target);
+    if (it == _indexes.end())
+        return 0;
+
+    // запись остается в буфере пустой, адрес получателя может достаться новому объекту
+    TargetMessages &targetMessages = _targets[it.value()];
+    int result = targetMessages.Messages.count();
+    targetMessages.Messages.clear();
+    targetMessages.Target = nullptr;
+    _indexes.erase(it);
+    return result;
+}
+
+int MessagesOutbox::deliver(IMessageSubscriber *target, const MessagesList &messages)
+{
+    if (messages.isEmpty())
+        return 0;
+
+    _messagesCount += quint64(messages.count());
+    _batchesCount++;
+
+    // группу принимает только неограниченная очередь, поэтому отклонить
+    // сообщение может лишь получатель одиночного сообщения
+    int result = 0;
+    if (1 == messages.count())
+    {
+        PostMessageResult postResult = target->postMessage(messages.first());
+        if (PostMessageResult::Accepted != postResult && PostMessageResult::DroppedOldest != postResult)
+            result = 1;
+    }
+    else
+        target->postMessages(messages);
+
+    _rejectedCount += quint64(result);
+    return result;
+}
+
+bool MessagesOutbox::isEmpty() const
+{
+    return _targets.isEmpty();
+}
+
+quint64 MessagesOutbox::messagesCount() const
+{
+    return _messagesCount;
+}
+
+quint64 MessagesOutbox::batchesCount() const
+{
+    return _batchesCount;
+}
+
+quint64 MessagesOutbox::rejectedCount() const
+{
+    return _rejectedCount;
+}
+
+}}
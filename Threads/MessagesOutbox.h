@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include "MessageBase.h"
+
+#include <QHash>
+#include <QVector>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief MessagesOutbox - Буфер исходящих сообщений потока
+ * Накапливает сообщения, отправляемые во время прохода обработки,
+ * и передает их каждому получателю одной группой с одним пробуждением.
+ * В буфер помещаются только сообщения получателям с неограниченной очередью,
+ * которые принимают каждое сообщение. Используется только потоком-владельцем
+ */
+class THREADERSHARED_EXPORT MessagesOutbox
+{
+public:
+    MessagesOutbox() = default;
+
+    MessagesOutbox(const MessagesOutbox &) = delete;
+    MessagesOutbox &operator=(const MessagesOutbox &) = delete;
+
+    /**
+     * @brief append - Добавление сообщения для получателя
+     * @param target - Получатель
+     * @param message - Сообщение
+     */
+    void append(IMessageSubscriber *target, const MessageBase::Ptr &message);
+
+    /**
+     * @brief flush - Передача накопленных сообщений получателям
+     * Сообщения каждого получателя передаются в порядке добавления
+     * @return - Количество сообщений, не принятых получателями
+     */
+    int flush();
+
+    /**
+     * @brief flush - Передача накопленных сообщений одному получателю
+     * Используется перед отправкой получателю в обход буфера для сохранения порядка
+     * @param target - Получатель
+     * @return - Количество сообщений, не принятых получателем
+     */
+    int flush(IMessageSubscriber *target);
+
+    /**
+     * @brief remove - Удаление накопленных сообщений получателя без передачи
+     * Вызывается при уничтожении получателя, чтобы буфер не обращался к освобожденной памяти
+     * @param target - Получатель
+     * @return - Количество удаленных сообщений
+     */
+    int remove(IMessageSubscriber *target);
+
+    /**
+     * @brief isEmpty - Получение признака отсутствия накопленных сообщений
+     * @return - Признак отсутствия накопленных сообщений
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief messagesCount - Получение количества сообщений, переданных через буфер
+     * @return - Количество сообщений
+     */
+    quint64 messagesCount() const;
+
+    /**
+     * @brief batchesCount - Получение количества переданных групп сообщений
+     * Разность с количеством сообщений равна числу сэкономленных пробуждений
+     * @return - Количество групп
+     */
+    quint64 batchesCount() const;
+
+    /**
+     * @brief rejectedCount - Получение количества переданных через буфер сообщений,
+     * не принятых получателями
+     * @return - Количество сообщений
+     */
+    quint64 rejectedCount() const;
+
+private:
+    struct TargetMessages
+    {
+        IMessageSubscriber *Target;
+        MessagesList Messages;
+    };
+
+    /**
+     * @brief deliver - Передача группы сообщений получателю
+     * @return - Количество сообщений, не принятых получателем
+     */
+    int deliver(IMessageSubscriber *target, const MessagesList &messages);
+
+    /**
+     * @brief _targets - Накопленные сообщения в порядке появления получателей
+     */
+    QVector<TargetMessages> _targets;
+
+    /**
+     * @brief _indexes - Индексы получателей в _targets
+     */
+    QHash<IMessageSubscriber*, int> _indexes;
+
+    quint64 _messagesCount = 0;
+    quint64 _batchesCount = 0;
+    quint64 _rejectedCount = 0;
+};
+
+}}
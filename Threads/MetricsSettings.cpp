@@ -0,0 +1,74 @@
+#include "MetricsSettings.h"
+
+#include <QMutexLocker>
+
+namespace Threader {
+
+namespace Threads {
+
+#define METRICS_SETTINGS_GROUP_NAME "Metrics"
+
+
+bool MetricsSettings::read(QSettings &settings)
+{
+    settings.beginGroup(METRICS_SETTINGS_GROUP_NAME);
+    uint port = settings.value("Port", 0).toUInt();
+    bool messageTiming = settings.value("MessageTiming", false).toBool();
+    int slowMessageMicroseconds = settings.value("SlowMessageMicroseconds", 0).toInt();
+    settings.endGroup();
+
+    QMutexLocker locker(&_mutex);
+    _port = (port <= 0xFFFF) ? uint16_t(port) : 0;
+    _messageTiming = messageTiming;
+    _slowMessageMicroseconds = qMax(slowMessageMicroseconds, 0);
+    return true;
+}
+
+bool MetricsSettings::write(QSettings &settings)
+{
+    QMutexLocker locker(&_mutex);
+    settings.beginGroup(METRICS_SETTINGS_GROUP_NAME);
+    settings.setValue("Port", _port);
+    settings.setValue("MessageTiming", _messageTiming);
+    settings.setValue("SlowMessageMicroseconds", _slowMessageMicroseconds);
+    settings.endGroup();
+    return true;
+}
+
+uint16_t MetricsSettings::port() const
+{
+    QMutexLocker locker(&_mutex);
+    return _port;
+}
+
+void MetricsSettings::setPort(uint16_t port)
+{
+    QMutexLocker locker(&_mutex);
+    _port = port;
+}
+
+bool MetricsSettings::messageTiming() const
+{
+    QMutexLocker locker(&_mutex);
+    return _messageTiming;
+}
+
+void MetricsSettings::setMessageTiming(bool messageTiming)
+{
+    QMutexLocker locker(&_mutex);
+    _messageTiming = messageTiming;
+}
+
+int MetricsSettings::slowMessageMicroseconds() const
+{
+    QMutexLocker locker(&_mutex);
+    return _slowMessageMicroseconds;
+}
+
+void MetricsSettings::setSlowMessageMicroseconds(int slowMessageMicroseconds)
+{
+    QMutexLocker locker(&_mutex);
+    _slowMessageMicroseconds = slowMessageMicroseconds;
+}
+
+}}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "SettingsBase.h"
+
+#include "../threader_global.h"
+
+#include <QMutex>
+#include <QSettings>
+
+#include <memory>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief MetricsSettings - Настройки подсистемы метрик
+ * Настройки хранятся в разделе Metrics:
+ *   Metrics\Port=9464
+ *   Metrics\MessageTiming=false
+ *   Metrics\SlowMessageMicroseconds=50000
+ * Порт 0 отключает сервер метрик
+ */
+class THREADERSHARED_EXPORT MetricsSettings : public SettingsBase
+{
+public:
+    using Ptr = std::shared_ptr<MetricsSettings>;
+
+public:
+    bool read(QSettings &settings) override;
+    bool write(QSettings &settings) override;
+
+    /**
+     * @brief port - Порт сервера метрик в формате Prometheus
+     * @return - Номер порта, 0 - сервер не запускается
+     */
+    uint16_t port() const;
+    void setPort(uint16_t port);
+
+    /**
+     * @brief messageTiming - Признак учета времени ожидания и обработки сообщений
+     */
+    bool messageTiming() const;
+    void setMessageTiming(bool messageTiming);
+
+    /**
+     * @brief slowMessageMicroseconds - Время обработки, начиная с которого
+     * сообщение протоколируется как медленное
+     * @return - Время в микросекундах, 0 - медленные сообщения не протоколируются
+     */
+    int slowMessageMicroseconds() const;
+    void setSlowMessageMicroseconds(int slowMessageMicroseconds);
+
+private:
+    mutable QMutex _mutex;
+    uint16_t _port = 0;
+    bool _messageTiming = false;
+    int _slowMessageMicroseconds = 0;
+};
+
+}}
@@ -1,6 +1,6 @@
 #include "PacketFactoryBase.h"
 
-#include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 
 
 namespace Threader {
@@ -10,15 +10,13 @@ namespace Threads {
 
 PacketBase::PacketBase(const char *data,
                        const int size)
-    : _createdUtc(QDateTime::currentDateTimeUtc())
-    , _createdTickCount(DateUtils::getTickCount())
+    : _createdTickCount(LoopClock::now())
 {
     _data = QByteArray(data, size);
 }
 
 PacketBase::PacketBase(int size)
-    : _createdUtc(QDateTime::currentDateTimeUtc())
-    , _createdTickCount(DateUtils::getTickCount())
+    : _createdTickCount(LoopClock::now())
     , _data(QByteArray(size, char(0)))
 {
 }
@@ -29,7 +27,8 @@ PacketBase::~PacketBase()
 
 QDateTime PacketBase::created() const
 {
-    return _createdUtc;
+    // календарное время вычисляется только по запросу
+    return LoopClock::toDateTimeUtc(_createdTickCount);
 }
 
 qint64 PacketBase::createdTickCount() const
@@ -48,6 +47,17 @@ void PacketBase::setData(const QByteArray &data)
     _data.append(data);
 }
 
+PacketBase::Ptr PacketFactoryBase::tryExtractPacket(QByteArray &data, int &position)
+{
+    // фабрики без поддержки позиции чтения работают с началом буфера
+    if (position > 0)
+    {
+        data.remove(0, position);
+        position = 0;
+    }
+    return tryExtractPacket(data);
+}
+
 void PacketFactoryBase::setLastResult(int value)
 {
     _lastResult = value;
@@ -58,4 +68,14 @@ int PacketFactoryBase::lastResult() const
     return 0;
 }
 
+quint64 PacketFactoryBase::checksumErrorsCount() const
+{
+    return _checksumErrorsCount;
+}
+
+void PacketFactoryBase::countChecksumError()
+{
+    _checksumErrorsCount++;
+}
+
 }}
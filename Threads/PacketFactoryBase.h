@@ -34,7 +34,6 @@ public:
 
     virtual bool write(DataStream &stream) const = 0;
 private:
-    QDateTime _createdUtc;
     qint64 _createdTickCount;
     QByteArray _data;
 };
@@ -45,15 +44,39 @@ public:
     explicit PacketFactoryBase() = default;
     virtual ~PacketFactoryBase() = default;
     virtual PacketBase::Ptr tryExtractPacket(QByteArray &) = 0;
+
+    /**
+     * @brief tryExtractPacket - Попытка извлечения пакета начиная с позиции чтения
+     * Фабрика сдвигает позицию чтения за пропущенные и извлеченные данные,
+     * не изменяя буфер, а владелец буфера удаляет прочитанное один раз после разбора.
+     * Реализация по умолчанию удаляет прочитанное и работает с началом буфера
+     * @param data - Буфер входящих данных
+     * @param position - Позиция чтения в буфере
+     * @return - Извлеченный пакет или nullptr
+     */
+    virtual PacketBase::Ptr tryExtractPacket(QByteArray &data, int &position);
+
     virtual PacketBase::Ptr buildPacket(const QByteArray &data,
                                         bool generatePacketId) = 0;
     virtual int lastResult() const;
 
+    /**
+     * @brief checksumErrorsCount - Получение количества пакетов с неверной контрольной суммой
+     * @return - Количество пакетов
+     */
+    quint64 checksumErrorsCount() const;
+
 protected:
     void setLastResult(int value);
 
+    /**
+     * @brief countChecksumError - Учет пакета с неверной контрольной суммой
+     */
+    void countChecksumError();
+
 private:
     int _lastResult;
+    quint64 _checksumErrorsCount = 0;
 };
 
 }}
@@ -1,34 +1,42 @@
 #include "PollerThread.h"
 
+#ifdef Q_OS_LINUX
+#include <sys/eventfd.h>
+#endif
+
 namespace Threader {
 
 namespace Threads {
 
+#define SIGNAL_FLAG(SIGNAL) (1 << static_cast<int>(SIGNAL))
+
 PollerThread::PollerThread()
     : PollerBase()
+    , _signals(0)
+    , _spinning(false)
+    , _wakeUpsIssued(0)
+    , _wakeUpsSuppressed(0)
 {
 #ifdef Q_OS_LINUX
-    memset(_pipeDescriptors, 0, sizeof (_pipeDescriptors));
-    if (::pipe2(_pipeDescriptors, O_NONBLOCK) == 0)
+    _eventDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (INVALID_DESCRIPTOR != _eventDescriptor)
     {
-        setDescriptor(_pipeDescriptors[0]);
+        setDescriptor(_eventDescriptor);
         setEvents(POLLIN);
     }
 #endif
 
 #ifdef Q_OS_WIN
-    _eventTerminate = CreateEvent(nullptr, true, false, nullptr);
-    _eventTerminateChildThreads = CreateEvent(nullptr, true, false, nullptr);
     _eventWakeUp = CreateEvent(nullptr, true, false, nullptr);
-    assign({_eventTerminate, _eventTerminateChildThreads, _eventWakeUp});
+    assign({_eventWakeUp});
 #endif
 }
 
 PollerThread::~PollerThread()
 {
 #ifdef Q_OS_LINUX
-    close(_pipeDescriptors[0]);
-    close(_pipeDescriptors[1]);
+    if (INVALID_DESCRIPTOR != _eventDescriptor)
+        close(_eventDescriptor);
 #endif
 }
 
@@ -47,6 +55,30 @@ void PollerThread::sendSignalWakeUp()
     sendSignal(ThreadSignals::SignalWakeUp);
 }
 
+quint64 PollerThread::wakeUpsIssued() const
+{
+    return _wakeUpsIssued.load(std::memory_order_relaxed);
+}
+
+quint64 PollerThread::wakeUpsSuppressed() const
+{
+    return _wakeUpsSuppressed.load(std::memory_order_relaxed);
+}
+
+void PollerThread::setSpinning(bool spinning)
+{
+    _spinning.store(spinning);
+}
+
+bool PollerThread::processPendingSignals()
+{
+    if (0 == _signals.load())
+        return false;
+
+    processSignals();
+    return true;
+}
+
 #ifdef Q_OS_WIN
 bool PollerThread::process(Descriptor eventToProcess)
 {
@@ -54,19 +86,7 @@ bool PollerThread::process(Descriptor eventToProcess)
     if (result)
     {
         ResetEvent(eventToProcess);
-
-        if (eventToProcess == _eventTerminate)
-        {
-            emit signalTerminateThread();
-        }
-        else if (eventToProcess == _eventTerminateChildThreads)
-        {
-            emit signalTerminateChildThreads();
-        }
-        else if (eventToProcess == _eventWakeUp) {
-            emit signalWakeUpThread();
-        }
-
+        processSignals();
     }
     return result;
 }
@@ -79,56 +99,60 @@ bool PollerThread::process(const pollfd &event)
     if (event.fd != descriptor())
         return false;
 
-    // если не надо читать из пайпа
+    // если нечего читать
     if (!(event.revents & POLLIN))
         return false;
 
-    uint8_t signal;
-    if (!receiveSignal(signal))
-        return false;
+    // сброс счетчика eventfd
+    eventfd_t value;
+    eventfd_read(_eventDescriptor, &value);
 
-    switch (static_cast<ThreadSignals>(signal)) {
-    case ThreadSignals::SignalTerminate:
-        emit signalTerminateThread();
-        break;
-    case ThreadSignals::SignalWakeUp:
-        emit signalWakeUpThread();
-        break;
-    case ThreadSignals::SignalTerminateChildThreads:
-        emit signalTerminateChildThreads();
-        break;
-    }
+    processSignals();
 
     return true;
 }
+#endif
 
-bool PollerThread::receiveSignal(uint8_t &signal)
+void PollerThread::processSignals()
 {
-    return read(_pipeDescriptors[0], &signal, sizeof(signal));
-}
-#endif
+    // флаги сбрасываются до обработки, чтобы сигналы, отправленные во время обработки,
+    // снова разбудили поток
+    int signalFlags = _signals.exchange(0);
 
+    if (signalFlags & SIGNAL_FLAG(ThreadSignals::SignalTerminateChildThreads))
+        emit signalTerminateChildThreads();
+
+    if (signalFlags & SIGNAL_FLAG(ThreadSignals::SignalWakeUp))
+        emit signalWakeUpThread();
+
+    if (signalFlags & SIGNAL_FLAG(ThreadSignals::SignalTerminate))
+        emit signalTerminateThread();
+}
 
 void PollerThread::sendSignal(ThreadSignals signal)
 {
+    // если поток уже разбужен и еще не забрал сигналы, то системный вызов не нужен
+    if (0 != _signals.fetch_or(SIGNAL_FLAG(signal)))
+    {
+        _wakeUpsSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // поток в активном ожидании обнаружит флаг сам, а после выхода из него
+    // проверяет флаги до блокировки
+    if (_spinning.load())
+    {
+        _wakeUpsSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    _wakeUpsIssued.fetch_add(1, std::memory_order_relaxed);
+
 #ifdef Q_OS_LINUX
-    // приведение к 8-ми битовому значению, т.к. sizeof(ThreadSignals) == 4
-    uint8_t signalInt = static_cast<uint8_t>(signal);
-    auto res = write(_pipeDescriptors[1], &signalInt, sizeof(signalInt));
-    Q_UNUSED(res)
+    eventfd_write(_eventDescriptor, 1);
 #endif
 #ifdef Q_OS_WIN
-    switch (signal) {
-    case ThreadSignals::SignalTerminate:
-        SetEvent(_eventTerminate);
-        break;
-    case ThreadSignals::SignalTerminateChildThreads:
-        SetEvent(_eventTerminateChildThreads);
-        break;
-    case ThreadSignals::SignalWakeUp:
-        SetEvent(_eventWakeUp);
-        break;
-    }
+    SetEvent(_eventWakeUp);
 #endif
 }
 
@@ -7,6 +7,8 @@
 
 #include <QObject>
 
+#include <atomic>
+
 #ifdef Q_OS_LINUX
 #include <fcntl.h>
 #include <unistd.h>
@@ -22,6 +24,11 @@ enum class ThreadSignals {
     SignalTerminateChildThreads = 3
 };
 
+/**
+ * @brief PollerThread - Голосующий сигналов потока.
+ * Сигналы хранятся флагами, системный вызов пробуждения (eventfd) выполняется только
+ * при переходе от состояния "нет сигналов" к состоянию "есть сигналы"
+ */
 class THREADERSHARED_EXPORT PollerThread : public PollerBase
 {
     Q_OBJECT
@@ -33,6 +40,34 @@ public:
     void sendSignalTerminateChildThreads();
     void sendSignalWakeUp();
 
+    /**
+     * @brief wakeUpsIssued - Получение количества выполненных пробуждений потока
+     * @return - Количество пробуждений
+     */
+    quint64 wakeUpsIssued() const;
+
+    /**
+     * @brief wakeUpsSuppressed - Получение количества пробуждений, не потребовавших
+     * системного вызова, т.к. поток уже был разбужен
+     * @return - Количество подавленных пробуждений
+     */
+    quint64 wakeUpsSuppressed() const;
+
+    /**
+     * @brief setSpinning - Установка признака активного ожидания потока
+     * Пока признак установлен, отправители сигналов не выполняют системный вызов
+     * пробуждения: поток сам проверяет флаги сигналов. После сброса признака поток
+     * обязан проверить флаги вызовом processPendingSignals
+     * @param spinning - Признак активного ожидания
+     */
+    void setSpinning(bool spinning);
+
+    /**
+     * @brief processPendingSignals - Обработка поступивших сигналов без ожидания дескриптора
+     * @return - Признак наличия обработанных сигналов
+     */
+    bool processPendingSignals();
+
 #ifdef Q_OS_WIN
     bool process(Descriptor eventToProcess) override;
 #endif
@@ -41,18 +76,32 @@ public:
 #endif
 private:
 #ifdef Q_OS_LINUX
-   Descriptor _pipeDescriptors[2];
-
-   bool receiveSignal(uint8_t &signal);
+   Descriptor _eventDescriptor;
 #endif
 #ifdef Q_OS_WIN
-   Descriptor _eventTerminate;
-   Descriptor _eventTerminateChildThreads;
    Descriptor _eventWakeUp;
 #endif
 
+   /**
+    * @brief _signals - Флаги поступивших и необработанных сигналов
+    */
+   std::atomic<int> _signals;
+
+   /**
+    * @brief _spinning - Признак активного ожидания потока-владельца
+    */
+   std::atomic<bool> _spinning;
+
+   std::atomic<quint64> _wakeUpsIssued;
+   std::atomic<quint64> _wakeUpsSuppressed;
+
    void sendSignal(ThreadSignals signal);
 
+   /**
+    * @brief processSignals - Сброс флагов сигналов и их обработка
+    */
+   void processSignals();
+
 signals:
    void signalTerminateThread();
    void signalTerminateChildThreads();
@@ -2,9 +2,12 @@
 
 #ifdef Q_OS_LINUX
 
-#include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 //#include <QDateTime>
 
+#include <errno.h>
+#include <unistd.h>
+
 namespace Threader {
 
 namespace Threads {
@@ -17,9 +20,16 @@ PollerBase::PollerBase(const int &descriptor, const short &events)
     : QObject(nullptr)
     , _descriptor(descriptor)
     , _events(events)
+    , _polling(nullptr)
 {
 }
 
+PollerBase::~PollerBase()
+{
+    if (_polling)
+        _polling->unregisterPoller(this);
+}
+
 int PollerBase::descriptor() const
 {
     return _descriptor;
@@ -27,7 +37,10 @@ int PollerBase::descriptor() const
 
 void PollerBase::setDescriptor(const Descriptor &descriptor)
 {
+    if (_descriptor == descriptor)
+        return;
     _descriptor = descriptor;
+    notifyEventsChanged(true);
 }
 
 short int PollerBase::events()
@@ -37,7 +50,16 @@ short int PollerBase::events()
 
 void PollerBase::setEvents(short int events)
 {
+    if (_events == events)
+        return;
     _events = events;
+    notifyEventsChanged();
+}
+
+void PollerBase::notifyEventsChanged(const bool descriptorChanged)
+{
+    if (_polling)
+        _polling->pollerChanged(this, descriptorChanged);
 }
 
 void PollerBase::assign(pollfd &event)
@@ -60,16 +82,92 @@ bool PollerBase::process(const pollfd &event)
 
 Polling::Polling()
     : _waitCount(0)
+    , _pollingMethod(PollingMethod::Poll)
+    , _epollDescriptor(INVALID_DESCRIPTOR)
+    , _host(nullptr)
 {
 }
 
+Polling::~Polling()
+{
+    setHost(nullptr);
+
+    for (auto poller : pollers())
+        poller->_polling = nullptr;
+
+    if (INVALID_DESCRIPTOR != _epollDescriptor)
+        ::close(_epollDescriptor);
+}
+
+PollingMethod Polling::pollingMethod() const
+{
+    return _pollingMethod;
+}
+
+bool Polling::setPollingMethod(const PollingMethod &pollingMethod)
+{
+    if (_pollingMethod == pollingMethod)
+        return true;
+
+    // перенос голосующих в новый способ ожидания
+    PollersList pollersList = pollers();
+    for (auto poller : pollersList)
+        unregisterPoller(poller);
+
+    if (PollingMethod::Epoll == pollingMethod)
+    {
+        _epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+        if (INVALID_DESCRIPTOR != _epollDescriptor)
+            _pollingMethod = pollingMethod;
+    }
+    else
+    {
+        ::close(_epollDescriptor);
+        _epollDescriptor = INVALID_DESCRIPTOR;
+        _pollingMethod = pollingMethod;
+    }
+
+    for (auto poller : pollersList)
+        registerPoller(poller);
+
+    return _pollingMethod == pollingMethod;
+}
+
 int Polling::pollersCount()
 {
+    if (PollingMethod::Epoll == _pollingMethod)
+        return _registrations.count();
     return _pollers.count();
 }
 
 int Polling::registerPoller(PollerBase *poller)
 {
+    if (_host)
+    {
+        if (!_pollers.contains(poller))
+            _pollers.append(poller);
+        _host->registerPoller(poller);
+        // уведомления голосующего проходят через данный объект
+        poller->_polling = this;
+        return _pollers.count();
+    }
+
+    if (PollingMethod::Epoll == _pollingMethod)
+    {
+        // регистрация в epoll выполняется перед ближайшим голосованием
+        if (!_registrations.contains(poller))
+        {
+            pollfd registration;
+            registration.fd = INVALID_DESCRIPTOR;
+            registration.events = 0;
+            registration.revents = 0;
+            _registrations.insert(poller, registration);
+        }
+        poller->_polling = this;
+        _changedPollers.insert(poller, true);
+        return _registrations.count();
+    }
+
     // проверка существования голосующего с добавляемым дескриптором
     int index = indexOfDescriptor(poller->descriptor());
 
@@ -77,6 +175,8 @@ int Polling::registerPoller(PollerBase *poller)
     if (index >= 0)
     {
         // замена голосующего
+        if (_pollers[index] != poller)
+            _pollers[index]->_polling = nullptr;
         _pollers[index] = poller;
     }
     else
@@ -84,6 +184,7 @@ int Polling::registerPoller(PollerBase *poller)
         // добавление нового голосущего
         _pollers.append(poller);
     }
+    poller->_polling = this;
 
     // получение количества голосующих
     int count = _pollers.count();
@@ -96,6 +197,28 @@ int Polling::registerPoller(PollerBase *poller)
 
 int Polling::unregisterPoller(PollerBase *poller)
 {
+    if (poller->_polling == this)
+        poller->_polling = nullptr;
+
+    if (_host)
+    {
+        _pollers.removeAll(poller);
+        _host->unregisterPoller(poller);
+        return _pollers.count();
+    }
+
+    if (PollingMethod::Epoll == _pollingMethod)
+    {
+        _changedPollers.remove(poller);
+        auto it = _registrations.find(poller);
+        if (it != _registrations.end())
+        {
+            removeEpollRegistration(poller, it.value());
+            _registrations.erase(it);
+        }
+        return _registrations.count();
+    }
+
     // удаление голосующего
     _pollers.removeAll(poller);
 
@@ -109,6 +232,13 @@ int Polling::unregisterPoller(PollerBase *poller)
 }
 
 int Polling::poll(const uint32_t &timeout)
+{
+    if (PollingMethod::Epoll == _pollingMethod)
+        return pollByEpoll(timeout);
+    return pollByPoll(timeout);
+}
+
+int Polling::pollByPoll(const uint32_t &timeout)
 {
     // получение количества голосующих
     int count = _pollStructArray.count();
@@ -128,14 +258,15 @@ int Polling::poll(const uint32_t &timeout)
     // голосование
     do
     {
-        // запоминание начала ожидания
-        qint64 pollStart = DateUtils::getTickCount();
+        // начало ожидания читается непосредственно перед вызовом, чтобы время
+        // обработки с начала итерации не учитывалось как ожидание
+        qint64 pollStart = LoopClock::read();
         // ожидание
         result = ::poll(pollArrayPointer,
                         static_cast<uint32_t>(count),
                         static_cast<int32_t>(timeout));
-        // вычисление времени в ожидании
-        _waitCount += DateUtils::getTickCount() - pollStart;
+        // время выхода из ожидания становится временем итерации
+        _waitCount += LoopClock::update() - pollStart;
         // может прийти сигнал и тогда ошибка будет EINTR
         // в этом случае ожидание продолжается
     } while (result < 0 && EINTR == errno);
@@ -146,18 +277,241 @@ int Polling::poll(const uint32_t &timeout)
         {
             // если произошло событие
             if (pollArrayPointer[i].revents != 0)
+            {
+                PollerBase *poller = _pollers.at(i);
+                // голосующий другого объекта голосования отмечает его до обработки,
+                // при которой голосующий может быть снят с регистрации
+                if (poller->_polling != this && poller->_polling)
+                    _activeGuests.insert(poller->_polling);
                 // обработка события голосующим
-                _pollers.at(i)->process(pollArrayPointer[i]);
+                poller->process(pollArrayPointer[i]);
+            }
         }
 
     return result;
 }
 
+int Polling::pollByEpoll(const uint32_t &timeout)
+{
+    // регистрации обновляются только для изменившихся голосующих
+    updateEpollRegistrations();
+
+    // проверка существования голосующих
+    if (_registrations.isEmpty())
+        return 0;
+
+    if (_epollEvents.count() < _registrations.count())
+        _epollEvents.resize(_registrations.count());
+
+    int result;
+    // голосование
+    do
+    {
+        // начало ожидания читается непосредственно перед вызовом, чтобы время
+        // обработки с начала итерации не учитывалось как ожидание
+        qint64 pollStart = LoopClock::read();
+        // ожидание
+        result = epoll_wait(_epollDescriptor,
+                            _epollEvents.data(),
+                            _epollEvents.count(),
+                            static_cast<int32_t>(timeout));
+        // время выхода из ожидания становится временем итерации
+        _waitCount += LoopClock::update() - pollStart;
+        // может прийти сигнал и тогда ошибка будет EINTR
+        // в этом случае ожидание продолжается
+    } while (result < 0 && EINTR == errno);
+
+    // обработка результатов
+    for (int i = 0; i < result; i++)
+    {
+        auto poller = static_cast<PollerBase*>(_epollEvents.at(i).data.ptr);
+
+        // голосующий мог быть снят с регистрации при обработке предыдущих событий
+        auto it = _registrations.constFind(poller);
+        if (it == _registrations.constEnd())
+            continue;
+
+        // голосующий другого объекта голосования отмечает его до обработки
+        if (poller->_polling != this && poller->_polling)
+            _activeGuests.insert(poller->_polling);
+
+        // флаги EPOLL* совпадают по значениям с флагами POLL*
+        pollfd event = it.value();
+        event.revents = static_cast<short>(_epollEvents.at(i).events);
+        poller->process(event);
+    }
+
+    return result;
+}
+
+void Polling::pollerChanged(PollerBase *poller, const bool descriptorChanged)
+{
+    if (_host)
+    {
+        _host->pollerChanged(poller, descriptorChanged);
+        return;
+    }
+
+    if (PollingMethod::Epoll != _pollingMethod)
+        return;
+
+    _changedPollers[poller] = _changedPollers.value(poller, false) || descriptorChanged;
+}
+
+void Polling::updateEpollRegistrations()
+{
+    if (_changedPollers.isEmpty())
+        return;
+
+    // сначала удаляются закрытые дескрипторы, чтобы повторно выданный системой номер
+    // дескриптора не был удален после регистрации нового владельца
+    auto it = _changedPollers.begin();
+    while (it != _changedPollers.end())
+    {
+        pollfd event;
+        event.fd = INVALID_DESCRIPTOR;
+        event.events = 0;
+        event.revents = 0;
+        it.key()->assign(event);
+
+        if (INVALID_DESCRIPTOR == event.fd)
+        {
+            updateEpollRegistration(it.key(), it.value());
+            it = _changedPollers.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    for (it = _changedPollers.begin(); it != _changedPollers.end(); ++it)
+        updateEpollRegistration(it.key(), it.value());
+
+    _changedPollers.clear();
+}
+
+void Polling::updateEpollRegistration(PollerBase *poller, const bool descriptorChanged)
+{
+    auto it = _registrations.find(poller);
+    if (it == _registrations.end())
+        return;
+
+    pollfd event;
+    event.fd = INVALID_DESCRIPTOR;
+    event.events = 0;
+    event.revents = 0;
+    poller->assign(event);
+    // POLLNVAL не имеет аналога в epoll
+    event.events &= ~POLLNVAL;
+    event.revents = 0;
+
+    // дескриптор другого голосующего: как и при poll(), новый голосующий заменяет прежнего,
+    // регистрация epoll остается за дескриптором и переводится на нового голосующего
+    // (повторное добавление завершается EEXIST и выполняется изменением)
+    PollerBase *owner = _descriptorPollers.value(event.fd, nullptr);
+    if (INVALID_DESCRIPTOR != event.fd && owner && owner != poller)
+    {
+        _descriptorPollers.remove(event.fd);
+        _registrations.remove(owner);
+        if (owner->_polling == this)
+            owner->_polling = nullptr;
+        it = _registrations.find(poller);
+    }
+
+    pollfd &registration = it.value();
+
+    if (!descriptorChanged
+            && registration.fd == event.fd
+            && registration.events == event.events)
+        return;
+
+    if (registration.fd != event.fd)
+    {
+        removeEpollRegistration(poller, registration);
+        registration.fd = INVALID_DESCRIPTOR;
+        registration.events = 0;
+    }
+
+    if (INVALID_DESCRIPTOR == event.fd)
+        return;
+
+    epoll_event epollEvent;
+    epollEvent.events = static_cast<uint32_t>(static_cast<unsigned short>(event.events));
+    epollEvent.data.ptr = poller;
+
+    // закрытый и повторно открытый с тем же номером дескриптор удаляется из epoll ядром,
+    // поэтому при неудаче изменения выполняется добавление и наоборот
+    int operation = (INVALID_DESCRIPTOR == registration.fd) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    int result = epoll_ctl(_epollDescriptor, operation, event.fd, &epollEvent);
+    if (result < 0 && EPOLL_CTL_MOD == operation && ENOENT == errno)
+        result = epoll_ctl(_epollDescriptor, EPOLL_CTL_ADD, event.fd, &epollEvent);
+    else if (result < 0 && EPOLL_CTL_ADD == operation && EEXIST == errno)
+        result = epoll_ctl(_epollDescriptor, EPOLL_CTL_MOD, event.fd, &epollEvent);
+
+    if (result < 0)
+    {
+        registration.fd = INVALID_DESCRIPTOR;
+        registration.events = 0;
+        return;
+    }
+
+    registration.fd = event.fd;
+    registration.events = event.events;
+    _descriptorPollers.insert(event.fd, poller);
+}
+
+void Polling::removeEpollRegistration(PollerBase *poller, const pollfd &registration)
+{
+    if (INVALID_DESCRIPTOR == registration.fd)
+        return;
+
+    if (_descriptorPollers.value(registration.fd, nullptr) == poller)
+        _descriptorPollers.remove(registration.fd);
+
+    // ошибка игнорируется - закрытый дескриптор уже удален из epoll ядром
+    epoll_ctl(_epollDescriptor, EPOLL_CTL_DEL, registration.fd, nullptr);
+}
+
 qint64 Polling::waitCount() const
 {
     return _waitCount;
 }
 
+Polling *Polling::host() const
+{
+    return _host;
+}
+
+void Polling::setHost(Polling *host)
+{
+    if (_host == host)
+        return;
+
+    PollersList pollersList = pollers();
+    for (auto poller : pollersList)
+        unregisterPoller(poller);
+
+    _host = host;
+
+    for (auto poller : pollersList)
+        registerPoller(poller);
+}
+
+QSet<Polling*> Polling::takeActiveGuests()
+{
+    QSet<Polling*> result;
+    result.swap(_activeGuests);
+    return result;
+}
+
+PollersList Polling::pollers() const
+{
+    if (_host)
+        return _pollers;
+    if (PollingMethod::Epoll == _pollingMethod)
+        return _registrations.keys();
+    return _pollers;
+}
+
 int Polling::indexOfDescriptor(const int &descriptor)
 {
     for (int i = 0; i < _pollers.count(); i++)
@@ -10,14 +10,19 @@
 #ifdef Q_OS_LINUX
 
 #include <QObject>
+#include <QHash>
 #include <QList>
+#include <QSet>
 #include <QVector>
 #include <poll.h>
+#include <sys/epoll.h>
 
 namespace Threader {
 
 namespace Threads {
 
+class Polling;
+
 /**
  * @brief The PollerBase class
  */
@@ -33,6 +38,11 @@ public:
     explicit PollerBase(const int &descriptor = -1,
                         const short int &events = 0);
 
+    /**
+     * @brief ~PollerBase - Деструктор. Снимает регистрацию в объекте голосования
+     */
+    ~PollerBase() override;
+
     /**
      * @brief assign - Заполнение данными голосующего pollfd структуры,
      * предоставляемой снаружи для формирования массива ожидания
@@ -71,10 +81,26 @@ public:
      */
     void setEvents(short int events);
 
+protected:
+    /**
+     * @brief notifyEventsChanged - Уведомление объекта голосования об изменении данных,
+     * заполняемых в assign. Потомки, формирующие маску событий в assign по собственному
+     * состоянию, обязаны вызывать метод при изменении этого состояния
+     * @param descriptorChanged - Признак смены дескриптора
+     */
+    void notifyEventsChanged(const bool descriptorChanged = false);
+
 private:
+    friend class Polling;
+
     int _descriptor;
     short int _events;
 
+    /**
+     * @brief _polling - Объект голосования, в котором зарегистрирован голосующий
+     */
+    Polling *_polling;
+
 signals:
     void signalOnPollEvent(const PollerBase *sender, const pollfd &event);
 };
@@ -92,6 +118,25 @@ public:
      */
     explicit Polling();
 
+    /**
+     * @brief ~Polling - Деструктор
+     */
+    ~Polling();
+
+    /**
+     * @brief pollingMethod - Получение способа ожидания событий
+     * @return - Способ ожидания событий
+     */
+    PollingMethod pollingMethod() const;
+
+    /**
+     * @brief setPollingMethod - Установка способа ожидания событий.
+     * Зарегистрированные голосующие переносятся в новый способ ожидания
+     * @param pollingMethod - Способ ожидания событий
+     * @return - Признак успешной установки
+     */
+    bool setPollingMethod(const PollingMethod &pollingMethod);
+
     /**
      * @brief pollersCount - Получение количества зарегистрированных голосующих
      * @return - Количество зарегистрированных голосующих
@@ -100,6 +145,9 @@ public:
 
     /**
      * @brief registerPoller - Регистрация голосующего 
+     * Дескриптор обслуживается одним голосующим: голосующий с уже зарегистрированным
+     * дескриптором заменяет прежнего, как при poll(), так и при epoll (при epoll -
+     * в момент обновления регистрации перед голосованием)
      * @param poller - Голосующий
      * @return - Количество зарегистрированных голосующих
      */
@@ -125,7 +173,78 @@ public:
      */
     qint64 waitCount() const;
 
+    /**
+     * @brief pollers - Получение списка зарегистрированных голосующих
+     * @return - Список голосующих
+     */
+    PollersList pollers() const;
+
+    /**
+     * @brief host - Получение объекта голосования, в котором выполняется ожидание
+     * событий голосующих данного объекта
+     * @return - Объект голосования или NULL
+     */
+    Polling *host() const;
+
+    /**
+     * @brief setHost - Передача голосующих в другой объект голосования (например, поток
+     * реактора). Голосующие продолжают учитываться в данном объекте, а регистрация,
+     * изменения и снятие регистрации передаются объекту-хозяину
+     * @param host - Объект голосования или NULL для возврата голосующих
+     */
+    void setHost(Polling *host);
+
+    /**
+     * @brief takeActiveGuests - Получение объектов голосования, голосующие которых,
+     * переданные данному объекту через setHost, получили события с предыдущего вызова
+     * @return - Объекты голосования
+     */
+    QSet<Polling*> takeActiveGuests();
+
 private:
+    friend class PollerBase;
+
+    /**
+     * @brief pollerChanged - Регистрация изменения маски событий голосующего
+     * @param poller - Голосующий
+     * @param descriptorChanged - Признак смены дескриптора
+     */
+    void pollerChanged(PollerBase *poller, const bool descriptorChanged);
+
+    /**
+     * @brief pollByPoll - Голосование с помощью poll()
+     * @param timeout - Время ожидания в миллисекундах
+     * @return - Количество сработавших дескрипторов
+     */
+    int pollByPoll(const uint32_t &timeout);
+
+    /**
+     * @brief pollByEpoll - Голосование с помощью epoll
+     * @param timeout - Время ожидания в миллисекундах
+     * @return - Количество сработавших дескрипторов
+     */
+    int pollByEpoll(const uint32_t &timeout);
+
+    /**
+     * @brief updateEpollRegistrations - Приведение регистраций epoll в соответствие
+     * с изменившимися голосующими
+     */
+    void updateEpollRegistrations();
+
+    /**
+     * @brief updateEpollRegistration - Приведение регистрации epoll одного голосующего
+     * @param poller - Голосующий
+     * @param descriptorChanged - Признак смены дескриптора
+     */
+    void updateEpollRegistration(PollerBase *poller, const bool descriptorChanged);
+
+    /**
+     * @brief removeEpollRegistration - Удаление дескриптора голосующего из epoll
+     * @param poller - Голосующий
+     * @param registration - Зарегистрированные данные голосующего
+     */
+    void removeEpollRegistration(PollerBase *poller, const pollfd &registration);
+
     /**
      * @brief indexOfDescriptor - Получение индекса голосующего по его дескриптору
      * @param descriptor - Дескриптор
@@ -147,6 +266,47 @@ private:
      * @brief _waitCount - Время в миллисекундах, проведеное в ожидании
      */
     qint64 _waitCount;
+
+    /**
+     * @brief _pollingMethod - Способ ожидания событий
+     */
+    PollingMethod _pollingMethod;
+
+    /**
+     * @brief _epollDescriptor - Дескриптор epoll
+     */
+    int _epollDescriptor;
+
+    /**
+     * @brief _registrations - Данные голосующих, зарегистрированные в epoll
+     */
+    QHash<PollerBase*, pollfd> _registrations;
+
+    /**
+     * @brief _descriptorPollers - Голосующие, зарегистрированные в epoll, по дескрипторам
+     */
+    QHash<int, PollerBase*> _descriptorPollers;
+
+    /**
+     * @brief _changedPollers - Голосующие, изменившие маску событий с последнего голосования,
+     * и признак смены их дескриптора
+     */
+    QHash<PollerBase*, bool> _changedPollers;
+
+    /**
+     * @brief _epollEvents - Массив для получения событий epoll
+     */
+    QVector<epoll_event> _epollEvents;
+
+    /**
+     * @brief _host - Объект голосования, выполняющий ожидание событий голосующих
+     */
+    Polling *_host;
+
+    /**
+     * @brief _activeGuests - Объекты голосования, голосующие которых получили события
+     */
+    QSet<Polling*> _activeGuests;
 };
 
 }}
@@ -2,7 +2,7 @@
 
 #ifdef Q_OS_WIN
 
-#include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 
 namespace Threader {
 
@@ -51,9 +51,20 @@ bool PollerBase::process(Descriptor eventToProcess)
 
 Polling::Polling()
     : _waitCount(0)
+    , _host(nullptr)
 {
 }
 
+PollingMethod Polling::pollingMethod() const
+{
+    return PollingMethod::Poll;
+}
+
+bool Polling::setPollingMethod(const PollingMethod &pollingMethod)
+{
+    return PollingMethod::Poll == pollingMethod;
+}
+
 int Polling::pollersCount()
 {
     return _pollers.count();
@@ -71,6 +82,12 @@ int Polling::registerPoller(PollerBase *poller)
         _pollers.append(poller);
     }
 
+    if (_host)
+    {
+        _host->registerPoller(poller);
+        _host->_guests.insert(poller, this);
+    }
+
     // получение количества голосующих
     int count = _pollers.count();
 
@@ -82,6 +99,12 @@ int Polling::unregisterPoller(PollerBase *poller)
     // удаление голосующего
     _pollers.removeAll(poller);
 
+    if (_host)
+    {
+        _host->unregisterPoller(poller);
+        _host->_guests.remove(poller);
+    }
+
     // получение количества голосующих
     int count = _pollers.count();
 
@@ -96,8 +119,8 @@ int Polling::poll(const uint32_t &timeout)
         pollArray.append(*poller->events());
     auto pollArrayCount = static_cast<uint32_t>(pollArray.count());
 
-    // запоминание начала ожидания событий
-    auto waitStarted = DateUtils::getTickCount();
+    // запоминание начала ожидания событий непосредственно перед ожиданием
+    auto waitStarted = LoopClock::read();
 
     // ожидание голосования
     auto waitResult = WaitForMultipleObjects(pollArrayCount,
@@ -106,7 +129,7 @@ int Polling::poll(const uint32_t &timeout)
                                              timeout);
 
     // фиксация общего времени ожидания событий
-    waitStarted = DateUtils::getTickCount() - waitStarted;
+    waitStarted = LoopClock::update() - waitStarted;
     _waitCount = _waitCount + waitStarted;
 
     // выход по таймауту
@@ -127,7 +150,13 @@ int Polling::poll(const uint32_t &timeout)
         // обработка события в голосующем
         for (auto poller : _pollers)
             if (poller->hasEvent(pollArray.at(eventIndex)))
+            {
+                // голосующий другого объекта голосования отмечает его до обработки
+                Polling *guest = _guests.value(poller, nullptr);
+                if (guest)
+                    _activeGuests.insert(guest);
                 poller->process(eventToProcess);
+            }
 
         // сброс события теперь здесь после обработки события
         // ResetEvent(eventToProcess);
@@ -136,6 +165,45 @@ int Polling::poll(const uint32_t &timeout)
     return 1;
 }
 
+Polling *Polling::host() const
+{
+    return _host;
+}
+
+void Polling::setHost(Polling *host)
+{
+    if (_host == host)
+        return;
+
+    if (_host)
+        for (auto poller : _pollers)
+        {
+            _host->unregisterPoller(poller);
+            _host->_guests.remove(poller);
+        }
+
+    _host = host;
+
+    if (_host)
+        for (auto poller : _pollers)
+        {
+            _host->registerPoller(poller);
+            _host->_guests.insert(poller, this);
+        }
+}
+
+QSet<Polling*> Polling::takeActiveGuests()
+{
+    QSet<Polling*> result;
+    result.swap(_activeGuests);
+    return result;
+}
+
+PollersList Polling::pollers() const
+{
+    return _pollers;
+}
+
 qint64 Polling::waitCount() const
 {
     return _waitCount;
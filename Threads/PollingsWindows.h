@@ -7,7 +7,9 @@
 
 #include "ThreadsCommon.h"
 
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QVector>
 
 #include <windows.h>
@@ -50,6 +52,20 @@ public:
      */
     explicit Polling();
 
+    /**
+     * @brief pollingMethod - Получение способа ожидания событий
+     * @return - Способ ожидания событий
+     */
+    PollingMethod pollingMethod() const;
+
+    /**
+     * @brief setPollingMethod - Установка способа ожидания событий.
+     * В Windows поддерживается только ожидание WaitForMultipleObjects (PollingMethod::Poll)
+     * @param pollingMethod - Способ ожидания событий
+     * @return - Признак успешной установки
+     */
+    bool setPollingMethod(const PollingMethod &pollingMethod);
+
     /**
      * @brief pollersCount - Получение количества зарегистрированных голосующих
      * @return - Количество зарегистрированных голосующих
@@ -82,6 +98,33 @@ public:
      * @return - Время в режиме ожидания голосования в миллисекундах
      */
     qint64 waitCount() const;
+
+    /**
+     * @brief pollers - Получение списка зарегистрированных голосующих
+     * @return - Список голосующих
+     */
+    PollersList pollers() const;
+
+    /**
+     * @brief host - Получение объекта голосования, в котором выполняется ожидание
+     * событий голосующих данного объекта
+     * @return - Объект голосования или NULL
+     */
+    Polling *host() const;
+
+    /**
+     * @brief setHost - Передача голосующих в другой объект голосования
+     * @param host - Объект голосования или NULL для возврата голосующих
+     */
+    void setHost(Polling *host);
+
+    /**
+     * @brief takeActiveGuests - Получение объектов голосования, голосующие которых,
+     * переданные данному объекту через setHost, получили события с предыдущего вызова
+     * @return - Объекты голосования
+     */
+    QSet<Polling*> takeActiveGuests();
+
 private:
     /**
      * @brief _pollers - Список голосующих
@@ -93,6 +136,20 @@ private:
      */
     qint64 _waitCount;
 
+    /**
+     * @brief _host - Объект голосования, выполняющий ожидание событий голосующих
+     */
+    Polling *_host;
+
+    /**
+     * @brief _guests - Объекты голосования, передавшие голосующих данному объекту
+     */
+    QHash<PollerBase*, Polling*> _guests;
+
+    /**
+     * @brief _activeGuests - Объекты голосования, голосующие которых получили события
+     */
+    QSet<Polling*> _activeGuests;
 };
 
 }}
@@ -1,76 +1,239 @@
 #include "QueueMessages.h"
 
+#include "../Utils/SlabAllocator.h"
+
+#include <new>
+
 namespace Threader {
 
 namespace Threads {
 
+
+namespace {
+
+/**
+ * @brief createNode - Создание узла очереди в блоке SlabAllocator потока-производителя
+ */
+QueueMessages::Node *createNode(QueueMessages::Node *next, const MessageBase::Ptr &message)
+{
+    void *memory = Utils::SlabAllocator::allocate(sizeof(QueueMessages::Node));
+    return new (memory) QueueMessages::Node{next, message};
+}
+
+/**
+ * @brief destroyNode - Освобождение узла очереди, блок возвращается потоку-производителю
+ */
+void destroyNode(QueueMessages::Node *node)
+{
+    node->~Node();
+    Utils::SlabAllocator::deallocate(node);
+}
+
+}
+
+
+QueueMessages::Batch::Batch(Node *first, const int count)
+    : _first(first)
+    , _count(count)
+{
+}
+
+QueueMessages::Batch::Batch(Batch &&other) noexcept
+    : _first(other._first)
+    , _count(other._count)
+{
+    other._first = nullptr;
+    other._count = 0;
+}
+
+QueueMessages::Batch &QueueMessages::Batch::operator=(Batch &&other) noexcept
+{
+    std::swap(_first, other._first);
+    std::swap(_count, other._count);
+    return *this;
+}
+
+QueueMessages::Batch::~Batch()
+{
+    while (_first)
+    {
+        Node *node = _first;
+        _first = node->next;
+        destroyNode(node);
+    }
+}
+
+int QueueMessages::Batch::count() const
+{
+    return _count;
+}
+
+bool QueueMessages::Batch::isEmpty() const
+{
+    return nullptr == _first;
+}
+
+MessageBase::Ptr QueueMessages::Batch::takeFirst()
+{
+    if (!_first)
+        return MessageBase::Ptr();
+
+    Node *node = _first;
+    _first = node->next;
+    _count--;
+
+    MessageBase::Ptr result = std::move(node->message);
+    destroyNode(node);
+    return result;
+}
+
 QueueMessages::QueueMessages()
+    : _incoming(nullptr)
+    , _count(0)
+    , _pendingFirst(nullptr)
+    , _pendingLast(nullptr)
+    , _pendingCount(0)
 {
-    _mutex = new QMutex();
 }
 
 QueueMessages::~QueueMessages()
 {
-    delete _mutex;
+    takeIncoming();
+    Batch batch(_pendingFirst, _pendingCount);
 }
 
 int QueueMessages::count()
 {
-    QMutexLocker locker(_mutex);
-
-    return _queue.count();
+    return _count.load(std::memory_order_relaxed);
 }
 
 int QueueMessages::enqueue(const MessageBase::Ptr& message)
 {
-    QMutexLocker locker(_mutex);
+    Node *node = createNode(nullptr, message);
+
+    // счетчик увеличивается до публикации узла, чтобы уменьшение потребителем
+    // не могло его опередить
+    int result = _count.fetch_add(1, std::memory_order_relaxed) + 1;
 
-    _queue.enqueue(message);
-    return _queue.count();
+    // добавление узла в стек производителей
+    node->next = _incoming.load(std::memory_order_relaxed);
+    while (!_incoming.compare_exchange_weak(node->next, node))
+    {
+    }
+
+    return result;
 }
 
 int QueueMessages::enqueue(const MessagesList &list)
 {
-    QMutexLocker locker(_mutex);
+    if (list.isEmpty())
+        return count();
+
+    // формирование цепочки в обратном порядке: последний элемент списка на вершине стека
+    Node *last = nullptr;
+    Node *first = nullptr;
+    for (const auto &message : list)
+    {
+        Node *node = createNode(first, message);
+        if (!last)
+            last = node;
+        first = node;
+    }
+
+    int result = _count.fetch_add(list.count(), std::memory_order_relaxed) + list.count();
+
+    // добавление всей цепочки одной операцией
+    last->next = _incoming.load(std::memory_order_relaxed);
+    while (!_incoming.compare_exchange_weak(last->next, first))
+    {
+    }
 
-    _queue.append(list);
-    return _queue.count();
+    return result;
 }
 
 MessageBase::Ptr QueueMessages::dequeue()
 {
-    QMutexLocker locker(_mutex);
+    if (!_pendingFirst)
+        takeIncoming();
 
-    if (!_queue.isEmpty())
-        return _queue.dequeue();
+    if (!_pendingFirst)
+        return MessageBase::Ptr();
 
-    return MessageBase::Ptr();
+    Node *node = _pendingFirst;
+    _pendingFirst = node->next;
+    if (!_pendingFirst)
+        _pendingLast = nullptr;
+    _pendingCount--;
+    _count.fetch_sub(1, std::memory_order_relaxed);
+
+    MessageBase::Ptr result = std::move(node->message);
+    destroyNode(node);
+    return result;
 }
 
 MessagesList QueueMessages::dequeue(int count)
 {
-    QMutexLocker locker(_mutex);
-
-    if (0 <= count || _queue.length() > count)
-        return dequeueAll();
-
-    // полная ёбань, нет удаления диапазона, делаем через жьёппу
-    // но метод не используется, поэтому пох
-    MessagesList result = _queue.mid(0, count);
-    MessagesList tail = _queue.mid(count, _queue.length() - count);
-    _queue.clear();
-    _queue.append(tail);
-
+    MessagesList result;
+    while (count-- > 0)
+    {
+        auto message = dequeue();
+        if (!message)
+            break;
+        result.append(message);
+    }
     return result;
 }
 
 MessagesList QueueMessages::dequeueAll()
 {
-    QMutexLocker locker(_mutex);
+    MessagesList result;
+    Batch batch = dequeueBatch();
+    result.reserve(batch.count());
+    while (!batch.isEmpty())
+        result.append(batch.takeFirst());
+    return result;
+}
+
+QueueMessages::Batch QueueMessages::dequeueBatch()
+{
+    takeIncoming();
+
+    Batch result(_pendingFirst, _pendingCount);
+    _count.fetch_sub(_pendingCount, std::memory_order_relaxed);
+
+    _pendingFirst = nullptr;
+    _pendingLast = nullptr;
+    _pendingCount = 0;
 
-    MessagesList result(_queue);
-    _queue.clear();
     return result;
 }
 
+void QueueMessages::takeIncoming()
+{
+    // забор всего стека одной операцией
+    Node *node = _incoming.exchange(nullptr);
+    if (!node)
+        return;
+
+    // разворот стека в порядок поступления
+    Node *first = nullptr;
+    Node *last = node;
+    int takenCount = 0;
+    while (node)
+    {
+        Node *next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+        takenCount++;
+    }
+
+    if (_pendingLast)
+        _pendingLast->next = first;
+    else
+        _pendingFirst = first;
+    _pendingLast = last;
+    _pendingCount += takenCount;
+}
+
 }}
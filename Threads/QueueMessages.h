@@ -5,8 +5,8 @@
 
 #include <QObject>
 #include <QList>
-#include <QQueue>
-#include <QMutexLocker>
+
+#include <atomic>
 
 
 namespace Threader {
@@ -15,10 +15,60 @@ namespace Threads {
 
 /**
  * @brief MessageQueue - Класс-хранище очереди сообщений для асинхоронного обмена между потоками
+ * Очередь без блокировок с множеством производителей и одним потребителем (MPSC).
+ * Производители добавляют узлы в стек одной атомарной операцией, потребитель забирает
+ * весь стек одной операцией и разворачивает его в порядок поступления.
+ * Узлы выделяются SlabAllocator в потоке-производителе и возвращаются ему потребителем,
+ * поэтому размещение сообщения не обращается к общему распределителю памяти.
+ * Методы извлечения вызываются только из потока-владельца очереди
  */
 class THREADERSHARED_EXPORT QueueMessages
 {
 public:
+    /**
+     * @brief Node - Узел очереди
+     */
+    struct Node
+    {
+        Node *next;
+        MessageBase::Ptr message;
+    };
+
+    /**
+     * @brief Batch - Пакет сообщений, извлеченный из очереди одной операцией
+     */
+    class THREADERSHARED_EXPORT Batch
+    {
+    public:
+        explicit Batch(Node *first = nullptr, const int count = 0);
+        Batch(Batch &&other) noexcept;
+        Batch &operator=(Batch &&other) noexcept;
+        ~Batch();
+
+        /**
+         * @brief count - Получение количества оставшихся в пакете сообщений
+         * @return - Количество сообщений
+         */
+        int count() const;
+
+        /**
+         * @brief isEmpty - Получение признака пустого пакета
+         * @return - Признак пустого пакета
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief takeFirst - Извлечение первого сообщения пакета
+         * @return - Сообщение. Если пакет пуст, то возвращается NULL
+         */
+        MessageBase::Ptr takeFirst();
+
+    private:
+        Q_DISABLE_COPY(Batch)
+
+        Node *_first;
+        int _count;
+    };
 
     /**
      * @brief MessagesQueue - Конструктор класса очереди
@@ -44,7 +94,7 @@ public:
     int enqueue(const MessageBase::Ptr& message);
 
     /**
-     * @brief enqueue - Размещеине списка сообщений в очереди
+     * @brief enqueue - Размещеине списка сообщений в очереди одной атомарной операцией
      * @param list - список сообщений
      * @return - Количество сообщений в списке
      */
@@ -69,17 +119,44 @@ public:
      */
     MessagesList dequeueAll();
 
+    /**
+     * @brief dequeueBatch - Извлечение из очереди всех сообщений без копирования
+     * @return - Пакет извлеченных сообщений
+     */
+    Batch dequeueBatch();
+
 private:
+    Q_DISABLE_COPY(QueueMessages)
+
+    /**
+     * @brief takeIncoming - Перенос поступивших сообщений в очередь потребителя
+     */
+    void takeIncoming();
+
+    /**
+     * @brief _incoming - Вершина стека поступивших сообщений (в обратном порядке)
+     */
+    std::atomic<Node*> _incoming;
+
+    /**
+     * @brief _count - Количество сообщений в очереди
+     */
+    std::atomic<int> _count;
+
+    /**
+     * @brief _pendingFirst - Начало очереди потребителя (в порядке поступления)
+     */
+    Node *_pendingFirst;
 
     /**
-     * @brief _queue - Хранилище очереди сообщений
+     * @brief _pendingLast - Конец очереди потребителя
      */
-    QQueue<MessageBase::Ptr> _queue;
+    Node *_pendingLast;
 
     /**
-     * @brief _mutex - Мьютекс синхронизации доступа к хранилищу очереди
+     * @brief _pendingCount - Количество сообщений в очереди потребителя
      */
-    QMutex *_mutex;
+    int _pendingCount;
 };
 
 }}
@@ -1,4 +1,7 @@
 #include "SettingsBase.h"
+#include "LogSettings.h"
+#include "MetricsSettings.h"
+#include "ThreadPlacement.h"
 
 #include <QFileInfo>
 #include <QTextCodec>
@@ -24,6 +27,27 @@ QString SettingsBundle::fileName() const
     return _fileName;
 }
 
+std::shared_ptr<ThreadPlacementSettings> SettingsBundle::threadPlacement()
+{
+    if (!_threadPlacement)
+        _threadPlacement = std::make_shared<ThreadPlacementSettings>();
+    return _threadPlacement;
+}
+
+std::shared_ptr<LogSettings> SettingsBundle::logSettings()
+{
+    if (!_logSettings)
+        _logSettings = std::make_shared<LogSettings>();
+    return _logSettings;
+}
+
+std::shared_ptr<MetricsSettings> SettingsBundle::metricsSettings()
+{
+    if (!_metricsSettings)
+        _metricsSettings = std::make_shared<MetricsSettings>();
+    return _metricsSettings;
+}
+
 void SettingsBundle::setFileName(const QString &fileName)
 {
     _fileName = fileName;
@@ -38,6 +62,12 @@ bool SettingsBundle::read(QSettings &settings)
         if (!r)
             result = false;
     }
+    if (!threadPlacement()->read(settings))
+        result = false;
+    if (!logSettings()->read(settings))
+        result = false;
+    if (!metricsSettings()->read(settings))
+        result = false;
     return result;
 }
 
@@ -49,6 +79,12 @@ bool SettingsBundle::write(QSettings &settings)
         if (!s->write(settings))
             result = false;
     }
+    if (!threadPlacement()->write(settings))
+        result = false;
+    if (!logSettings()->write(settings))
+        result = false;
+    if (!metricsSettings()->write(settings))
+        result = false;
     return result;
 }
 
@@ -39,6 +39,11 @@ using SettingsBaseVector = QVector<SettingsBase::Ptr>;
 using SettingsBaseHash = QHash<QString, SettingsBase::Ptr>;
 
 
+class LogSettings;
+class MetricsSettings;
+class ThreadPlacementSettings;
+
+
 class THREADERSHARED_EXPORT SettingsBundle : public SettingsBase
 {
 public:
@@ -50,6 +55,25 @@ public:
 
     QString fileName() const;
 
+    /**
+     * @brief threadPlacement - Получение настроек размещения потоков
+     * Настройки читаются и записываются вместе с остальными настройками набора
+     * @return - Настройки размещения потоков
+     */
+    std::shared_ptr<ThreadPlacementSettings> threadPlacement();
+
+    /**
+     * @brief logSettings - Получение настроек подсистемы протоколирования
+     * @return - Настройки протоколирования
+     */
+    std::shared_ptr<LogSettings> logSettings();
+
+    /**
+     * @brief metricsSettings - Получение настроек подсистемы метрик
+     * @return - Настройки метрик
+     */
+    std::shared_ptr<MetricsSettings> metricsSettings();
+
 protected:
     void setFileName(const QString &fileName);
 
@@ -62,6 +86,9 @@ protected:
 private:
     SettingsBaseVector _settingsBundle;
     QString _fileName = QString();
+    std::shared_ptr<ThreadPlacementSettings> _threadPlacement;
+    std::shared_ptr<LogSettings> _logSettings;
+    std::shared_ptr<MetricsSettings> _metricsSettings;
 };
 
 }}
@@ -1,9 +1,17 @@
 #include "ThreadBase.h"
+#include "BinaryLog.h"
 #include "ListThreads.h"
+#include "LogRateLimiter.h"
 #include "MessageLog.h"
-#include "ThreadTimer.h"
+#include "MessageThread.h"
+#include "MessageTimer.h"
+#include "MessageTypes.h"
+#include "ThreadReactor.h"
 
+#include "../Utils/CycleClock.h"
 #include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
+#include "../Utils/SlabAllocator.h"
 
 #include <QTextCodec>
 
@@ -17,6 +25,12 @@
 #include <unistd.h>
 #endif
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace Threader
 {
 
@@ -33,10 +47,74 @@ const int ThreadBase::WAIT_RESULT_NOT_INITIALIZED = -2;
 
 const int ThreadBase::TIMEOUT_COLLECT_TERMINATED_THREADS_MILLISECONDS = 1000;
 const int ThreadBase::TIMEOUT_ACCUMULATE_STATISTIC_MILLISECONDS       = 10000;
+const int ThreadBase::TIMEOUT_UPDATE_METRICS_MILLISECONDS             = 1000;
 
 ThreadBase *ThreadBase::_logThread = nullptr;
 int ThreadBase::_logLevel = 9;
 
+ThreadPlacementSettings::Ptr ThreadBase::_placementSettings = nullptr;
+std::atomic<bool> ThreadBase::_isMessageTimingEnabled(false);
+std::atomic<qint64> ThreadBase::_slowMessageNanoseconds(0);
+
+namespace {
+
+/**
+ * @brief activeOutbox - Буфер исходящих сообщений текущего прохода обработки в потоке ОС
+ */
+thread_local MessagesOutbox *activeOutbox = nullptr;
+
+/**
+ * @brief OutboxScope - Проход обработки с накоплением исходящих сообщений
+ * Вложенные проходы используют буфер внешнего прохода, отправка выполняется
+ * при завершении внешнего прохода
+ */
+class OutboxScope
+{
+public:
+    explicit OutboxScope(MessagesOutbox *outbox)
+        : _outbox(activeOutbox ? nullptr : outbox)
+    {
+        if (_outbox)
+            activeOutbox = _outbox;
+    }
+
+    ~OutboxScope()
+    {
+        if (!_outbox)
+            return;
+
+        // при отправке буфер отключается, чтобы получатели ставили сообщения в очередь сразу
+        activeOutbox = nullptr;
+        _outbox->flush();
+    }
+
+private:
+    MessagesOutbox *_outbox;
+};
+
+/**
+ * @brief cpuRelax - Подсказка процессору о цикле активного ожидания
+ * Снижает энергопотребление и не отнимает ресурсы у соседнего логического ядра
+ */
+inline void cpuRelax()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+}
+
+struct ThreadBase::TimerEntry : public TimerWheel::Timer
+{
+    QString Name;
+    int Delay;
+    bool MultiShot;
+    qint64 ShotCount;
+};
+
 ThreadBase::ThreadBase(IMessageSubscriber *parent,
                        const QString &threadName,
                        const ThreadRunMode &threadRunMode)
@@ -44,7 +122,7 @@ ThreadBase::ThreadBase(IMessageSubscriber *parent,
     , _parentThread(parent)
     , _threadName((threadName.trimmed().isEmpty()) ? QString(metaObject()->className()) : threadName)
     , _thisThreadId(0)
-    , _aliveCheckedUtc(QDateTime::currentDateTimeUtc())
+    , _aliveCheckedTickCount(DateUtils::getTickCount())
     , _isTerminated(false)
     , _waitCount(0)
     , _nextDestroyTerminatedThreadsTickCount(DateUtils::getNextTickCount(TIMEOUT_COLLECT_TERMINATED_THREADS_MILLISECONDS))
@@ -56,6 +134,10 @@ ThreadBase::ThreadBase(IMessageSubscriber *parent,
     , _threadRunMode(threadRunMode)
     , _eventLoop(nullptr)
     , _timerEventLoop(nullptr)
+    , _reactor(nullptr)
+    , _hostedSignals(0)
+    , _hostedFinished(false)
+    , _timerWheel(LoopClock::read())
 {
     _pollerThread.moveToThread(this);
     if (ThreadRunMode::EventLoop == _threadRunMode)
@@ -64,6 +146,12 @@ ThreadBase::ThreadBase(IMessageSubscriber *parent,
 
 ThreadBase::~ThreadBase()
 {
+    // сообщения уничтожаемому потоку, накопленные в текущем проходе обработки
+    // (например, потоком-родителем, уничтожающим завершенные дочерние потоки), не передаются
+    if (activeOutbox)
+        activeOutbox->remove(this);
+
+    qDeleteAll(_timers);
 }
 
 IMessageSubscriber *ThreadBase::parentThread() const
@@ -102,6 +190,19 @@ void ThreadBase::setThreadRunMode(const ThreadRunMode &threadRunMode)
         this->moveToThread(this);
 }
 
+PollingMethod ThreadBase::pollingMethod() const
+{
+    return _polling.pollingMethod();
+}
+
+bool ThreadBase::setPollingMethod(const PollingMethod &pollingMethod)
+{
+    if (isRunning())
+        return false;
+
+    return _polling.setPollingMethod(pollingMethod);
+}
+
 QString ThreadBase::threadClassName()
 {
     return QString(metaObject()->className());
@@ -110,7 +211,9 @@ QString ThreadBase::threadClassName()
 long ThreadBase::threadId()
 {
 #ifdef Q_OS_LINUX
-    return syscall(SYS_gettid);
+    // системный вызов выполняется один раз на поток
+    static thread_local long id = syscall(SYS_gettid);
+    return id;
 #endif
 #ifdef Q_OS_WIN
     return GetCurrentThreadId();
@@ -127,6 +230,43 @@ QDateTime ThreadBase::startedUtc() const
     return _startedUtc;
 }
 
+quint64 ThreadBase::wakeUpsIssued() const
+{
+    return _pollerThread.wakeUpsIssued();
+}
+
+quint64 ThreadBase::wakeUpsSuppressed() const
+{
+    return _pollerThread.wakeUpsSuppressed();
+}
+
+quint64 ThreadBase::outboxMessagesCount() const
+{
+    return _outbox.messagesCount();
+}
+
+quint64 ThreadBase::outboxBatchesCount() const
+{
+    return _outbox.batchesCount();
+}
+
+quint64 ThreadBase::outboxRejectedCount() const
+{
+    return _outbox.rejectedCount();
+}
+
+bool ThreadBase::isThreadFinished() const
+{
+    if (_reactor)
+        return _hostedFinished.load();
+    return isFinished();
+}
+
+ThreadReactor *ThreadBase::reactor() const
+{
+    return _reactor;
+}
+
 bool ThreadBase::isTerminated() const
 {
     return _isTerminated;
@@ -137,18 +277,178 @@ Polling *ThreadBase::polling()
     return &_polling;
 }
 
-void ThreadBase::postMessage(const MessageBase::Ptr &message)
+PostMessageResult ThreadBase::postMessage(const MessageBase::Ptr &message)
 {
-    _queue.enqueue(message);
-    signalEventWakeUp();
+    // управляющие сообщения не задерживаются в буфере исходящих сообщений
+    if (activeOutbox && MessagePriority::Control != message->priority())
+    {
+        if (!_inbox.isBounded())
+        {
+            activeOutbox->append(this, message);
+            return PostMessageResult::Accepted;
+        }
+
+        // ограниченная очередь размещает сообщение сразу, чтобы отправитель получил
+        // действительный результат и ожидал места в очереди при отправке, а не при
+        // передаче буфера; накопленные ранее сообщения передаются первыми
+        activeOutbox->flush(this);
+    }
+
+    return postMessageNow(message);
+}
+
+PostMessageResult ThreadBase::postMessage(const MessageBase::Ptr &message, MessagePriority priority)
+{
+    message->setPriority(priority);
+    return postMessage(message);
 }
 
 void ThreadBase::postMessages(const MessagesList &messagesList)
 {
-    _queue.enqueue(messagesList);
+    if (messagesList.isEmpty())
+        return;
+
+    if (activeOutbox)
+    {
+        for (const MessageBase::Ptr &message : messagesList)
+            postMessage(message);
+        return;
+    }
+
+    // при ограниченной очереди каждое сообщение проверяется отдельно
+    if (_inbox.isBounded())
+    {
+        bool accepted = false;
+        for (const MessageBase::Ptr &message : messagesList)
+            accepted |= isPostAccepted(enqueueMessage(message));
+        if (accepted)
+            signalEventWakeUp();
+        return;
+    }
+
+    // группа с одним приоритетом размещается в очереди одной операцией
+    MessagePriority priority = messagesList.first()->priority();
+    bool samePriority = true;
+    int limitedCount = 0;
+    qint64 limitedBytes = 0;
+
+    // сообщения группы получают одну отметку времени размещения
+    qint64 enqueuedNanoseconds = 0;
+#ifndef THREADER_NO_MESSAGE_TIMING
+    if (_isMessageTimingEnabled.load(std::memory_order_relaxed))
+        enqueuedNanoseconds = CycleClock::nanoseconds();
+#endif
+
+    for (const MessageBase::Ptr &message : messagesList)
+    {
+        if (enqueuedNanoseconds > 0)
+            message->setEnqueuedNanoseconds(enqueuedNanoseconds);
+        if (message->priority() != priority)
+            samePriority = false;
+        if (MessagePriority::Control != message->priority())
+        {
+            limitedCount++;
+            limitedBytes += message->approximateSize();
+        }
+    }
+    _inbox.reserve(limitedCount, limitedBytes);
+
+    if (samePriority)
+    {
+        _queues[int(priority)].enqueue(messagesList);
+    }
+    else
+    {
+        MessagesList lanes[MESSAGE_PRIORITIES_COUNT];
+        for (const MessageBase::Ptr &message : messagesList)
+            lanes[int(message->priority())].append(message);
+        for (int lane = 0; lane < MESSAGE_PRIORITIES_COUNT; lane++)
+            _queues[lane].enqueue(lanes[lane]);
+    }
+
     signalEventWakeUp();
 }
 
+PostMessageResult ThreadBase::postMessageNow(const MessageBase::Ptr &message)
+{
+    PostMessageResult result = enqueueMessage(message);
+    if (isPostAccepted(result))
+        signalEventWakeUp();
+    return result;
+}
+
+bool ThreadBase::isPostAccepted(PostMessageResult result)
+{
+    return PostMessageResult::Accepted == result || PostMessageResult::DroppedOldest == result;
+}
+
+InboxLimits ThreadBase::inboxLimits() const
+{
+    return _inbox.limits();
+}
+
+void ThreadBase::setInboxLimits(const InboxLimits &limits)
+{
+    _inbox.setLimits(limits);
+}
+
+InboxStatistic ThreadBase::inboxStatistic() const
+{
+    return _inbox.statistic();
+}
+
+int ThreadBase::maxMessagesPerPass() const
+{
+    return _maxMessagesPerPass;
+}
+
+int ThreadBase::maxMicrosecondsPerPass() const
+{
+    return _maxMicrosecondsPerPass;
+}
+
+void ThreadBase::setMessagesBudget(int maxMessages, int maxMicroseconds)
+{
+    _maxMessagesPerPass = qMax(0, maxMessages);
+    _maxMicrosecondsPerPass = qMax(0, maxMicroseconds);
+}
+
+PostMessageResult ThreadBase::enqueueMessage(const MessageBase::Ptr &message)
+{
+    MessagePriority priority = message->priority();
+    PostMessageResult result = PostMessageResult::Accepted;
+
+    // управляющие сообщения не ограничиваются
+    if (MessagePriority::Control != priority)
+    {
+        result = _inbox.admit(message, canBlockProducer());
+        if (!isPostAccepted(result))
+            return result;
+    }
+
+#ifndef THREADER_NO_MESSAGE_TIMING
+    if (_isMessageTimingEnabled.load(std::memory_order_relaxed))
+        message->setEnqueuedNanoseconds(CycleClock::nanoseconds());
+#endif
+
+    _queues[int(priority)].enqueue(message);
+    return result;
+}
+
+bool ThreadBase::canBlockProducer() const
+{
+    // поток не может ожидать освобождения собственной очереди
+    if (isThreadFinished())
+        return false;
+    long consumerThreadId = _reactor ? _reactor->thisThreadId() : _thisThreadId;
+    return consumerThreadId != threadId();
+}
+
+int ThreadBase::queueCount(MessagePriority priority)
+{
+    return _queues[int(priority)].count();
+}
+
 void ThreadBase::postTerminateEvent()
 {
     signalEventTerminate();
@@ -168,8 +468,15 @@ void ThreadBase::initializeThread()
 
     _thisThreadId = -1;
 
+    // размещение применяется до создания объектов потока, чтобы их память
+    // выделялась на заданном узле NUMA
+    applyPlacement();
+
+    createMetrics();
+
     switch (_threadRunMode) {
     case ThreadRunMode::Polling:
+    case ThreadRunMode::Spinning:
 
         connect(&_pollerThread, &PollerThread::signalTerminateThread,
                 this, &ThreadBase::slotTerminateThread, Qt::DirectConnection);
@@ -178,15 +485,21 @@ void ThreadBase::initializeThread()
         connect(&_pollerThread, &PollerThread::signalWakeUpThread,
                 this, &ThreadBase::slotWakeUpThread, Qt::DirectConnection);
 
-        _polling.registerPoller(&_pollerThread);
+        // поток, обслуживаемый реактором, пробуждается через реактор
+        if (!_reactor)
+            _polling.registerPoller(&_pollerThread);
 
         break;
     case ThreadRunMode::EventLoop:
         _eventLoop = new QEventLoop();
         _eventLoop->moveToThread(this);
 
+        _nextCallIdle = LoopClock::read() + _timeout;
+
         _timerEventLoop = new QTimer();
         _timerEventLoop->moveToThread(this);
+        // точный таймер не срабатывает раньше срока, что важно для таймеров потока
+        _timerEventLoop->setTimerType(Qt::PreciseTimer);
         _timerEventLoop->setInterval(static_cast<int>(_timeout));
         connect(_timerEventLoop, &QTimer::timeout,
                 this, &ThreadBase::slotTimerEventLoop, Qt::AutoConnection);
@@ -210,6 +523,8 @@ void ThreadBase::finalizeThread()
     if (ListThreads::instance())
         ListThreads::instance()->unregisterThread(this);
 
+    releaseMetrics();
+
     if (_eventLoop)
         delete _eventLoop;
 
@@ -230,7 +545,17 @@ void ThreadBase::onBeforeWaitEvents() {}
 void ThreadBase::onAfterWaitEvents()
 {
     if (ThreadRunMode::EventLoop == _threadRunMode)
-        onIdle();
+    {
+        processTimers();
+
+        if (_nextCallIdle <= LoopClock::now())
+        {
+            onIdle();
+            _nextCallIdle = LoopClock::now() + _timeout;
+        }
+
+        restartTimerEventLoop();
+    }
     destroyTerminatedChildThreads(false);
 
     accumulateStatistic();
@@ -238,25 +563,16 @@ void ThreadBase::onAfterWaitEvents()
 
 void ThreadBase::run()
 {
-    initializeThread();
-
-    _thisThreadId = threadId();
-
-    _startedTickCount = DateUtils::getTickCount();
-    _startedUtc = QDateTime::currentDateTimeUtc();
-
-    onThreadStarted();
-
-    MESSAGE_TEMPLATE(50, 0, Debug, "Идентификатор потока [%s]: %d");
+    beginThreadCycle();
 
-    writeLog(Message50, STRLOG(threadName()), threadId());
-
-    startChildThreads();
-
-    if (ThreadRunMode::Polling == _threadRunMode)
+    if (ThreadRunMode::EventLoop != _threadRunMode)
     {
         while (!isTerminated())
         {
+            // время итерации захватывается до расчета таймаута ожидания
+            // и повторно при выходе из ожидания событий
+            LoopClock::update();
+
             onBeforeWaitEvents();
 
             waitEvents();
@@ -269,19 +585,46 @@ void ThreadBase::run()
         _eventLoop->exec();
     }
 
+    finishThreadCycle();
+
+    auto *ownerThread = parentThread();
+    if (ownerThread)
+        ownerThread->postEventChildThreadTerminated();
+}
+
+void ThreadBase::beginThreadCycle()
+{
+    initializeThread();
+
+    _thisThreadId = threadId();
+
+    _startedTickCount = DateUtils::getTickCount();
+    _startedUtc = QDateTime::currentDateTimeUtc();
+
+    onThreadStarted();
+
+    MESSAGE_TEMPLATE(50, 0, Debug, "Идентификатор потока [%s]: %d");
+
+    WRITE_LOG(Message50, STRLOG(threadName()), threadId());
+
+    startChildThreads();
+}
+
+void ThreadBase::finishThreadCycle()
+{
     onThreadFinishing();
 
+    stopAllTimers();
+
     terminateChildThreads();
 
-    processMessages();
+    do
+        processMessages();
+    while (hasPendingMessages());
 
     onThreadFinished();
 
     finalizeThread();
-
-    auto *ownerThread = parentThread();
-    if (ownerThread)
-        ownerThread->postEventChildThreadTerminated();
 }
 
 void ThreadBase::terminateThread()
@@ -291,25 +634,139 @@ void ThreadBase::terminateThread()
 
 bool ThreadBase::accumulateStatistic()
 {
-    if (DateUtils::getTickCount() <= _nextAccumulateStatisticTickCount)
+    updateMetrics();
+
+    if (LoopClock::now() <= _nextAccumulateStatisticTickCount)
         return false;
 
     _nextAccumulateStatisticTickCount =
-            DateUtils::getNextTickCount(TIMEOUT_ACCUMULATE_STATISTIC_MILLISECONDS);
+            LoopClock::now() + TIMEOUT_ACCUMULATE_STATISTIC_MILLISECONDS;
 
     ListThreads *list = ListThreads::instance();
     if (!list)
         return false;
 
-    list->accumulateStatistic(this, _thisThreadId, _threadName,
-                              _startedUtc.toLocalTime().toMSecsSinceEpoch(),
-                              QDateTime::currentDateTime().toMSecsSinceEpoch(),
-                              quint64(polling()->waitCount()),
-                              _queue.count(),
-                              isTerminated());
+    ThreadStatisticStruct statistic = {};
+    statistic.ThreadId = _thisThreadId;
+    statistic.ThreadName = _threadName;
+    statistic.StartedMsecsSinceEpoch = _startedUtc.toLocalTime().toMSecsSinceEpoch();
+    statistic.AliveMsecsSinceEpoch = LoopClock::currentMSecsSinceEpoch();
+    statistic.WaitMSecsCount = polling()->waitCount();
+    statistic.ControlQueueCount = queueCount(MessagePriority::Control);
+    statistic.NormalQueueCount = queueCount(MessagePriority::Normal);
+    statistic.BulkQueueCount = queueCount(MessagePriority::Bulk);
+    statistic.QueueCount = statistic.ControlQueueCount + statistic.NormalQueueCount +
+            statistic.BulkQueueCount;
+    statistic.Terminated = isTerminated();
+    statistic.Placement = effectivePlacement();
+    statistic.WakeUpsIssued = wakeUpsIssued();
+    statistic.WakeUpsSuppressed = wakeUpsSuppressed();
+    statistic.OutboxMessages = outboxMessagesCount();
+    statistic.OutboxBatches = outboxBatchesCount();
+    statistic.OutboxRejected = outboxRejectedCount();
+
+    InboxStatistic inboxStatistic = _inbox.statistic();
+    statistic.InboxDroppedNewest = inboxStatistic.DroppedNewest;
+    statistic.InboxDroppedOldest = inboxStatistic.DroppedOldest;
+    statistic.InboxConflated = inboxStatistic.Conflated;
+    statistic.InboxTimedOut = inboxStatistic.TimedOut;
+    statistic.InboxHighWaterCount = inboxStatistic.HighWaterCount;
+    statistic.InboxHighWaterBytes = inboxStatistic.HighWaterBytes;
+
+    list->accumulateStatistic(this, statistic);
     return true;
 }
 
+QString ThreadBase::metricsLabels() const
+{
+    return Metrics::label("thread", _threadName);
+}
+
+void ThreadBase::createMetrics()
+{
+    QString labels = metricsLabels();
+    _metrics.MessagesProcessed = Metrics::counter("threader_thread_messages_processed_total",
+                                                  "Messages processed by the thread", labels);
+    _metrics.PollWakeUps = Metrics::counter("threader_thread_poll_wakeups_total",
+                                            "Event waits finished by an event", labels);
+    _metrics.WaitMilliseconds = Metrics::counter("threader_thread_wait_milliseconds_total",
+                                                 "Time spent waiting for events", labels);
+    _metrics.WakeUpsIssued = Metrics::counter("threader_thread_wakeups_issued_total",
+                                              "Wake-ups of the thread issued by a system call", labels);
+    _metrics.InboxDropped = Metrics::counter("threader_thread_inbox_dropped_total",
+                                             "Messages dropped, conflated or timed out by inbox limits", labels);
+    _metrics.QueueCount = Metrics::gauge("threader_thread_queue_messages",
+                                         "Messages waiting in the thread queues", labels);
+    _nextUpdateMetricsTickCount = 0;
+}
+
+void ThreadBase::releaseMetrics()
+{
+    _metrics = ThreadMetrics();
+    _messageTimings.clear();
+}
+
+void ThreadBase::recordMessageTiming(const MessageBase &message,
+                                     qint64 dequeuedNanoseconds,
+                                     qint64 processedNanoseconds)
+{
+    int typeId = message.typeId();
+    if (typeId < 0)
+        return;
+    if (typeId >= _messageTimings.count())
+        _messageTimings.resize(typeId + 1);
+
+    // гистограммы типа создаются при обработке первого сообщения этого типа
+    MessageTiming &timing = _messageTimings[typeId];
+    if (!timing.Processing)
+    {
+        QString labels = metricsLabels() + "," + Metrics::label("message_type", MessageTypes::typeName(typeId));
+        timing.QueueDelay = Metrics::histogram("threader_message_queue_delay_nanoseconds",
+                                               "Time from enqueueing a message to the start of its processing",
+                                               labels);
+        timing.Processing = Metrics::histogram("threader_message_processing_nanoseconds",
+                                               "Time spent processing a message", labels);
+    }
+
+    // сообщение, размещенное до включения учета, не имеет отметки времени
+    qint64 enqueuedNanoseconds = message.enqueuedNanoseconds();
+    qint64 queueDelay = (enqueuedNanoseconds > 0) ? dequeuedNanoseconds - enqueuedNanoseconds : 0;
+    if (enqueuedNanoseconds > 0)
+        timing.QueueDelay->recordExclusive(queueDelay);
+
+    qint64 processing = processedNanoseconds - dequeuedNanoseconds;
+    timing.Processing->recordExclusive(processing);
+
+    qint64 slowMessageNanoseconds = _slowMessageNanoseconds.load(std::memory_order_relaxed);
+    if (slowMessageNanoseconds > 0 && processing >= slowMessageNanoseconds)
+    {
+        MESSAGE_TEMPLATE(52, 1, Warning,
+                         "Медленная обработка сообщения [%s] потоком [%s]: %lld мкс, ожидание в очереди: %lld мкс");
+
+        WRITE_LOG(Message52, STRLOG2(MessageTypes::typeName(typeId), threadName()),
+                  processing / 1000, queueDelay / 1000);
+    }
+}
+
+void ThreadBase::updateMetrics()
+{
+    if (!_metrics.QueueCount || LoopClock::now() < _nextUpdateMetricsTickCount)
+        return;
+
+    _nextUpdateMetricsTickCount = LoopClock::now() + TIMEOUT_UPDATE_METRICS_MILLISECONDS;
+
+    // значения, которые поток уже накапливает, переносятся целиком
+    _metrics.WaitMilliseconds->set(quint64(polling()->waitCount()));
+    _metrics.WakeUpsIssued->set(wakeUpsIssued());
+
+    InboxStatistic inboxStatistic = _inbox.statistic();
+    _metrics.InboxDropped->set(inboxStatistic.DroppedNewest + inboxStatistic.DroppedOldest +
+                               inboxStatistic.Conflated + inboxStatistic.TimedOut);
+    _metrics.QueueCount->set(queueCount(MessagePriority::Control) +
+                             queueCount(MessagePriority::Normal) +
+                             queueCount(MessagePriority::Bulk));
+}
+
 int ThreadBase::childthreadsCount()
 {
     return _childThreadsList.count();
@@ -332,15 +789,27 @@ ThreadBase *ThreadBase::registerAndStartChildThread(ThreadBase *thread)
     return thread;
 }
 
+ThreadBase *ThreadBase::registerAndAttachChildThread(ThreadBase *thread, ThreadReactor *reactor)
+{
+    if (!thread)
+        return nullptr;
+
+    if (!reactor || thread->isRunning() || !reactor->attachThread(thread))
+        return registerAndStartChildThread(thread);
+
+    _childThreadsList.append(thread);
+    return thread;
+}
+
 bool ThreadBase::terminateChildThread(ThreadBase *thread)
 {
     if (!thread)
         return false;
 
-    if (!thread->isFinished())
+    if (!thread->isThreadFinished())
     {
         thread->postTerminateEvent();
-        while (!thread->isFinished())
+        while (!thread->isThreadFinished())
         {
             processMessages();
         }
@@ -370,20 +839,20 @@ void ThreadBase::onDestroyTerminatedChildThread(ThreadBase *thread)
 
 void ThreadBase::destroyTerminatedChildThreads(bool rightNow)
 {
-    if (rightNow || _nextDestroyTerminatedThreadsTickCount <= DateUtils::getTickCount())
+    if (rightNow || _nextDestroyTerminatedThreadsTickCount <= LoopClock::now())
     {
         for (int i = _childThreadsList.count() - 1; i >= 0; i--)
         {
             ThreadBase *thread = _childThreadsList[i];
-            if (thread->isFinished())
+            if (thread->isThreadFinished())
             {
                 onDestroyTerminatedChildThread(thread);
                 delete thread;
                 _childThreadsList.removeAt(i);
             }
         }
-        _nextDestroyTerminatedThreadsTickCount = DateUtils::getNextTickCount(
-                    TIMEOUT_COLLECT_TERMINATED_THREADS_MILLISECONDS);
+        _nextDestroyTerminatedThreadsTickCount =
+                LoopClock::now() + TIMEOUT_COLLECT_TERMINATED_THREADS_MILLISECONDS;
     }
 }
 
@@ -392,30 +861,138 @@ int ThreadBase::messagesLeftToProcess()
     return _messagesLeftToProcess;
 }
 
-bool ThreadBase::processMessage(const MessageBase::Ptr &)
+bool ThreadBase::processMessage(const MessageBase::Ptr &message)
 {
-    return false;
+    return _dispatcher.dispatch(message);
 }
 
 void ThreadBase::processMessages()
 {
-    const MessagesList messages = _queue.dequeueAll();
-    _messagesLeftToProcess = messages.count();
+    OutboxScope outboxScope(&_outbox);
+
+    // пакеты забираются из очередей одной операцией без копирования, пакет очереди
+    // обновляется только после полной обработки оставшегося с прошлого прохода
+    _messagesLeftToProcess = 0;
+    for (int lane = 0; lane < MESSAGE_PRIORITIES_COUNT; lane++)
+    {
+        if (_batches[lane].isEmpty())
+            _batches[lane] = _queues[lane].dequeueBatch();
+        _messagesLeftToProcess += _batches[lane].count();
+    }
+
+    QueueMessages &controlQueue = _queues[int(MessagePriority::Control)];
+    QueueMessages::Batch &control = _batches[int(MessagePriority::Control)];
+    QueueMessages::Batch &normal = _batches[int(MessagePriority::Normal)];
+    QueueMessages::Batch &bulk = _batches[int(MessagePriority::Bulk)];
+
+    _messagesPasses++;
+
+    int processedCount = 0;
+
+    // окончание обработки сообщения считается началом обработки следующего,
+    // поэтому на сообщение приходится одно чтение счетчика
+    bool isTimed = false;
+    qint64 timingNanoseconds = 0;
+#ifndef THREADER_NO_MESSAGE_TIMING
+    isTimed = _metrics.MessagesProcessed && _isMessageTimingEnabled.load(std::memory_order_relaxed);
+    if (isTimed)
+        timingNanoseconds = CycleClock::nanoseconds();
+#endif
+
+    qint64 deadline = (_maxMicrosecondsPerPass > 0) ?
+                (isTimed ? timingNanoseconds : DateUtils::getTickCountNanoseconds()) +
+                qint64(_maxMicrosecondsPerPass) * 1000 : 0;
 
     onProcessMessagesStarted();
 
-    for (int i = 0; i < messages.count(); i++)
+    while (true)
     {
+        // по исчерпании бюджета оставшиеся сообщения обрабатываются после обслуживания событий
+        if (processedCount > 0 &&
+                ((_maxMessagesPerPass > 0 && processedCount >= _maxMessagesPerPass) ||
+                 (deadline > 0 &&
+                  (isTimed ? timingNanoseconds : DateUtils::getTickCountNanoseconds()) >= deadline)))
+            break;
+
+        // управляющие сообщения, поступившие во время прохода, обрабатываются без ожидания
+        // следующего прохода
+        if (control.isEmpty() && controlQueue.count() > 0)
+        {
+            control = controlQueue.dequeueBatch();
+            _messagesLeftToProcess += control.count();
+        }
+
+        // при переполнении удаляются самые старые массовые, затем обычные сообщения
+        while (control.isEmpty() && _inbox.takeEviction())
+        {
+            QueueMessages::Batch *evicted = !bulk.isEmpty() ? &bulk : (!normal.isEmpty() ? &normal : nullptr);
+            if (!evicted)
+            {
+                _inbox.returnEviction();
+                break;
+            }
+            _messagesLeftToProcess--;
+            _inbox.release(evicted->takeFirst());
+        }
+
+        QueueMessages::Batch *batch;
+        if (!control.isEmpty())
+        {
+            batch = &control;
+        }
+        else if (!normal.isEmpty() && (bulk.isEmpty() || _normalStreak < BULK_STARVATION_LIMIT))
+        {
+            batch = &normal;
+            _normalStreak++;
+        }
+        else if (!bulk.isEmpty())
+        {
+            // массовые сообщения обрабатываются не реже одного на BULK_STARVATION_LIMIT обычных
+            batch = &bulk;
+            _normalStreak = 0;
+        }
+        else
+        {
+            break;
+        }
+
         _messagesLeftToProcess--;
-        MessageBase::Ptr message = messages[i];
+        MessageBase::Ptr message = batch->takeFirst();
+        if (batch != &control)
+            message = _inbox.release(message);
         processMessage(message);
+        processedCount++;
 
-        accumulateStatistic();
+#ifndef THREADER_NO_MESSAGE_TIMING
+        if (isTimed)
+        {
+            qint64 dequeuedNanoseconds = timingNanoseconds;
+            timingNanoseconds = CycleClock::nanoseconds();
+            recordMessageTiming(*message, dequeuedNanoseconds, timingNanoseconds);
+        }
+#endif
     }
 
     onProcessMessagesFinished();
 
+    if (_metrics.MessagesProcessed && processedCount > 0)
+        _metrics.MessagesProcessed->increment(quint64(processedCount));
+
     accumulateStatistic();
+
+    // в режиме цикла событий и на реакторе продолжение обработки планируется отдельно
+    if (hasPendingMessages() && ThreadRunMode::EventLoop == _threadRunMode && !_reactor)
+        signalEventWakeUp();
+}
+
+bool ThreadBase::hasPendingMessages() const
+{
+    for (int lane = 0; lane < MESSAGE_PRIORITIES_COUNT; lane++)
+    {
+        if (!_batches[lane].isEmpty())
+            return true;
+    }
+    return false;
 }
 
 void ThreadBase::waitEvents()
@@ -425,25 +1002,102 @@ void ThreadBase::waitEvents()
 
 void ThreadBase::waitEvents(uint timeout)
 {
+    OutboxScope outboxScope(&_outbox);
+
     // ожидание голосования
     // результаты положительного голосования обрабатыватся внутри функции
     // и вызываются соответствующие слоты
     // остальные результаты отдаются на обработку снаружи
-    auto pollResult = _polling.poll(timeout);
+    // ожидание ограничивается временем ближайшего таймера
+    // при оставшихся после исчерпания бюджета сообщениях события только опрашиваются
+    uint waitTimeout = hasPendingMessages() ? 0 : timersWaitTimeout(timeout);
+    quint64 messagesPasses = _messagesPasses;
+    auto pollResult = (ThreadRunMode::Spinning == _threadRunMode && waitTimeout > 0) ?
+                spinEvents(waitTimeout) : _polling.poll(waitTimeout);
 
     // если произошла ошибка
     if (pollResult < 0)
     {
         processError("Ошибка ожидания событий", errno);
     }
+    else if (pollResult > 0 && _metrics.PollWakeUps)
+    {
+        _metrics.PollWakeUps->increment();
+    }
 
-    // если выход по таймауту или нужно вызывать Idle
-    if (0 == pollResult || _nextCallIdle < DateUtils::getTickCount())
+    // если выход по таймауту потока (а не таймера) или нужно вызывать Idle
+    if ((0 == pollResult && waitTimeout == timeout) || _nextCallIdle < LoopClock::now())
     {
         onIdle();
-        _nextCallIdle = DateUtils::getNextTickCount(_timeout);
+        _nextCallIdle = LoopClock::now() + _timeout;
+    }
+
+    processTimers();
+
+    // продолжение обработки, если сообщения не обрабатывались при обслуживании событий
+    if (messagesPasses == _messagesPasses && hasPendingMessages())
+        processMessages();
+
+    _aliveCheckedTickCount = LoopClock::now();
+}
+
+int ThreadBase::spinEvents(uint timeout)
+{
+    // окно активного ожидания не превышает таймаут ожидания
+    qint64 spinStarted = DateUtils::getTickCountNanoseconds();
+    qint64 spinDeadline = spinStarted +
+            qMin(qint64(_spinWindow) * 1000, qint64(timeout) * 1000000);
+    qint64 spinNow = spinStarted;
+    int result = 0;
+
+    _pollerThread.setSpinning(true);
+    while (true)
+    {
+        // сигналы проверяются по флагам, голосующие - с нулевым таймаутом
+        if (_pollerThread.processPendingSignals())
+        {
+            result = 1;
+            break;
+        }
+
+        result = _polling.poll(0);
+        if (0 != result || isTerminated())
+            break;
+
+        spinNow = DateUtils::getTickCountNanoseconds();
+        if (spinNow >= spinDeadline)
+            break;
+
+        cpuRelax();
     }
-    _aliveCheckedUtc = QDateTime::currentDateTimeUtc();
+    _pollerThread.setSpinning(false);
+
+    // сигнал мог поступить между последней проверкой и сбросом признака
+    if (0 == result && _pollerThread.processPendingSignals())
+        result = 1;
+
+    if (0 != result)
+    {
+        _spinWindow = _spinMicroseconds;
+        return result;
+    }
+
+    if (isTerminated())
+        return result;
+
+    // ожидание без событий сокращает окно
+    _spinWindow = qMax(_spinWindow / 2, _spinMicroseconds / SPIN_BACKOFF_DIVIDER);
+
+    qint64 spentMsecs = (spinNow - spinStarted) / 1000000;
+    uint blockTimeout = (spentMsecs < qint64(timeout)) ? uint(timeout - spentMsecs) : 0;
+    result = _polling.poll(blockTimeout);
+
+    // событие вскоре после блокировки означает, что окно было слишком коротким
+    if (result > 0 &&
+            DateUtils::getTickCountNanoseconds() - spinNow < qint64(_spinMicroseconds) * 1000)
+        _spinWindow = qMin(_spinWindow * 2, _spinMicroseconds);
+
+    return result;
 }
 
 QString ThreadBase::errorString(int errorNo)
@@ -478,7 +1132,7 @@ void ThreadBase::processError(const QString &errorTitle, int errorNo)
     if (errorNo < 0)
         errorNo = errno;
 
-    writeLog(Message99999, STRLOG(errorTitle), errorNo, strerror(errorNo));
+    WRITE_LOG(Message99999, STRLOG(errorTitle), errorNo, strerror(errorNo));
 }
 
 void ThreadBase::setLogThread(ThreadBase *thread,
@@ -524,7 +1178,20 @@ void ThreadBase::writeLog(IMessageSubscriber *receiver, const MessageLogTemplate
     if (messageTemplate.level > _logLevel)
         return;
 
+    // подавление частых сообщений до форматирования и выделения памяти
+    if (!LogRateLimiter::allow(messageTemplate))
+        return;
+
     va_list args;
+    if (_logThread)
+    {
+        va_start(args, messageTemplate);
+        bool isWritten = BinaryLog::write(messageTemplate, args);
+        va_end(args);
+        if (isWritten)
+            return;
+    }
+
     va_start(args, messageTemplate);
     char resultPtr[1024];
     memset(resultPtr, 0, sizeof(resultPtr));
@@ -540,7 +1207,7 @@ void ThreadBase::writeLog(IMessageSubscriber *receiver, const MessageLogTemplate
     {
         message = "Не удалось выполнить форматирование строки";
     }
-    auto messageLog = std::make_shared<MessageLog>(message,
+    auto messageLog = Utils::makeSlabShared<MessageLog>(message,
                                                    messageTemplate.number,
                                                    messageTemplate.level,
                                                    messageTemplate.messageType);
@@ -552,12 +1219,41 @@ void ThreadBase::writeLog(const MessageLogTemplate messageTemplate, ...)
     if (messageTemplate.level > _logLevel || !_logThread)
         return;
 
+    // подавление частых сообщений до форматирования и выделения памяти
+    if (!LogRateLimiter::allow(messageTemplate))
+        return;
+
+    va_list args;
+    va_start(args, messageTemplate);
+    writeLogArguments(messageTemplate, args);
+    va_end(args);
+}
+
+void ThreadBase::writeLogAdmitted(const MessageLogTemplate messageTemplate, ...)
+{
+    if (!_logThread)
+        return;
+
     va_list args;
     va_start(args, messageTemplate);
+    writeLogArguments(messageTemplate, args);
+    va_end(args);
+}
+
+void ThreadBase::writeLogArguments(const MessageLogTemplate &messageTemplate, va_list args)
+{
+    // запись в двоичный журнал без форматирования, форматирует поток протоколирования
+    va_list binaryArgs;
+    va_copy(binaryArgs, args);
+    bool isWritten = BinaryLog::write(messageTemplate, binaryArgs);
+    va_end(binaryArgs);
+    if (isWritten)
+        return;
+
+    // журнал отключен или буфер переполнен у самого потока протоколирования
     char resultPtr[1024];
     memset(resultPtr, 0, sizeof(resultPtr));
     auto resultCount = vsnprintf(resultPtr, sizeof(resultPtr), STRLOG(messageTemplate.text), args);
-    va_end(args);
 
     QString messageText;
     if (resultCount > 0)
@@ -568,7 +1264,7 @@ void ThreadBase::writeLog(const MessageLogTemplate messageTemplate, ...)
     {
         messageText = "Не удалось выполнить форматирование строки";
     }
-    auto message = std::make_shared<MessageLog>(messageText,
+    auto message = Utils::makeSlabShared<MessageLog>(messageText,
                                                 messageTemplate.number,
                                                 messageTemplate.level,
                                                 messageTemplate.messageType);
@@ -596,62 +1292,168 @@ MessageSubscribersVector ThreadBase::messageSubscribers(const QString &messageNa
     return {};
 }
 
+int ThreadBase::publishMessage(const MessageBase::Ptr &message)
+{
+    auto it = _subscribers.constFind(message->name());
+    if (it == _subscribers.constEnd())
+        return 0;
+
+    // во время прохода обработки получатель сам помещает сообщение в буфер исходящих
+    for (IMessageSubscriber *subscriber : it.value())
+        subscriber->postMessage(message);
+
+    return it.value().count();
+}
+
 QEventLoop *ThreadBase::eventLoop() const
 {
     return _eventLoop;
 }
 
-ThreadBase *ThreadBase::startTimer(const QString &timerName,
-                                   const int &delayMsecs,
-                                   const bool multiShot)
+bool ThreadBase::startTimer(const QString &timerName,
+                            const int &delayMsecs,
+                            const bool multiShot)
 {
-    auto thread = new ThreadTimer(this, timerName, delayMsecs, multiShot);
-    registerAndStartChildThread(thread);
-    return thread;
+    if (delayMsecs < 0)
+        return false;
+
+    TimerEntry *timer = _timers.value(timerName, nullptr);
+    if (!timer)
+    {
+        timer = new TimerEntry();
+        timer->Name = timerName;
+        _timers.insert(timerName, timer);
+    }
+
+    // периодический таймер с нулевой задержкой занял бы поток полностью
+    timer->Delay = (multiShot && 0 == delayMsecs) ? 1 : delayMsecs;
+    timer->MultiShot = multiShot;
+    timer->ShotCount = 0;
+
+    // счетчик читается заново: таймер может запускаться в середине итерации
+    _timerWheel.start(timer, LoopClock::read() + timer->Delay);
+
+    restartTimerEventLoop();
+    return true;
 }
 
 bool ThreadBase::stopTimer(const QString &timerName)
 {
-    bool result = false;
+    TimerEntry *timer = _timers.take(timerName);
+    if (!timer)
+        return false;
+
+    // таймер извлекается из колеса в деструкторе
+    delete timer;
+    return true;
+}
+
+int ThreadBase::stopAllTimers()
+{
+    int result = _timers.count();
+
+    qDeleteAll(_timers);
+    _timers.clear();
 
-    for (int i = 0; i < _childThreadsList.count(); i++)
+    return result;
+}
+
+int ThreadBase::timersCount() const
+{
+    return _timers.count();
+}
+
+void ThreadBase::processTimers()
+{
+    if (0 == _timerWheel.count())
+        return;
+
+    auto tickCount = LoopClock::now();
+
+    TimerWheel::TimersList expired;
+    if (0 == _timerWheel.expire(tickCount, expired))
+        return;
+
+    for (auto wheelTimer : expired)
     {
-        auto thread = dynamic_cast<ThreadTimer*>(_childThreadsList.at(i));
-        if (!thread)
-            continue;
+        auto timer = static_cast<TimerEntry*>(wheelTimer);
+        timer->ShotCount++;
 
-        if (thread->timerName() == timerName)
+        // сообщение ставится в собственную очередь без пробуждения потока
+        _queues[int(MessagePriority::Control)].enqueue(
+                    Utils::makeSlabShared<MessageTimer>(timer->Name, timer->ShotCount));
+
+        if (timer->MultiShot)
+        {
+            // следующее срабатывание отсчитывается от расчетного, чтобы не накапливать отставание,
+            // а пропущенные срабатывания не повторяются
+            qint64 expires = timer->expires() + timer->Delay;
+            if (expires <= tickCount)
+                expires = tickCount + timer->Delay;
+            _timerWheel.start(timer, expires);
+        }
+        else
         {
-            thread->postTerminateEvent();
-            result = true;
+            _timers.remove(timer->Name);
+            delete timer;
         }
     }
-    return result;
+
+    processMessages();
 }
 
-int ThreadBase::stopAllTimers()
+uint ThreadBase::timersWaitTimeout(uint timeout) const
 {
-    int result = 0;
+    qint64 deadline = _timerWheel.nextDeadline();
+    if (deadline < 0)
+        return timeout;
 
-    for (int i = 0; i < _childThreadsList.count(); i++)
-    {
-        auto thread = dynamic_cast<ThreadTimer*>(_childThreadsList.at(i));
-        if (!thread)
-            continue;
+    qint64 delay = deadline - LoopClock::now();
+    if (delay <= 0)
+        return 0;
 
-        thread->postTerminateEvent();
-        result++;
-    }
-    return result;
+    return (delay < qint64(timeout)) ? uint(delay) : timeout;
+}
+
+void ThreadBase::restartTimerEventLoop()
+{
+    if (!_timerEventLoop)
+        return;
+
+    // интервал ограничивается ближайшим вызовом onIdle и ближайшим таймером
+    qint64 idleDelay = _nextCallIdle - LoopClock::now();
+    uint timeout = (idleDelay > 0) ? uint(qMin(idleDelay, qint64(_timeout))) : 0;
+
+    _timerEventLoop->start(static_cast<int>(timersWaitTimeout(timeout)));
+}
+
+void ThreadBase::signalHostedThread(ThreadSignals signal)
+{
+    // сообщение реактору отправляется только при появлении первого необработанного события
+    if (0 == _hostedSignals.fetch_or(1 << static_cast<int>(signal)))
+        _reactor->postMessage(std::make_shared<MessageThread>(
+                                  ThreadReactor::MESSAGE_NAME_THREAD_SIGNALS, this));
+}
+
+void ThreadBase::wakeUp()
+{
+    signalEventWakeUp();
 }
 
 void ThreadBase::signalEventWakeUp()
 {
-    if (isFinished())
+    if (isThreadFinished())
         return;
 
+    if (_reactor)
+    {
+        signalHostedThread(ThreadSignals::EVENT_THREAD_WAKEUP);
+        return;
+    }
+
     switch (_threadRunMode) {
     case ThreadRunMode::Polling:
+    case ThreadRunMode::Spinning:
         _pollerThread.sendSignalWakeUp();
         break;
     case ThreadRunMode::EventLoop:
@@ -662,11 +1464,18 @@ void ThreadBase::signalEventWakeUp()
 
 void ThreadBase::signalEventTerminate()
 {
-    if (isFinished())
+    if (isThreadFinished())
+        return;
+
+    if (_reactor)
+    {
+        signalHostedThread(ThreadSignals::EVENT_THREAD_TERMINATE);
         return;
+    }
 
     switch (_threadRunMode) {
     case ThreadRunMode::Polling:
+    case ThreadRunMode::Spinning:
         _pollerThread.sendSignalTerminate();
         break;
     case ThreadRunMode::EventLoop:
@@ -677,11 +1486,18 @@ void ThreadBase::signalEventTerminate()
 
 void ThreadBase::signalEventChildThreadTerminated()
 {
-    if (isFinished())
+    if (isThreadFinished())
         return;
 
+    if (_reactor)
+    {
+        signalHostedThread(ThreadSignals::EVENT_CHILD_THREAD_TERMINATED);
+        return;
+    }
+
     switch (_threadRunMode) {
     case ThreadRunMode::Polling:
+    case ThreadRunMode::Spinning:
         _pollerThread.sendSignalTerminateChildThreads();
         break;
     case ThreadRunMode::EventLoop:
@@ -700,6 +1516,105 @@ void ThreadBase::setTimeout(uint timeout)
     _timeout = timeout;
 }
 
+uint ThreadBase::spinMicroseconds() const
+{
+    return _spinMicroseconds;
+}
+
+void ThreadBase::setSpinMicroseconds(uint spinMicroseconds)
+{
+    _spinMicroseconds = spinMicroseconds;
+    _spinWindow = spinMicroseconds;
+}
+
+void ThreadBase::start(Priority priority)
+{
+    // размер стека задается только до запуска потока
+    ThreadPlacement threadPlacement = placement();
+    if (threadPlacement.StackSize > 0)
+        setStackSize(threadPlacement.StackSize);
+
+    QThread::start(priority);
+}
+
+ThreadPlacement ThreadBase::placement() const
+{
+    {
+        QMutexLocker locker(&_placementMutex);
+        if (_hasPlacement)
+            return _placement;
+    }
+
+    ThreadPlacement result;
+    ThreadPlacementSettings::Ptr settings = placementSettings();
+    if (settings)
+        settings->placementFor(_threadName, result);
+    return result;
+}
+
+void ThreadBase::setPlacement(const ThreadPlacement &placement)
+{
+    QMutexLocker locker(&_placementMutex);
+    _placement = placement;
+    _hasPlacement = true;
+}
+
+QString ThreadBase::effectivePlacement() const
+{
+    QMutexLocker locker(&_placementMutex);
+    return _effectivePlacement;
+}
+
+bool ThreadBase::applyPlacement()
+{
+    // поток реактора размещается настройками самого реактора
+    if (_reactor)
+        return false;
+
+    bool isCurrentThread = QThread::currentThread() == this;
+    long id = isCurrentThread ? threadId() : _thisThreadId;
+    if (id <= 0)
+        return false;
+
+    ThreadPlacement threadPlacement = placement();
+    QString errors = threadPlacement.isEmpty() ? QString() : threadPlacement.apply(id, isCurrentThread);
+    QString effective = threadPlacement.effective(id).toString();
+
+    {
+        QMutexLocker locker(&_placementMutex);
+        _effectivePlacement = effective;
+    }
+
+    if (!errors.isEmpty())
+    {
+        MESSAGE_TEMPLATE(51, 1, Warning, "Размещение потока [%s] применено с ошибками: %s");
+
+        WRITE_LOG(Message51, STRLOG2(threadName(), errors));
+        return false;
+    }
+    return true;
+}
+
+void ThreadBase::setPlacementSettings(const ThreadPlacementSettings::Ptr &settings)
+{
+    std::atomic_store(&_placementSettings, settings);
+}
+
+ThreadPlacementSettings::Ptr ThreadBase::placementSettings()
+{
+    return std::atomic_load(&_placementSettings);
+}
+
+void ThreadBase::setMessageTiming(bool enabled, int slowMessageMicroseconds)
+{
+    // частота счетчика тактов определяется до первого замера
+    if (enabled)
+        CycleClock::calibrate();
+    _isMessageTimingEnabled.store(enabled, std::memory_order_relaxed);
+    _slowMessageNanoseconds.store(qint64(qMax(slowMessageMicroseconds, 0)) * 1000,
+                                  std::memory_order_relaxed);
+}
+
 void ThreadBase::slotTerminateThread()
 {
     if (ThreadRunMode::EventLoop == _threadRunMode && _eventLoop)
@@ -715,6 +1630,8 @@ void ThreadBase::slotTerminateChildThreads()
 
 void ThreadBase::slotWakeUpThread()
 {
+    LoopClock::update();
+
     if (threadRunMode() == ThreadRunMode::EventLoop)
     {
         msleep(0);
@@ -724,6 +1641,7 @@ void ThreadBase::slotWakeUpThread()
 
 void ThreadBase::slotTimerEventLoop()
 {
+    LoopClock::update();
     onAfterWaitEvents();
 }
 
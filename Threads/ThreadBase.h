@@ -1,7 +1,11 @@
 #pragma once
 
+#include "InboxLimiter.h"
+#include "LogRateLimiter.h"
 #include "MessageBase.h"
+#include "MessageDispatcher.h"
 #include "MessageLog.h"
+#include "MessagesOutbox.h"
 #include "PollerThread.h"
 
 #ifdef Q_OS_LINUX
@@ -14,16 +18,23 @@
 #endif
 
 #include "QueueMessages.h"
+#include "ThreadPlacement.h"
+#include "TimerWheel.h"
+#include "../Utils/Metrics.h"
 #include "../threader_global.h"
 
 #include <QDateTime>
 #include <QEventLoop>
 #include <QList>
+#include <QMutex>
 #include <QString>
 #include <QThread>
 #include <QTimer>
 #include <QVector>
 
+#include <atomic>
+#include <cstdarg>
+
 #ifdef Q_OS_LINUX
 #include <poll.h>
 #endif
@@ -36,6 +47,7 @@ namespace Threads
 
 
 class ThreadBase;
+class ThreadReactor;
 
 using ThreadsList = QList<ThreadBase*>;
 
@@ -63,7 +75,8 @@ public:
     enum class ThreadRunMode
     {
         Polling,    // на основе системных функций получения событий дексрипторов
-        EventLoop   // на основе QEventLoop
+        EventLoop,  // на основе QEventLoop
+        Spinning    // активное ожидание с переходом к голосованию с блокировкой
     };
 
     /**
@@ -119,12 +132,59 @@ public:
      */
     QDateTime startedUtc() const;
 
+    /**
+     * @brief wakeUpsIssued - Получение количества пробуждений потока системным вызовом
+     * @return - Количество пробуждений
+     */
+    quint64 wakeUpsIssued() const;
+
+    /**
+     * @brief wakeUpsSuppressed - Получение количества пробуждений, подавленных
+     * из-за уже ожидающего обработки сигнала
+     * @return - Количество подавленных пробуждений
+     */
+    quint64 wakeUpsSuppressed() const;
+
+    /**
+     * @brief outboxMessagesCount - Получение количества сообщений, отправленных группами
+     * по завершении проходов обработки
+     * @return - Количество сообщений
+     */
+    quint64 outboxMessagesCount() const;
+
+    /**
+     * @brief outboxBatchesCount - Получение количества групп сообщений, отправленных
+     * по завершении проходов обработки. Каждая группа требует одного пробуждения получателя
+     * @return - Количество групп
+     */
+    quint64 outboxBatchesCount() const;
+
+    /**
+     * @brief outboxRejectedCount - Получение количества сообщений буфера исходящих сообщений,
+     * не принятых получателями при его передаче
+     * @return - Количество сообщений
+     */
+    quint64 outboxRejectedCount() const;
+
     /**
      * @brief isTerminated - Получение признака завершения потока
      * @return - Признак завершения потока
      */
     bool isTerminated() const;
 
+    /**
+     * @brief isThreadFinished - Получение признака окончания выполнения потока. Для потока,
+     * обслуживаемого реактором, признак устанавливается реактором после финализации потока
+     * @return - Признак окончания выполнения потока
+     */
+    bool isThreadFinished() const;
+
+    /**
+     * @brief reactor - Получение потока-реактора, обслуживающего данный поток
+     * @return - Поток-реактор или NULL, если поток выполняется самостоятельно
+     */
+    ThreadReactor *reactor() const;
+
     /**
      * @brief polling - Получение указателя на объект голосования
      * @return указатель на объект голосования
@@ -145,9 +205,22 @@ public:
 
     /**
      * @brief postMessage - Оправка сообщения потоку
+     * Если отправитель находится в проходе обработки сообщений или событий,
+     * сообщение накапливается в его буфере исходящих сообщений и передается
+     * вместе с остальными сообщениями этому потоку по завершении прохода.
+     * Потоку с ограниченной очередью сообщение передается сразу
+     * @param message - Сообщения для потока
+     * @return - Результат отправки. Для накопленного сообщения - Accepted
+     */
+    PostMessageResult postMessage(const MessageBase::Ptr &message) override;
+
+    /**
+     * @brief postMessage - Оправка сообщения потоку с заданным приоритетом
      * @param message - Сообщения для потока
+     * @param priority - Приоритет, устанавливаемый сообщению
+     * @return - Результат отправки
      */
-    void postMessage(const MessageBase::Ptr &message) override;
+    PostMessageResult postMessage(const MessageBase::Ptr &message, MessagePriority priority);
 
     /**
      * @brief postMessages - Отправка потоку группы сообщений
@@ -155,6 +228,70 @@ public:
      */
     void postMessages(const MessagesList &messagesList) override;
 
+    /**
+     * @brief postMessageNow - Немедленная отправка сообщения потоку в обход буфера
+     * исходящих сообщений отправителя. Предназначена для сообщений, критичных к задержке
+     * @param message - Сообщения для потока
+     * @return - Результат отправки
+     */
+    PostMessageResult postMessageNow(const MessageBase::Ptr &message);
+
+    /**
+     * @brief isPostAccepted - Получение признака размещения сообщения в очереди
+     * @param result - Результат отправки
+     * @return - Признак размещения сообщения в очереди
+     */
+    static bool isPostAccepted(PostMessageResult result);
+
+    /**
+     * @brief inboxLimits - Получение ограничений входящей очереди потока
+     * @return - Ограничения входящей очереди
+     */
+    InboxLimits inboxLimits() const;
+
+    /**
+     * @brief setInboxLimits - Установка ограничений входящей очереди потока
+     * Ограничения распространяются на обычные и массовые сообщения
+     * и устанавливаются до начала обмена сообщениями
+     * @param limits - Ограничения входящей очереди
+     */
+    void setInboxLimits(const InboxLimits &limits);
+
+    /**
+     * @brief inboxStatistic - Получение статистики переполнения входящей очереди потока
+     * @return - Статистика входящей очереди
+     */
+    InboxStatistic inboxStatistic() const;
+
+    /**
+     * @brief maxMessagesPerPass - Получение ограничения количества сообщений,
+     * обрабатываемых за один проход
+     * @return - Количество сообщений, 0 - без ограничения
+     */
+    int maxMessagesPerPass() const;
+
+    /**
+     * @brief maxMicrosecondsPerPass - Получение ограничения длительности прохода обработки сообщений
+     * @return - Длительность в микросекундах, 0 - без ограничения
+     */
+    int maxMicrosecondsPerPass() const;
+
+    /**
+     * @brief setMessagesBudget - Установка бюджета прохода обработки сообщений
+     * После исчерпания бюджета поток обслуживает события голосования с нулевым
+     * таймаутом и продолжает обработку оставшихся сообщений
+     * @param maxMessages - Количество сообщений, 0 - без ограничения
+     * @param maxMicroseconds - Длительность в микросекундах, 0 - без ограничения
+     */
+    void setMessagesBudget(int maxMessages, int maxMicroseconds = 0);
+
+    /**
+     * @brief queueCount - Получение количества сообщений в очереди заданного приоритета
+     * @param priority - Приоритет сообщений
+     * @return - Количество сообщений
+     */
+    int queueCount(MessagePriority priority);
+
     /**
      * @brief postTerminateEvent - Отправка события завершения потока
      */
@@ -177,6 +314,75 @@ public:
      */
     void setTimeout(uint timeout);
 
+    /**
+     * @brief spinMicroseconds - Получение наибольшего окна активного ожидания
+     * @return - Длительность окна в микросекундах
+     */
+    uint spinMicroseconds() const;
+
+    /**
+     * @brief setSpinMicroseconds - Установка наибольшего окна активного ожидания
+     * В режиме Spinning поток в течение окна опрашивает сигналы и голосующих
+     * с нулевым таймаутом, а затем блокируется в голосовании. Окно сокращается
+     * вдвое после каждого ожидания без событий (до 1/16 наибольшего) и
+     * увеличивается, если событие пришло вскоре после блокировки. Активное
+     * ожидание занимает ядро целиком, поэтому поток следует закреплять за
+     * отдельным ядром
+     * @param spinMicroseconds - Длительность окна в микросекундах, 0 - без активного ожидания
+     */
+    void setSpinMicroseconds(uint spinMicroseconds);
+
+    /**
+     * @brief start - Запуск потока с размером стека из размещения потока
+     * @param priority - Приоритет потока Qt
+     */
+    void start(Priority priority = InheritPriority);
+
+    /**
+     * @brief placement - Получение размещения потока
+     * Явно установленное размещение имеет приоритет над настройками по имени потока
+     * @return - Размещение потока
+     */
+    ThreadPlacement placement() const;
+
+    /**
+     * @brief setPlacement - Явная установка размещения потока до его запуска
+     * @param placement - Размещение потока
+     */
+    void setPlacement(const ThreadPlacement &placement);
+
+    /**
+     * @brief effectivePlacement - Получение описания действующего размещения потока
+     * @return - Описание размещения, пустая строка, если размещение не применялось
+     */
+    QString effectivePlacement() const;
+
+    /**
+     * @brief applyPlacement - Применение размещения к запущенному потоку
+     * Вызывается при инициализации потока и может быть повторно вызвано из другого
+     * потока после чтения настроек. Потоки, обслуживаемые реактором, не размещаются
+     * @return - Признак успешного применения
+     */
+    bool applyPlacement();
+
+    /**
+     * @brief setPlacementSettings - Регистрация настроек размещения потоков по имени
+     * @param settings - Настройки размещения потоков
+     */
+    static void setPlacementSettings(const ThreadPlacementSettings::Ptr &settings);
+    static ThreadPlacementSettings::Ptr placementSettings();
+
+    /**
+     * @brief setMessageTiming - Настройка учета времени ожидания и обработки сообщений
+     * Для каждого потока и типа сообщения ведутся гистограммы времени от размещения
+     * в очереди до начала обработки и времени обработки по CycleClock. По умолчанию
+     * учет выключен, при сборке с THREADER_NO_MESSAGE_TIMING учет отсутствует
+     * @param enabled - Признак учета
+     * @param slowMessageMicroseconds - Время обработки, начиная с которого сообщение
+     * протоколируется как медленное, 0 - не протоколируется
+     */
+    static void setMessageTiming(bool enabled, int slowMessageMicroseconds);
+
     /**
      * @brief logThread - Получение зарегистрированного потока приема и обработки сообщений
      * протоколирования
@@ -198,6 +404,18 @@ public:
      */
     static void writeLog(const MessageLogTemplate messageTemplate, ...);
 
+    /**
+     * @brief writeLogAdmitted - Отправка сообщения протоколирования без проверки уровня
+     * и ограничения частоты, проверки выполняются макросом WRITE_LOG до вычисления аргументов
+     * @param message - Шаблон сообщения протоколирования
+     */
+    static void writeLogAdmitted(const MessageLogTemplate messageTemplate, ...);
+
+    /**
+     * @brief wakeUp - Пробуждение потока для обработки накопленных данных
+     */
+    void wakeUp();
+
     /**
      * @brief errorString - получение текстовой расшифровки номера ошибки
      * @param errorNo - номер ошибки
@@ -228,6 +446,15 @@ public:
      */
     MessageSubscribersVector messageSubscribers(const QString &messageName);
 
+    /**
+     * @brief publishMessage - отправка сообщения подписчикам, зарегистрированным на его имя
+     * Во время прохода обработки сообщения подписчикам с неограниченной очередью
+     * накапливаются в буфере исходящих сообщений
+     * @param message - сообщение
+     * @return количество подписчиков
+     */
+    int publishMessage(const MessageBase::Ptr &message);
+
     /**
      * @brief eventLoop - получение указателя на цикл обработки сообщений
      * @return
@@ -294,6 +521,24 @@ protected:
      */
     virtual bool accumulateStatistic();
 
+    /**
+     * @brief metricsLabels - Получение меток метрик потока
+     * @return - Метки в формате Prometheus
+     */
+    QString metricsLabels() const;
+
+    /**
+     * @brief createMetrics - Регистрация метрик потока, вызывается при запуске потока
+     * Наследник, регистрирующий собственные метрики, вызывает реализацию базового класса
+     */
+    virtual void createMetrics();
+
+    /**
+     * @brief releaseMetrics - Освобождение метрик потока, вызывается при остановке потока.
+     * Освобожденные метрики исключаются из снимков
+     */
+    virtual void releaseMetrics();
+
     /**
      * @brief threadName - Получение имени потока
      * @return - Имя потока
@@ -318,6 +563,21 @@ protected:
      */
     void setThreadRunMode(const ThreadRunMode &threadRunMode);
 
+    /**
+     * @brief pollingMethod - получение способа ожидания событий дескрипторов
+     * @return - способ ожидания событий дескрипторов
+     */
+    PollingMethod pollingMethod() const;
+
+    /**
+     * @brief setPollingMethod - установка способа ожидания событий дескрипторов
+     * (poll или epoll). Устанавливается до запуска потока, зарегистрированные
+     * голосующие переносятся автоматически
+     * @param pollingMethod - способ ожидания событий дескрипторов
+     * @return - признак успешной установки
+     */
+    bool setPollingMethod(const PollingMethod &pollingMethod);
+
     /***********************************************************************************************
     * ПОДСИСТЕМА УПРАВЛЕНИЯ ПОДЧИНЕННЫМИ ПОТОКАМИ
     ***********************************************************************************************/
@@ -342,6 +602,16 @@ protected:
      */
     ThreadBase *registerAndStartChildThread(ThreadBase *thread);
 
+    /**
+     * @brief registerAndAttachChildThread - Регистрация подчиненного потока и передача его
+     * на обслуживание потоку-реактору. Если реактор не может обслуживать поток,
+     * то поток запускается самостоятельно
+     * @param thread - Подчиненный поток
+     * @param reactor - Поток-реактор
+     * @return Зарегистрированный подчиненный поток
+     */
+    ThreadBase *registerAndAttachChildThread(ThreadBase *thread, ThreadReactor *reactor);
+
     /**
      * @brief terminateChildThread - Остановка подчиненного потока
      * @param thread - Подчиненный поток
@@ -382,6 +652,13 @@ protected:
      */
     int messagesLeftToProcess();
 
+    /**
+     * @brief hasPendingMessages - получение признака наличия сообщений, оставшихся
+     * необработанными после исчерпания бюджета прохода
+     * @return - Признак наличия оставшихся сообщений
+     */
+    bool hasPendingMessages() const;
+
     /**
      * @brief onProcessMessagesStarted - событие начала шага цикла обработки сообщений
      */
@@ -394,9 +671,30 @@ protected:
 
     /**
      * @brief processMessage - Виртуальный метод вызываемый при обработке сообщений для потока.
-     * Предназначен для перекрытия в дочерних потоках
+     * Предназначен для перекрытия в дочерних потоках. Базовая реализация вызывает
+     * обработчик, установленный методом on<T>() для типа сообщения
      */
-    virtual bool processMessage(const MessageBase::Ptr &);
+    virtual bool processMessage(const MessageBase::Ptr &message);
+
+    /**
+     * @brief on - Установка обработчика сообщений заданного класса
+     * Обработчик выбирается по идентификатору типа сообщения без сравнения имен
+     * @param handler - Функция, принимающая const std::shared_ptr<T> &
+     */
+    template<typename T, typename Function>
+    void on(Function handler)
+    {
+        _dispatcher.on<T>(handler);
+    }
+
+    /**
+     * @brief off - Удаление обработчика сообщений заданного класса
+     */
+    template<typename T>
+    void off()
+    {
+        _dispatcher.off<T>();
+    }
 
     /**
      * @brief processMessages - Обработка входящих сообщений из очереди
@@ -418,6 +716,13 @@ protected:
      */
     virtual void waitEvents(uint timeout);
 
+    /**
+     * @brief spinEvents - Активное ожидание событий с переходом к блокировке
+     * @param timeout - Таймаут ожидания событий в миллисекундах
+     * @return - Результат голосования
+     */
+    int spinEvents(uint timeout);
+
     /***********************************************************************************************
      * ПОДСИСТЕМА ПРОТОКОЛИРОВАНИЯ
     ************************************************************************************************/
@@ -448,32 +753,46 @@ protected:
     ************************************************************************************************/
 
     /**
-     * @brief startTimer - Запуск потока таймера
+     * @brief startTimer - Запуск таймера в колесе таймеров потока
+     * Таймер срабатывает в цикле потока и доставляет сообщение MessageTimer
+     * в собственную очередь потока. Имя таймера уникально: в отличие от прежних
+     * потоков-таймеров, повторный запуск с тем же именем не добавляет второй таймер,
+     * а перезапускает существующий с новыми задержкой и признаком множественного
+     * срабатывания, счетчик срабатываний при этом сбрасывается.
+     * Вызывается только из контекста потока
      * @param timerName - Имя сообщения таймера
      * @param delayMsecs - Задержка таймера в миллисекундах
      * @param multiShot - Признак множественного срабатывания таймера
-     * @return - Указатель на поток таймера
+     * @return - Признак запуска таймера
      */
-    virtual ThreadBase *startTimer(const QString &timerName,
-                                   const int &delayMsecs,
-                                   const bool multiShot);
+    virtual bool startTimer(const QString &timerName,
+                            const int &delayMsecs,
+                            const bool multiShot);
 
     /**
-     * @brief stopTimer - Остановка потока таймера
+     * @brief stopTimer - Остановка таймера
      * @param timerName - Имя сообщения таймера
-     * @return - Признак остановки потока
+     * @return - Признак остановки таймера
      */
     virtual bool stopTimer(const QString &timerName);
 
     /**
-     * @brief stopAllTimers - Остановка всех потоков таймеров
-     * @return - Количество остановленных потоков
+     * @brief stopAllTimers - Остановка всех таймеров потока
+     * @return - Количество остановленных таймеров
      */
     virtual int stopAllTimers();
 
+    /**
+     * @brief timersCount - Получение количества запущенных таймеров потока
+     * @return - Количество запущенных таймеров
+     */
+    int timersCount() const;
+
     virtual void onAfterWaitEvents();
 
 private:
+    friend class ThreadReactor;
+
     static const int WAIT_RESULT_TIMEOUT;
     static const int WAIT_RESULT_ERROR;
     static const int WAIT_RESULT_NOT_INITIALIZED;
@@ -481,11 +800,105 @@ private:
 
     static const int TIMEOUT_COLLECT_TERMINATED_THREADS_MILLISECONDS;
     static const int TIMEOUT_ACCUMULATE_STATISTIC_MILLISECONDS;
+    static const int TIMEOUT_UPDATE_METRICS_MILLISECONDS;
+
+    /**
+     * @brief ThreadMetrics - Встроенные метрики потока
+     */
+    struct ThreadMetrics
+    {
+        Utils::MetricCounter::Ptr MessagesProcessed;
+        Utils::MetricCounter::Ptr PollWakeUps;
+        Utils::MetricCounter::Ptr WaitMilliseconds;
+        Utils::MetricCounter::Ptr WakeUpsIssued;
+        Utils::MetricCounter::Ptr InboxDropped;
+        Utils::MetricGauge::Ptr QueueCount;
+    };
+
+    /**
+     * @brief MessageTiming - Гистограммы времени сообщений одного типа
+     */
+    struct MessageTiming
+    {
+        Utils::MetricHistogram::Ptr QueueDelay;
+        Utils::MetricHistogram::Ptr Processing;
+    };
+
+    /**
+     * @brief recordMessageTiming - Учет времени ожидания и обработки сообщения
+     * @param message - Обработанное сообщение
+     * @param dequeuedNanoseconds - Время начала обработки
+     * @param processedNanoseconds - Время окончания обработки
+     */
+    void recordMessageTiming(const MessageBase &message,
+                             qint64 dequeuedNanoseconds,
+                             qint64 processedNanoseconds);
+
+    /**
+     * @brief updateMetrics - Перенос накопленных потоком значений в метрики
+     * не чаще TIMEOUT_UPDATE_METRICS_MILLISECONDS
+     */
+    void updateMetrics();
+
+    /**
+     * @brief writeLogArguments - Запись сообщения протоколирования в двоичный журнал,
+     * при невозможности - форматирование и отправка потоку протоколирования
+     * @param messageTemplate - Шаблон сообщения протоколирования
+     * @param args - Аргументы шаблона
+     */
+    static void writeLogArguments(const MessageLogTemplate &messageTemplate, va_list args);
+
+    /**
+     * @brief BULK_STARVATION_LIMIT - Количество обычных сообщений подряд,
+     * после которого обрабатывается одно массовое сообщение
+     */
+    static const int BULK_STARVATION_LIMIT = 16;
+
+    /**
+     * @brief DEFAULT_SPIN_MICROSECONDS - Наибольшее окно активного ожидания по умолчанию
+     */
+    static const uint DEFAULT_SPIN_MICROSECONDS = 100;
+
+    /**
+     * @brief SPIN_BACKOFF_DIVIDER - Отношение наибольшего окна активного ожидания к наименьшему
+     */
+    static const uint SPIN_BACKOFF_DIVIDER = 16;
+
+    /**
+     * @brief enqueueMessage - Размещение сообщения в очереди с проверкой ограничений
+     * без пробуждения потока
+     * @param message - Сообщение
+     * @return - Результат отправки
+     */
+    PostMessageResult enqueueMessage(const MessageBase::Ptr &message);
+
+    /**
+     * @brief canBlockProducer - Получение признака допустимости ожидания текущего потока
+     * при переполнении очереди
+     * @return - Признак допустимости ожидания
+     */
+    bool canBlockProducer() const;
 
     /***********************************************************************************************
      * ВНУТРЕННЯЯ (PRIVATE) РЕАЛИЗАЦИЯ ПОДСИСТЕМЫ СОБЫТИЙ
     ************************************************************************************************/
 
+    /**
+     * @brief beginThreadCycle - Инициализация и запуск потока до основного цикла
+     */
+    void beginThreadCycle();
+
+    /**
+     * @brief finishThreadCycle - Остановка и финализация потока после основного цикла
+     */
+    void finishThreadCycle();
+
+    /**
+     * @brief signalHostedThread - Отправка события потоку, обслуживаемому реактором
+     * @param signal - Событие
+     */
+    void signalHostedThread(ThreadSignals signal);
+
     /**
      * @brief signalEventWakeUp - Отправка события пробуждения потока
      */
@@ -501,6 +914,32 @@ private:
      */
     void signalEventChildThreadTerminated();
 
+    /***********************************************************************************************
+     * ВНУТРЕННЯЯ (PRIVATE) РЕАЛИЗАЦИЯ ПОДСИСТЕМЫ ТАЙМЕРОВ
+    ************************************************************************************************/
+
+    /**
+     * @brief TimerEntry - Таймер потока, размещаемый в колесе таймеров
+     */
+    struct TimerEntry;
+
+    /**
+     * @brief processTimers - Обработка сработавших таймеров потока
+     */
+    void processTimers();
+
+    /**
+     * @brief timersWaitTimeout - Ограничение таймаута ожидания ближайшим таймером
+     * @param timeout - Таймаут ожидания событий в миллисекундах
+     * @return - Таймаут ожидания с учетом таймеров
+     */
+    uint timersWaitTimeout(uint timeout) const;
+
+    /**
+     * @brief restartTimerEventLoop - Перезапуск таймера цикла EventLoop по ближайшему событию
+     */
+    void restartTimerEventLoop();
+
     /***********************************************************************************************
      * ПОДСИСТЕМА ПРОТОКОЛИРОВАНИЯ
     ************************************************************************************************/
@@ -512,6 +951,39 @@ private:
 
     static int _logLevel;
 
+    /***********************************************************************************************
+     * РАЗМЕЩЕНИЕ ПОТОКА
+    ************************************************************************************************/
+
+    /**
+     * @brief _placementSettings - Настройки размещения потоков по имени
+     */
+    static ThreadPlacementSettings::Ptr _placementSettings;
+
+    /***********************************************************************************************
+     * УЧЕТ ВРЕМЕНИ СООБЩЕНИЙ
+    ************************************************************************************************/
+
+    static std::atomic<bool> _isMessageTimingEnabled;
+    static std::atomic<qint64> _slowMessageNanoseconds;
+
+    /**
+     * @brief _messageTimings - Гистограммы времени сообщений по идентификаторам типов
+     */
+    QVector<MessageTiming> _messageTimings;
+
+    /**
+     * @brief _placement - Явно установленное размещение потока
+     */
+    ThreadPlacement _placement;
+    bool _hasPlacement = false;
+
+    /**
+     * @brief _effectivePlacement - Описание действующего размещения потока
+     */
+    QString _effectivePlacement;
+    mutable QMutex _placementMutex;
+
     /***********************************************************************************************
      * ЛОКАЛЬНЫЕ ПЕРЕМЕННЫЕ ПОТОКА
     ************************************************************************************************/
@@ -542,14 +1014,19 @@ private:
     QDateTime _startedUtc;
 
     /**
-     * @brief _aliveChecked - Дата и время установки признака жизни потока
+     * @brief _aliveCheckedTickCount - Время установки признака жизни потока по монотонному счетчику
+     */
+    qint64 _aliveCheckedTickCount;
+
+    /**
+     * @brief _queues - Очереди входящих сообщений потока по приоритетам
      */
-    QDateTime _aliveCheckedUtc;
+    QueueMessages _queues[MESSAGE_PRIORITIES_COUNT];
 
     /**
-     * @brief _queue - Очередь входящих сообщений потока
+     * @brief _inbox - Учет и ограничение входящих сообщений
      */
-    QueueMessages _queue;
+    InboxLimiter _inbox;
 
     /**
      * @brief _isTerminated - Признак остановки потока
@@ -586,6 +1063,16 @@ private:
      */
     qint64 _nextAccumulateStatisticTickCount;
 
+    /**
+     * @brief _metrics - Встроенные метрики потока, создаются при запуске потока
+     */
+    ThreadMetrics _metrics;
+
+    /**
+     * @brief _nextUpdateMetricsTickCount - Следующее время переноса значений в метрики
+     */
+    qint64 _nextUpdateMetricsTickCount = 0;
+
     uint _timeout = WAIT_EVENTS_TIMEOUT;
 
     qint64 _nextCallIdle;
@@ -595,11 +1082,57 @@ private:
      */
     int _messagesLeftToProcess;
 
+    /**
+     * @brief _batches - Пакеты сообщений по приоритетам, извлеченные из очередей
+     * и не обработанные до исчерпания бюджета прохода
+     */
+    QueueMessages::Batch _batches[MESSAGE_PRIORITIES_COUNT];
+
+    /**
+     * @brief _normalStreak - Количество обычных сообщений, обработанных подряд
+     */
+    int _normalStreak = 0;
+
+    /**
+     * @brief _maxMessagesPerPass - Ограничение количества сообщений за проход
+     */
+    int _maxMessagesPerPass = 0;
+
+    /**
+     * @brief _maxMicrosecondsPerPass - Ограничение длительности прохода в микросекундах
+     */
+    int _maxMicrosecondsPerPass = 0;
+
+    /**
+     * @brief _messagesPasses - Количество проходов обработки сообщений
+     */
+    quint64 _messagesPasses = 0;
+
+    /**
+     * @brief _spinMicroseconds - Наибольшее окно активного ожидания в микросекундах
+     */
+    uint _spinMicroseconds = DEFAULT_SPIN_MICROSECONDS;
+
+    /**
+     * @brief _spinWindow - Текущее окно активного ожидания в микросекундах
+     */
+    uint _spinWindow = DEFAULT_SPIN_MICROSECONDS;
+
     /**
      * @brief _subscribers - хранилище подписчиков на события
      */
     QHash<QString, MessageSubscribersVector> _subscribers;
 
+    /**
+     * @brief _dispatcher - Таблица обработчиков сообщений по типам
+     */
+    MessageDispatcher _dispatcher;
+
+    /**
+     * @brief _outbox - Буфер исходящих сообщений прохода обработки
+     */
+    MessagesOutbox _outbox;
+
     /**
      * @brief _threadRunMode - режим ожидания событий потока
      */
@@ -615,6 +1148,31 @@ private:
      */
     QTimer *_timerEventLoop;
 
+    /**
+     * @brief _reactor - поток-реактор, обслуживающий поток
+     */
+    ThreadReactor *_reactor;
+
+    /**
+     * @brief _hostedSignals - флаги событий потока, обслуживаемого реактором
+     */
+    std::atomic<int> _hostedSignals;
+
+    /**
+     * @brief _hostedFinished - признак окончания выполнения потока, обслуживаемого реактором
+     */
+    std::atomic<bool> _hostedFinished;
+
+    /**
+     * @brief _timerWheel - Колесо таймеров потока
+     */
+    TimerWheel _timerWheel;
+
+    /**
+     * @brief _timers - Таймеры потока по именам сообщений
+     */
+    QHash<QString, TimerEntry*> _timers;
+
 signals:
     void signalTerminate();
     void signalWakeUp();
@@ -629,4 +1187,16 @@ protected slots:
 
 #define PRINT_THREAD_INFO  qInfo("Thread ID: %ld, Function: %s", threadId(), QString(Q_FUNC_INFO).toUtf8().constData());
 
+/**
+ * Макрос протоколирования с проверкой уровня и ограничения частоты до вычисления
+ * аргументов (STRLOG и т.п.)
+ * @param TEMPLATE - шаблон сообщения
+ */
+#define WRITE_LOG(TEMPLATE, ...)                                                                   \
+    do {                                                                                           \
+        if ((TEMPLATE).level <= Threader::Threads::ThreadBase::logLevel() &&                       \
+                Threader::Threads::LogRateLimiter::allow(TEMPLATE))                                \
+            Threader::Threads::ThreadBase::writeLogAdmitted(TEMPLATE, ##__VA_ARGS__);              \
+    } while (0)
+
 }}
@@ -3,7 +3,7 @@
 #include "HandlerBase.h"
 #include "HandlerTcpSocket.h"
 
-#include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 
 namespace Threader {
 
@@ -11,6 +11,18 @@ namespace Threads {
 
 using namespace Threader::Utils;
 
+// глубина распознавания повторно полученных пакетов
+static const qint64 DUPLICATES_DEPTH = 0x10000;
+// количество номеров пакетов до переполнения счетчика DataFramesPacketFactory
+static const qint64 PACKET_IDS_RANGE = 0x1FFFFFFE;
+
+// признак пакета, номер которого уже был принят, с учетом переполнения счетчика номеров
+static bool isPacketIdPassed(PacketIdType packetId, qint64 nextPacketId)
+{
+    qint64 distance = (nextPacketId - qint64(packetId) + PACKET_IDS_RANGE) % PACKET_IDS_RANGE;
+    return distance > 0 && distance <= DUPLICATES_DEPTH;
+}
+
 ThreadDataFrames::ThreadDataFrames(IMessageSubscriber *parent,
                                    const Descriptor &socket,
                                    const QString &host,
@@ -20,8 +32,10 @@ ThreadDataFrames::ThreadDataFrames(IMessageSubscriber *parent,
                     new HandlerTcpSocket(host, port, socket),
                     0,
                     new DataFramesPacketFactory())
-    , _currentPacket(nullptr)
     , _queuePackets(nullptr)
+    , _sendWindow(1)
+    , _sendSequence(0)
+    , _nextRetransmit(-1)
 {
     if (useQueue)
         _queuePackets = new QueueDataFramesPackets();
@@ -36,8 +50,10 @@ ThreadDataFrames::ThreadDataFrames(IMessageSubscriber *parent,
                     new HandlerTcpSocket(host, port),
                     reconnectTimeout,
                     new DataFramesPacketFactory())
-    , _currentPacket(nullptr)
     , _queuePackets(nullptr)
+    , _sendWindow(1)
+    , _sendSequence(0)
+    , _nextRetransmit(-1)
 {
     if (useQueue)
         _queuePackets = new QueueDataFramesPackets();
@@ -63,9 +79,52 @@ void ThreadDataFrames::setIsAuthorized(bool isAuthorized)
     _isAuthorized = isAuthorized;
 }
 
+int ThreadDataFrames::sendWindow() const
+{
+    return _sendWindow;
+}
+
+void ThreadDataFrames::setSendWindow(int sendWindow)
+{
+    _sendWindow = qMax(sendWindow, 1);
+}
+
+int ThreadDataFrames::inFlightCount() const
+{
+    return _inFlight.count();
+}
+
+const RttEstimator &ThreadDataFrames::rttEstimator() const
+{
+    return _rttEstimator;
+}
+
 void ThreadDataFrames::onConnected()
 {
     _nextPacketId = -1;
+    // время обхода нового соединения оценивается заново
+    _rttEstimator.reset();
+
+    // неподтвержденные пакеты отправляются повторно сразу после подключения в порядке отправки
+    if (!_inFlight.isEmpty())
+    {
+        auto nowTickCount = LoopClock::now();
+        for (auto inFlight = _inFlight.begin(); inFlight != _inFlight.end(); ++inFlight)
+        {
+            inFlight->Timeout = _rttEstimator.timeout();
+            inFlight->Deadline = nowTickCount;
+        }
+        _nextRetransmit = nowTickCount;
+    }
+}
+
+void ThreadDataFrames::onBeforeWaitEvents()
+{
+    ThreadHandler::onBeforeWaitEvents();
+
+    // повторная отправка пакетов с истекшим таймаутом
+    if (_nextRetransmit >= 0 && _nextRetransmit <= LoopClock::now())
+        processQueue();
 }
 
 bool ThreadDataFrames::onPacketReceived(const PacketBase::Ptr &packet)
@@ -77,6 +136,15 @@ bool ThreadDataFrames::onPacketReceived(const PacketBase::Ptr &packet)
     DataFramesPacketHeader header = dataFramesPacket->header();
     PacketIdType packetId = header.packetId;
 
+    // повторно отправленный пакет подтверждается, но не обрабатывается
+    if (PacketType::Ticket != header.packetType &&
+            _nextPacketId >= 0 && isPacketIdPassed(packetId, _nextPacketId))
+    {
+        auto packetTicket = _dataFramesPacketFactory->buildPacketTicket(packetId);
+        sendPacket(packetTicket);
+        return true;
+    }
+
     // проверка номера пакета
     if (_nextPacketId >= 0 && _nextPacketId != packetId)
     {
@@ -137,11 +205,25 @@ int ThreadDataFrames::applyTicket(PacketIdType packetId)
         return -1;
 
     auto result = _queuePackets->applyTicket(packetId);
+
+    auto sequence = _inFlightSequences.find(packetId);
+    if (sequence != _inFlightSequences.end())
+    {
+        auto inFlight = _inFlight.find(sequence.value());
+        if (inFlight != _inFlight.end())
+        {
+            // время обхода измеряется только по пакетам, отправленным однократно
+            if (!inFlight->Retransmitted)
+                _rttEstimator.addSample(LoopClock::now() - inFlight->SentAt);
+            _inFlight.erase(inFlight);
+        }
+        _inFlightSequences.erase(sequence);
+    }
+
     if (result > 0)
     {
         onPacketApplied(packetId);
 
-        _currentPacket = nullptr;
         processQueue();
     }
 
@@ -184,7 +266,9 @@ QueueDataFramesPackets *ThreadDataFrames::queuePackets() const
 
 void ThreadDataFrames::resetQueue()
 {
-    _currentPacket = nullptr;
+    _inFlight.clear();
+    _inFlightSequences.clear();
+    restartRetransmitTimer();
     if (_queuePackets)
         _queuePackets->reset();
 }
@@ -194,27 +278,69 @@ void ThreadDataFrames::processQueue()
     if (!_queuePackets)
         return;
 
-    auto nowTickCount = DateUtils::getTickCount();
-    // если текущий пакет определен
-    if (_currentPacket)
+    auto nowTickCount = LoopClock::now();
+
+    // повторная отправка пакетов, квитанции на которые не пришли за таймаут,
+    // в порядке первой отправки
+    for (auto inFlight = _inFlight.begin(); inFlight != _inFlight.end(); ++inFlight)
     {
-        // если пришло время отправлять пакет повторно
-        if (lastPacketSent() + 2000 < nowTickCount)
-            // отправка пакета
-            sendPacket(_currentPacket);
+        if (inFlight->Deadline > nowTickCount)
+            continue;
+
+        sendPacket(inFlight->Packet);
+        inFlight->Retransmitted = true;
+        inFlight->Timeout = _rttEstimator.backoff(inFlight->Timeout);
+        inFlight->Deadline = nowTickCount + inFlight->Timeout;
     }
-    else
+
+    // заполнение окна отправки пакетами из начала очереди
+    for (int i = 0; _inFlight.count() < _sendWindow && i < _queuePackets->count(); i++)
     {
-        // если текущий пакет не определен, то отправка из очереди по необходимости
-        _currentPacket = _queuePackets->first();
-        if (_currentPacket)
-        {
-            // установка номера пакета новому пакету из очереди
-            _currentPacket->setPacketId(_dataFramesPacketFactory->generateNextPacketId());
-            // отправка пакета
-            sendPacket(_currentPacket);
-        }
+        DataFramesPacket::Ptr packet = _queuePackets->at(i);
+
+        if (!packet)
+            continue;
+
+        // признак отправки - наличие пакета среди ожидающих квитанцию, а не номер:
+        // пакет, собранный с generateId, попадает в очередь уже с номером
+        auto sequence = _inFlightSequences.constFind(packet->packetId());
+        if (sequence != _inFlightSequences.constEnd() &&
+                _inFlight.value(sequence.value()).Packet == packet)
+            continue;
+
+        // установка номера пакета новому пакету из очереди
+        _queuePackets->setPacketId(i, _dataFramesPacketFactory->generateNextPacketId());
+        // отправка пакета
+        sendPacket(packet);
+
+        InFlightPacket inFlight;
+        inFlight.Packet = packet;
+        inFlight.SentAt = nowTickCount;
+        inFlight.Timeout = _rttEstimator.timeout();
+        inFlight.Deadline = nowTickCount + inFlight.Timeout;
+        inFlight.Retransmitted = false;
+        _inFlight.insert(_sendSequence, inFlight);
+        _inFlightSequences.insert(packet->packetId(), _sendSequence);
+        _sendSequence++;
     }
+
+    restartRetransmitTimer();
+}
+
+void ThreadDataFrames::restartRetransmitTimer()
+{
+    _nextRetransmit = -1;
+    foreach (const InFlightPacket &inFlight, _inFlight)
+        if (_nextRetransmit < 0 || inFlight.Deadline < _nextRetransmit)
+            _nextRetransmit = inFlight.Deadline;
+
+    // таймер только пробуждает поток, повторная отправка выполняется в onBeforeWaitEvents
+    if (_nextRetransmit < 0)
+        stopTimer(TIMER_NAME_RETRANSMIT);
+    else
+        startTimer(TIMER_NAME_RETRANSMIT,
+                   int(qMax(_nextRetransmit - LoopClock::now(), qint64(0))),
+                   false);
 }
 
 }}
@@ -4,6 +4,7 @@
 
 #include "../Frames/DataFramesPackets.h"
 #include "../Frames/DataFramesFactory.h"
+#include "../Utils/RttEstimator.h"
 
 #include "../threader_global.h"
 
@@ -17,6 +18,7 @@ namespace Threads {
 
 
 const QString ALIAS_UNDEFINED = "Undefined";
+const QString TIMER_NAME_RETRANSMIT = "DataFramesRetransmit";
 
 class THREADERSHARED_EXPORT ThreadDataFrames : public ThreadHandler
 {
@@ -50,8 +52,36 @@ public:
     bool isAuthorized() const;
     void setIsAuthorized(bool isAuthorized);
 
+    /**
+     * @brief sendWindow - Получение окна отправки
+     * @return - Максимальное количество отправленных и не подтвержденных пакетов
+     */
+    int sendWindow() const;
+
+    /**
+     * @brief setSendWindow - Установка окна отправки
+     * Окно из одного пакета соответствует поочередной отправке с ожиданием квитанции.
+     * Принимающая сторона подтверждает каждый пакет отдельной квитанцией, поэтому
+     * окно больше одного совместимо с узлами, отправляющими пакеты поочередно
+     * @param sendWindow - Максимальное количество отправленных и не подтвержденных пакетов
+     */
+    void setSendWindow(int sendWindow);
+
+    /**
+     * @brief inFlightCount - Получение количества отправленных и не подтвержденных пакетов
+     * @return - Количество пакетов
+     */
+    int inFlightCount() const;
+
+    /**
+     * @brief rttEstimator - Получение оценки времени обхода и таймаута повторной отправки
+     * @return - Оценка времени обхода
+     */
+    const RttEstimator &rttEstimator() const;
+
 protected:
     void onConnected() override;
+    void onBeforeWaitEvents() override;
 
     bool onPacketReceived(const PacketBase::Ptr &packet) override;
     bool onPacketSent(const PacketBase::Ptr &) override;
@@ -75,12 +105,43 @@ protected:
     void resetQueue();
     void processQueue();
 private:
+    /**
+     * @brief InFlightPacket - Отправленный и не подтвержденный пакет
+     */
+    struct InFlightPacket
+    {
+        DataFramesPacket::Ptr Packet;
+        qint64 SentAt;
+        qint64 Timeout;
+        qint64 Deadline;
+        bool Retransmitted;
+    };
+
+    /**
+     * @brief restartRetransmitTimer - Перезапуск таймера по ближайшему сроку повторной отправки
+     */
+    void restartRetransmitTimer();
+
     bool _isAuthorized = false;    
     qint64 _nextPacketId;
 
-    DataFramesPacket::Ptr _currentPacket;
     DataFramesPacketFactory *_dataFramesPacketFactory;
     QueueDataFramesPackets *_queuePackets;
+
+    int _sendWindow;
+    /**
+     * @brief _inFlight - Пакеты, ожидающие квитанцию, в порядке первой отправки
+     * Повторная отправка выполняется в том же порядке: получатель подтверждает
+     * и отбрасывает пакет с номером меньше уже принятого
+     */
+    QMap<qint64, InFlightPacket> _inFlight;
+    /**
+     * @brief _inFlightSequences - Порядковые номера отправки ожидающих квитанцию пакетов
+     */
+    QHash<PacketIdType, qint64> _inFlightSequences;
+    qint64 _sendSequence;
+    qint64 _nextRetransmit;
+    RttEstimator _rttEstimator;
 };
 
 }}
@@ -3,7 +3,9 @@
 #include "MessageBinary.h"
 
 #include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 #include "../Utils/DataStream.h"
+#include "../Utils/SlabAllocator.h"
 
 namespace Threader {
 
@@ -116,8 +118,10 @@ void ThreadHandler::onBeforeWaitEvents()
 
     // проверка необходимости открытия устройства
     if (_reconnectTimeout > 0 && _handler->connectionState() == HandlerBase::ConnectionState::Disconnected
-            && _nextTryToConnect <= DateUtils::getTickCount())
+            && _nextTryToConnect <= LoopClock::now())
     {
+        if (_handlerMetrics.Reconnects)
+            _handlerMetrics.Reconnects->increment();
         _handler->open();
     }
 
@@ -137,7 +141,9 @@ bool ThreadHandler::sendPacket(const PacketBase::Ptr &packet)
     bool result = packet->write(*outputStream());
     slotOnReadyToWrite(handler());
 
-    _lastPacketSent = DateUtils::getTickCount();
+    _lastPacketSent = LoopClock::now();
+    if (result && _handlerMetrics.PacketsSent)
+        _handlerMetrics.PacketsSent->increment();
     onPacketSent(packet);
     return result;
 }
@@ -162,6 +168,32 @@ TrafficCounter *ThreadHandler::outputTrafficCounter()
     return &_outputTrafficCounter;
 }
 
+void ThreadHandler::createMetrics()
+{
+    ThreadBase::createMetrics();
+
+    QString labels = metricsLabels() + "," +
+            Metrics::label("handler", _handler ? _handler->metaObject()->className() : "");
+    _handlerMetrics.BytesReceived = Metrics::counter("threader_handler_received_bytes_total",
+                                                     "Bytes read from the device", labels);
+    _handlerMetrics.BytesSent = Metrics::counter("threader_handler_sent_bytes_total",
+                                                 "Bytes written to the device", labels);
+    _handlerMetrics.PacketsReceived = Metrics::counter("threader_handler_received_packets_total",
+                                                       "Packets extracted from the device data", labels);
+    _handlerMetrics.PacketsSent = Metrics::counter("threader_handler_sent_packets_total",
+                                                   "Packets written to the device", labels);
+    _handlerMetrics.ChecksumErrors = Metrics::counter("threader_handler_checksum_errors_total",
+                                                      "Packets rejected by checksum", labels);
+    _handlerMetrics.Reconnects = Metrics::counter("threader_handler_reconnects_total",
+                                                  "Attempts to reopen the disconnected device", labels);
+}
+
+void ThreadHandler::releaseMetrics()
+{
+    _handlerMetrics = HandlerMetrics();
+    ThreadBase::releaseMetrics();
+}
+
 void ThreadHandler::slotOnConnectionStateChanged(HandlerBase *sender,
                                                  HandlerBase::ConnectionState oldState,
                                                  HandlerBase::ConnectionState newState)
@@ -173,7 +205,7 @@ void ThreadHandler::slotOnConnectionStateChanged(HandlerBase *sender,
         onConnecting();
         break;
     case HandlerBase::ConnectionState::Connected:
-        _lastPacketSent = DateUtils::getTickCount();
+        _lastPacketSent = LoopClock::now();
         _lastPacketReceived = _lastPacketSent;
 
         _inputTrafficCounter.clear();
@@ -183,7 +215,7 @@ void ThreadHandler::slotOnConnectionStateChanged(HandlerBase *sender,
         break;
     case HandlerBase::ConnectionState::Disconnected:
         onDisconnected();
-        _nextTryToConnect = DateUtils::getNextTickCount(_reconnectTimeout);
+        _nextTryToConnect = LoopClock::now() + _reconnectTimeout;
         break;
     }
     Q_UNUSED(sender)
@@ -200,43 +232,45 @@ void ThreadHandler::slotOnReadyToRead(HandlerBase *sender)
     int readCount;
     uint totalReadCount = 0;
 
-    QByteArray localInputBuffer;
-    localInputBuffer.reserve(1024 * 1024);
+    // начало данных, прочитанных в этом цикле чтения
+    const int inputBufferStart = _inputBuffer.size();
 
     do
     {
-        // иницализация шага цикла чтения
-        memset(buffer, 0, sizeof(buffer));
-
-        // чтение данных
-        readCount = sender->read(buffer, sizeof(buffer));
-
-        if (readCount > 0) {
-            // если обмен данными происходит фиксированными порциями как в UDP
-            if (_portionedIO)
+        // если обмен данными происходит фиксированными порциями как в UDP
+        if (_portionedIO)
+        {
+            readCount = sender->read(buffer, sizeof(buffer));
+            if (readCount > 0)
             {
+                totalReadCount += uint(readCount);
                 onReadData(buffer, readCount);
             }
-            else
-            {
-                // сохранение прочитанных данных при успешном чтении
-                localInputBuffer.append(buffer, readCount);
+        }
+        else
+        {
+            // чтение непосредственно в конец входящего буфера без промежуточных копий
+            int bufferSize = _inputBuffer.size();
+            _inputBuffer.resize(bufferSize + int(sizeof(buffer)));
+            readCount = sender->read(_inputBuffer.data() + bufferSize, sizeof(buffer));
+            _inputBuffer.resize(bufferSize + qMax(readCount, 0));
+
+            if (readCount > 0)
                 totalReadCount += uint(readCount);
-            }
         }
     } while (readCount > 0);
 
     // подсчет трафика
-    _inputTrafficCounter.append(QDateTime::currentDateTime(), totalReadCount);
+    _inputTrafficCounter.append(LoopClock::currentMSecsSinceEpoch(), totalReadCount);
+    if (_handlerMetrics.BytesReceived)
+        _handlerMetrics.BytesReceived->increment(totalReadCount);
 
     // если обмен данными не происходит фиксированными порциями как в UDP
     if (!_portionedIO)
     {
-        // добавление во входящий буфер
-        _inputBuffer.append(localInputBuffer);
-
         // вызов заглушки события приема данных
-        onReadData(localInputBuffer.constData(), localInputBuffer.size());
+        onReadData(_inputBuffer.constData() + inputBufferStart,
+                   _inputBuffer.size() - inputBufferStart);
 
         // если фабрика пакетов не определена
         if (!_packetFactory)
@@ -245,7 +279,7 @@ void ThreadHandler::slotOnReadyToRead(HandlerBase *sender)
             {
                 // создание сообщения с бинарными данными
                 MessageBase::Ptr message(
-                            std::make_shared<MessageBinary>(
+                            Utils::makeSlabShared<MessageBinary>(
                                 MESSAGE_NAME_DEVICE_DATA_INPUT,
                                 _inputBuffer.data(),
                                 _inputBuffer.size()));
@@ -257,24 +291,41 @@ void ThreadHandler::slotOnReadyToRead(HandlerBase *sender)
         else
         {
             // попытка распознавания пакетов с данными, пока они распознаются
+            // пакеты извлекаются по позиции чтения, а буфер сжимается один раз после разбора
+            int position = 0;
             while(true)
             {
-                PacketBase::Ptr packet = _packetFactory->tryExtractPacket(_inputBuffer);
+                int previousPosition = position;
+                PacketBase::Ptr packet = _packetFactory->tryExtractPacket(_inputBuffer, position);
                 // если пакет распознан
                 if (packet)
                 {
-                    _lastPacketReceived = DateUtils::getTickCount();
+                    _lastPacketReceived = LoopClock::now();
+                    if (_handlerMetrics.PacketsReceived)
+                        _handlerMetrics.PacketsReceived->increment();
                     onPacketReceived(packet);
                 }
                 else
                 {
+                    // разбор продолжается, если фабрика пропустила ошибочные данные
+                    if (position != previousPosition && position < _inputBuffer.size())
+                        continue;
+
+                    if (_handlerMetrics.ChecksumErrors)
+                        _handlerMetrics.ChecksumErrors->set(_packetFactory->checksumErrorsCount());
+
+                    // результат разбора сообщается один раз за чтение по итоговому результату
                     int result = _packetFactory->lastResult();
                     QByteArray code(1, char(result & 0xFF));
-                    auto message(std::make_shared<MessageBinary>(MESSAGE_NAME_DEVICE_ERROR, code));
+                    auto message(Utils::makeSlabShared<MessageBinary>(MESSAGE_NAME_DEVICE_ERROR, code));
                     postMessage(message);
                     break;
                 }
             }
+
+            // удаление прочитанных данных
+            if (position > 0)
+                _inputBuffer.remove(0, position);
         }
     }
 }
@@ -291,7 +342,9 @@ void ThreadHandler::slotOnReadyToWrite(HandlerBase *sender)
     // если хоть что-то ушло в устройство
     if (written > 0) {
         // подсчет отправленных данных
-        _outputTrafficCounter.append(QDateTime::currentDateTime(), static_cast<uint>(written));
+        _outputTrafficCounter.append(LoopClock::currentMSecsSinceEpoch(), static_cast<uint>(written));
+        if (_handlerMetrics.BytesSent)
+            _handlerMetrics.BytesSent->increment(quint64(written));
         // вызов заглушки протоколирования отправки
         onWriteData(_outputBuffer.constData(), written);
 
@@ -71,7 +71,23 @@ protected:
     TrafficCounter *inputTrafficCounter();
     TrafficCounter *outputTrafficCounter();
 
+    void createMetrics() override;
+    void releaseMetrics() override;
+
 private:
+    /**
+     * @brief HandlerMetrics - Метрики обмена с устройством
+     */
+    struct HandlerMetrics
+    {
+        MetricCounter::Ptr BytesReceived;
+        MetricCounter::Ptr BytesSent;
+        MetricCounter::Ptr PacketsReceived;
+        MetricCounter::Ptr PacketsSent;
+        MetricCounter::Ptr ChecksumErrors;
+        MetricCounter::Ptr Reconnects;
+    };
+
     HandlerBase *_handler;
     uint _reconnectTimeout;
     qint64 _nextTryToConnect;
@@ -93,6 +109,8 @@ private:
 
     bool _portionedIO;
 
+    HandlerMetrics _handlerMetrics;
+
 private slots:
     void slotOnConnectionStateChanged(HandlerBase *sender,
                                     HandlerBase::ConnectionState oldState,
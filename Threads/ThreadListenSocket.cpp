@@ -1,6 +1,7 @@
 #include "ThreadListenSocket.h"
 
 #include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 #include "../Utils/SocketUtils.h"
 
 namespace Threader {
@@ -12,6 +13,7 @@ using namespace Threader::Utils;
 
 
 const uint ThreadListenSocket::TIMEOUT_REOPEN_LISTEN_SOCKET_MILLISECONDS = 30000;
+const int ThreadListenSocket::REACTORS_COUNT_AUTO = -1;
 
 
 ThreadListenSocket::ThreadListenSocket(uint16_t port,
@@ -20,6 +22,7 @@ ThreadListenSocket::ThreadListenSocket(uint16_t port,
     , _port(port)
     , _listener(new PollerListenSocket(port))
     , _nextStartListening(DateUtils::getTickCount())
+    , _reactorsCount(0)
 {
     _listener->moveToThread(this);
     connect(_listener, &PollerListenSocket::signalOnListenSocketError,
@@ -41,7 +44,7 @@ uint16_t ThreadListenSocket::port() const
 void ThreadListenSocket::onBeforeWaitEvents()
 {
     // проверка необходимости инициализации слушающего сокета
-    if (_listener->isInitialized() || _nextStartListening > DateUtils::getTickCount())
+    if (_listener->isInitialized() || _nextStartListening > LoopClock::now())
         return;
 
     // вызов заглушки перед стартом инициализации
@@ -58,16 +61,61 @@ void ThreadListenSocket::onBeforeWaitEvents()
     else
     {
         // формирование времени следующего срабатывания ининциализации
-        _nextStartListening = DateUtils::getNextTickCount(TIMEOUT_REOPEN_LISTEN_SOCKET_MILLISECONDS);
+        _nextStartListening = LoopClock::now() + TIMEOUT_REOPEN_LISTEN_SOCKET_MILLISECONDS;
         // обработчик ошибок вызывается голосующим
     }
 
 }
 
+void ThreadListenSocket::startChildThreads()
+{
+    ThreadBase::startChildThreads();
+
+    // потоки-реакторы запускаются первыми, поэтому останавливаются после потоков подключений
+    for (int i = 0; i < _reactorsCount; i++)
+    {
+        auto reactor = new ThreadReactor(this, QString("%1.Reactor.%2").arg(threadName()).arg(i + 1));
+        registerAndStartChildThread(reactor);
+        _reactors.append(reactor);
+    }
+}
+
 void ThreadListenSocket::terminateChildThreads()
 {
     _listener->finalize();
     ThreadBase::terminateChildThreads();
+    _reactors.clear();
+}
+
+int ThreadListenSocket::reactorsCount() const
+{
+    return _reactorsCount;
+}
+
+void ThreadListenSocket::setReactorsCount(const int reactorsCount)
+{
+    if (isRunning())
+        return;
+
+    _reactorsCount = (reactorsCount < 0)
+            ? qMax(1, QThread::idealThreadCount())
+            : reactorsCount;
+}
+
+ThreadBase *ThreadListenSocket::registerAndStartConnectionThread(ThreadBase *thread)
+{
+    // выбор наименее загруженного реактора
+    ThreadReactor *reactor = nullptr;
+    for (auto item : _reactors)
+    {
+        if (!reactor || item->threadsCount() < reactor->threadsCount())
+            reactor = item;
+    }
+
+    if (reactor)
+        return registerAndAttachChildThread(thread, reactor);
+
+    return registerAndStartChildThread(thread);
 }
 
 void ThreadListenSocket::slotOnListenSocketError(PollerListenSocket *sender,
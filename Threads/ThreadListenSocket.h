@@ -2,6 +2,7 @@
 
 #include "PollerListenSocket.h"
 #include "ThreadBase.h"
+#include "ThreadReactor.h"
 
 #include "../threader_global.h"
 
@@ -15,6 +16,11 @@ class THREADERSHARED_EXPORT ThreadListenSocket : public ThreadBase
 {
     Q_OBJECT
 public:
+    /**
+     * @brief REACTORS_COUNT_AUTO - количество реакторов по количеству ядер процессора
+     */
+    static const int REACTORS_COUNT_AUTO;
+
     explicit ThreadListenSocket(uint16_t port,
                                 IMessageSubscriber *parent = nullptr);
     ~ThreadListenSocket() override;
@@ -22,8 +28,31 @@ public:
 
 protected:
     void onBeforeWaitEvents() override;
+    void startChildThreads() override;
     void terminateChildThreads() override;
 
+    /**
+     * @brief reactorsCount - Получение количества потоков-реакторов обслуживания подключений
+     * @return - Количество потоков-реакторов
+     */
+    int reactorsCount() const;
+
+    /**
+     * @brief setReactorsCount - Установка количества потоков-реакторов, обслуживающих
+     * подключения. Вызывается до запуска потока.
+     * При значении 0 каждое подключение обслуживается собственным потоком
+     * @param reactorsCount - Количество потоков-реакторов
+     */
+    void setReactorsCount(const int reactorsCount = REACTORS_COUNT_AUTO);
+
+    /**
+     * @brief registerAndStartConnectionThread - Регистрация и запуск потока подключения.
+     * При включенных реакторах поток передается наименее загруженному реактору
+     * @param thread - Поток подключения
+     * @return - Зарегистрированный поток
+     */
+    ThreadBase *registerAndStartConnectionThread(ThreadBase *thread);
+
     virtual void onBeforeListenSocketInitialization() = 0;
     virtual void onListenSocketInitialized() = 0;
     virtual void onAcceptConnectionRequest(Descriptor socket,
@@ -36,6 +65,8 @@ private:
     uint16_t _port;
     PollerListenSocket *_listener;
     qint64 _nextStartListening;
+    int _reactorsCount;
+    QList<ThreadReactor*> _reactors;
 
     static const uint TIMEOUT_REOPEN_LISTEN_SOCKET_MILLISECONDS;
 
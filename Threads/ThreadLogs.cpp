@@ -1,8 +1,11 @@
 #include "ThreadLogs.h"
 
 #include "LogMessagesTemplates.h"
+#include "MessageTypes.h"
 
 #include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
+#include "../Utils/SlabAllocator.h"
 
 #include <QDir>
 
@@ -17,12 +20,16 @@ using namespace Threader::Utils;
 class MessageLogLevel : public MessageBase
 {
 public:
+    static const int TYPE_ID;
+
     static const QString MESSAGE_NAME;
 
     explicit MessageLogLevel(const int &level)
         : MessageBase(MESSAGE_NAME)
         , _level(level)
     {
+        setTypeId(TYPE_ID);
+        setPriority(MessagePriority::Control);
     }
 
     int level() const
@@ -34,13 +41,45 @@ private:
     int _level;
 };
 
+const int MessageLogLevel::TYPE_ID = MessageTypes::registerType("MessageLogLevel");
+
 const QString MessageLogLevel::MESSAGE_NAME = "Message.Log.Level";
 
 
+class MessageLogSettings : public MessageBase
+{
+public:
+    static const int TYPE_ID;
+
+    static const QString MESSAGE_NAME;
+
+    explicit MessageLogSettings(const LogSettings::Ptr &settings)
+        : MessageBase(MESSAGE_NAME)
+        , _settings(settings)
+    {
+        setTypeId(TYPE_ID);
+        setPriority(MessagePriority::Control);
+    }
+
+    LogSettings::Ptr settings() const
+    {
+        return _settings;
+    }
+
+private:
+    LogSettings::Ptr _settings;
+};
+
+const int MessageLogSettings::TYPE_ID = MessageTypes::registerType("MessageLogSettings");
+
+const QString MessageLogSettings::MESSAGE_NAME = "Message.Log.Settings";
+
+
 #define THREAD_NAME_LOG "Thread.Log"
 #define PATH_TO_LOG "Log"
-#define LOG_BUFFER_MAXIMIUM_SIZE (1024 * 32)
+#define LOG_BUFFER_MAXIMIUM_SIZE (1024 * 256)
 #define TIMEOUT_BUFFER_FLUSH_MILLISECONDS 1000
+#define TIMEOUT_RATE_LIMIT_SUMMARY_MILLISECONDS 10000
 
 
 ThreadLogs::ThreadLogs(bool doConsoleOutput,
@@ -48,11 +87,44 @@ ThreadLogs::ThreadLogs(bool doConsoleOutput,
     : ThreadBase(nullptr, THREAD_NAME_LOG)
     , WriterLog(doConsoleOutput, "./Log/", 9)
     , _nextWriteFileTickCount(DateUtils::getNextTickCount(TIMEOUT_BUFFER_FLUSH_MILLISECONDS))
+    , _rateLimitSummaryMilliseconds(TIMEOUT_RATE_LIMIT_SUMMARY_MILLISECONDS)
+    , _nextRateLimitSummaryTickCount(DateUtils::getNextTickCount(TIMEOUT_RATE_LIMIT_SUMMARY_MILLISECONDS))
     , _subscriber(subscriber)
 {
     // регистрация в качестве обработчика сообщений протоколирования
     setLogThread(this, getLevel());
     setTimeout(1000);
+
+    on<MessageLog>([this](const MessageLog::Ptr &messageLog)
+    {
+        // записи двоичного журнала сделаны раньше, чем отправлено сообщение
+        drainBinaryLog();
+        doMessageLog(messageLog);
+        if (_subscriber && getLevel() >= messageLog->level())
+            _subscriber->postMessage(messageLog);
+    });
+
+    on<MessageWriteToFile>([this](const MessageWriteToFile::Ptr &message)
+    {
+        doMessageRewriteFile(message);
+    });
+
+    on<MessageLogLevel>([this](const std::shared_ptr<MessageLogLevel> &message)
+    {
+        setLevel(message->level());
+    });
+
+    on<MessageLogSettings>([this](const std::shared_ptr<MessageLogSettings> &message)
+    {
+        if (!message->settings())
+            return;
+
+        applyLogSettings(*message->settings());
+
+        // ограничения частоты применяются потоками-источниками сразу после замены правил
+        LogRateLimiter::setLimits(message->settings()->rateLimits());
+        _rateLimitSummaryMilliseconds = qint64(qMax(message->settings()->rateLimitSummarySeconds(), 1)) * 1000;
+    });
 }
 
 void ThreadLogs::flush()
@@ -67,56 +139,65 @@ void ThreadLogs::setLogLevel(const int &level)
         logThread->postMessage(std::make_shared<MessageLogLevel>(level));
 }
 
+void ThreadLogs::setLogSettings(const LogSettings::Ptr &settings)
+{
+    auto *logThread = dynamic_cast<ThreadLogs*>(ThreadBase::logThread());
+    if (logThread)
+        logThread->postMessage(std::make_shared<MessageLogSettings>(settings));
+}
+
 void ThreadLogs::onThreadStarted()
 {
-    doMessageLog(std::make_shared<MessageLog>(Message0));
+    doMessageLog(Utils::makeSlabShared<MessageLog>(Message0));
+
+    // прием сообщений двоичного журнала с отложенным форматированием
+    BinaryLog::setConsumer(this);
 }
 
 void ThreadLogs::onThreadFinishing()
 {
-    doMessageLog(std::make_shared<MessageLog>(Message1));
+    doMessageLog(Utils::makeSlabShared<MessageLog>(Message1));
 }
 
 void ThreadLogs::onThreadFinished()
 {
-    doMessageLog(std::make_shared<MessageLog>(Message2));
+    // после отключения журнала сообщения отправляются обычным путем,
+    // повторное извлечение забирает записи, сделанные во время отключения
+    drainBinaryLog();
+    BinaryLog::setConsumer(nullptr);
+    drainBinaryLog();
+    logSuppressedSummary(true);
+
+    doMessageLog(Utils::makeSlabShared<MessageLog>(Message2));
 
     // сброс накопленных данных на диск
     logFlushBuffer();
 
-    // освобождение файла
-    _currentLogFile.close();
+    // запись оставшихся данных потоком записи и освобождение файлов
+    logClose();
 }
 
 void ThreadLogs::onIdle()
 {
+    drainBinaryLog();
+    logSuppressedSummary(false);
+    logCheckAndFlushBuffer();
+}
+
+void ThreadLogs::onProcessMessagesFinished()
+{
+    drainBinaryLog();
+    logSuppressedSummary(false);
     logCheckAndFlushBuffer();
 }
 
 bool ThreadLogs::processMessage(const MessageBase::Ptr &message)
 {
-    QString messageName = message->name();
-    if (MessageLog::MESSAGE_NAME == messageName)
-    {
-        auto messageLog = std::dynamic_pointer_cast<MessageLog>(message);
-        if (messageLog)
-        {
-            doMessageLog(messageLog);
-            if (_subscriber && getLevel() >= messageLog->level())
-                _subscriber->postMessage(messageLog);
-        }
-    }
-    else if (MessageWriteToFile::MESSAGE_NAME_WRITE_TO_FILE == messageName)
-    {
-        doMessageRewriteFile(std::dynamic_pointer_cast<MessageWriteToFile>(message));
-    }
-    else if (MessageLogLevel::MESSAGE_NAME == messageName)
-    {
-        auto messageLogLevel = std::dynamic_pointer_cast<MessageLogLevel>(message);
-        if (messageLogLevel)
-            setLevel(messageLogLevel->level());
-    }
+    // сообщения протоколирования, записи в файл и смены уровня обрабатываются по типу
+    ThreadBase::processMessage(message);
 
+    // под непрерывным потоком сообщений onIdle не вызывается
+    logSuppressedSummary(false);
     logCheckAndFlushBuffer();
 
     return true;
@@ -126,7 +207,43 @@ void ThreadLogs::logFlushBuffer()
 {
     WriterLog::logFlushBuffer();
     // вычисление следующего времени сброса накопленных данных
-    _nextWriteFileTickCount = DateUtils::getNextTickCount(TIMEOUT_BUFFER_FLUSH_MILLISECONDS);
+    _nextWriteFileTickCount = LoopClock::now() + TIMEOUT_BUFFER_FLUSH_MILLISECONDS;
+}
+
+void ThreadLogs::drainBinaryLog()
+{
+    BinaryLog::drain([this](const BinaryLogRecord &record)
+    {
+        doBinaryLogRecord(record);
+    });
+}
+
+void ThreadLogs::doBinaryLogRecord(const BinaryLogRecord &record)
+{
+    doLogLine(record.Created, record.Type, record.Number, record.Level, record.Text);
+
+    if (_subscriber && getLevel() >= record.Level)
+    {
+        auto messageLog = Utils::makeSlabShared<MessageLog>(record.Text, record.Number,
+                                                            record.Level, record.Type);
+        _subscriber->postMessage(messageLog);
+    }
+}
+
+void ThreadLogs::logSuppressedSummary(bool rightNow)
+{
+    if (!rightNow && LoopClock::now() < _nextRateLimitSummaryTickCount)
+        return;
+
+    _nextRateLimitSummaryTickCount = LoopClock::now() + _rateLimitSummaryMilliseconds;
+
+    // строка сводки имеет номер, уровень и тип подавленного шаблона
+    QDateTime now = QDateTime::currentDateTime();
+    for (const LogSuppressedCount &suppressed : LogRateLimiter::takeSuppressed())
+    {
+        doLogLine(now, suppressed.Type, suppressed.Number, suppressed.Level,
+                  QString("Подавлено сообщений: %1").arg(suppressed.Count));
+    }
 }
 
 void ThreadLogs::logCheckAndFlushBuffer()
@@ -134,7 +251,8 @@ void ThreadLogs::logCheckAndFlushBuffer()
     if (_logBuffer.isEmpty())
         return;
 
-    if (DateUtils::getTickCount() < _nextWriteFileTickCount)
+    // буфер передается потоку записи по времени или по достижении размера
+    if (LoopClock::now() < _nextWriteFileTickCount && _logBuffer.size() < LOG_BUFFER_MAXIMIUM_SIZE)
         return;
 
     logFlushBuffer();
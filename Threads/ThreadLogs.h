@@ -6,6 +6,7 @@
 
 #include "MessageWriteToFile.h"
 
+#include "BinaryLog.h"
 #include "MessageBase.h"
 #include "MessageLog.h"
 #include "ThreadBase.h"
@@ -34,18 +35,39 @@ public:
 
     static void setLogLevel(const int &level);
 
+    /**
+     * @brief setLogSettings - Применение настроек протоколирования потоком протоколирования
+     * @param settings - Настройки протоколирования
+     */
+    static void setLogSettings(const LogSettings::Ptr &settings);
+
 protected:
     void onThreadStarted() override;
     void onThreadFinishing() override;
     void onThreadFinished() override;
     void onIdle() override;
+    void onProcessMessagesFinished() override;
     bool processMessage(const MessageBase::Ptr &message) override;
 
 private:
     void logFlushBuffer() override;
     void logCheckAndFlushBuffer();
 
+    /**
+     * @brief drainBinaryLog - Извлечение и запись сообщений двоичного журнала
+     */
+    void drainBinaryLog();
+    void doBinaryLogRecord(const BinaryLogRecord &record);
+
+    /**
+     * @brief logSuppressedSummary - Запись количества сообщений, подавленных ограничением частоты
+     * @param rightNow - Признак записи без ожидания окончания периода
+     */
+    void logSuppressedSummary(bool rightNow);
+
     qint64 _nextWriteFileTickCount;
+    qint64 _rateLimitSummaryMilliseconds;
+    qint64 _nextRateLimitSummaryTickCount;
     IMessageSubscriber *_subscriber;
 };
 
@@ -3,8 +3,12 @@
 #include "ListThreads.h"
 #include "LogMessagesTemplates.h"
 #include "MessageWriteToFile.h"
+#include "MetricsSettings.h"
+#include "ThreadLogs.h"
+#include "ThreadMetricsServer.h"
 
 #include "../Utils/DateUtils.h"
+#include "../Utils/LoopClock.h"
 
 #include <QCoreApplication>
 
@@ -97,6 +101,22 @@ void ThreadMainDaemon::onThreadStarted()
 
             _settings->writeBundle();
         }
+
+        // потоки, запущенные до чтения настроек, размещаются повторно
+        ThreadBase::setPlacementSettings(_settings->threadPlacement());
+        if (ListThreads::instance())
+            ListThreads::instance()->applyPlacement();
+
+        ThreadLogs::setLogSettings(_settings->logSettings());
+
+        MetricsSettings::Ptr metricsSettings = _settings->metricsSettings();
+        ThreadBase::setMessageTiming(metricsSettings->messageTiming(),
+                                     metricsSettings->slowMessageMicroseconds());
+
+        // сервер метрик запускается только при заданном порте
+        uint16_t metricsPort = metricsSettings->port();
+        if (metricsPort > 0)
+            registerAndStartChildThread(new ThreadMetricsServer(metricsPort, this));
     }
 }
 
@@ -132,11 +152,11 @@ SettingsBundle::Ptr ThreadMainDaemon::settings()
 
 void ThreadMainDaemon::snapshotThreads(bool rightNow)
 {
-    auto tickCount = DateUtils::getTickCount();
+    auto tickCount = LoopClock::now();
     if (!rightNow && tickCount < _nextBuildStatisticTickCount)
         return;
 
-    _nextBuildStatisticTickCount = DateUtils::getNextTickCount(TIMEOUT_BUILD_STATISTIC_MILLISECONDS);
+    _nextBuildStatisticTickCount = LoopClock::now() + TIMEOUT_BUILD_STATISTIC_MILLISECONDS;
 
     ListThreads *threads = ListThreads::instance();
     if (!threads)
@@ -179,14 +199,29 @@ void ThreadMainDaemon::snapshotThreads(bool rightNow)
         qint64 workingMSecs = workingTotalMSecs - statistic.WaitMSecsCount;
 
         QDateTime alive = QDateTime::fromMSecsSinceEpoch(statistic.AliveMsecsSinceEpoch);
-        statisticString += QString("%1. (Id: %2) %3 %4 (%5/%6) Queue: %7").
+        statisticString += QString("%1. (Id: %2) %3 %4 (%5/%6) Queue: %7 (%8/%9/%10) WakeUps: %11/%12 Outbox: %13/%14/%15 Inbox: %16/%17/%18/%19 HWM: %20/%21").
                 arg(i + 1).
                 arg(statistic.ThreadId).
                 arg(statistic.ThreadName).
                 arg(alive.toString("dd.MM.yy hh:mm:ss.zzz")).
                 arg(workingMSecs).
                 arg(workingTotalMSecs).
-                arg(statistic.QueueCount)
+                arg(statistic.QueueCount).
+                arg(statistic.ControlQueueCount).
+                arg(statistic.NormalQueueCount).
+                arg(statistic.BulkQueueCount).
+                arg(statistic.WakeUpsIssued).
+                arg(statistic.WakeUpsSuppressed).
+                arg(statistic.OutboxMessages).
+                arg(statistic.OutboxBatches).
+                arg(statistic.OutboxRejected).
+                arg(statistic.InboxDroppedNewest).
+                arg(statistic.InboxDroppedOldest).
+                arg(statistic.InboxConflated).
+                arg(statistic.InboxTimedOut).
+                arg(statistic.InboxHighWaterCount).
+                arg(statistic.InboxHighWaterBytes)
+                + ((statistic.Placement.isEmpty()) ? "" : " Placement: " + statistic.Placement)
                 + ((statistic.Terminated) ? " Terminated" : "") + "\r\n";
     }
 
@@ -209,7 +244,7 @@ void ThreadMainDaemon::snapshotThreads(bool rightNow)
     {
         writeLog(Message120, statisticList.count(), memoryUsage, messagesCount);
 
-        _nextBuildCommonStatisticTickCount = DateUtils::getNextTickCount(60000);
+        _nextBuildCommonStatisticTickCount = LoopClock::now() + 60000;
     }
 }
 
@@ -0,0 +1,121 @@
+#include "ThreadMetricsConnection.h"
+
+#include "HandlerTcpSocket.h"
+#include "PacketFactoryAsciiLines.h"
+
+#include "../Utils/LoopClock.h"
+#include "../Utils/Metrics.h"
+
+namespace Threader {
+
+namespace Threads {
+
+
+namespace {
+
+/**
+ * @brief PacketHttpResponse - Ответ HTTP, записываемый без преобразования кодировки
+ */
+class PacketHttpResponse : public PacketBase
+{
+public:
+    explicit PacketHttpResponse(const QByteArray &response)
+        : PacketBase(response.constData(), response.size())
+    {
+    }
+
+    bool write(DataStream &stream) const override
+    {
+        return stream.write(data()->constData(), data()->size());
+    }
+};
+
+}
+
+
+ThreadMetricsConnection::ThreadMetricsConnection(IMessageSubscriber *parent,
+                                                 Descriptor socket,
+                                                 const QString &host,
+                                                 const uint16_t port)
+    : ThreadHandler(parent,
+                    new HandlerTcpSocket(host, port, socket),
+                    0,
+                    new PacketFactoryAsciiLines())
+    , _isResponded(false)
+    , _responseBytesLeft(0)
+{
+    setThreadName(QString("Thread.Metrics.%1").arg(handler()->deviceName()));
+    setTimeout(1000);
+}
+
+void ThreadMetricsConnection::createMetrics()
+{
+    // подключения сервера метрик не учитываются, чтобы каждый запрос
+    // не порождал новые ряды
+}
+
+void ThreadMetricsConnection::onBeforeWaitEvents()
+{
+    ThreadHandler::onBeforeWaitEvents();
+
+    // подключение закрывается после отправки ответа целиком
+    if (_isResponded && _responseBytesLeft <= 0 && handler()->isConnected())
+        handler()->close();
+}
+
+void ThreadMetricsConnection::onIdle()
+{
+    if (!_isResponded && startedTickCount() + TIMEOUT_REQUEST_MILLISECONDS <= LoopClock::now())
+        terminateThread();
+}
+
+void ThreadMetricsConnection::onDisconnected()
+{
+    terminateThread();
+}
+
+void ThreadMetricsConnection::onWriteData(const char *, const int &size)
+{
+    _responseBytesLeft -= size;
+}
+
+bool ThreadMetricsConnection::onPacketReceived(const PacketBase::Ptr &packet)
+{
+    auto request = std::dynamic_pointer_cast<PacketAsciiLines>(packet);
+    if (_isResponded || !request || request->lines().isEmpty())
+        return false;
+
+    // строка запроса: метод, путь и версия протокола
+    QStringList requestLine = request->lines().first().split(' ', QString::SkipEmptyParts);
+    QString method = requestLine.value(0);
+    QString path = requestLine.value(1).section('?', 0, 0);
+
+    if (method != "GET")
+        sendResponse("405 Method Not Allowed", QByteArray());
+    else if (path != "/metrics" && path != "/")
+        sendResponse("404 Not Found", QByteArray());
+    else
+        sendResponse("200 OK", Metrics::exposition());
+    return true;
+}
+
+bool ThreadMetricsConnection::onPacketSent(const PacketBase::Ptr &packet)
+{
+    Q_UNUSED(packet)
+    return true;
+}
+
+void ThreadMetricsConnection::sendResponse(const QByteArray &status, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+            "Connection: close\r\n"
+            "\r\n" + body;
+
+    _isResponded = true;
+    _responseBytesLeft = response.size();
+    sendPacket(std::make_shared<PacketHttpResponse>(response));
+}
+
+}}
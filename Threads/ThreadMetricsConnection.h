@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ThreadHandler.h"
+
+#include "../threader_global.h"
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief ThreadMetricsConnection - Подключение к серверу метрик
+ * По первой строке запроса HTTP отправляет снимок метрик и закрывает подключение
+ */
+class THREADERSHARED_EXPORT ThreadMetricsConnection : public ThreadHandler
+{
+public:
+    explicit ThreadMetricsConnection(IMessageSubscriber *parent,
+                                     Descriptor socket,
+                                     const QString &host,
+                                     const uint16_t port);
+
+protected:
+    void createMetrics() override;
+
+    void onBeforeWaitEvents() override;
+    void onIdle() override;
+    void onDisconnected() override;
+    void onWriteData(const char *, const int &size) override;
+
+    bool onPacketReceived(const PacketBase::Ptr &packet) override;
+    bool onPacketSent(const PacketBase::Ptr &packet) override;
+
+private:
+    static const int TIMEOUT_REQUEST_MILLISECONDS = 10000;
+
+    /**
+     * @brief sendResponse - Отправка ответа HTTP с закрытием подключения
+     * @param status - Строка состояния
+     * @param body - Тело ответа
+     */
+    void sendResponse(const QByteArray &status, const QByteArray &body);
+
+    bool _isResponded;
+    qint64 _responseBytesLeft;
+};
+
+}}
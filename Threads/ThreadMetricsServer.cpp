@@ -0,0 +1,49 @@
+#include "ThreadMetricsServer.h"
+
+#include "LogMessagesTemplates.h"
+#include "ThreadMetricsConnection.h"
+
+namespace Threader {
+
+namespace Threads {
+
+
+ThreadMetricsServer::ThreadMetricsServer(uint16_t port,
+                                         IMessageSubscriber *parent)
+    : ThreadListenSocket(port, parent)
+{
+    setThreadName(QString("Thread.Metrics:%1").arg(port));
+    setReactorsCount(1);
+}
+
+void ThreadMetricsServer::createMetrics()
+{
+    // сервер метрик не учитывается в собственных снимках
+}
+
+void ThreadMetricsServer::onBeforeListenSocketInitialization()
+{
+    writeLog(Message130, port());
+}
+
+void ThreadMetricsServer::onListenSocketInitialized()
+{
+    writeLog(Message131, port());
+}
+
+void ThreadMetricsServer::onAcceptConnectionRequest(Descriptor socket,
+                                                    const QString &ipAddress,
+                                                    bool &accept)
+{
+    accept = true;
+    registerAndStartConnectionThread(new ThreadMetricsConnection(this, socket, ipAddress, port()));
+}
+
+void ThreadMetricsServer::onListenSocketError(PollerListenSocket *sender,
+                                              int errorCode)
+{
+    writeLog(Message132, port(), errorCode, errorString(errorCode).toUtf8().constData());
+    Q_UNUSED(sender)
+}
+
+}}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ThreadListenSocket.h"
+
+#include "../threader_global.h"
+
+#include <QObject>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief ThreadMetricsServer - Сервер метрик в текстовом формате Prometheus
+ * Подключения обслуживаются одним реактором: каждое подключение получает снимок
+ * метрик по запросу GET /metrics и закрывается
+ */
+class THREADERSHARED_EXPORT ThreadMetricsServer : public ThreadListenSocket
+{
+    Q_OBJECT
+public:
+    explicit ThreadMetricsServer(uint16_t port,
+                                 IMessageSubscriber *parent = nullptr);
+
+protected:
+    void createMetrics() override;
+
+    void onBeforeListenSocketInitialization() override;
+    void onListenSocketInitialized() override;
+    void onAcceptConnectionRequest(Descriptor socket,
+                                   const QString &ipAddress,
+                                   bool &accept) override;
+    void onListenSocketError(PollerListenSocket *sender,
+                             int errorCode) override;
+};
+
+}}
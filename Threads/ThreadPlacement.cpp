@@ -0,0 +1,396 @@
+#include "ThreadPlacement.h"
+
+#include <QFile>
+#include <QRegExp>
+#include <QStringList>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+#endif
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace Threader {
+
+namespace Threads {
+
+static const char *PLACEMENT_ARRAY_NAME = "ThreadPlacement";
+
+static QString policyToString(ThreadSchedulingPolicy policy)
+{
+    switch (policy) {
+    case ThreadSchedulingPolicy::Other:
+        return "Other";
+    case ThreadSchedulingPolicy::Fifo:
+        return "Fifo";
+    case ThreadSchedulingPolicy::Default:
+        break;
+    }
+    return "Default";
+}
+
+static ThreadSchedulingPolicy policyFromString(const QString &policy)
+{
+    if (0 == policy.compare("Other", Qt::CaseInsensitive))
+        return ThreadSchedulingPolicy::Other;
+    if (0 == policy.compare("Fifo", Qt::CaseInsensitive))
+        return ThreadSchedulingPolicy::Fifo;
+    return ThreadSchedulingPolicy::Default;
+}
+
+#ifdef Q_OS_LINUX
+static QString errorText(const char *operation)
+{
+    return QString("%1: %2").arg(operation).arg(strerror(errno));
+}
+#endif
+
+
+bool ThreadPlacement::isEmpty() const
+{
+    return Cpus.isEmpty() && ThreadSchedulingPolicy::Default == Policy &&
+            NumaNode < 0 && 0 == StackSize;
+}
+
+QString ThreadPlacement::apply(long threadId, bool isCurrentThread) const
+{
+    QStringList errors;
+
+    // без явного списка процессоров поток закрепляется за процессорами узла NUMA
+    QVector<int> cpus = Cpus;
+    if (cpus.isEmpty() && NumaNode >= 0)
+        cpus = numaNodeCpus(NumaNode);
+
+#ifdef Q_OS_LINUX
+    pid_t tid = pid_t(threadId);
+
+    if (!cpus.isEmpty())
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (int cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpuSet);
+        }
+        if (0 != sched_setaffinity(tid, sizeof(cpuSet), &cpuSet))
+            errors << errorText("affinity");
+    }
+
+    switch (Policy) {
+    case ThreadSchedulingPolicy::Fifo:
+    {
+        sched_param param = {};
+        param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), Priority,
+                                      sched_get_priority_max(SCHED_FIFO));
+        if (0 != sched_setscheduler(tid, SCHED_FIFO, &param))
+            errors << errorText("sched_fifo");
+        break;
+    }
+    case ThreadSchedulingPolicy::Other:
+    {
+        sched_param param = {};
+        if (0 != sched_setscheduler(tid, SCHED_OTHER, &param))
+            errors << errorText("sched_other");
+        // для потока Linux уровень nice задается по его идентификатору
+        if (0 != setpriority(PRIO_PROCESS, id_t(tid), Nice))
+            errors << errorText("nice");
+        break;
+    }
+    case ThreadSchedulingPolicy::Default:
+        break;
+    }
+
+    // политика памяти задается только для вызывающего потока
+    if (NumaNode >= 0 && isCurrentThread)
+    {
+        static const int MASK_WORDS = 16;
+        static const int BITS_PER_WORD = int(sizeof(unsigned long) * 8);
+        unsigned long nodeMask[MASK_WORDS] = {};
+        if (NumaNode < MASK_WORDS * BITS_PER_WORD)
+        {
+            nodeMask[NumaNode / BITS_PER_WORD] = 1UL << (NumaNode % BITS_PER_WORD);
+            if (0 != syscall(SYS_set_mempolicy, MPOL_BIND, nodeMask,
+                             (unsigned long)(MASK_WORDS * BITS_PER_WORD + 1)))
+                errors << errorText("numa");
+        }
+        else
+        {
+            errors << QString("numa: node %1 out of range").arg(NumaNode);
+        }
+    }
+#endif
+
+#ifdef Q_OS_WIN
+    HANDLE handle = isCurrentThread ?
+                GetCurrentThread() :
+                OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, DWORD(threadId));
+    if (!handle)
+        return QString("open thread: %1").arg(GetLastError());
+
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < int(sizeof(DWORD_PTR) * 8))
+            mask |= DWORD_PTR(1) << cpu;
+    }
+    if (mask && 0 == SetThreadAffinityMask(handle, mask))
+        errors << QString("affinity: %1").arg(GetLastError());
+
+    int priority = THREAD_PRIORITY_NORMAL;
+    if (ThreadSchedulingPolicy::Fifo == Policy)
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+    else if (Nice <= -10)
+        priority = THREAD_PRIORITY_HIGHEST;
+    else if (Nice < 0)
+        priority = THREAD_PRIORITY_ABOVE_NORMAL;
+    else if (Nice >= 10)
+        priority = THREAD_PRIORITY_LOWEST;
+    else if (Nice > 0)
+        priority = THREAD_PRIORITY_BELOW_NORMAL;
+    if (ThreadSchedulingPolicy::Default != Policy && !SetThreadPriority(handle, priority))
+        errors << QString("priority: %1").arg(GetLastError());
+
+    if (!isCurrentThread)
+        CloseHandle(handle);
+#endif
+
+    return errors.join("; ");
+}
+
+ThreadPlacement ThreadPlacement::effective(long threadId) const
+{
+    ThreadPlacement result = *this;
+
+#ifdef Q_OS_LINUX
+    pid_t tid = pid_t(threadId);
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (0 == sched_getaffinity(tid, sizeof(cpuSet), &cpuSet))
+    {
+        result.Cpus.clear();
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &cpuSet))
+                result.Cpus.append(cpu);
+        }
+    }
+
+    int policy = sched_getscheduler(tid);
+    if (SCHED_FIFO == policy)
+    {
+        sched_param param = {};
+        sched_getparam(tid, &param);
+        result.Policy = ThreadSchedulingPolicy::Fifo;
+        result.Priority = param.sched_priority;
+    }
+    else if (SCHED_OTHER == policy)
+    {
+        result.Policy = ThreadSchedulingPolicy::Other;
+        result.Priority = 0;
+        errno = 0;
+        int nice = getpriority(PRIO_PROCESS, id_t(tid));
+        if (0 == errno)
+            result.Nice = nice;
+    }
+#else
+    Q_UNUSED(threadId)
+#endif
+
+    return result;
+}
+
+QString ThreadPlacement::toString() const
+{
+    QStringList parts;
+    if (!Cpus.isEmpty())
+        parts << "cpus=" + cpusToString(Cpus);
+
+    switch (Policy) {
+    case ThreadSchedulingPolicy::Fifo:
+        parts << QString("sched=fifo/%1").arg(Priority);
+        break;
+    case ThreadSchedulingPolicy::Other:
+        parts << QString("sched=other/nice=%1").arg(Nice);
+        break;
+    case ThreadSchedulingPolicy::Default:
+        break;
+    }
+
+    if (NumaNode >= 0)
+        parts << QString("numa=%1").arg(NumaNode);
+    if (StackSize > 0)
+        parts << QString("stack=%1").arg(StackSize);
+
+    return parts.join(' ');
+}
+
+QVector<int> ThreadPlacement::parseCpus(const QString &cpus)
+{
+    QVector<int> result;
+    for (const QString &item : cpus.split(',', QString::SkipEmptyParts))
+    {
+        QStringList range = item.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        int first = range.first().toInt(&firstOk);
+        int last = (range.count() > 1) ? range.at(1).toInt(&lastOk) : first;
+        if (!firstOk || (range.count() > 1 && !lastOk) || range.count() > 2 ||
+                first < 0 || last < first)
+            continue;
+
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            if (!result.contains(cpu))
+                result.append(cpu);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QString ThreadPlacement::cpusToString(const QVector<int> &cpus)
+{
+    QStringList ranges;
+    int index = 0;
+    while (index < cpus.count())
+    {
+        // подряд идущие номера сворачиваются в диапазон
+        int first = cpus.at(index);
+        int last = first;
+        while (index + 1 < cpus.count() && cpus.at(index + 1) == last + 1)
+            last = cpus.at(++index);
+        ranges << ((first == last) ? QString::number(first) : QString("%1-%2").arg(first).arg(last));
+        index++;
+    }
+    return ranges.join(',');
+}
+
+QVector<int> ThreadPlacement::numaNodeCpus(int numaNode)
+{
+#ifdef Q_OS_LINUX
+    QFile file(QString("/sys/devices/system/node/node%1/cpulist").arg(numaNode));
+    if (file.open(QIODevice::ReadOnly))
+        return parseCpus(QString::fromLatin1(file.readAll()).trimmed());
+    return QVector<int>();
+#endif
+
+#ifdef Q_OS_WIN
+    ULONGLONG mask = 0;
+    QVector<int> result;
+    if (numaNode >= 0 && numaNode <= 0xFF && GetNumaNodeProcessorMask(UCHAR(numaNode), &mask))
+    {
+        for (int cpu = 0; cpu < 64; cpu++)
+        {
+            if (mask & (ULONGLONG(1) << cpu))
+                result.append(cpu);
+        }
+    }
+    return result;
+#endif
+}
+
+
+bool ThreadPlacementSettings::read(QSettings &settings)
+{
+    QVector<Rule> rules;
+
+    int count = settings.beginReadArray(PLACEMENT_ARRAY_NAME);
+    for (int i = 0; i < count; i++)
+    {
+        settings.setArrayIndex(i);
+
+        Rule rule;
+        rule.Pattern = settings.value("Pattern").toString().trimmed();
+        if (rule.Pattern.isEmpty())
+            continue;
+
+        rule.Placement.Cpus = ThreadPlacement::parseCpus(settings.value("Cpus").toString());
+        rule.Placement.Policy = policyFromString(settings.value("Policy").toString());
+        rule.Placement.Priority = settings.value("Priority", 0).toInt();
+        rule.Placement.Nice = settings.value("Nice", 0).toInt();
+        rule.Placement.NumaNode = settings.value("NumaNode", -1).toInt();
+        rule.Placement.StackSize = settings.value("StackSize", 0).toUInt();
+        rules.append(rule);
+    }
+    settings.endArray();
+
+    QMutexLocker locker(&_mutex);
+    _rules = rules;
+    return true;
+}
+
+bool ThreadPlacementSettings::write(QSettings &settings)
+{
+    QMutexLocker locker(&_mutex);
+
+    // без правил раздел в файл настроек не добавляется
+    if (_rules.isEmpty())
+        return true;
+
+    settings.beginWriteArray(PLACEMENT_ARRAY_NAME, _rules.count());
+    for (int i = 0; i < _rules.count(); i++)
+    {
+        const Rule &rule = _rules.at(i);
+        settings.setArrayIndex(i);
+        settings.setValue("Pattern", rule.Pattern);
+        settings.setValue("Cpus", ThreadPlacement::cpusToString(rule.Placement.Cpus));
+        settings.setValue("Policy", policyToString(rule.Placement.Policy));
+        settings.setValue("Priority", rule.Placement.Priority);
+        settings.setValue("Nice", rule.Placement.Nice);
+        settings.setValue("NumaNode", rule.Placement.NumaNode);
+        settings.setValue("StackSize", rule.Placement.StackSize);
+    }
+    settings.endArray();
+    return true;
+}
+
+void ThreadPlacementSettings::clear()
+{
+    QMutexLocker locker(&_mutex);
+    _rules.clear();
+}
+
+void ThreadPlacementSettings::appendRule(const QString &pattern, const ThreadPlacement &placement)
+{
+    QMutexLocker locker(&_mutex);
+    _rules.append({pattern, placement});
+}
+
+int ThreadPlacementSettings::count() const
+{
+    QMutexLocker locker(&_mutex);
+    return _rules.count();
+}
+
+bool ThreadPlacementSettings::placementFor(const QString &threadName, ThreadPlacement &placement) const
+{
+    QMutexLocker locker(&_mutex);
+    for (const Rule &rule : _rules)
+    {
+        QRegExp pattern(rule.Pattern, Qt::CaseSensitive, QRegExp::Wildcard);
+        if (pattern.exactMatch(threadName))
+        {
+            placement = rule.Placement;
+            return true;
+        }
+    }
+    return false;
+}
+
+}}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "SettingsBase.h"
+
+#include "../threader_global.h"
+
+#include <QMutex>
+#include <QSettings>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief ThreadSchedulingPolicy - Политика планирования потока
+ */
+enum class ThreadSchedulingPolicy
+{
+    Default,  // политика не изменяется
+    Other,    // разделение времени (SCHED_OTHER) с заданным уровнем nice
+    Fifo      // реальное время (SCHED_FIFO) с заданным приоритетом
+};
+
+/**
+ * @brief ThreadPlacement - Размещение потока: процессоры, планирование, узел NUMA и стек
+ * Пустые значения полей означают, что соответствующий параметр не изменяется
+ */
+struct THREADERSHARED_EXPORT ThreadPlacement
+{
+    QVector<int> Cpus;
+    ThreadSchedulingPolicy Policy = ThreadSchedulingPolicy::Default;
+    int Priority = 0;
+    int Nice = 0;
+    int NumaNode = -1;
+    uint StackSize = 0;
+
+    bool isEmpty() const;
+
+    /**
+     * @brief apply - Применение размещения к потоку
+     * Привязка памяти к узлу NUMA применяется только к текущему потоку, поэтому
+     * при повторном применении к другому потоку она не изменяется. Если процессоры
+     * не заданы, поток закрепляется за процессорами узла NUMA
+     * @param threadId - Системный идентификатор потока
+     * @param isCurrentThread - Признак применения к текущему потоку
+     * @return - Описание ошибок применения, пустая строка при успехе
+     */
+    QString apply(long threadId, bool isCurrentThread) const;
+
+    /**
+     * @brief effective - Получение действующего размещения потока
+     * Узел NUMA и размер стека системой не сообщаются и берутся из заданного размещения
+     * @param threadId - Системный идентификатор потока
+     * @return - Действующее размещение
+     */
+    ThreadPlacement effective(long threadId) const;
+
+    /**
+     * @brief toString - Получение краткого описания размещения для статистики
+     * @return - Описание вида "cpus=2-3 sched=fifo/50 numa=0 stack=262144"
+     */
+    QString toString() const;
+
+    /**
+     * @brief parseCpus - Разбор списка процессоров вида "0-3,8,10-11"
+     * @param cpus - Список процессоров
+     * @return - Номера процессоров
+     */
+    static QVector<int> parseCpus(const QString &cpus);
+
+    /**
+     * @brief cpusToString - Формирование списка процессоров вида "0-3,8,10-11"
+     * @param cpus - Номера процессоров
+     * @return - Список процессоров
+     */
+    static QString cpusToString(const QVector<int> &cpus);
+
+    /**
+     * @brief numaNodeCpus - Получение процессоров узла NUMA
+     * @param numaNode - Номер узла
+     * @return - Номера процессоров, пустой список, если узел неизвестен
+     */
+    static QVector<int> numaNodeCpus(int numaNode);
+};
+
+/**
+ * @brief ThreadPlacementSettings - Настройки размещения потоков по шаблону имени потока
+ * Правила хранятся в массиве ThreadPlacement:
+ *   ThreadPlacement\size=1
+ *   ThreadPlacement\1\Pattern=ThreadHandler*
+ *   ThreadPlacement\1\Cpus=2-3
+ *   ThreadPlacement\1\Policy=Fifo
+ *   ThreadPlacement\1\Priority=50
+ *   ThreadPlacement\1\Nice=0
+ *   ThreadPlacement\1\NumaNode=0
+ *   ThreadPlacement\1\StackSize=262144
+ * Шаблон сравнивается с именем потока по правилам подстановки (*, ?, []),
+ * применяется первое подходящее правило
+ */
+class THREADERSHARED_EXPORT ThreadPlacementSettings : public SettingsBase
+{
+public:
+    using Ptr = std::shared_ptr<ThreadPlacementSettings>;
+
+public:
+    bool read(QSettings &settings) override;
+    bool write(QSettings &settings) override;
+
+    void clear();
+    void appendRule(const QString &pattern, const ThreadPlacement &placement);
+    int count() const;
+
+    /**
+     * @brief placementFor - Поиск размещения для потока
+     * @param threadName - Имя потока
+     * @param placement - Найденное размещение
+     * @return - Признак наличия подходящего правила
+     */
+    bool placementFor(const QString &threadName, ThreadPlacement &placement) const;
+
+private:
+    struct Rule
+    {
+        QString Pattern;
+        ThreadPlacement Placement;
+    };
+
+    mutable QMutex _mutex;
+    QVector<Rule> _rules;
+};
+
+}}
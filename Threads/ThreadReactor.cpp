@@ -0,0 +1,268 @@
+#include "ThreadReactor.h"
+
+#include "MessageThread.h"
+
+#include "../Utils/LoopClock.h"
+
+namespace Threader {
+
+namespace Threads {
+
+using namespace Threader::Utils;
+
+const QString ThreadReactor::MESSAGE_NAME_ATTACH_THREAD = "Reactor.Thread.Attach";
+const QString ThreadReactor::MESSAGE_NAME_THREAD_SIGNALS = "Reactor.Thread.Signals";
+
+ThreadReactor::ThreadReactor(IMessageSubscriber *parent,
+                             const QString &threadName)
+    : ThreadBase(parent, threadName, ThreadRunMode::Polling)
+    , _threadsCount(0)
+{
+    // реактор ожидает события множества дескрипторов
+    setPollingMethod(PollingMethod::Epoll);
+}
+
+bool ThreadReactor::attachThread(ThreadBase *thread)
+{
+    if (!thread || thread->_reactor || thread->isRunning())
+        return false;
+
+    // обслуживаются только потоки, работающие на голосовании
+    if (ThreadRunMode::Polling != thread->threadRunMode())
+        return false;
+
+    if (isTerminated() || isThreadFinished())
+        return false;
+
+    thread->_reactor = this;
+    _threadsCount.fetch_add(1);
+
+    postMessage(std::make_shared<MessageThread>(MESSAGE_NAME_ATTACH_THREAD, thread));
+    return true;
+}
+
+int ThreadReactor::threadsCount() const
+{
+    return _threadsCount.load(std::memory_order_relaxed);
+}
+
+bool ThreadReactor::processMessage(const MessageBase::Ptr &message)
+{
+    if (MESSAGE_NAME_THREAD_SIGNALS == message->name())
+    {
+        auto messageThread = std::static_pointer_cast<MessageThread>(message);
+        // поток мог быть остановлен до обработки сообщения
+        if (_threadsSet.contains(messageThread->thread()))
+            processThreadSignals(messageThread->thread());
+        return true;
+    }
+
+    if (MESSAGE_NAME_ATTACH_THREAD == message->name())
+    {
+        auto messageThread = std::static_pointer_cast<MessageThread>(message);
+        startThread(messageThread->thread());
+        return true;
+    }
+
+    return ThreadBase::processMessage(message);
+}
+
+void ThreadReactor::onBeforeWaitEvents()
+{
+    ThreadBase::onBeforeWaitEvents();
+
+    // проход выполняется только по потокам, обслуженным на предыдущем проходе
+    QSet<ThreadBase*> threads;
+    threads.swap(_activeThreads);
+    for (auto thread : threads)
+        if (_threadsSet.contains(thread))
+            thread->onBeforeWaitEvents();
+}
+
+void ThreadReactor::onAfterWaitEvents()
+{
+    ThreadBase::onAfterWaitEvents();
+
+    auto tickCount = LoopClock::now();
+
+    // потоки с наступившим сроком таймеров или onIdle
+    while (!_deadlines.isEmpty() && _deadlines.firstKey() <= tickCount)
+    {
+        auto deadline = _deadlines.begin();
+        _readyThreads.insert(deadline.value());
+        _threadDeadlines.remove(deadline.value());
+        _deadlines.erase(deadline);
+    }
+
+    QSet<ThreadBase*> threads;
+    threads.swap(_readyThreads);
+    for (auto thread : threads)
+    {
+        if (!_threadsSet.contains(thread))
+            continue;
+
+        thread->processTimers();
+
+        // сообщения, оставшиеся после исчерпания бюджета потока
+        if (thread->hasPendingMessages())
+            thread->processMessages();
+
+        // таймаут ожидания событий обслуживаемого потока
+        if (!thread->isTerminated() && thread->_nextCallIdle <= tickCount)
+        {
+            thread->onIdle();
+            thread->_nextCallIdle = LoopClock::now() + thread->timeout();
+        }
+
+        thread->onAfterWaitEvents();
+
+        if (thread->isTerminated())
+        {
+            finishThread(thread);
+            continue;
+        }
+
+        scheduleThread(thread);
+        _activeThreads.insert(thread);
+
+        // сообщения, оставшиеся после исчерпания бюджета, обрабатываются на следующем проходе
+        if (thread->hasPendingMessages())
+            _readyThreads.insert(thread);
+    }
+}
+
+void ThreadReactor::onThreadFinishing()
+{
+    // остановка потоков, оставшихся на обслуживании
+    while (!_threads.isEmpty())
+    {
+        ThreadBase *thread = _threads.first();
+        thread->terminateThread();
+        finishThread(thread);
+    }
+
+    ThreadBase::onThreadFinishing();
+}
+
+void ThreadReactor::waitEvents(uint timeout)
+{
+    // таймаут вычисляется на каждом проходе: при ожидающих обслуживания потоках
+    // события только опрашиваются, иначе ожидание ограничивается ближайшим сроком
+    if (!_readyThreads.isEmpty())
+        timeout = 0;
+    else if (!_deadlines.isEmpty())
+    {
+        qint64 delay = qMax(_deadlines.firstKey() - LoopClock::now(), qint64(0));
+        if (delay < qint64(timeout))
+            timeout = uint(delay);
+    }
+
+    ThreadBase::waitEvents(timeout);
+
+    // потоки, голосующие которых получили события
+    const QSet<Polling*> guests = polling()->takeActiveGuests();
+    for (auto guest : guests)
+    {
+        ThreadBase *thread = _threadsByPolling.value(guest, nullptr);
+        if (thread)
+            _readyThreads.insert(thread);
+    }
+}
+
+void ThreadReactor::startThread(ThreadBase *thread)
+{
+    _threads.append(thread);
+    _threadsSet.insert(thread);
+    _threadsByPolling.insert(&thread->_polling, thread);
+
+    // голосующие потока ожидают событий в голосовании реактора
+    thread->_polling.setHost(polling());
+
+    thread->beginThreadCycle();
+    thread->_nextCallIdle = LoopClock::now() + thread->timeout();
+
+    // сроки потока планируются после первого обслуживания
+    _readyThreads.insert(thread);
+
+    // если реактор уже останавливается, то поток сразу останавливается
+    if (isTerminated())
+        thread->terminateThread();
+
+    // обработка событий, поступивших до начала обслуживания
+    processThreadSignals(thread);
+}
+
+void ThreadReactor::processThreadSignals(ThreadBase *thread)
+{
+    int signalFlags = thread->_hostedSignals.exchange(0);
+
+    // таймеры и сроки потока, измененные при обработке, учитываются после ожидания
+    _readyThreads.insert(thread);
+
+    if (signalFlags & (1 << static_cast<int>(ThreadSignals::EVENT_CHILD_THREAD_TERMINATED)))
+        thread->destroyTerminatedChildThreads(true);
+
+    if (signalFlags & (1 << static_cast<int>(ThreadSignals::EVENT_THREAD_WAKEUP)))
+        thread->processMessages();
+
+    if (signalFlags & (1 << static_cast<int>(ThreadSignals::EVENT_THREAD_TERMINATE)))
+        thread->terminateThread();
+
+    if (thread->isTerminated())
+        finishThread(thread);
+}
+
+void ThreadReactor::scheduleThread(ThreadBase *thread)
+{
+    qint64 deadline = thread->_nextCallIdle;
+    qint64 timersDeadline = thread->_timerWheel.nextDeadline();
+    if (timersDeadline >= 0 && timersDeadline < deadline)
+        deadline = timersDeadline;
+
+    auto scheduled = _threadDeadlines.find(thread);
+    if (scheduled != _threadDeadlines.end())
+    {
+        if (scheduled.value() == deadline)
+            return;
+        _deadlines.remove(scheduled.value(), thread);
+        scheduled.value() = deadline;
+    }
+    else
+        _threadDeadlines.insert(thread, deadline);
+
+    _deadlines.insert(deadline, thread);
+}
+
+void ThreadReactor::finishThread(ThreadBase *thread)
+{
+    if (!_threadsSet.contains(thread))
+        return;
+
+    _threads.removeAll(thread);
+    _threadsSet.remove(thread);
+    _threadsByPolling.remove(&thread->_polling);
+    _readyThreads.remove(thread);
+    _activeThreads.remove(thread);
+    auto deadline = _threadDeadlines.find(thread);
+    if (deadline != _threadDeadlines.end())
+    {
+        _deadlines.remove(deadline.value(), thread);
+        _threadDeadlines.erase(deadline);
+    }
+
+    thread->finishThreadCycle();
+
+    // возврат голосующих потоку
+    thread->_polling.setHost(nullptr);
+
+    _threadsCount.fetch_sub(1);
+
+    // после установки признака поток может быть уничтожен владельцем
+    auto *ownerThread = thread->parentThread();
+    thread->_hostedFinished.store(true);
+
+    if (ownerThread)
+        ownerThread->postEventChildThreadTerminated();
+}
+
+}}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "ThreadBase.h"
+
+#include "../threader_global.h"
+
+#include <QHash>
+#include <QMultiMap>
+#include <QObject>
+#include <QSet>
+
+#include <atomic>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief ThreadReactor - Поток-реактор, обслуживающий в одном системном потоке множество
+ * потоков ThreadBase (например, ThreadHandler подключений).
+ * Обслуживаемые потоки не запускают собственный QThread: их голосующие ожидают событий
+ * в голосовании реактора, а сообщения, таймауты и сигналы обрабатываются реактором
+ * вызовом методов обслуживаемого потока. Модель программирования потока не меняется -
+ * все его обработчики выполняются в системном потоке реактора
+ */
+class THREADERSHARED_EXPORT ThreadReactor : public ThreadBase
+{
+    Q_OBJECT
+public:
+    static const QString MESSAGE_NAME_ATTACH_THREAD;
+    static const QString MESSAGE_NAME_THREAD_SIGNALS;
+
+    /**
+     * @brief ThreadReactor - Конструктор
+     * @param parent - Владелец потока
+     * @param threadName - Имя потока
+     */
+    explicit ThreadReactor(IMessageSubscriber *parent = nullptr,
+                           const QString &threadName = QString());
+
+    /**
+     * @brief attachThread - Передача потока на обслуживание реактору.
+     * Может вызываться из любого потока. Поток не должен быть запущен
+     * @param thread - Обслуживаемый поток
+     * @return - Признак принятия потока на обслуживание
+     */
+    bool attachThread(ThreadBase *thread);
+
+    /**
+     * @brief threadsCount - Получение количества обслуживаемых потоков
+     * @return - Количество обслуживаемых потоков, включая ожидающие подключения
+     */
+    int threadsCount() const;
+
+protected:
+    bool processMessage(const MessageBase::Ptr &message) override;
+
+    void onBeforeWaitEvents() override;
+    void onAfterWaitEvents() override;
+    void onThreadFinishing() override;
+
+    /**
+     * @brief waitEvents - Ожидание событий с учетом ближайшего срока обслуживаемых потоков
+     * @param timeout - таймаут ожидания событий
+     */
+    void waitEvents(uint timeout) override;
+
+private:
+    /**
+     * @brief startThread - Запуск обслуживания потока в контексте реактора
+     * @param thread - Обслуживаемый поток
+     */
+    void startThread(ThreadBase *thread);
+
+    /**
+     * @brief processThreadSignals - Обработка событий обслуживаемого потока
+     * @param thread - Обслуживаемый поток
+     */
+    void processThreadSignals(ThreadBase *thread);
+
+    /**
+     * @brief scheduleThread - Планирование обслуживания потока по ближайшему
+     * из сроков его таймеров и вызова onIdle
+     * @param thread - Обслуживаемый поток
+     */
+    void scheduleThread(ThreadBase *thread);
+
+    /**
+     * @brief finishThread - Остановка обслуживания потока
+     * @param thread - Обслуживаемый поток
+     */
+    void finishThread(ThreadBase *thread);
+
+    /**
+     * @brief _threads - Обслуживаемые потоки
+     */
+    ThreadsList _threads;
+
+    /**
+     * @brief _threadsSet - Множество обслуживаемых потоков для проверки сообщений,
+     * пришедших от уже остановленных потоков
+     */
+    QSet<ThreadBase*> _threadsSet;
+
+    /**
+     * @brief _threadsByPolling - Обслуживаемые потоки по их объектам голосования
+     * для отбора потоков, голосующие которых получили события
+     */
+    QHash<Polling*, ThreadBase*> _threadsByPolling;
+
+    /**
+     * @brief _readyThreads - Потоки, требующие обслуживания после ожидания событий:
+     * получившие сообщения или события голосующих, с наступившим сроком
+     * или с оставшимися после исчерпания бюджета сообщениями
+     */
+    QSet<ThreadBase*> _readyThreads;
+
+    /**
+     * @brief _activeThreads - Потоки, обслуженные на предыдущем проходе,
+     * для которых перед ожиданием вызывается onBeforeWaitEvents
+     */
+    QSet<ThreadBase*> _activeThreads;
+
+    /**
+     * @brief _deadlines - Ближайшие сроки таймеров и onIdle обслуживаемых потоков
+     */
+    QMultiMap<qint64, ThreadBase*> _deadlines;
+
+    /**
+     * @brief _threadDeadlines - Запланированный срок каждого потока для его замены
+     */
+    QHash<ThreadBase*, qint64> _threadDeadlines;
+
+    /**
+     * @brief _threadsCount - Количество обслуживаемых потоков для выбора наименее
+     * загруженного реактора
+     */
+    std::atomic<int> _threadsCount;
+};
+
+}}
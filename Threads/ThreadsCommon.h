@@ -23,3 +23,17 @@ using Descriptor = HANDLE;
 #endif
 
 
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief PollingMethod - способ ожидания событий дескрипторов
+ */
+enum class PollingMethod
+{
+    Poll,   // poll() с формированием массива ожидания на каждом шаге
+    Epoll   // epoll с постоянной регистрацией дескрипторов (только Linux)
+};
+
+}}
@@ -0,0 +1,282 @@
+#include "TimerWheel.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Threader {
+
+namespace Threads {
+
+
+// номер младшего установленного бита непустой битовой карты
+static inline int lowestBit(quint64 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return int(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// циклический сдвиг битовой карты вправо
+static inline quint64 rotateRight(quint64 value, int count)
+{
+    return (value >> count) | (value << ((64 - count) & 63));
+}
+
+
+TimerWheel::Timer::~Timer()
+{
+    if (_wheel)
+        _wheel->stop(this);
+}
+
+qint64 TimerWheel::Timer::expires() const
+{
+    return _expires;
+}
+
+bool TimerWheel::Timer::isActive() const
+{
+    return nullptr != _wheel;
+}
+
+
+TimerWheel::TimerWheel(qint64 tickCount)
+    : _overdue(nullptr)
+    , _current(tickCount)
+    , _count(0)
+{
+    for (int level = 0; level < LEVELS_COUNT; level++)
+    {
+        _occupied[level] = 0;
+        for (int slot = 0; slot < SLOTS_COUNT; slot++)
+            _slots[level][slot] = nullptr;
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    // оставшиеся таймеры отвязываются от колеса
+    while (_overdue)
+        stop(_overdue);
+
+    for (int level = 0; level < LEVELS_COUNT; level++)
+    {
+        for (int slot = 0; slot < SLOTS_COUNT; slot++)
+        {
+            while (_slots[level][slot])
+                stop(_slots[level][slot]);
+        }
+    }
+}
+
+void TimerWheel::start(Timer *timer, qint64 expires)
+{
+    if (timer->_wheel)
+        timer->_wheel->stop(timer);
+
+    timer->_expires = expires;
+    timer->_wheel = this;
+    _count++;
+    insert(timer);
+}
+
+bool TimerWheel::stop(Timer *timer)
+{
+    if (this != timer->_wheel)
+        return false;
+
+    unlink(timer);
+    timer->_wheel = nullptr;
+    _count--;
+    return true;
+}
+
+int TimerWheel::count() const
+{
+    return _count;
+}
+
+qint64 TimerWheel::nextDeadline() const
+{
+    if (0 == _count)
+        return -1;
+
+    // просроченные таймеры должны сработать немедленно
+    if (_overdue)
+        return _current - 1;
+
+    qint64 result = -1;
+
+    // нижний уровень дает точное время срабатывания
+    if (_occupied[0])
+    {
+        int index = int(_current & (SLOTS_COUNT - 1));
+        quint64 ahead = _occupied[0] & (~quint64(0) << index);
+        if (ahead)
+            result = (_current & ~qint64(SLOTS_COUNT - 1)) + lowestBit(ahead);
+        else
+            result = (_current | (SLOTS_COUNT - 1)) + 1 + lowestBit(_occupied[0]);
+    }
+
+    // верхние уровни дают время переноса ближайшей занятой ячейки
+    for (int level = 1; level < LEVELS_COUNT; level++)
+    {
+        if (!_occupied[level])
+            continue;
+
+        int shift = SLOT_BITS * level;
+        qint64 base = _current >> shift;
+        // если время выровнено на границу уровня, то текущая ячейка переносится сейчас
+        int start = (_current & ((qint64(1) << shift) - 1)) ? 1 : 0;
+        quint64 rotated = rotateRight(_occupied[level], int((base + start) & (SLOTS_COUNT - 1)));
+        qint64 deadline = (base + start + lowestBit(rotated)) << shift;
+
+        if (result < 0 || deadline < result)
+            result = deadline;
+    }
+
+    return result;
+}
+
+int TimerWheel::expire(qint64 tickCount, TimersList &expired)
+{
+    int result = 0;
+
+    while (_overdue)
+    {
+        Timer *timer = _overdue;
+        stop(timer);
+        expired.append(timer);
+        result++;
+    }
+
+    while (_count > 0 && _current <= tickCount)
+    {
+        int index = int(_current & (SLOTS_COUNT - 1));
+
+        // на границе уровня таймеры верхних уровней переносятся вниз
+        if (0 == index)
+        {
+            for (int level = 1; level < LEVELS_COUNT; level++)
+            {
+                int slot = int((_current >> (SLOT_BITS * level)) & (SLOTS_COUNT - 1));
+                cascade(level, slot);
+                if (0 != slot)
+                    break;
+            }
+        }
+
+        Timer *timer = _slots[0][index];
+        _slots[0][index] = nullptr;
+        _occupied[0] &= ~(quint64(1) << index);
+
+        while (timer)
+        {
+            Timer *next = timer->_next;
+            timer->_next = nullptr;
+            timer->_prev = nullptr;
+            timer->_wheel = nullptr;
+            _count--;
+            expired.append(timer);
+            result++;
+            timer = next;
+        }
+
+        _current++;
+
+        // пустые миллисекунды пропускаются до ближайшего события колеса
+        qint64 deadline = nextDeadline();
+        if (deadline > _current)
+            _current = qMin(deadline, tickCount + 1);
+    }
+
+    // пустое колесо просто переводится на текущее время
+    if (0 == _count && _current <= tickCount)
+        _current = tickCount + 1;
+
+    return result;
+}
+
+void TimerWheel::insert(Timer *timer)
+{
+    static const qint64 MAX_DELTA = (qint64(1) << (SLOT_BITS * LEVELS_COUNT)) - 1;
+
+    qint64 when = timer->_expires;
+    qint64 delta = when - _current;
+    int level = 0;
+
+    if (delta < 0)
+    {
+        // просроченный таймер срабатывает при ближайшем продвижении колеса
+        timer->_level = -1;
+        timer->_prev = nullptr;
+        timer->_next = _overdue;
+        if (_overdue)
+            _overdue->_prev = timer;
+        _overdue = timer;
+        return;
+    }
+
+    // слишком далекий таймер размещается на верхнем уровне и переносится повторно
+    if (delta > MAX_DELTA)
+    {
+        delta = MAX_DELTA;
+        when = _current + MAX_DELTA;
+    }
+    while (level < LEVELS_COUNT - 1 && delta >= (qint64(1) << (SLOT_BITS * (level + 1))))
+        level++;
+
+    int slot = int((when >> (SLOT_BITS * level)) & (SLOTS_COUNT - 1));
+
+    timer->_level = level;
+    timer->_slot = slot;
+    timer->_prev = nullptr;
+    timer->_next = _slots[level][slot];
+    if (timer->_next)
+        timer->_next->_prev = timer;
+    _slots[level][slot] = timer;
+    _occupied[level] |= quint64(1) << slot;
+}
+
+void TimerWheel::unlink(Timer *timer)
+{
+    if (timer->_prev)
+        timer->_prev->_next = timer->_next;
+    else if (timer->_level < 0)
+        _overdue = timer->_next;
+    else
+        _slots[timer->_level][timer->_slot] = timer->_next;
+
+    if (timer->_next)
+        timer->_next->_prev = timer->_prev;
+
+    if (timer->_level >= 0 && !_slots[timer->_level][timer->_slot])
+        _occupied[timer->_level] &= ~(quint64(1) << timer->_slot);
+
+    timer->_next = nullptr;
+    timer->_prev = nullptr;
+}
+
+void TimerWheel::cascade(int level, int slot)
+{
+    Timer *timer = _slots[level][slot];
+    if (!timer)
+        return;
+
+    _slots[level][slot] = nullptr;
+    _occupied[level] &= ~(quint64(1) << slot);
+
+    while (timer)
+    {
+        Timer *next = timer->_next;
+        insert(timer);
+        timer = next;
+    }
+}
+
+}}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QList>
+
+#include <cstdint>
+
+namespace Threader {
+
+namespace Threads {
+
+/**
+ * @brief TimerWheel - Иерархическое колесо таймеров
+ * Таймеры хранятся в интрузивных списках ячеек нескольких уровней по 64 ячейки
+ * с шагом в одну миллисекунду на нижнем уровне. Запуск и остановка таймера
+ * выполняются за O(1), при переходе через границу уровня таймеры верхнего уровня
+ * переносятся на нижние. Поиск занятых ячеек выполняется по битовым картам.
+ * Колесо не потокобезопасно и используется только потоком-владельцем.
+ */
+class THREADERSHARED_EXPORT TimerWheel
+{
+public:
+    /**
+     * @brief Timer - Базовый класс таймера, размещаемого в колесе
+     */
+    class THREADERSHARED_EXPORT Timer
+    {
+    public:
+        Timer() = default;
+        virtual ~Timer();
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        /**
+         * @brief expires - Получение времени срабатывания таймера
+         * @return - Время срабатывания в миллисекундах монотонного счетчика
+         */
+        qint64 expires() const;
+
+        /**
+         * @brief isActive - Получение признака нахождения таймера в колесе
+         * @return - Признак нахождения таймера в колесе
+         */
+        bool isActive() const;
+
+    private:
+        friend class TimerWheel;
+
+        Timer *_next = nullptr;
+        Timer *_prev = nullptr;
+        TimerWheel *_wheel = nullptr;
+        qint64 _expires = 0;
+        int _level = 0;
+        int _slot = 0;
+    };
+
+    using TimersList = QList<Timer*>;
+
+public:
+    /**
+     * @brief TimerWheel - Конструктор
+     * @param tickCount - Начальное время колеса в миллисекундах монотонного счетчика
+     */
+    explicit TimerWheel(qint64 tickCount = 0);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /**
+     * @brief start - Запуск или перезапуск таймера
+     * @param timer - Таймер
+     * @param expires - Время срабатывания в миллисекундах монотонного счетчика
+     */
+    void start(Timer *timer, qint64 expires);
+
+    /**
+     * @brief stop - Остановка таймера
+     * @param timer - Таймер
+     * @return - Признак нахождения таймера в колесе до остановки
+     */
+    bool stop(Timer *timer);
+
+    /**
+     * @brief count - Получение количества таймеров в колесе
+     * @return - Количество таймеров
+     */
+    int count() const;
+
+    /**
+     * @brief nextDeadline - Получение времени ближайшего события колеса
+     * Возвращаемое время не превышает время срабатывания ближайшего таймера:
+     * это либо оно само, либо время переноса таймеров с верхнего уровня
+     * @return - Время в миллисекундах монотонного счетчика или -1, если колесо пусто
+     */
+    qint64 nextDeadline() const;
+
+    /**
+     * @brief expire - Продвижение колеса и извлечение сработавших таймеров
+     * @param tickCount - Текущее время в миллисекундах монотонного счетчика
+     * @param expired - Список, в который добавляются сработавшие таймеры
+     * @return - Количество сработавших таймеров
+     */
+    int expire(qint64 tickCount, TimersList &expired);
+
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS_COUNT = 1 << SLOT_BITS;
+    static const int LEVELS_COUNT = 6;
+
+    /**
+     * @brief insert - Размещение таймера в ячейке по его времени срабатывания
+     * @param timer - Таймер
+     */
+    void insert(Timer *timer);
+
+    /**
+     * @brief unlink - Извлечение таймера из ячейки
+     * @param timer - Таймер
+     */
+    void unlink(Timer *timer);
+
+    /**
+     * @brief cascade - Перенос таймеров ячейки верхнего уровня на нижние уровни
+     * @param level - Уровень
+     * @param slot - Ячейка
+     */
+    void cascade(int level, int slot);
+
+    /**
+     * @brief _slots - Головы списков таймеров ячеек
+     */
+    Timer *_slots[LEVELS_COUNT][SLOTS_COUNT];
+
+    /**
+     * @brief _occupied - Битовые карты занятых ячеек уровней
+     */
+    quint64 _occupied[LEVELS_COUNT];
+
+    /**
+     * @brief _overdue - Список таймеров, запущенных с уже прошедшим временем срабатывания
+     */
+    Timer *_overdue;
+
+    /**
+     * @brief _current - Следующая необработанная миллисекунда колеса
+     */
+    qint64 _current;
+
+    /**
+     * @brief _count - Количество таймеров в колесе
+     */
+    int _count;
+};
+
+}}
@@ -2,34 +2,29 @@
 
 #include "LogMessagesTemplates.h"
 #include "../Utils/DateUtils.h"
+#include "../Utils/SlabAllocator.h"
 
 #include <QCoreApplication>
 #include <QDir>
-#include <QTextCodec>
-
-#include <iostream>
 
 
 namespace Threader {
 
 namespace Threads {
 
-#define ANSI_COLOR_RED     "\x1b[31m"
-#define ANSI_COLOR_GREEN   "\x1b[32m"
-#define ANSI_COLOR_YELLOW  "\x1b[33m"
-#define ANSI_COLOR_BLUE    "\x1b[34m"
-#define ANSI_COLOR_MAGENTA "\x1b[35m"
-#define ANSI_COLOR_CYAN    "\x1b[36m"
-#define ANSI_COLOR_RESET   "\x1b[0m"
+// начальная емкость буфера накопления строк протокола
+#define LOG_BUFFER_CAPACITY (1024 * 256)
 
 
 WriterLog::WriterLog(bool doConsoleOutput,
                      const QString &pathToLog,
                      int logLevel)
-    : _logBuffer("")
-    , _doConsoleOutput(doConsoleOutput)
+    : _doConsoleOutput(doConsoleOutput)
     , _logLevel(logLevel)
+    , _writeErrorsReported(0)
 {
+    // буфер с зарезервированной емкостью сохраняет ее при обмене с потоком записи
+    _logBuffer.reserve(LOG_BUFFER_CAPACITY);
     // инициализация нулевого времени
     _currentLogFileDate.setDate(2014, 3, 21);
     // префикс имени файла протокола
@@ -39,20 +34,14 @@ WriterLog::WriterLog(bool doConsoleOutput,
     // формирование пути к файлам
     QDir path = QDir(pathToLog);
     _pathToLog = path.absolutePath();
-#ifdef Q_OS_WIN
-    _consoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
-    _codec = QTextCodec::codecForName("cp866");
-#endif
+
+    if (_doConsoleOutput)
+        _consoleSink.reset(new LogConsoleSink());
 }
 
 WriterLog::~WriterLog()
 {
-#ifdef Q_OS_WIN
-    if (_codec)
-    {
-        _codec = nullptr;
-    }
-#endif
+    logClose();
 }
 
 QString WriterLog::getLogFileName(const QString &pathToLog,
@@ -74,103 +63,54 @@ QString WriterLog::logCheckPath()
     return _pathToLog;
 }
 
-void WriterLog::logPrint(const MessageLog::Ptr &message)
+void WriterLog::logPrint(MessageType messageType, const QString &messageString)
 {
-    QString messageString = message->toString() + "\r\n";
-
-#ifdef Q_OS_LINUX
-    QString colorString;
-    switch (message->messageType()) {
-    case Warning:
-        colorString = ANSI_COLOR_YELLOW;
-        break;
-    case Error:
-        colorString = ANSI_COLOR_RED;
-        break;
-    case Debug:
-        colorString = ANSI_COLOR_BLUE;
-        break;
-    default:
-        colorString = ANSI_COLOR_RESET;
-        break;
-    }
-    std::cout << colorString.toStdString() << messageString.toStdString();
-#endif
-#ifdef Q_OS_WIN
-    uint8_t color;
-    switch (message->messageType()) {
-    case Message:
-        color = 15;
-        break;
-    case Warning:
-        color = 14;
-        break;
-    case Error:
-        color = 12;
-        break;
-    case Debug:
-        color = 6;
-        break;
-    default:
-        color = 15;
-    }
-    if (INVALID_HANDLE_VALUE != _consoleHandle)
-        SetConsoleTextAttribute(_consoleHandle, color);
-
-    if (_codec)
-    {
-        QByteArray dosString = _codec->fromUnicode(messageString.toUtf8());
-        std::cout << dosString.constData();
-    }
-#endif
+    // консоль не задерживает поток протоколирования, при заполнении очереди строка отбрасывается
+    if (_consoleSink)
+        _consoleSink->print(messageType, messageString);
 }
 
 void WriterLog::logRecreateFile()
 {
-    // закрытие файла, если файл открыт
-    if (_currentLogFile.isOpen())
-        _currentLogFile.close();
-
     // создание подкаталога
     auto pathToLog = logCheckPath();
 
-    // формирование имени файла
-    auto logFileName = getLogFileName(pathToLog, QCoreApplication::applicationName(), _currentLogFileDate);
-
-    // установка нового имени
-    _currentLogFile.setFileName(logFileName);
-    // создание и открытие файла
-    _currentLogFile.open(QIODevice::ReadWrite | QIODevice::Text | QIODevice::Append);
+    // формирование имени файла, файл открывается потоком записи при получении данных
+    _currentLogFileName = getLogFileName(pathToLog, QCoreApplication::applicationName(),
+                                         _currentLogFileDate);
 }
 
 void WriterLog::logFlushBuffer()
 {
-    // если нечего сбрасывать или файл закрыт, то курить бамбук
-    if (_logBuffer.isEmpty() || !_currentLogFile.isOpen())
+    // если нечего сбрасывать, то курить бамбук
+    if (_logBuffer.isEmpty() || _currentLogFileName.isEmpty())
         return;
 
-    // перевод в UTF8
-    auto bufferUtf8 = _logBuffer.toUtf8();
-    qint64 bufferSize = bufferUtf8.size();
-    // запись накопленных данных
-    qint64 writtenCount = _currentLogFile.write(bufferUtf8);
+    // передача накопленных данных потоку записи в обмен на освобожденный буфер
+    _fileWriter.submit(_currentLogFileName, _logBuffer, LogFileWriter::WriteMode::Log);
 
-    // обработка
-    if (bufferSize > writtenCount)
+    // ошибки записи обнаруживаются потоком записи, который повторно открывает файл
+    quint64 writeErrors = _fileWriter.writeErrors();
+    if (writeErrors != _writeErrorsReported)
     {
-        // удаление из буфера записанных данных
-        _logBuffer.remove(0, int(writtenCount));
-        // повторное открытие файла
-        logRecreateFile();
-        // запись оставшихся данных
-        _currentLogFile.write(_logBuffer.toUtf8());
-
-        doMessageLog(std::make_shared<MessageLog>(Message3));
+        _writeErrorsReported = writeErrors;
+        doMessageLog(Utils::makeSlabShared<MessageLog>(Message3));
     }
-    // сброс буфера файла на диск
-    _currentLogFile.flush();
-    // очистка накопленных данных
-    _logBuffer.clear();
+}
+
+void WriterLog::logClose()
+{
+    // запись оставшихся данных и закрытие файлов
+    _fileWriter.stop();
+    if (_consoleSink)
+        _consoleSink->stop();
+}
+
+void WriterLog::applyLogSettings(const LogSettings &settings)
+{
+    _fileWriter.setRotation(settings.rotation());
+    if (_consoleSink)
+        _consoleSink->setMaximumLines(settings.consoleMaximumLines());
 }
 
 void WriterLog::doMessageLog(const MessageLog::Ptr &message)
@@ -178,16 +118,25 @@ void WriterLog::doMessageLog(const MessageLog::Ptr &message)
     if (!message)
         return;
 
-    if (message->level() > _logLevel)
+    doLogLine(message->created(), message->messageType(), message->number(), message->level(),
+              message->text());
+}
+
+void WriterLog::doLogLine(const QDateTime &created, MessageType messageType, int number, int level,
+                          const QString &text)
+{
+    if (level > _logLevel)
         return;
 
+    QString messageString = MessageLog::format(created, messageType, number, text);
+
     // при установленном выводе на консоль
     if (_doConsoleOutput)
         // вывод на консоль
-        logPrint(message);
+        logPrint(messageType, messageString + "\r\n");
 
     // получение даты сообщения протоколирования
-    QDate currentMessageDate = message->created().date();
+    QDate currentMessageDate = created.date();
 
     // если дата сообщения не совпадает с датой предыдущего сообщения
     if (_currentLogFileDate != currentMessageDate)
@@ -203,7 +152,7 @@ void WriterLog::doMessageLog(const MessageLog::Ptr &message)
     }
 
     // накопление сообщений в буфер
-    _logBuffer.append(message->toString());
+    _logBuffer.append(messageString.toUtf8());
     _logBuffer.append("\r\n");
 }
 
@@ -217,24 +166,13 @@ void WriterLog::doMessageRewriteFile(const MessageWriteToFile::Ptr &message)
 
     // формирование имени файла
     QString fileName = pathToLog + QDir::separator() + message->fileName();
-    // установка имени файла
-    QFile file(fileName);
-
-    QFile::OpenMode openMode = (message->writeMode() == MessageWriteToFile::WriteMode::Truncate)
-            ? QIODevice::ReadWrite | QIODevice::Text | QIODevice::Truncate
-            : QIODevice::ReadWrite | QIODevice::Text | QIODevice::Append;
-    // создание и открытие файла
-    if (file.open(openMode))
-    {
-        if (message->writeMode() == MessageWriteToFile::WriteMode::Append)
-            file.seek(file.size());
-        // запись данных
-        file.write(message->text().toUtf8());
-        // закрытие файла
-        file.flush();
-        file.close();
-        //std::cout << message->text().toStdString();
-    }
+
+    // файл удерживается открытым потоком записи между сообщениями
+    QByteArray data = message->text().toUtf8();
+    _fileWriter.submit(fileName, data,
+                       (message->writeMode() == MessageWriteToFile::WriteMode::Truncate)
+                       ? LogFileWriter::WriteMode::Truncate
+                       : LogFileWriter::WriteMode::Append);
 }
 
 int WriterLog::getLevel()
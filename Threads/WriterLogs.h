@@ -2,23 +2,30 @@
 
 #include "MessageBase.h"
 
+#include "LogConsoleSink.h"
+#include "LogFileWriter.h"
+#include "LogSettings.h"
 #include "MessageLog.h"
 #include "MessageWriteToFile.h"
 
 #include "../threader_global.h"
 
-#include <QFile>
+#include <QByteArray>
+#include <QDate>
 #include <QString>
 
-#ifdef Q_OS_WIN
-#include <windows.h>
-#endif
+#include <memory>
 
 namespace Threader {
 
 namespace Threads {
 
 
+/**
+ * @brief WriterLog - Формирование файла протокола
+ * Строки накапливаются в буфере в UTF-8, запись на диск и вывод на консоль
+ * выполняются отдельными потоками (LogFileWriter, LogConsoleSink)
+ */
 class THREADERSHARED_EXPORT WriterLog
 {
 public:
@@ -32,17 +39,21 @@ public:
                                   const QDate &logFileDate);
 protected:
     QString logCheckPath();
-    void logPrint(const MessageLog::Ptr& message);
+    void logPrint(MessageType messageType, const QString &messageString);
     void logRecreateFile();
     virtual void logFlushBuffer();
+    void logClose();
+    void applyLogSettings(const LogSettings &settings);
     void doMessageLog(const MessageLog::Ptr& message);
+    void doLogLine(const QDateTime &created, MessageType messageType, int number, int level,
+                   const QString &text);
     void doMessageRewriteFile(const MessageWriteToFile::Ptr& message);
     int getLevel();
     void setLevel(const int &level);
 
 protected:
-    QFile _currentLogFile;
-    QString _logBuffer;
+    QString _currentLogFileName;
+    QByteArray _logBuffer;
 
 private:
     bool _doConsoleOutput;
@@ -50,10 +61,10 @@ private:
     QDate _currentLogFileDate;
     QString _pathToLog;
     int _logLevel;
-#ifdef Q_OS_WIN
-    HANDLE _consoleHandle;
-    QTextCodec *_codec;
-#endif
+
+    LogFileWriter _fileWriter;
+    std::unique_ptr<LogConsoleSink> _consoleSink;
+    quint64 _writeErrorsReported;
 };
 
 
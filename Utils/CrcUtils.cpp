@@ -2,6 +2,13 @@
 
 #include <QFile>
 
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC_UTILS_CLMUL
+#include <immintrin.h>
+#endif
+
 namespace Threader {
 
 namespace Utils {
@@ -148,6 +155,302 @@ const quint32 crc32_table[BUFSIZE] =
     0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
 };
 
+// минимальная длина данных, с которой выгодна свертка умножением без переноса
+const size_t CLMUL_MINIMUM_LENGTH = 64;
+
+/**
+ * @brief CrcTables - Таблицы и константы ускоренного вычисления контрольных сумм
+ * Таблицы срезов строятся из исходных побайтовых таблиц при первом обращении
+ */
+struct CrcTables
+{
+    CrcTables();
+
+    uint16_t crc16[8][256];
+    uint32_t crc32[8][256];
+
+    // константы свертки на 128 и 512 бит: [0] - младшая половина, [1] - старшая
+    quint64 crc16Fold128[2];
+    quint64 crc16Fold512[2];
+    quint64 crc32Fold128[2];
+    quint64 crc32Fold512[2];
+
+    bool clmulSupported;
+};
+
+// остаток от деления x^power на полином в обычном (не отраженном) порядке бит
+static quint64 xPowerModulo(int power, quint64 polynomial, int width)
+{
+    const quint64 top = quint64(1) << width;
+    quint64 result = 1;
+    for (int i = 0; i < power; i++)
+    {
+        result <<= 1;
+        if (result & top)
+            result ^= top | polynomial;
+    }
+    return result;
+}
+
+static quint64 reflect64(quint64 value)
+{
+    quint64 result = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        result = (result << 1) | (value & 1);
+        value >>= 1;
+    }
+    return result;
+}
+
+CrcTables::CrcTables()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        crc16[0][i] = crc16_table[i];
+        crc32[0][i] = crc32_table[i];
+    }
+
+    // таблица среза k - значение байта, за которым следуют k нулевых байт
+    for (int k = 1; k < 8; k++)
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            crc16[k][i] = uint16_t(crc16[k - 1][i] << 8) ^ crc16[0][crc16[k - 1][i] >> 8];
+            crc32[k][i] = (crc32[k - 1][i] >> 8) ^ crc32[0][crc32[k - 1][i] & 0xFF];
+        }
+    }
+
+    // CRC-16/CCITT: старшая половина блока умножается на x^(d+64), младшая - на x^d
+    crc16Fold128[0] = xPowerModulo(128, 0x1021, 16);
+    crc16Fold128[1] = xPowerModulo(128 + 64, 0x1021, 16);
+    crc16Fold512[0] = xPowerModulo(512, 0x1021, 16);
+    crc16Fold512[1] = xPowerModulo(512 + 64, 0x1021, 16);
+
+    // CRC-32 в отраженном порядке: младшая половина блока содержит старшие степени,
+    // а произведение отраженных операндов дает дополнительный множитель x
+    crc32Fold128[0] = reflect64(xPowerModulo(128 + 63, 0x04C11DB7, 32));
+    crc32Fold128[1] = reflect64(xPowerModulo(128 - 1, 0x04C11DB7, 32));
+    crc32Fold512[0] = reflect64(xPowerModulo(512 + 63, 0x04C11DB7, 32));
+    crc32Fold512[1] = reflect64(xPowerModulo(512 - 1, 0x04C11DB7, 32));
+
+#ifdef CRC_UTILS_CLMUL
+    __builtin_cpu_init();
+    clmulSupported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#else
+    clmulSupported = false;
+#endif
+}
+
+static const CrcTables &crcTables()
+{
+    static const CrcTables tables;
+    return tables;
+}
+
+static uint16_t crc16Bytewise(uint16_t crc, const uint8_t *data, size_t length)
+{
+    while (length--)
+        crc = uint16_t(crc << 8) ^ crc16_table[(crc >> 8) ^ *data++];
+    return crc;
+}
+
+static uint16_t crc16SliceBy8(uint16_t crc, const uint8_t *data, size_t length)
+{
+    const CrcTables &tables = crcTables();
+
+    while (length >= 8)
+    {
+        crc ^= uint16_t((data[0] << 8) | data[1]);
+        crc = tables.crc16[7][crc >> 8] ^ tables.crc16[6][crc & 0xFF]
+                ^ tables.crc16[5][data[2]] ^ tables.crc16[4][data[3]]
+                ^ tables.crc16[3][data[4]] ^ tables.crc16[2][data[5]]
+                ^ tables.crc16[1][data[6]] ^ tables.crc16[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    return crc16Bytewise(crc, data, length);
+}
+
+static uint32_t crc32Bytewise(uint32_t crc, const uint8_t *data, size_t length)
+{
+    while (length--)
+        crc = (crc >> 8) ^ crc32_table[(crc ^ *data++) & 0xFF];
+    return crc;
+}
+
+static uint32_t crc32SliceBy8(uint32_t crc, const uint8_t *data, size_t length)
+{
+    const CrcTables &tables = crcTables();
+
+    while (length >= 8)
+    {
+        crc ^= uint32_t(data[0]) | (uint32_t(data[1]) << 8)
+                | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+        crc = tables.crc32[7][crc & 0xFF] ^ tables.crc32[6][(crc >> 8) & 0xFF]
+                ^ tables.crc32[5][(crc >> 16) & 0xFF] ^ tables.crc32[4][crc >> 24]
+                ^ tables.crc32[3][data[4]] ^ tables.crc32[2][data[5]]
+                ^ tables.crc32[1][data[6]] ^ tables.crc32[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    return crc32Bytewise(crc, data, length);
+}
+
+#ifdef CRC_UTILS_CLMUL
+
+#define CRC_UTILS_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+
+// свертка блока: половины блока умножаются на соответствующие константы
+CRC_UTILS_CLMUL_TARGET
+static inline __m128i foldBlock(__m128i block, __m128i constants)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(block, constants, 0x00),
+                         _mm_clmulepi64_si128(block, constants, 0x11));
+}
+
+CRC_UTILS_CLMUL_TARGET
+static inline __m128i loadBlock(const uint8_t *data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+CRC_UTILS_CLMUL_TARGET
+static inline __m128i loadBlock(const uint8_t *data, __m128i reverse)
+{
+    return _mm_shuffle_epi8(loadBlock(data), reverse);
+}
+
+// данные сворачиваются до одного блока, сравнимого с ними по модулю полинома,
+// после чего контрольная сумма блока и остатка данных досчитывается по таблицам
+CRC_UTILS_CLMUL_TARGET
+static uint16_t crc16Clmul(uint16_t crc, const uint8_t *data, size_t length)
+{
+    const CrcTables &tables = crcTables();
+    // CRC-16/CCITT считается от старшего бита: байты блока переставляются
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i fold512 = _mm_set_epi64x(qint64(tables.crc16Fold512[1]), qint64(tables.crc16Fold512[0]));
+    const __m128i fold128 = _mm_set_epi64x(qint64(tables.crc16Fold128[1]), qint64(tables.crc16Fold128[0]));
+
+    __m128i x0 = _mm_xor_si128(loadBlock(data, reverse), _mm_set_epi64x(qint64(quint64(crc) << 48), 0));
+    __m128i x1 = loadBlock(data + 16, reverse);
+    __m128i x2 = loadBlock(data + 32, reverse);
+    __m128i x3 = loadBlock(data + 48, reverse);
+    data += 64;
+    length -= 64;
+
+    while (length >= 64)
+    {
+        x0 = _mm_xor_si128(foldBlock(x0, fold512), loadBlock(data, reverse));
+        x1 = _mm_xor_si128(foldBlock(x1, fold512), loadBlock(data + 16, reverse));
+        x2 = _mm_xor_si128(foldBlock(x2, fold512), loadBlock(data + 32, reverse));
+        x3 = _mm_xor_si128(foldBlock(x3, fold512), loadBlock(data + 48, reverse));
+        data += 64;
+        length -= 64;
+    }
+
+    __m128i x = _mm_xor_si128(foldBlock(x0, fold128), x1);
+    x = _mm_xor_si128(foldBlock(x, fold128), x2);
+    x = _mm_xor_si128(foldBlock(x, fold128), x3);
+
+    while (length >= 16)
+    {
+        x = _mm_xor_si128(foldBlock(x, fold128), loadBlock(data, reverse));
+        data += 16;
+        length -= 16;
+    }
+
+    alignas(16) uint8_t block[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(block), _mm_shuffle_epi8(x, reverse));
+
+    crc = crc16SliceBy8(0, block, sizeof(block));
+    return crc16SliceBy8(crc, data, length);
+}
+
+CRC_UTILS_CLMUL_TARGET
+static uint32_t crc32Clmul(uint32_t crc, const uint8_t *data, size_t length)
+{
+    const CrcTables &tables = crcTables();
+    const __m128i fold512 = _mm_set_epi64x(qint64(tables.crc32Fold512[1]), qint64(tables.crc32Fold512[0]));
+    const __m128i fold128 = _mm_set_epi64x(qint64(tables.crc32Fold128[1]), qint64(tables.crc32Fold128[0]));
+
+    __m128i x0 = _mm_xor_si128(loadBlock(data), _mm_cvtsi32_si128(int(crc)));
+    __m128i x1 = loadBlock(data + 16);
+    __m128i x2 = loadBlock(data + 32);
+    __m128i x3 = loadBlock(data + 48);
+    data += 64;
+    length -= 64;
+
+    while (length >= 64)
+    {
+        x0 = _mm_xor_si128(foldBlock(x0, fold512), loadBlock(data));
+        x1 = _mm_xor_si128(foldBlock(x1, fold512), loadBlock(data + 16));
+        x2 = _mm_xor_si128(foldBlock(x2, fold512), loadBlock(data + 32));
+        x3 = _mm_xor_si128(foldBlock(x3, fold512), loadBlock(data + 48));
+        data += 64;
+        length -= 64;
+    }
+
+    __m128i x = _mm_xor_si128(foldBlock(x0, fold128), x1);
+    x = _mm_xor_si128(foldBlock(x, fold128), x2);
+    x = _mm_xor_si128(foldBlock(x, fold128), x3);
+
+    while (length >= 16)
+    {
+        x = _mm_xor_si128(foldBlock(x, fold128), loadBlock(data));
+        data += 16;
+        length -= 16;
+    }
+
+    alignas(16) uint8_t block[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(block), x);
+
+    crc = crc32SliceBy8(0, block, sizeof(block));
+    return crc32SliceBy8(crc, data, length);
+}
+
+#endif
+
+static std::atomic<int> &selectedKernel()
+{
+    static std::atomic<int> kernel(int(crcTables().clmulSupported
+                                       ? CrcUtils::CrcKernel::Clmul
+                                       : CrcUtils::CrcKernel::SliceBy8));
+    return kernel;
+}
+
+static uint16_t crc16Update(uint16_t crc, const uint8_t *data, size_t length)
+{
+    switch (CrcUtils::CrcKernel(selectedKernel().load(std::memory_order_relaxed))) {
+    case CrcUtils::CrcKernel::Bytewise:
+        return crc16Bytewise(crc, data, length);
+    case CrcUtils::CrcKernel::Clmul:
+#ifdef CRC_UTILS_CLMUL
+        if (length >= CLMUL_MINIMUM_LENGTH)
+            return crc16Clmul(crc, data, length);
+#endif
+        return crc16SliceBy8(crc, data, length);
+    default:
+        return crc16SliceBy8(crc, data, length);
+    }
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    switch (CrcUtils::CrcKernel(selectedKernel().load(std::memory_order_relaxed))) {
+    case CrcUtils::CrcKernel::Bytewise:
+        return crc32Bytewise(crc, data, length);
+    case CrcUtils::CrcKernel::Clmul:
+#ifdef CRC_UTILS_CLMUL
+        if (length >= CLMUL_MINIMUM_LENGTH)
+            return crc32Clmul(crc, data, length);
+#endif
+        return crc32SliceBy8(crc, data, length);
+    default:
+        return crc32SliceBy8(crc, data, length);
+    }
+}
+
 unsigned char CrcUtils::Crc8(const unsigned char *pcBlock, unsigned char len)
 {
     // мы ничего не меняем в данных, нам нужно просто по ним пробежать
@@ -164,34 +467,40 @@ uint16_t CrcUtils::Crc16(uint16_t start,
                          const int count)
 {
     if (count > 0)
-    {
-        for(int i = 0; i < count; i++)
-            start = uint16_t(start << 8) ^ crc16_table[(start >> 8) ^ data[i]];
-    }
+        start = crc16Update(start, data, size_t(count));
     return start;
 }
 
 uint16_t CrcUtils::Crc16(uint8_t *data,
                          uint16_t length)
 {
-    unsigned short crc = 0xFFFF;
+    return crc16Update(0xFFFF, data, length);
+}
 
-    while (length--)
-        crc = (crc << 8) ^ crc16_table[(crc >> 8) ^ *data++];
+uint32_t CrcUtils::Crc32(uint8_t *data, uint32_t length)
+{
+    return crc32Update(0xFFFFFFFFUL, data, length) ^ 0xFFFFFFFFUL;
+}
 
-    return crc;
+CrcUtils::CrcKernel CrcUtils::kernel()
+{
+    return CrcKernel(selectedKernel().load(std::memory_order_relaxed));
 }
 
-uint32_t CrcUtils::Crc32(uint8_t *data, uint32_t length)
+bool CrcUtils::isKernelSupported(CrcUtils::CrcKernel kernel)
 {
-    uint32_t crc32 = 0xFFFFFFFFUL;
+    if (CrcKernel::Clmul == kernel)
+        return crcTables().clmulSupported;
+    return true;
+}
 
-    for (uint32_t i = 0; i < length; i++)
-    {
-        crc32 = (crc32 >> 8) ^ crc32_table[(crc32 ^ data[i]) & 0xff];
-    }
+bool CrcUtils::setKernel(CrcUtils::CrcKernel kernel)
+{
+    if (!isKernelSupported(kernel))
+        return false;
 
-     return crc32 ^ 0xFFFFFFFFUL;
+    selectedKernel().store(int(kernel), std::memory_order_relaxed);
+    return true;
 }
 
 QByteArray CrcUtils::fileChecksum(const QString &fileName,
@@ -22,6 +22,20 @@ namespace Utils {
 class THREADERSHARED_EXPORT CrcUtils
 {
 public:
+    /**
+     * @brief CrcKernel - Реализация вычисления CRC-16 и CRC-32
+     * Bytewise - побайтовая таблица, SliceBy8 - таблицы срезов по 8 байт,
+     * Clmul - свертка умножением без переноса (PCLMULQDQ) для длинных данных
+     * Инструкция crc32 из SSE4.2 вычисляет только CRC-32C (Castagnoli) и не подходит
+     * для CRC-16/CCITT и CRC-32 IEEE, поэтому аппаратная реализация построена на PCLMULQDQ
+     */
+    enum class CrcKernel
+    {
+        Bytewise,
+        SliceBy8,
+        Clmul
+    };
+
     static unsigned char Crc8(const unsigned char *pcBlock,
                               unsigned char len);
 
@@ -34,6 +48,27 @@ public:
 
     static uint32_t Crc32(uint8_t *data, uint32_t length);
 
+    /**
+     * @brief kernel - Получение текущей реализации вычисления контрольных сумм
+     * По умолчанию выбирается самая быстрая реализация, поддерживаемая процессором
+     * @return - Реализация вычисления контрольных сумм
+     */
+    static CrcKernel kernel();
+
+    /**
+     * @brief setKernel - Установка реализации вычисления контрольных сумм
+     * @param kernel - Реализация вычисления контрольных сумм
+     * @return - Признак поддержки реализации процессором
+     */
+    static bool setKernel(CrcKernel kernel);
+
+    /**
+     * @brief isKernelSupported - Проверка поддержки реализации процессором
+     * @param kernel - Реализация вычисления контрольных сумм
+     * @return - Признак поддержки реализации
+     */
+    static bool isKernelSupported(CrcKernel kernel);
+
     static QByteArray fileChecksum(const QString &fileName,
                                    QCryptographicHash::Algorithm hashAlgorithm);
 
@@ -0,0 +1,114 @@
+#include "CycleClock.h"
+#include "DateUtils.h"
+
+#if defined(Q_PROCESSOR_X86)
+#if defined(Q_CC_MSVC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace Threader {
+
+namespace Utils {
+
+namespace {
+
+// продолжительность определения частоты счетчика тактов
+const qint64 CALIBRATION_NANOSECONDS = 2000000;
+
+/**
+ * @brief Calibration - Параметры перевода счетчика тактов в наносекунды
+ */
+struct Calibration
+{
+    bool IsCycleCounter = false;
+    quint64 BaseCycles = 0;
+    double NanosecondsPerCycle = 1.0;
+};
+
+#if defined(Q_PROCESSOR_X86)
+/**
+ * @brief isInvariantCounter - Проверка признака инвариантного счетчика тактов
+ * (CPUID 0x80000007, EDX бит 8)
+ */
+bool isInvariantCounter()
+{
+#if defined(Q_CC_MSVC)
+    int registers[4] = {0, 0, 0, 0};
+    __cpuid(registers, int(0x80000000));
+    if (quint32(registers[0]) < 0x80000007)
+        return false;
+    __cpuid(registers, int(0x80000007));
+    return 0 != (registers[3] & (1 << 8));
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (0 == __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+        return false;
+    return 0 != (edx & (1 << 8));
+#endif
+}
+#endif
+
+Calibration calibrateCounter()
+{
+    Calibration result;
+#if defined(Q_PROCESSOR_X86)
+    if (!isInvariantCounter())
+        return result;
+
+    // частота определяется по приращениям счетчика и монотонных часов
+    qint64 startedNanoseconds = DateUtils::getTickCountNanoseconds();
+    quint64 startedCycles = __rdtsc();
+    qint64 finishedNanoseconds = startedNanoseconds;
+    while (finishedNanoseconds - startedNanoseconds < CALIBRATION_NANOSECONDS)
+        finishedNanoseconds = DateUtils::getTickCountNanoseconds();
+    quint64 finishedCycles = __rdtsc();
+    if (finishedCycles <= startedCycles)
+        return result;
+
+    result.IsCycleCounter = true;
+    result.BaseCycles = startedCycles;
+    result.NanosecondsPerCycle = double(finishedNanoseconds - startedNanoseconds) /
+            double(finishedCycles - startedCycles);
+#endif
+    return result;
+}
+
+const Calibration &calibration()
+{
+    static const Calibration result = calibrateCounter();
+    return result;
+}
+
+}
+
+
+qint64 CycleClock::nanoseconds()
+{
+    const Calibration &current = calibration();
+#if defined(Q_PROCESSOR_X86)
+    // отсчет от начала калибровки сохраняет точность умножения на дробный множитель,
+    // а значения после калибровки не меньше ее продолжительности и всегда положительны
+    if (current.IsCycleCounter)
+        return qint64(double(qint64(__rdtsc() - current.BaseCycles)) * current.NanosecondsPerCycle);
+#endif
+    return DateUtils::getTickCountNanoseconds();
+}
+
+void CycleClock::calibrate()
+{
+    calibration();
+}
+
+bool CycleClock::isCycleCounter()
+{
+    return calibration().IsCycleCounter;
+}
+
+}}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QtGlobal>
+
+namespace Threader {
+
+namespace Utils {
+
+/**
+ * @brief CycleClock - Монотонное время в наносекундах для замеров коротких интервалов
+ * На x86 с инвариантным счетчиком тактов (постоянная частота, счет во всех
+ * состояниях питания) время вычисляется по счетчику тактов: чтение в несколько раз
+ * дешевле системных часов. Частота счетчика определяется один раз по монотонным
+ * часам за 2 мс при первом обращении. На остальных процессорах время читается
+ * из монотонных часов. Начало отсчета произвольное, значения пригодны только
+ * для вычисления интервалов внутри процесса
+ */
+class THREADERSHARED_EXPORT CycleClock
+{
+public:
+    CycleClock() = delete;
+
+    /**
+     * @brief nanoseconds - Получение текущего времени
+     * @return - Время в наносекундах от начала отсчета
+     */
+    static qint64 nanoseconds();
+
+    /**
+     * @brief calibrate - Определение частоты счетчика тактов, если оно еще не выполнено
+     * Вызывается заранее, чтобы калибровка не задержала первый замер
+     */
+    static void calibrate();
+
+    /**
+     * @brief isCycleCounter - Признак вычисления времени по счетчику тактов
+     */
+    static bool isCycleCounter();
+};
+
+}}
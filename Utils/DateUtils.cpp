@@ -47,6 +47,28 @@ qint64 DateUtils::getTickCount()
 #endif
 }
 
+qint64 DateUtils::getTickCountNanoseconds()
+{
+#ifdef Q_OS_LINUX
+    timespec ts{0, 0};
+    if (0 != clock_gettime(CLOCK_MONOTONIC, &ts))
+        return -1;
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+
+#ifdef Q_OS_WIN
+    static LARGE_INTEGER frequency = {};
+    if (0 == frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // деление по частям исключает переполнение при умножении
+    return (counter.QuadPart / frequency.QuadPart) * 1000000000 +
+            (counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#endif
+}
+
 qint64 DateUtils::getNextTickCount(uint milliseconds)
 {
     qint64 result = getTickCount();
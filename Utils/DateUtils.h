@@ -28,6 +28,12 @@ public:
     DateUtils() = default;
 
     static qint64 getTickCount();
+
+    /**
+     * @brief getTickCountNanoseconds - Получение значения монотонного счетчика в наносекундах
+     * @return - Значение счетчика
+     */
+    static qint64 getTickCountNanoseconds();
     static qint64 getNextTickCount(uint milliseconds);
     static bool setCurrenrDateTime(const QDateTime &dateTime);
 
@@ -0,0 +1,78 @@
+#include "LoopClock.h"
+#include "DateUtils.h"
+
+#include <ctime>
+
+namespace Threader {
+
+namespace Utils {
+
+std::atomic<bool> LoopClock::_coarse(false);
+std::atomic<qint64> LoopClock::_wallClockOffset(0);
+std::atomic<qint64> LoopClock::_wallClockSynced(-1);
+
+// время итерации потока, отрицательное до первого захвата
+static thread_local qint64 loopNow = -1;
+
+qint64 LoopClock::update()
+{
+    loopNow = read();
+    return loopNow;
+}
+
+qint64 LoopClock::now()
+{
+    return (loopNow < 0) ? read() : loopNow;
+}
+
+qint64 LoopClock::read()
+{
+#ifdef Q_OS_LINUX
+    if (_coarse.load(std::memory_order_relaxed))
+    {
+        timespec ts{0, 0};
+        if (0 == clock_gettime(CLOCK_MONOTONIC_COARSE, &ts))
+            return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    }
+#endif
+    // на Windows счетчик GetTickCount64 и так имеет дискретность системного таймера
+    return DateUtils::getTickCount();
+}
+
+void LoopClock::setCoarse(bool coarse)
+{
+    _coarse.store(coarse, std::memory_order_relaxed);
+    // смещение пересчитывается по часам нового режима
+    _wallClockSynced.store(-1, std::memory_order_relaxed);
+}
+
+bool LoopClock::isCoarse()
+{
+    return _coarse.load(std::memory_order_relaxed);
+}
+
+qint64 LoopClock::toMSecsSinceEpoch(qint64 tickCount)
+{
+    qint64 synced = _wallClockSynced.load(std::memory_order_relaxed);
+    if (synced < 0 || tickCount - synced >= WALL_CLOCK_RESYNC_MILLISECONDS)
+    {
+        // одновременный пересчет в нескольких потоках дает одинаковый результат
+        qint64 tickCountNow = read();
+        _wallClockOffset.store(QDateTime::currentMSecsSinceEpoch() - tickCountNow,
+                               std::memory_order_relaxed);
+        _wallClockSynced.store(tickCountNow, std::memory_order_relaxed);
+    }
+    return tickCount + _wallClockOffset.load(std::memory_order_relaxed);
+}
+
+QDateTime LoopClock::toDateTimeUtc(qint64 tickCount)
+{
+    return QDateTime::fromMSecsSinceEpoch(toMSecsSinceEpoch(tickCount), Qt::UTC);
+}
+
+qint64 LoopClock::currentMSecsSinceEpoch()
+{
+    return toMSecsSinceEpoch(now());
+}
+
+}}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QDateTime>
+
+#include <atomic>
+
+namespace Threader {
+
+namespace Utils {
+
+/**
+ * @brief LoopClock - Время итерации цикла потока
+ * Поток с циклом событий захватывает значение монотонного счетчика один раз
+ * за итерацию (update), а все внутренние потребители времени итерации читают
+ * запомненное значение (now) без обращения к системным часам. Поток, не
+ * выполнявший захват, получает при каждом обращении текущее значение счетчика.
+ * В грубом режиме на Linux счетчик читается из CLOCK_MONOTONIC_COARSE: чтение
+ * дешевле, но дискретность равна периоду системного таймера (1-4 мс).
+ * Перевод в календарное время выполняется по смещению, которое кешируется
+ * для всех потоков и обновляется раз в секунду
+ */
+class THREADERSHARED_EXPORT LoopClock
+{
+public:
+    LoopClock() = delete;
+
+    /**
+     * @brief update - Захват времени итерации текущего потока
+     * @return - Значение монотонного счетчика в миллисекундах
+     */
+    static qint64 update();
+
+    /**
+     * @brief now - Получение времени итерации текущего потока
+     * @return - Значение монотонного счетчика в миллисекундах
+     */
+    static qint64 now();
+
+    /**
+     * @brief read - Чтение монотонного счетчика в выбранном режиме без захвата
+     * @return - Значение монотонного счетчика в миллисекундах
+     */
+    static qint64 read();
+
+    /**
+     * @brief setCoarse - Установка режима грубого чтения счетчика для всех потоков
+     * @param coarse - Признак грубого режима
+     */
+    static void setCoarse(bool coarse);
+    static bool isCoarse();
+
+    /**
+     * @brief toMSecsSinceEpoch - Перевод значения монотонного счетчика в календарное время
+     * @param tickCount - Значение монотонного счетчика в миллисекундах
+     * @return - Количество миллисекунд от начала эпохи (UTC)
+     */
+    static qint64 toMSecsSinceEpoch(qint64 tickCount);
+
+    /**
+     * @brief toDateTimeUtc - Перевод значения монотонного счетчика в дату и время UTC
+     * @param tickCount - Значение монотонного счетчика в миллисекундах
+     * @return - Дата и время UTC
+     */
+    static QDateTime toDateTimeUtc(qint64 tickCount);
+
+    /**
+     * @brief currentMSecsSinceEpoch - Получение календарного времени итерации текущего потока
+     * @return - Количество миллисекунд от начала эпохи (UTC)
+     */
+    static qint64 currentMSecsSinceEpoch();
+
+private:
+    static const qint64 WALL_CLOCK_RESYNC_MILLISECONDS = 1000;
+
+    /**
+     * @brief _coarse - Признак грубого режима чтения счетчика
+     */
+    static std::atomic<bool> _coarse;
+
+    /**
+     * @brief _wallClockOffset - Смещение календарного времени относительно счетчика
+     */
+    static std::atomic<qint64> _wallClockOffset;
+
+    /**
+     * @brief _wallClockSynced - Значение счетчика при последнем вычислении смещения
+     */
+    static std::atomic<qint64> _wallClockSynced;
+};
+
+}}
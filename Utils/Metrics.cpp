@@ -0,0 +1,379 @@
+#include "Metrics.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <limits>
+
+namespace Threader {
+
+namespace Utils {
+
+
+namespace {
+
+struct MetricsRegistry
+{
+    QMutex Mutex;
+    QVector<std::weak_ptr<MetricBase>> Metrics;
+    int PruneCount = 64;
+};
+
+/**
+ * @brief collectMetrics - Получение действующих метрик с удалением освобожденных
+ * Вызывается под блокировкой реестра
+ */
+QVector<MetricBase::Ptr> collectMetrics(MetricsRegistry &registry)
+{
+    QVector<MetricBase::Ptr> result;
+    result.reserve(registry.Metrics.count());
+
+    int alive = 0;
+    for (int i = 0; i < registry.Metrics.count(); i++)
+    {
+        MetricBase::Ptr metric = registry.Metrics.at(i).lock();
+        if (!metric)
+            continue;
+        registry.Metrics[alive++] = registry.Metrics.at(i);
+        result.append(metric);
+    }
+    registry.Metrics.resize(alive);
+    registry.PruneCount = qMax(64, alive * 2);
+    return result;
+}
+
+MetricsRegistry &metricsRegistry()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief MetricSeries - Ряд семейства метрик, собранный при формировании снимка
+ */
+struct MetricSeries
+{
+    QString Labels;
+    qint64 Value = 0;
+    MetricHistogramSnapshot Histogram;
+};
+
+struct MetricFamily
+{
+    QString Name;
+    QString Help;
+    MetricKind Kind;
+    QVector<MetricSeries> Series;
+    QHash<QString, int> SeriesIndex;
+};
+
+const char *kindName(MetricKind kind)
+{
+    switch (kind) {
+    case MetricKind::Counter:
+        return "counter";
+    case MetricKind::Gauge:
+        return "gauge";
+    case MetricKind::Histogram:
+        return "histogram";
+    }
+    return "untyped";
+}
+
+QByteArray seriesLabels(const QString &labels, const QByteArray &le = QByteArray())
+{
+    if (labels.isEmpty() && le.isEmpty())
+        return QByteArray();
+
+    QByteArray result = "{" + labels.toUtf8();
+    if (!le.isEmpty())
+        result += (labels.isEmpty() ? "" : ",") + QByteArray("le=\"") + le + "\"";
+    return result + "}";
+}
+
+void mergeSeries(MetricSeries &series, const MetricBase &metric)
+{
+    switch (metric.kind()) {
+    case MetricKind::Counter:
+        series.Value += qint64(static_cast<const MetricCounter&>(metric).value());
+        break;
+    case MetricKind::Gauge:
+        series.Value += static_cast<const MetricGauge&>(metric).value();
+        break;
+    case MetricKind::Histogram:
+    {
+        MetricHistogramSnapshot snapshot = static_cast<const MetricHistogram&>(metric).snapshot();
+        if (series.Histogram.Buckets.isEmpty())
+        {
+            series.Histogram = snapshot;
+            break;
+        }
+        series.Histogram.Count += snapshot.Count;
+        series.Histogram.Sum += snapshot.Sum;
+        for (int i = 0; i < snapshot.Buckets.count(); i++)
+            series.Histogram.Buckets[i] += snapshot.Buckets.at(i);
+        break;
+    }
+    }
+}
+
+void writeHistogram(QByteArray &result, const QByteArray &name, const MetricSeries &series)
+{
+    const QVector<quint64> &buckets = series.Histogram.Buckets;
+    int lastBucket = buckets.count() - 1;
+    while (lastBucket > 0 && 0 == buckets.at(lastBucket))
+        lastBucket--;
+
+    // интервалы объединяются по степеням двойки до последнего непустого интервала
+    quint64 cumulative = 0;
+    for (int i = 0; i < buckets.count(); i++)
+    {
+        cumulative += buckets.at(i);
+        qint64 upperBound = MetricHistogram::bucketUpperBound(i);
+        if (upperBound <= 0 || 0 != (upperBound & (upperBound - 1)))
+            continue;
+
+        result += name + "_bucket" + seriesLabels(series.Labels, QByteArray::number(upperBound)) +
+                " " + QByteArray::number(cumulative) + "\n";
+        if (i >= lastBucket)
+            break;
+    }
+    result += name + "_bucket" + seriesLabels(series.Labels, "+Inf") +
+            " " + QByteArray::number(series.Histogram.Count) + "\n";
+    result += name + "_sum" + seriesLabels(series.Labels) +
+            " " + QByteArray::number(series.Histogram.Sum) + "\n";
+    result += name + "_count" + seriesLabels(series.Labels) +
+            " " + QByteArray::number(series.Histogram.Count) + "\n";
+}
+
+}
+
+
+MetricBase::MetricBase(MetricKind kind,
+                       const QString &name,
+                       const QString &help,
+                       const QString &labels)
+    : _kind(kind)
+    , _name(name)
+    , _help(help)
+    , _labels(labels)
+{
+}
+
+MetricKind MetricBase::kind() const
+{
+    return _kind;
+}
+
+QString MetricBase::name() const
+{
+    return _name;
+}
+
+QString MetricBase::help() const
+{
+    return _help;
+}
+
+QString MetricBase::labels() const
+{
+    return _labels;
+}
+
+
+MetricCounter::MetricCounter(const QString &name,
+                             const QString &help,
+                             const QString &labels)
+    : MetricBase(MetricKind::Counter, name, help, labels)
+    , _value(0)
+{
+}
+
+void MetricCounter::set(quint64 value)
+{
+    _value.store(value, std::memory_order_relaxed);
+}
+
+quint64 MetricCounter::value() const
+{
+    return _value.load(std::memory_order_relaxed);
+}
+
+
+MetricGauge::MetricGauge(const QString &name,
+                         const QString &help,
+                         const QString &labels)
+    : MetricBase(MetricKind::Gauge, name, help, labels)
+    , _value(0)
+{
+}
+
+qint64 MetricGauge::value() const
+{
+    return _value.load(std::memory_order_relaxed);
+}
+
+
+qint64 MetricHistogramSnapshot::percentile(double percent) const
+{
+    if (0 == Count)
+        return 0;
+
+    quint64 threshold = quint64(qMax(1.0, double(Count) * qMin(percent, 100.0) / 100.0));
+    quint64 cumulative = 0;
+    for (int i = 0; i < Buckets.count(); i++)
+    {
+        cumulative += Buckets.at(i);
+        if (cumulative >= threshold)
+            return MetricHistogram::bucketUpperBound(i);
+    }
+    return MetricHistogram::bucketUpperBound(Buckets.count() - 1);
+}
+
+
+MetricHistogram::MetricHistogram(const QString &name,
+                                 const QString &help,
+                                 const QString &labels)
+    : MetricBase(MetricKind::Histogram, name, help, labels)
+    , _sum(0)
+{
+    for (int i = 0; i < BUCKETS_COUNT; i++)
+        _buckets[i].store(0, std::memory_order_relaxed);
+}
+
+MetricHistogramSnapshot MetricHistogram::snapshot() const
+{
+    // счетчики читаются без остановки записи, поэтому сумма может немного
+    // расходиться с количеством замеров
+    MetricHistogramSnapshot result;
+    result.Buckets.resize(BUCKETS_COUNT);
+    for (int i = 0; i < BUCKETS_COUNT; i++)
+    {
+        result.Buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        result.Count += result.Buckets.at(i);
+    }
+    result.Sum = _sum.load(std::memory_order_relaxed);
+    return result;
+}
+
+qint64 MetricHistogram::bucketUpperBound(int index)
+{
+    if (index <= SUB_BUCKETS_COUNT)
+        return qMax(index, 0);
+
+    int shift = (index - 1) / SUB_BUCKETS_COUNT - 1;
+    quint64 subBucket = quint64((index - 1) % SUB_BUCKETS_COUNT + SUB_BUCKETS_COUNT);
+    if (shift > 63 - SUB_BUCKETS_BITS - 1)
+        return std::numeric_limits<qint64>::max();
+
+    quint64 result = (subBucket + 1) << shift;
+    return (result > quint64(std::numeric_limits<qint64>::max()))
+            ? std::numeric_limits<qint64>::max() : qint64(result);
+}
+
+
+MetricCounter::Ptr Metrics::counter(const QString &name,
+                                    const QString &help,
+                                    const QString &labels)
+{
+    auto result = std::make_shared<MetricCounter>(name, help, labels);
+    registerMetric(result);
+    return result;
+}
+
+MetricGauge::Ptr Metrics::gauge(const QString &name,
+                                const QString &help,
+                                const QString &labels)
+{
+    auto result = std::make_shared<MetricGauge>(name, help, labels);
+    registerMetric(result);
+    return result;
+}
+
+MetricHistogram::Ptr Metrics::histogram(const QString &name,
+                                        const QString &help,
+                                        const QString &labels)
+{
+    auto result = std::make_shared<MetricHistogram>(name, help, labels);
+    registerMetric(result);
+    return result;
+}
+
+QString Metrics::label(const QString &name, const QString &value)
+{
+    QString escaped = value;
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+    return name + "=\"" + escaped + "\"";
+}
+
+QByteArray Metrics::exposition()
+{
+    QVector<MetricBase::Ptr> metrics;
+    {
+        MetricsRegistry &registry = metricsRegistry();
+        QMutexLocker locker(&registry.Mutex);
+        metrics = collectMetrics(registry);
+    }
+
+    // семейства выводятся в порядке регистрации первой метрики
+    QVector<MetricFamily> families;
+    QHash<QString, int> familiesIndex;
+    for (const MetricBase::Ptr &metric : metrics)
+    {
+        int familyIndex = familiesIndex.value(metric->name(), -1);
+        if (familyIndex < 0)
+        {
+            familyIndex = families.count();
+            familiesIndex.insert(metric->name(), familyIndex);
+            families.append(MetricFamily{metric->name(), metric->help(), metric->kind(), {}, {}});
+        }
+
+        MetricFamily &family = families[familyIndex];
+        if (family.Kind != metric->kind())
+            continue;
+
+        int seriesIndex = family.SeriesIndex.value(metric->labels(), -1);
+        if (seriesIndex < 0)
+        {
+            seriesIndex = family.Series.count();
+            family.SeriesIndex.insert(metric->labels(), seriesIndex);
+            family.Series.append(MetricSeries());
+            family.Series[seriesIndex].Labels = metric->labels();
+        }
+        mergeSeries(family.Series[seriesIndex], *metric);
+    }
+
+    QByteArray result;
+    for (const MetricFamily &family : families)
+    {
+        QByteArray name = family.Name.toUtf8();
+        QString help = family.Help;
+        help.replace("\\", "\\\\").replace("\n", "\\n");
+
+        result += "# HELP " + name + " " + help.toUtf8() + "\n";
+        result += "# TYPE " + name + " " + kindName(family.Kind) + "\n";
+        for (const MetricSeries &series : family.Series)
+        {
+            if (MetricKind::Histogram == family.Kind)
+                writeHistogram(result, name, series);
+            else
+                result += name + seriesLabels(series.Labels) + " " + QByteArray::number(series.Value) + "\n";
+        }
+    }
+    return result;
+}
+
+void Metrics::registerMetric(const MetricBase::Ptr &metric)
+{
+    MetricsRegistry &registry = metricsRegistry();
+    QMutexLocker locker(&registry.Mutex);
+
+    // без запросов снимков освобожденные метрики удаляются при росте реестра
+    if (registry.Metrics.count() >= registry.PruneCount)
+        collectMetrics(registry);
+
+    registry.Metrics.append(metric);
+}
+
+}}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QByteArray>
+#include <QtAlgorithms>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+namespace Threader {
+
+namespace Utils {
+
+enum class MetricKind
+{
+    Counter,
+    Gauge,
+    Histogram
+};
+
+/**
+ * @brief MetricBase - Метрика с именем, описанием и набором меток
+ * Метки хранятся готовой строкой в формате Prometheus (name="value",...)
+ */
+class THREADERSHARED_EXPORT MetricBase
+{
+public:
+    using Ptr = std::shared_ptr<MetricBase>;
+
+public:
+    MetricBase(MetricKind kind,
+               const QString &name,
+               const QString &help,
+               const QString &labels);
+    virtual ~MetricBase() = default;
+
+    MetricBase(const MetricBase &) = delete;
+    MetricBase &operator=(const MetricBase &) = delete;
+
+    MetricKind kind() const;
+    QString name() const;
+    QString help() const;
+    QString labels() const;
+
+private:
+    MetricKind _kind;
+    QString _name;
+    QString _help;
+    QString _labels;
+};
+
+/**
+ * @brief MetricCounter - Монотонно возрастающий счетчик
+ * Изменяется атомарной операцией без упорядочивания памяти, счетчик размещается
+ * в отдельной строке кеша
+ */
+class THREADERSHARED_EXPORT MetricCounter : public MetricBase
+{
+public:
+    using Ptr = std::shared_ptr<MetricCounter>;
+
+public:
+    MetricCounter(const QString &name,
+                  const QString &help,
+                  const QString &labels);
+
+    void increment(quint64 value = 1);
+
+    /**
+     * @brief set - Установка значения счетчика, который ведется вне метрики
+     * @param value - Накопленное значение
+     */
+    void set(quint64 value);
+
+    quint64 value() const;
+
+private:
+    alignas(64) std::atomic<quint64> _value;
+};
+
+/**
+ * @brief MetricGauge - Текущее значение величины
+ */
+class THREADERSHARED_EXPORT MetricGauge : public MetricBase
+{
+public:
+    using Ptr = std::shared_ptr<MetricGauge>;
+
+public:
+    MetricGauge(const QString &name,
+                const QString &help,
+                const QString &labels);
+
+    void set(qint64 value);
+    void add(qint64 value);
+
+    qint64 value() const;
+
+private:
+    alignas(64) std::atomic<qint64> _value;
+};
+
+/**
+ * @brief MetricHistogramSnapshot - Снимок гистограммы
+ */
+struct THREADERSHARED_EXPORT MetricHistogramSnapshot
+{
+    quint64 Count = 0;
+    qint64 Sum = 0;
+    QVector<quint64> Buckets;
+
+    /**
+     * @brief percentile - Оценка процентиля по верхней границе интервала
+     * @param percent - Процент от 0 до 100
+     * @return - Значение, не меньшее заданной доли замеров
+     */
+    qint64 percentile(double percent) const;
+};
+
+/**
+ * @brief MetricHistogram - Гистограмма неотрицательных значений
+ * Интервалы логарифмически-линейные, как в HDR Histogram: каждая степень двойки
+ * делится на SUB_BUCKETS_COUNT равных интервалов, относительная погрешность
+ * не превышает 1 / SUB_BUCKETS_COUNT. Границы степеней двойки совпадают с границами
+ * интервалов, поэтому при выводе в формате Prometheus интервалы объединяются по
+ * степеням двойки без потери точности. Учет замера - два атомарных сложения
+ */
+class THREADERSHARED_EXPORT MetricHistogram : public MetricBase
+{
+public:
+    using Ptr = std::shared_ptr<MetricHistogram>;
+
+    static const int SUB_BUCKETS_BITS = 2;
+    static const int SUB_BUCKETS_COUNT = 1 << SUB_BUCKETS_BITS;
+    static const int BUCKETS_COUNT = 1 + 64 * SUB_BUCKETS_COUNT;
+
+public:
+    MetricHistogram(const QString &name,
+                    const QString &help,
+                    const QString &labels);
+
+    void record(qint64 value);
+
+    /**
+     * @brief recordExclusive - Учет замера единственным потоком, изменяющим гистограмму
+     * Выполняется обычными записями без атомарных операций чтения-изменения-записи
+     * @param value - Значение замера
+     */
+    void recordExclusive(qint64 value);
+
+    MetricHistogramSnapshot snapshot() const;
+
+    /**
+     * @brief bucketIndex - Получение номера интервала значения
+     */
+    static int bucketIndex(qint64 value);
+
+    /**
+     * @brief bucketUpperBound - Получение верхней границы интервала включительно
+     */
+    static qint64 bucketUpperBound(int index);
+
+private:
+    std::atomic<qint64> _sum;
+    std::atomic<quint64> _buckets[BUCKETS_COUNT];
+};
+
+/**
+ * @brief Metrics - Реестр метрик
+ * Метрики создаются владельцами (потоками, обработчиками) и изменяются без
+ * блокировок, реестр хранит слабые ссылки и собирает значения только при запросе
+ * снимка. Метрика исключается из реестра при освобождении владельцем. Ряды одного
+ * семейства с одинаковыми метками при выводе суммируются
+ */
+class THREADERSHARED_EXPORT Metrics
+{
+public:
+    Metrics() = delete;
+
+    static MetricCounter::Ptr counter(const QString &name,
+                                      const QString &help,
+                                      const QString &labels = QString());
+
+    static MetricGauge::Ptr gauge(const QString &name,
+                                  const QString &help,
+                                  const QString &labels = QString());
+
+    static MetricHistogram::Ptr histogram(const QString &name,
+                                          const QString &help,
+                                          const QString &labels = QString());
+
+    /**
+     * @brief label - Формирование метки с экранированием значения
+     * @param name - Имя метки
+     * @param value - Значение метки
+     * @return - Метка в формате name="value"
+     */
+    static QString label(const QString &name, const QString &value);
+
+    /**
+     * @brief exposition - Формирование снимка метрик в текстовом формате Prometheus 0.0.4
+     * @return - Текст в кодировке UTF-8
+     */
+    static QByteArray exposition();
+
+private:
+    static void registerMetric(const MetricBase::Ptr &metric);
+};
+
+
+inline void MetricCounter::increment(quint64 value)
+{
+    _value.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline void MetricGauge::set(qint64 value)
+{
+    _value.store(value, std::memory_order_relaxed);
+}
+
+inline void MetricGauge::add(qint64 value)
+{
+    _value.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline int MetricHistogram::bucketIndex(qint64 value)
+{
+    if (value <= 0)
+        return 0;
+
+    // интервалы сдвинуты на единицу, чтобы степени двойки были верхними границами
+    quint64 shifted = quint64(value - 1);
+    if (shifted < quint64(SUB_BUCKETS_COUNT))
+        return 1 + int(shifted);
+
+    int highestBit = 63 - int(qCountLeadingZeroBits(shifted));
+    int shift = highestBit - SUB_BUCKETS_BITS;
+    return 1 + (shift + 1) * SUB_BUCKETS_COUNT + int(shifted >> shift) - SUB_BUCKETS_COUNT;
+}
+
+inline void MetricHistogram::record(qint64 value)
+{
+    _buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(qMax(value, qint64(0)), std::memory_order_relaxed);
+}
+
+inline void MetricHistogram::recordExclusive(qint64 value)
+{
+    std::atomic<quint64> &bucket = _buckets[bucketIndex(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _sum.store(_sum.load(std::memory_order_relaxed) + qMax(value, qint64(0)), std::memory_order_relaxed);
+}
+
+}}
@@ -0,0 +1,75 @@
+#include "RttEstimator.h"
+
+namespace Threader {
+
+namespace Utils {
+
+
+RttEstimator::RttEstimator(qint64 initialTimeout,
+                           qint64 minimumTimeout,
+                           qint64 maximumTimeout)
+    : _initialTimeout(initialTimeout)
+    , _minimumTimeout(minimumTimeout)
+    , _maximumTimeout(qMax(minimumTimeout, maximumTimeout))
+{
+    reset();
+}
+
+void RttEstimator::reset()
+{
+    _smoothedRtt = 0;
+    _rttVariation = 0;
+    _timeout = qBound(_minimumTimeout, _initialTimeout, _maximumTimeout);
+    _hasSamples = false;
+}
+
+void RttEstimator::addSample(qint64 rtt)
+{
+    if (rtt < 0)
+        return;
+
+    if (!_hasSamples)
+    {
+        _smoothedRtt = rtt;
+        _rttVariation = rtt / 2;
+        _hasSamples = true;
+    }
+    else
+    {
+        // RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R|, SRTT = 7/8 * SRTT + 1/8 * R
+        _rttVariation = (3 * _rttVariation + qAbs(_smoothedRtt - rtt)) / 4;
+        _smoothedRtt = (7 * _smoothedRtt + rtt) / 8;
+    }
+
+    // разброс не меньше миллисекунды - разрешения счетчика времени
+    _timeout = qBound(_minimumTimeout,
+                      _smoothedRtt + qMax(qint64(1), 4 * _rttVariation),
+                      _maximumTimeout);
+}
+
+qint64 RttEstimator::timeout() const
+{
+    return _timeout;
+}
+
+qint64 RttEstimator::backoff(qint64 timeout) const
+{
+    return qMin(timeout * 2, _maximumTimeout);
+}
+
+bool RttEstimator::hasSamples() const
+{
+    return _hasSamples;
+}
+
+qint64 RttEstimator::smoothedRtt() const
+{
+    return _smoothedRtt;
+}
+
+qint64 RttEstimator::rttVariation() const
+{
+    return _rttVariation;
+}
+
+}}
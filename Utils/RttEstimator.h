@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QtGlobal>
+
+namespace Threader {
+
+namespace Utils {
+
+/**
+ * @brief RttEstimator - Оценка времени кругового обхода и таймаута повторной отправки
+ * Сглаженное время обхода (SRTT) и его разброс (RTTVAR) вычисляются по замерам
+ * времени получения подтверждений, таймаут повторной отправки равен SRTT + 4 * RTTVAR
+ * в заданных границах (алгоритм Джекобсона, RFC 6298). Замеры по пакетам, отправленным
+ * повторно, не учитываются (алгоритм Карна)
+ */
+class THREADERSHARED_EXPORT RttEstimator
+{
+public:
+    /**
+     * @brief RttEstimator - Конструктор
+     * @param initialTimeout - Таймаут до первого замера в миллисекундах
+     * @param minimumTimeout - Минимальный таймаут в миллисекундах
+     * @param maximumTimeout - Максимальный таймаут в миллисекундах
+     */
+    explicit RttEstimator(qint64 initialTimeout = 2000,
+                          qint64 minimumTimeout = 200,
+                          qint64 maximumTimeout = 60000);
+
+    /**
+     * @brief reset - Сброс замеров
+     */
+    void reset();
+
+    /**
+     * @brief addSample - Учет замера времени обхода
+     * @param rtt - Время от отправки пакета до получения подтверждения в миллисекундах
+     */
+    void addSample(qint64 rtt);
+
+    /**
+     * @brief timeout - Получение текущего таймаута повторной отправки
+     * @return - Таймаут в миллисекундах
+     */
+    qint64 timeout() const;
+
+    /**
+     * @brief backoff - Увеличение таймаута пакета после очередной повторной отправки
+     * @param timeout - Текущий таймаут пакета в миллисекундах
+     * @return - Удвоенный таймаут в пределах максимального
+     */
+    qint64 backoff(qint64 timeout) const;
+
+    bool hasSamples() const;
+    qint64 smoothedRtt() const;
+    qint64 rttVariation() const;
+
+private:
+    qint64 _initialTimeout;
+    qint64 _minimumTimeout;
+    qint64 _maximumTimeout;
+    qint64 _smoothedRtt;
+    qint64 _rttVariation;
+    qint64 _timeout;
+    bool _hasSamples;
+};
+
+}}
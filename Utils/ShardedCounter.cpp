@@ -0,0 +1,30 @@
+#include "ShardedCounter.h"
+
+namespace Threader {
+
+namespace Utils {
+
+
+ShardedCounter::ShardedCounter()
+{
+    for (int i = 0; i < SHARDS_COUNT; i++)
+        _shards[i].Value.store(0, std::memory_order_relaxed);
+}
+
+qint64 ShardedCounter::value() const
+{
+    qint64 result = 0;
+    for (int i = 0; i < SHARDS_COUNT; i++)
+        result += _shards[i].Value.load(std::memory_order_relaxed);
+    return result;
+}
+
+int ShardedCounter::shardIndex()
+{
+    // ячейка назначается потоку один раз по порядку первого обращения
+    static std::atomic<int> nextIndex(0);
+    static thread_local int index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SHARDS_COUNT;
+    return index;
+}
+
+}}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QtGlobal>
+
+#include <atomic>
+
+namespace Threader {
+
+namespace Utils {
+
+/**
+ * @brief ShardedCounter - Счетчик экземпляров, распределенный по потокам
+ * Каждый поток изменяет свою ячейку счетчика, размещенную в отдельной строке кеша,
+ * атомарной операцией без упорядочивания памяти. Значение счетчика - сумма ячеек,
+ * поэтому уменьшение в потоке, отличном от увеличившего, допустимо. Чтение значения
+ * дороже изменения и предназначено для статистики
+ */
+class THREADERSHARED_EXPORT ShardedCounter
+{
+public:
+    ShardedCounter();
+
+    ShardedCounter(const ShardedCounter &) = delete;
+    ShardedCounter &operator=(const ShardedCounter &) = delete;
+
+    void increment();
+    void decrement();
+
+    /**
+     * @brief value - Получение значения счетчика
+     * @return - Сумма ячеек счетчика
+     */
+    qint64 value() const;
+
+private:
+    static const int SHARDS_COUNT = 16;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<qint64> Value;
+    };
+
+    /**
+     * @brief shardIndex - Получение номера ячейки текущего потока
+     */
+    static int shardIndex();
+
+    Shard _shards[SHARDS_COUNT];
+};
+
+inline void ShardedCounter::increment()
+{
+    _shards[shardIndex()].Value.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void ShardedCounter::decrement()
+{
+    _shards[shardIndex()].Value.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}}
@@ -0,0 +1,231 @@
+#include "SlabAllocator.h"
+#include "ShardedCounter.h"
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace Threader {
+
+namespace Utils {
+
+
+namespace {
+
+const size_t HEADER_SIZE = 16;
+const size_t SLAB_SIZE = 64 * 1024;
+const size_t MINIMUM_CLASS_BITS = 5;
+const int LARGE_CLASS = -1;
+
+struct SlabCache;
+
+/**
+ * @brief BlockHeader - Заголовок блока перед выдаваемой областью памяти
+ */
+struct BlockHeader
+{
+    SlabCache *Owner;
+    int SizeClass;
+};
+
+static_assert(sizeof(BlockHeader) <= HEADER_SIZE, "Заголовок блока не помещается в отведенный размер");
+
+/**
+ * @brief FreeBlock - Звено списка свободных блоков, размещаемое в области данных блока
+ */
+struct FreeBlock
+{
+    FreeBlock *Next;
+};
+
+struct SizeClassCache
+{
+    FreeBlock *Local = nullptr;
+    std::atomic<FreeBlock*> Remote{nullptr};
+    char *Cursor = nullptr;
+    char *End = nullptr;
+};
+
+/**
+ * @brief SlabCache - Плиты и списки свободных блоков одного потока
+ * Кеш удерживается потоком-владельцем и каждым выделенным блоком,
+ * удаляется при освобождении последней ссылки
+ */
+struct SlabCache
+{
+    SizeClassCache Classes[SlabAllocator::SIZE_CLASSES_COUNT];
+    std::vector<char*> Slabs;
+    std::atomic<qint64> References{1};
+
+    ~SlabCache()
+    {
+        for (char *slab : Slabs)
+            ::operator delete(slab);
+    }
+
+    void release()
+    {
+        if (1 == References.fetch_sub(1, std::memory_order_acq_rel))
+            delete this;
+    }
+};
+
+thread_local SlabCache *currentCache = nullptr;
+
+/**
+ * @brief CacheHolder - Освобождение кеша потока при завершении потока
+ */
+struct CacheHolder
+{
+    ~CacheHolder()
+    {
+        SlabCache *cache = currentCache;
+        currentCache = nullptr;
+        if (cache)
+            cache->release();
+    }
+};
+
+ShardedCounter *liveCounters()
+{
+    static ShardedCounter counters[SlabAllocator::SIZE_CLASSES_COUNT];
+    return counters;
+}
+
+inline int sizeClassOf(size_t size)
+{
+    int sizeClass = 0;
+    while (sizeClass < SlabAllocator::SIZE_CLASSES_COUNT &&
+           size > (size_t(1) << (MINIMUM_CLASS_BITS + sizeClass)))
+        sizeClass++;
+    return (sizeClass < SlabAllocator::SIZE_CLASSES_COUNT) ? sizeClass : LARGE_CLASS;
+}
+
+inline void *payloadOf(BlockHeader *header)
+{
+    return reinterpret_cast<char*>(header) + HEADER_SIZE;
+}
+
+inline BlockHeader *headerOf(void *pointer)
+{
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(pointer) - HEADER_SIZE);
+}
+
+SlabCache *threadCache()
+{
+    if (!currentCache)
+    {
+        // хранитель создается при первом выделении и освобождает кеш при завершении потока
+        thread_local CacheHolder holder;
+        currentCache = new SlabCache();
+    }
+    return currentCache;
+}
+
+}
+
+
+void *SlabAllocator::allocate(size_t size)
+{
+    int sizeClass = sizeClassOf(size);
+    BlockHeader *header;
+
+    if (LARGE_CLASS == sizeClass)
+    {
+        header = static_cast<BlockHeader*>(::operator new(HEADER_SIZE + size));
+        header->Owner = nullptr;
+        header->SizeClass = LARGE_CLASS;
+        return payloadOf(header);
+    }
+
+    SlabCache *cache = threadCache();
+    SizeClassCache &classCache = cache->Classes[sizeClass];
+
+    // при пустом локальном списке забираются все блоки, освобожденные другими потоками
+    if (!classCache.Local)
+        classCache.Local = classCache.Remote.exchange(nullptr, std::memory_order_acquire);
+
+    if (classCache.Local)
+    {
+        FreeBlock *block = classCache.Local;
+        classCache.Local = block->Next;
+        header = headerOf(block);
+    }
+    else
+    {
+        size_t blockSize = HEADER_SIZE + sizeClassSize(sizeClass);
+        if (!classCache.Cursor || size_t(classCache.End - classCache.Cursor) < blockSize)
+        {
+            char *slab = static_cast<char*>(::operator new(SLAB_SIZE));
+            cache->Slabs.push_back(slab);
+            classCache.Cursor = slab;
+            classCache.End = slab + SLAB_SIZE;
+        }
+        header = reinterpret_cast<BlockHeader*>(classCache.Cursor);
+        classCache.Cursor += blockSize;
+        header->Owner = cache;
+        header->SizeClass = sizeClass;
+    }
+
+    cache->References.fetch_add(1, std::memory_order_relaxed);
+    liveCounters()[sizeClass].increment();
+    return payloadOf(header);
+}
+
+void SlabAllocator::deallocate(void *pointer)
+{
+    if (!pointer)
+        return;
+
+    BlockHeader *header = headerOf(pointer);
+    if (LARGE_CLASS == header->SizeClass)
+    {
+        ::operator delete(header);
+        return;
+    }
+
+    SlabCache *cache = header->Owner;
+    SizeClassCache &classCache = cache->Classes[header->SizeClass];
+    FreeBlock *block = static_cast<FreeBlock*>(pointer);
+
+    liveCounters()[header->SizeClass].decrement();
+
+    if (cache == currentCache)
+    {
+        block->Next = classCache.Local;
+        classCache.Local = block;
+    }
+    else
+    {
+        // стек Трайбера: вершина забирается владельцем только целиком, поэтому ABA невозможна
+        FreeBlock *head = classCache.Remote.load(std::memory_order_relaxed);
+        do
+            block->Next = head;
+        while (!classCache.Remote.compare_exchange_weak(head, block,
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed));
+    }
+
+    cache->release();
+}
+
+size_t SlabAllocator::sizeClassSize(int sizeClass)
+{
+    if (sizeClass < 0 || sizeClass >= SIZE_CLASSES_COUNT)
+        return 0;
+    return size_t(1) << (MINIMUM_CLASS_BITS + sizeClass);
+}
+
+qint64 SlabAllocator::liveBlocks(int sizeClass)
+{
+    if (sizeClass < 0 || sizeClass >= SIZE_CLASSES_COUNT)
+        return 0;
+    return liveCounters()[sizeClass].value();
+}
+
+qint64 SlabAllocator::liveBytes(int sizeClass)
+{
+    return liveBlocks(sizeClass) * qint64(sizeClassSize(sizeClass));
+}
+
+}}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../threader_global.h"
+
+#include <QtGlobal>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace Threader {
+
+namespace Utils {
+
+/**
+ * @brief SlabAllocator - Распределитель памяти блоками фиксированных размеров
+ * Блоки размером до 4 КиБ нарезаются из плит по 64 КиБ, принадлежащих выделившему их потоку.
+ * Выделение и освобождение в потоке-владельце выполняются через локальный список свободных
+ * блоков без блокировок. Блок, освобожденный в другом потоке, помещается в lock-free стек
+ * удаленных освобождений владельца и забирается им целиком при исчерпании локального списка.
+ * Плиты завершившегося потока освобождаются после возврата последнего выделенного из них блока.
+ * Блоки большего размера выделяются через operator new
+ */
+class THREADERSHARED_EXPORT SlabAllocator
+{
+public:
+    static const int SIZE_CLASSES_COUNT = 8;
+
+    /**
+     * @brief allocate - Выделение блока памяти, выровненного на 16 байт
+     * @param size - Размер блока
+     * @return - Указатель на блок
+     */
+    static void *allocate(size_t size);
+
+    /**
+     * @brief deallocate - Освобождение блока памяти в любом потоке
+     * @param pointer - Указатель на блок
+     */
+    static void deallocate(void *pointer);
+
+    /**
+     * @brief sizeClassSize - Получение размера блоков класса
+     * @param sizeClass - Номер класса размера
+     * @return - Размер блоков в байтах
+     */
+    static size_t sizeClassSize(int sizeClass);
+
+    /**
+     * @brief liveBlocks - Получение количества выделенных блоков класса
+     * @param sizeClass - Номер класса размера
+     * @return - Количество блоков
+     */
+    static qint64 liveBlocks(int sizeClass);
+
+    /**
+     * @brief liveBytes - Получение объема выделенных блоков класса
+     * @param sizeClass - Номер класса размера
+     * @return - Объем в байтах
+     */
+    static qint64 liveBytes(int sizeClass);
+};
+
+/**
+ * @brief SlabStdAllocator - Адаптер SlabAllocator для стандартных контейнеров и std::allocate_shared
+ */
+template<typename T>
+class SlabStdAllocator
+{
+public:
+    using value_type = T;
+
+    SlabStdAllocator() = default;
+
+    template<typename U>
+    SlabStdAllocator(const SlabStdAllocator<U> &) {}
+
+    T *allocate(size_t count)
+    {
+        return static_cast<T*>(SlabAllocator::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, size_t)
+    {
+        SlabAllocator::deallocate(pointer);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const SlabStdAllocator<T> &, const SlabStdAllocator<U> &)
+{
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const SlabStdAllocator<T> &, const SlabStdAllocator<U> &)
+{
+    return false;
+}
+
+/**
+ * @brief makeSlabShared - Создание объекта и его счетчика ссылок одним блоком SlabAllocator
+ */
+template<typename T, typename... Args>
+inline std::shared_ptr<T> makeSlabShared(Args&&... args)
+{
+    return std::allocate_shared<T>(SlabStdAllocator<T>(), std::forward<Args>(args)...);
+}
+
+}}
@@ -1,4 +1,5 @@
 #include "TrafficCounter.h"
+#include "LoopClock.h"
 
 namespace Threader {
 
@@ -25,6 +26,15 @@ quint64 TrafficCounter::append(const QDateTime &dateTime,
     return actualize();
 }
 
+quint64 TrafficCounter::append(const qint64 msecsSinceEpoch,
+                               const quint64 &count)
+{
+    _total += count;
+    _historyList.append(TrafficHistory(msecsSinceEpoch, count));
+
+    return actualize(msecsSinceEpoch);
+}
+
 quint64 TrafficCounter::currentSpeed() const
 {
     return _currentSpeed;
@@ -47,7 +57,12 @@ quint64 TrafficCounter::total() const
 
 quint64 TrafficCounter::actualize()
 {
-    quint64 limit = QDateTime::currentDateTime().addSecs(-_secondsToStore).toMSecsSinceEpoch();
+    return actualize(LoopClock::currentMSecsSinceEpoch());
+}
+
+quint64 TrafficCounter::actualize(const qint64 msecsSinceEpoch)
+{
+    quint64 limit = quint64(msecsSinceEpoch - qint64(_secondsToStore) * 1000);
     
     int removeCount = 0;
     quint64 trafficCount = 0;
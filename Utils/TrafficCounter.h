@@ -19,6 +19,13 @@ struct TrafficHistory
     {
     }
 
+    TrafficHistory(const qint64 receivedMsecsSinceEpoch,
+                   const quint64 &count)
+        : Received(quint64(receivedMsecsSinceEpoch))
+        , Count(count)
+    {
+    }
+
     quint64 Received;
     quint64 Count;
 };
@@ -33,7 +40,10 @@ public:
     void clear();
     quint64 append(const QDateTime &dateTime,
                    const quint64 &count);
+    quint64 append(const qint64 msecsSinceEpoch,
+                   const quint64 &count);
     quint64 actualize();
+    quint64 actualize(const qint64 msecsSinceEpoch);
     quint64 currentSpeed() const;
 
     int secondsToStore() const;